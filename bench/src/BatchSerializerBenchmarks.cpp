@@ -0,0 +1,64 @@
+#include "Benchmark.hpp"
+#include <string>
+#include <Uri/BatchSerializer.hpp>
+#include <Uri/Uri.hpp>
+#include <vector>
+
+namespace
+{
+    const size_t URL_COUNT = 200000;
+}
+
+BENCHMARK(BatchSerializer)
+{
+    std::vector< Uri::Uri > uris;
+    size_t total_length = 0;
+    for (const auto& url: Benchmark::MakeUrls(URL_COUNT, 0))
+    {
+        uris.emplace_back();
+        (void)uris.back().ParseFromString(url);
+        total_length += url.length() + 1;
+    }
+
+    // What the exporter did: a string per URI, copied into the output.
+    {
+        std::string output;
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            output += uri.GenerateString();
+            output += '\n';
+        }
+        reporter.ReportThroughput("generate_string_and_copy", uris.size(), timer.ElapsedSeconds());
+        reporter.ReportThroughput("generate_string_and_copy_bytes", output.length(), timer.ElapsedSeconds());
+    }
+    {
+        std::string output;
+        std::vector< size_t > offsets;
+        Benchmark::Timer timer;
+        Uri::BatchSerializer::Serialize(uris, "\n", output, &offsets);
+        reporter.ReportThroughput("batch_serialize", uris.size(), timer.ElapsedSeconds());
+        reporter.ReportThroughput("batch_serialize_bytes", output.length(), timer.ElapsedSeconds());
+        reporter.Report("output_matches_length", (output.length() == total_length) ? 1 : 0, "");
+    }
+#if !defined(_WIN32)
+    {
+        std::vector< std::string > chunks(16, std::string(1 << 20, '\0'));
+        std::vector< struct iovec > iovecs(chunks.size());
+        size_t written = 0;
+        Benchmark::Timer timer;
+        while (written < uris.size())
+        {
+            for (size_t i = 0; i < chunks.size(); ++i)
+            {
+                iovecs[i].iov_base = &chunks[i][0];
+                iovecs[i].iov_len = chunks[i].length();
+            }
+            written += Uri::BatchSerializer::Serialize(
+                uris.data() + written, uris.size() - written, "\n", iovecs.data(), iovecs.size()
+            );
+        }
+        reporter.ReportThroughput("batch_serialize_iovecs", uris.size(), timer.ElapsedSeconds());
+    }
+#endif
+}
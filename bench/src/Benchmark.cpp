@@ -0,0 +1,77 @@
+#include "Benchmark.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+
+namespace
+{
+    std::vector< std::pair< std::string, Benchmark::Function > >& Registry()
+    {
+        static std::vector< std::pair< std::string, Benchmark::Function > > registry;
+        return registry;
+    }
+}
+
+namespace Benchmark
+{
+    Reporter::Reporter(const std::string& benchmark_name)
+        : benchmark_name_(benchmark_name)
+    {
+    }
+
+    void Reporter::Report(const std::string& metric, double value, const std::string& unit)
+    {
+        printf("%-40s %-32s %16.2f %s\n", benchmark_name_.c_str(), metric.c_str(), value, unit.c_str());
+    }
+
+    void Reporter::ReportThroughput(const std::string& metric, size_t operations, double seconds)
+    {
+        Report(metric, (seconds > 0.0) ? (operations / seconds) : 0.0, "ops/s");
+    }
+
+    Timer::Timer()
+        : start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    double Timer::ElapsedSeconds() const
+    {
+        return std::chrono::duration< double >(std::chrono::steady_clock::now() - start_).count();
+    }
+
+    Registrar::Registrar(const char* name, Function function)
+    {
+        Registry().emplace_back(name, function);
+    }
+
+    std::vector< std::string > MakeUrls(size_t count, size_t distinct)
+    {
+        std::vector< std::string > urls;
+        urls.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto id = (distinct == 0) ? i : (i % distinct);
+            urls.push_back(
+                "https://www.host" + std::to_string(id % 4093) + ".example.com/products/category-"
+                + std::to_string(id % 97) + "/item/" + std::to_string(id)
+                + "?ref=crawl&page=" + std::to_string(id % 13)
+            );
+        }
+        return urls;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const char* filter = (argc > 1) ? argv[1] : "";
+    for (const auto& benchmark: Registry())
+    {
+        if (strstr(benchmark.first.c_str(), filter) == nullptr)
+        {
+            continue;
+        }
+        Benchmark::Reporter reporter(benchmark.first);
+        benchmark.second(reporter);
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef URI_BENCHMARK_HPP
+#define URI_BENCHMARK_HPP
+
+#include <chrono>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+    class Reporter
+    {
+    public:
+        explicit Reporter(const std::string& benchmark_name);
+        void Report(const std::string& metric, double value, const std::string& unit);
+        void ReportThroughput(const std::string& metric, size_t operations, double seconds);
+
+    private:
+        std::string benchmark_name_;
+    };
+
+    class Timer
+    {
+    public:
+        Timer();
+        double ElapsedSeconds() const;
+
+    private:
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    typedef void (*Function)(Reporter&);
+
+    struct Registrar
+    {
+        Registrar(const char* name, Function function);
+    };
+
+    // Synthetic crawl-like URLs: a few thousand hosts, deep paths, queries.
+    std::vector< std::string > MakeUrls(size_t count, size_t distinct);
+}
+
+#define BENCHMARK(name) \
+    static void name(Benchmark::Reporter&); \
+    static const Benchmark::Registrar name##_registrar(#name, name); \
+    static void name(Benchmark::Reporter& reporter)
+
+#endif
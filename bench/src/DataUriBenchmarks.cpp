@@ -0,0 +1,60 @@
+#include "Benchmark.hpp"
+#include <stdint.h>
+#include <string>
+#include <Uri/DataUri.hpp>
+#include <Uri/Uri.hpp>
+#include <vector>
+
+namespace
+{
+    const size_t PAYLOAD_SIZE = 4 * 1024 * 1024;
+    const size_t BUFFER_SIZE = 64 * 1024;
+
+    std::string MakeDataUri()
+    {
+        static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string uri_string = "data:image/png;base64,";
+        uint32_t state = 12345;
+        for (size_t i = 0; i < PAYLOAD_SIZE / 3 * 4; ++i)
+        {
+            state = state * 1103515245 + 12345;
+            uri_string += ALPHABET[(state >> 16) & 63];
+        }
+        return uri_string;
+    }
+}
+
+BENCHMARK(DataUri)
+{
+    const auto uri_string = MakeDataUri();
+    {
+        Benchmark::Timer timer;
+        Uri::Uri uri;
+        (void)uri.ParseFromString(uri_string);
+        const auto path = uri.GetPath();
+        reporter.ReportThroughput("uri_parse_bytes", uri_string.length(), timer.ElapsedSeconds());
+    }
+    {
+        Benchmark::Timer timer;
+        Uri::DataUri data_uri;
+        (void)data_uri.ParseFromString(uri_string);
+        reporter.ReportThroughput("data_uri_parse_bytes", uri_string.length(), timer.ElapsedSeconds());
+
+        timer = Benchmark::Timer();
+        Uri::DataUriDecoder decoder(data_uri);
+        std::vector< char > buffer(BUFFER_SIZE);
+        size_t total = 0;
+        while (!decoder.Done())
+        {
+            size_t written = 0;
+            if (!decoder.Read(buffer.data(), buffer.size(), written))
+            {
+                break;
+            }
+            total += written;
+        }
+        reporter.ReportThroughput("base64_decode_bytes", data_uri.GetPayload().length(), timer.ElapsedSeconds());
+        reporter.Report("decoded_all", (total == data_uri.GetMaxDecodedLength()) ? 1 : 0, "");
+        reporter.Report("peak_buffer", BUFFER_SIZE, "bytes");
+    }
+}
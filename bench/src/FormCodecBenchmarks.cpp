@@ -0,0 +1,179 @@
+#include "Benchmark.hpp"
+#include <ctype.h>
+#include <string>
+#include <Uri/FormCodec.hpp>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    const size_t PAIR_COUNT = 100000;
+    const size_t CHUNK_SIZE = 64 * 1024;
+
+    // A body of form fields, some with spaces and escapes, some plain.
+    std::string MakeBody()
+    {
+        std::string body;
+        for (size_t i = 0; i < PAIR_COUNT; ++i)
+        {
+            if (i > 0)
+            {
+                body += '&';
+            }
+            body += "field_" + std::to_string(i) + "=";
+            switch (i % 4)
+            {
+                case 0: body += "some+words+here"; break;
+                case 1: body += "J%C3%B6rg%20%26%20Co"; break;
+                case 2: body += "plain-value-with-no-escapes-at-all-" + std::to_string(i); break;
+                default: body += "a%3Db"; break;
+            }
+        }
+        return body;
+    }
+
+    int HexValue(char c)
+    {
+        if ((c >= '0') && (c <= '9'))
+        {
+            return c - '0';
+        }
+        if ((c >= 'A') && (c <= 'F'))
+        {
+            return c - 'A' + 10;
+        }
+        if ((c >= 'a') && (c <= 'f'))
+        {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    // How the services decoded bodies before: a character at a time, a
+    // pair of strings per field.
+    std::vector< std::pair< std::string, std::string > > NaiveDecode(const std::string& body)
+    {
+        std::vector< std::pair< std::string, std::string > > pairs;
+        std::string name;
+        std::string value;
+        bool in_value = false;
+        for (size_t i = 0; i <= body.length(); ++i)
+        {
+            if ((i == body.length()) || (body[i] == '&'))
+            {
+                if (!name.empty() || in_value)
+                {
+                    pairs.emplace_back(name, value);
+                }
+                name.clear();
+                value.clear();
+                in_value = false;
+                continue;
+            }
+            auto c = body[i];
+            if ((c == '=') && !in_value)
+            {
+                in_value = true;
+                continue;
+            }
+            if (c == '+')
+            {
+                c = ' ';
+            }
+            else if ((c == '%') && (i + 2 < body.length())
+                && (HexValue(body[i + 1]) >= 0) && (HexValue(body[i + 2]) >= 0))
+            {
+                c = (char)((HexValue(body[i + 1]) << 4) | HexValue(body[i + 2]));
+                i += 2;
+            }
+            (in_value ? value : name).push_back(c);
+        }
+        return pairs;
+    }
+}
+
+BENCHMARK(FormCodec)
+{
+    const auto body = MakeBody();
+    size_t checksum = 0;
+    {
+        Benchmark::Timer timer;
+        const auto pairs = NaiveDecode(body);
+        reporter.ReportThroughput("naive_decode_bytes", body.length(), timer.ElapsedSeconds());
+        checksum += pairs.size();
+    }
+    {
+        std::vector< Uri::FormPair > pairs;
+        std::string storage;
+        Benchmark::Timer timer;
+        Uri::FormDecoder::DecodeAll(body, pairs, storage);
+        reporter.ReportThroughput("decode_all_bytes", body.length(), timer.ElapsedSeconds());
+        checksum += pairs.size();
+    }
+    {
+        Uri::FormDecoder decoder;
+        std::vector< Uri::FormPair > pairs;
+        std::string storage;
+        size_t pair_count = 0;
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < body.length(); i += CHUNK_SIZE)
+        {
+            decoder.Decode(std::string_view(body).substr(i, CHUNK_SIZE), pairs, storage);
+            pair_count += pairs.size();
+        }
+        decoder.Finish(pairs, storage);
+        pair_count += pairs.size();
+        reporter.ReportThroughput("streaming_decode_bytes", body.length(), timer.ElapsedSeconds());
+        reporter.Report("pairs_match", (pair_count == PAIR_COUNT) && (checksum == 2 * PAIR_COUNT) ? 1 : 0, "");
+    }
+
+    std::vector< std::pair< std::string, std::string > > fields = NaiveDecode(body);
+    {
+        Benchmark::Timer timer;
+        std::string form;
+        for (const auto& field: fields)
+        {
+            if (!form.empty())
+            {
+                form += '&';
+            }
+            for (const auto* element: {&field.first, &field.second})
+            {
+                for (const auto c: *element)
+                {
+                    if (isalnum((unsigned char)c) || (c == '*') || (c == '-') || (c == '.') || (c == '_'))
+                    {
+                        form += c;
+                    }
+                    else if (c == ' ')
+                    {
+                        form += '+';
+                    }
+                    else
+                    {
+                        static const char HEX[] = "0123456789ABCDEF";
+                        form += '%';
+                        form += HEX[(unsigned char)c >> 4];
+                        form += HEX[(unsigned char)c & 0x0F];
+                    }
+                }
+                if (element == &field.first)
+                {
+                    form += '=';
+                }
+            }
+        }
+        reporter.ReportThroughput("naive_encode_pairs", fields.size(), timer.ElapsedSeconds());
+    }
+    {
+        Uri::FormBuilder builder;
+        for (const auto& field: fields)
+        {
+            builder.Add(field.first, field.second);
+        }
+        Benchmark::Timer timer;
+        const auto form = builder.Build();
+        reporter.ReportThroughput("builder_build_pairs", fields.size(), timer.ElapsedSeconds());
+        reporter.Report("build_allocated_exactly", (form.capacity() == form.length()) ? 1 : 0, "");
+    }
+}
@@ -0,0 +1,50 @@
+#include "Benchmark.hpp"
+#include <Uri/Idna.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t HOST_COUNT = 100000;
+    const size_t DISTINCT_IDN_HOSTS = 200;
+}
+
+BENCHMARK(Idna)
+{
+    std::vector< std::string > ascii_hosts;
+    for (const auto& url: Benchmark::MakeUrls(HOST_COUNT, 0))
+    {
+        Uri::Uri uri;
+        (void)uri.ParseFromString(url);
+        ascii_hosts.push_back(uri.GetHost());
+    }
+    std::vector< std::string > idn_hosts;
+    for (size_t i = 0; i < HOST_COUNT; ++i)
+    {
+        idn_hosts.push_back(
+            "b\xC3\xBC" "cher-" + std::to_string(i % DISTINCT_IDN_HOSTS) + ".\xD0\xBF\xD1\x80\xD0\xB8\xD0\xBC\xD0\xB5\xD1\x80"
+        );
+    }
+    std::string converted;
+    {
+        Uri::Idna idna;
+        Benchmark::Timer timer;
+        for (const auto& host: ascii_hosts)
+        {
+            (void)idna.ToAscii(host, converted);
+        }
+        reporter.ReportThroughput("to_ascii_plain_ascii", ascii_hosts.size(), timer.ElapsedSeconds());
+    }
+    for (const size_t capacity: {(size_t)0, Uri::Idna::DEFAULT_CACHE_CAPACITY})
+    {
+        Uri::Idna idna(capacity);
+        const std::string suffix = (capacity == 0) ? "_uncached" : "_cached";
+        Benchmark::Timer timer;
+        for (const auto& host: idn_hosts)
+        {
+            (void)idna.ToAscii(host, converted);
+        }
+        reporter.ReportThroughput("to_ascii_idn" + suffix, idn_hosts.size(), timer.ElapsedSeconds());
+    }
+}
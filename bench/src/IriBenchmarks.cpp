@@ -0,0 +1,47 @@
+#include "Benchmark.hpp"
+#include <Uri/Iri.hpp>
+#include <Uri/Uri.hpp>
+
+namespace
+{
+    const size_t URL_COUNT = 100000;
+}
+
+BENCHMARK(Iri)
+{
+    auto ascii = Benchmark::MakeUrls(URL_COUNT, 0);
+    auto utf8 = ascii;
+    for (auto& url: utf8)
+    {
+        url += "/caf\xC3\xA9-\xE2\x82\xAC";
+    }
+    for (const auto* urls: {&ascii, &utf8})
+    {
+        const std::string suffix = (urls == &ascii) ? "_ascii" : "_utf8";
+        size_t total_bytes = 0;
+        for (const auto& url: *urls)
+        {
+            total_bytes += url.length();
+        }
+        std::string uri;
+        {
+            Benchmark::Timer timer;
+            for (const auto& url: *urls)
+            {
+                (void)Uri::Iri::ToUri(url, uri);
+            }
+            const auto seconds = timer.ElapsedSeconds();
+            reporter.ReportThroughput("to_uri" + suffix, urls->size(), seconds);
+            reporter.Report("to_uri_bytes_per_second" + suffix, total_bytes / seconds, "B/s");
+        }
+        {
+            Benchmark::Timer timer;
+            for (const auto& url: *urls)
+            {
+                Uri::Uri iri;
+                (void)iri.ParseFromIriString(url);
+            }
+            reporter.ReportThroughput("parse_iri" + suffix, urls->size(), timer.ElapsedSeconds());
+        }
+    }
+}
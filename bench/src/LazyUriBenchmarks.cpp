@@ -0,0 +1,62 @@
+#include "Benchmark.hpp"
+#include <string>
+#include <Uri/LazyUri.hpp>
+#include <Uri/Uri.hpp>
+#include <vector>
+
+namespace
+{
+    const size_t URL_COUNT = 200000;
+}
+
+BENCHMARK(LazyUri)
+{
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    size_t eager_checksum = 0;
+    {
+        // What the routing layer reads: the host and the first segment.
+        Uri::Uri uri;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            (void)uri.ParseFromString(url);
+            eager_checksum += uri.GetHost().length();
+            const auto path = uri.GetPath();
+            if (path.size() > 1)
+            {
+                eager_checksum += path[1].length();
+            }
+        }
+        reporter.ReportThroughput("eager_parse_host_segment", urls.size(), timer.ElapsedSeconds());
+    }
+    size_t lazy_checksum = 0;
+    {
+        Uri::LazyUri uri;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            (void)uri.ParseFromString(url);
+            lazy_checksum += uri.GetHost().length();
+            const auto& path = uri.GetPath();
+            if (path.size() > 1)
+            {
+                lazy_checksum += path[1].length();
+            }
+        }
+        reporter.ReportThroughput("lazy_parse_host_segment", urls.size(), timer.ElapsedSeconds());
+    }
+    reporter.Report("checksums_match", (eager_checksum == lazy_checksum) ? 1 : 0, "");
+    {
+        Uri::LazyUri uri;
+        size_t checksum = 0;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            (void)uri.ParseFromString(url);
+            checksum += uri.GetScheme().length() + uri.GetUserInfo().length() + uri.GetHost().length()
+                + uri.GetPath().size() + uri.GetQuery().length() + uri.GetFragment().length();
+        }
+        reporter.ReportThroughput("lazy_parse_all_components", urls.size(), timer.ElapsedSeconds());
+        reporter.Report("checksum", (double)(checksum % 1000), "");
+    }
+}
@@ -0,0 +1,74 @@
+#include "Benchmark.hpp"
+#include <string>
+#include <Uri/ResolvedBase.hpp>
+#include <Uri/Uri.hpp>
+#include <vector>
+
+namespace
+{
+    const size_t NUM_LINKS = 100000;
+}
+
+BENCHMARK(MakeRelative)
+{
+    // Links found on one page: mostly the same host, some elsewhere.
+    Uri::Uri page;
+    (void)page.ParseFromString("https://www.host1.example.com/section/articles/2024/page.html?id=7");
+    std::vector< Uri::Uri > links(NUM_LINKS);
+    size_t absolute_length = 0;
+    for (size_t i = 0; i < NUM_LINKS; ++i)
+    {
+        std::string link;
+        switch (i % 4)
+        {
+            case 0:
+            {
+                link = "https://www.host1.example.com/section/articles/2024/other" + std::to_string(i) + ".html";
+            } break;
+
+            case 1:
+            {
+                link = "https://www.host1.example.com/section/images/" + std::to_string(i) + ".png";
+            } break;
+
+            case 2:
+            {
+                link = "https://www.host1.example.com/section/articles/2024/page.html?id=" + std::to_string(i);
+            } break;
+
+            default:
+            {
+                link = "https://cdn" + std::to_string(i % 10) + ".example.net/lib.js";
+            } break;
+        }
+        absolute_length += link.length();
+        (void)links[i].ParseFromString(link);
+    }
+    {
+        Benchmark::Timer timer;
+        for (const auto& link: links)
+        {
+            (void)page.MakeRelative(link);
+        }
+        reporter.ReportThroughput("make_relative", links.size(), timer.ElapsedSeconds());
+    }
+    const Uri::ResolvedBase base(page);
+    {
+        std::vector< Uri::Uri > relative_refs;
+        Benchmark::Timer timer;
+        base.MakeRelativeAll(links, relative_refs);
+        reporter.ReportThroughput("make_relative_all", links.size(), timer.ElapsedSeconds());
+    }
+    std::vector< std::string > relative_strings;
+    {
+        Benchmark::Timer timer;
+        base.MakeRelativeAll(links, relative_strings);
+        reporter.ReportThroughput("make_relative_all_strings", links.size(), timer.ElapsedSeconds());
+    }
+    size_t relative_length = 0;
+    for (const auto& relative_string: relative_strings)
+    {
+        relative_length += relative_string.length();
+    }
+    reporter.Report("size_ratio", (double)relative_length / (double)absolute_length, "");
+}
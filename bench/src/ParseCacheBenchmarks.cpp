@@ -0,0 +1,58 @@
+#include "Benchmark.hpp"
+#include <Uri/ParseCache.hpp>
+#include <Uri/Uri.hpp>
+#include <thread>
+
+namespace
+{
+    const size_t REQUEST_COUNT = 400000;
+    const size_t HOT_URL_COUNT = 500;
+    const size_t NUM_THREADS = 4;
+}
+
+BENCHMARK(ParseCacheHotSet)
+{
+    const auto urls = Benchmark::MakeUrls(REQUEST_COUNT, HOT_URL_COUNT);
+    {
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            Uri::Uri uri;
+            (void)uri.ParseFromString(url);
+        }
+        reporter.ReportThroughput("parse_from_string", urls.size(), timer.ElapsedSeconds());
+    }
+    Uri::ParseCache cache;
+    {
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            (void)cache.Parse(url);
+        }
+        reporter.ReportThroughput("cache_parse", urls.size(), timer.ElapsedSeconds());
+    }
+    {
+        std::vector< std::thread > workers;
+        Benchmark::Timer timer;
+        for (size_t worker = 0; worker < NUM_THREADS; ++worker)
+        {
+            workers.emplace_back(
+                [&cache, &urls]
+                {
+                    for (const auto& url: urls)
+                    {
+                        (void)cache.Parse(url);
+                    }
+                }
+            );
+        }
+        for (auto& worker: workers)
+        {
+            worker.join();
+        }
+        reporter.ReportThroughput("cache_parse_4_threads", NUM_THREADS * urls.size(), timer.ElapsedSeconds());
+    }
+    const auto statistics = cache.GetStatistics();
+    reporter.Report("hit_rate", 100.0 * statistics.hits / (statistics.hits + statistics.misses), "%");
+    reporter.Report("memory", (double)statistics.memory_usage, "bytes");
+}
@@ -0,0 +1,39 @@
+#include "Benchmark.hpp"
+#include <Uri/ParseInstrumentation.hpp>
+#include <Uri/Uri.hpp>
+
+namespace
+{
+    const size_t URL_COUNT = 100000;
+}
+
+BENCHMARK(ParseInstrumentation)
+{
+    typedef Uri::ParseInstrumentation Instrumentation;
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    reporter.Report("compiled_in", Instrumentation::IsCompiledIn() ? 1 : 0, "");
+    for (const uint32_t interval: {1u, 64u})
+    {
+        Instrumentation::SetSampleInterval(interval);
+        Instrumentation::ResetThread();
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            Uri::Uri uri;
+            (void)uri.ParseFromString(url);
+        }
+        const auto seconds = timer.ElapsedSeconds();
+        reporter.ReportThroughput("parse_sample_every_" + std::to_string(interval), urls.size(), seconds);
+        const auto snapshot = Instrumentation::GetThreadSnapshot();
+        const auto& parse = snapshot[Instrumentation::Stage::PARSE];
+        if (parse.timed_calls > 0)
+        {
+            reporter.Report(
+                "mean_parse_ticks_sample_every_" + std::to_string(interval),
+                (double)parse.ticks / parse.timed_calls,
+                "ticks"
+            );
+        }
+    }
+    Instrumentation::SetSampleInterval(1);
+}
@@ -0,0 +1,66 @@
+#include "Benchmark.hpp"
+#include <regex>
+#include <string>
+#include <Uri/PathRouter.hpp>
+#include <Uri/Uri.hpp>
+#include <vector>
+
+namespace
+{
+    const size_t NUM_ROUTES = 5000;
+    const size_t NUM_PATHS = 100000;
+    const size_t NUM_REGEX_PATHS = 100;
+}
+
+BENCHMARK(PathRouter)
+{
+    // What services did before: a regular expression per route, tried in
+    // turn.
+    Uri::PathRouter router;
+    std::vector< std::regex > expressions;
+    for (size_t i = 0; i < NUM_ROUTES; ++i)
+    {
+        const auto service = "/v1/service" + std::to_string(i);
+        (void)router.AddRoute(service + "/users/{id}/orders/{orderId}");
+        expressions.emplace_back(service + "/users/([^/]+)/orders/([^/]+)");
+    }
+
+    std::vector< Uri::Uri > uris(NUM_PATHS);
+    for (size_t i = 0; i < NUM_PATHS; ++i)
+    {
+        (void)uris[i].ParseFromString(
+            "https://api.example.com/v1/service" + std::to_string((i * 7919) % NUM_ROUTES)
+            + "/users/" + std::to_string(i) + "/orders/" + std::to_string(i % 97)
+        );
+    }
+    size_t num_found = 0;
+    {
+        Uri::PathRouter::Match match;
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            num_found += router.Find(uri, match) ? 1 : 0;
+        }
+        reporter.ReportThroughput("route_trie", uris.size(), timer.ElapsedSeconds());
+    }
+    reporter.Report("found", (double)num_found, "");
+    {
+        size_t num_regex_found = 0;
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < NUM_REGEX_PATHS; ++i)
+        {
+            const auto path = uris[i].GenerateString().substr(sizeof("https://api.example.com") - 1);
+            for (const auto& expression: expressions)
+            {
+                std::smatch match;
+                if (std::regex_match(path, match, expression))
+                {
+                    ++num_regex_found;
+                    break;
+                }
+            }
+        }
+        reporter.ReportThroughput("route_regex", NUM_REGEX_PATHS, timer.ElapsedSeconds());
+        reporter.Report("regex_found", (double)num_regex_found, "");
+    }
+}
@@ -0,0 +1,87 @@
+#include "Benchmark.hpp"
+#include <Uri/PublicSuffixList.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    const size_t URL_COUNT = 100000;
+    const size_t NUM_SUFFIXES = 8000;
+
+    // What callers did before: try every label split against a set of
+    // suffixes, longest first.
+    std::string_view NaiveRegistrableDomain(
+        const std::unordered_set< std::string >& suffixes,
+        std::string_view host
+    )
+    {
+        std::string_view previous;
+        for (size_t start = 0;;)
+        {
+            const auto candidate = host.substr(start);
+            if (suffixes.count(std::string(candidate)) != 0)
+            {
+                return previous;
+            }
+            const auto dot = host.find('.', start);
+            if (dot == std::string_view::npos)
+            {
+                return previous;
+            }
+            previous = candidate;
+            start = dot + 1;
+        }
+    }
+}
+
+BENCHMARK(PublicSuffixList)
+{
+    std::string list;
+    std::unordered_set< std::string > suffixes;
+    for (const auto* tld: {"com", "org", "net", "uk", "io"})
+    {
+        list += std::string(tld) + "\n";
+        suffixes.insert(tld);
+        for (size_t i = 0; i < NUM_SUFFIXES / 5; ++i)
+        {
+            const auto suffix = "sub" + std::to_string(i) + "." + tld;
+            list += suffix + "\n";
+            suffixes.insert(suffix);
+        }
+    }
+    Uri::PublicSuffixList public_suffix_list;
+    {
+        Benchmark::Timer timer;
+        (void)public_suffix_list.Build(list);
+        reporter.Report("build_seconds", timer.ElapsedSeconds(), "s");
+    }
+    reporter.Report("memory_usage", (double)public_suffix_list.MemoryUsage(), "B");
+
+    std::vector< Uri::Uri > uris;
+    for (const auto& url: Benchmark::MakeUrls(URL_COUNT, 0))
+    {
+        uris.emplace_back();
+        (void)uris.back().ParseFromString(url);
+    }
+    size_t total_length = 0;
+    {
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            total_length += uri.GetRegistrableDomain(public_suffix_list).length();
+        }
+        reporter.ReportThroughput("registrable_domain_trie", uris.size(), timer.ElapsedSeconds());
+    }
+    {
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            total_length -= NaiveRegistrableDomain(suffixes, uri.GetHostView()).length();
+        }
+        reporter.ReportThroughput("registrable_domain_hash_set", uris.size(), timer.ElapsedSeconds());
+    }
+    reporter.Report("results_differ", (total_length == 0) ? 0 : 1, "");
+}
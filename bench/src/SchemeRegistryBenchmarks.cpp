@@ -0,0 +1,62 @@
+#include "Benchmark.hpp"
+#include <Uri/SchemeRegistry.hpp>
+#include <Uri/Uri.hpp>
+
+namespace
+{
+    const size_t URL_COUNT = 100000;
+}
+
+BENCHMARK(SchemePolicies)
+{
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    std::vector< Uri::Uri > uris(urls.size());
+    {
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < urls.size(); ++i)
+        {
+            (void)uris[i].ParseFromString(urls[i]);
+        }
+        reporter.ReportThroughput("parse", urls.size(), timer.ElapsedSeconds());
+    }
+    {
+        size_t num_found = 0;
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            num_found += (Uri::SchemeRegistry::Find(uri.GetSchemeView()) != nullptr);
+        }
+        reporter.ReportThroughput("find_policy", uris.size(), timer.ElapsedSeconds());
+        reporter.Report("registered_fraction", (double)num_found / uris.size(), "");
+    }
+    {
+        size_t num_http = 0;
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            num_http += (uri.GetSchemeId() == Uri::HttpScheme::ID);
+        }
+        reporter.ReportThroughput("compare_scheme_id", uris.size(), timer.ElapsedSeconds());
+        reporter.Report("http_fraction", (double)num_http / uris.size(), "");
+    }
+    {
+        const char* const schemes[] = {"http", "HTTPS", "Mailto", "gopher", "urn", "svn+ssh"};
+        const size_t num_lookups = 1000000;
+        size_t num_registered = 0;
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < num_lookups; ++i)
+        {
+            num_registered += (Uri::SchemeRegistry::FindId(schemes[i % 6]) != Uri::SchemeRegistry::UNREGISTERED_SCHEME);
+        }
+        reporter.ReportThroughput("find_id", num_lookups, timer.ElapsedSeconds());
+        reporter.Report("find_id_registered_fraction", (double)num_registered / num_lookups, "");
+    }
+    {
+        Benchmark::Timer timer;
+        for (auto& uri: uris)
+        {
+            uri.Normalize();
+        }
+        reporter.ReportThroughput("normalize", uris.size(), timer.ElapsedSeconds());
+    }
+}
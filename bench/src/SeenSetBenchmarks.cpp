@@ -0,0 +1,67 @@
+#include "Benchmark.hpp"
+#include <Uri/SeenSet.hpp>
+#include <Uri/Uri.hpp>
+#include <unordered_set>
+
+namespace
+{
+    const size_t URL_COUNT = 1000000;
+    const size_t DISTINCT_URL_COUNT = 600000;
+
+    void RunSeenSet(Benchmark::Reporter& reporter, Uri::SeenSet::FingerprintBits bits)
+    {
+        const auto urls = Benchmark::MakeUrls(URL_COUNT, DISTINCT_URL_COUNT);
+        {
+            Uri::SeenSet seen_set(0, bits);
+            Benchmark::Timer timer;
+            for (const auto& url: urls)
+            {
+                (void)seen_set.Insert(url);
+            }
+            reporter.ReportThroughput("insert", urls.size(), timer.ElapsedSeconds());
+        }
+        Uri::SeenSet seen_set(0, bits);
+        std::vector< Uri::SeenSet::InsertResult > results;
+        Benchmark::Timer timer;
+        const auto inserted = seen_set.InsertAll(urls, results);
+        reporter.ReportThroughput("insert_all", urls.size(), timer.ElapsedSeconds());
+        reporter.Report("distinct", (double)inserted, "uris");
+        reporter.Report("memory", (double)seen_set.MemoryUsage(), "bytes");
+        reporter.Report("memory_per_uri", (double)seen_set.MemoryUsage() / seen_set.Size(), "bytes");
+    }
+}
+
+BENCHMARK(SeenSet64)
+{
+    RunSeenSet(reporter, Uri::SeenSet::FingerprintBits::BITS_64);
+}
+
+BENCHMARK(SeenSet128)
+{
+    RunSeenSet(reporter, Uri::SeenSet::FingerprintBits::BITS_128);
+}
+
+BENCHMARK(UnorderedSetOfNormalizedStrings)
+{
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, DISTINCT_URL_COUNT);
+    std::unordered_set< std::string > seen;
+    size_t string_bytes = 0;
+    Benchmark::Timer timer;
+    for (const auto& url: urls)
+    {
+        Uri::Uri uri;
+        if (uri.ParseFromString(url))
+        {
+            uri.NormalizePath();
+            const auto inserted = seen.insert(uri.GenerateString());
+            if (inserted.second)
+            {
+                string_bytes += sizeof(std::string) + inserted.first->capacity() + 1 + 2 * sizeof(void*);
+            }
+        }
+    }
+    reporter.ReportThroughput("insert", urls.size(), timer.ElapsedSeconds());
+    const auto memory = string_bytes + seen.bucket_count() * sizeof(void*);
+    reporter.Report("memory_estimate", (double)memory, "bytes");
+    reporter.Report("memory_per_uri", (double)memory / seen.size(), "bytes");
+}
@@ -0,0 +1,34 @@
+#include "Benchmark.hpp"
+#include <Uri/Uri.hpp>
+
+namespace
+{
+    const size_t URL_COUNT = 100000;
+}
+
+BENCHMARK(UriCopyAndResolve)
+{
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    std::vector< Uri::Uri > uris(urls.size());
+    for (size_t i = 0; i < urls.size(); ++i)
+    {
+        (void)uris[i].ParseFromString(urls[i]);
+    }
+    {
+        Benchmark::Timer timer;
+        std::vector< Uri::Uri > copies(uris);
+        reporter.ReportThroughput("copy", copies.size(), timer.ElapsedSeconds());
+    }
+    Uri::Uri reference;
+    (void)reference.ParseFromString("?page=2");
+    {
+        size_t total_length = 0;
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            total_length += uri.Resolve(reference).GetHost().length();
+        }
+        reporter.ReportThroughput("resolve_query_only", uris.size(), timer.ElapsedSeconds());
+        reporter.Report("average_host_length", (double)total_length / uris.size(), "characters");
+    }
+}
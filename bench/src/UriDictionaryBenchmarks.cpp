@@ -0,0 +1,57 @@
+#include "Benchmark.hpp"
+#include <Uri/UriDictionary.hpp>
+
+namespace
+{
+    const size_t URL_COUNT = 200000;
+}
+
+BENCHMARK(UriDictionary)
+{
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    size_t string_bytes = 0;
+    for (const auto& url: urls)
+    {
+        string_bytes += url.length();
+    }
+    Uri::UriDictionary dictionary;
+    {
+        Benchmark::Timer timer;
+        (void)dictionary.Build(urls);
+        reporter.ReportThroughput("build", urls.size(), timer.ElapsedSeconds());
+    }
+    reporter.Report("memory_per_uri", (double)dictionary.MemoryUsage() / dictionary.Size(), "bytes");
+    reporter.Report("raw_string_bytes_per_uri", (double)string_bytes / urls.size(), "bytes");
+    {
+        size_t found = 0;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            size_t id;
+            if (dictionary.Find(url, id))
+            {
+                ++found;
+            }
+        }
+        reporter.ReportThroughput("find", urls.size(), timer.ElapsedSeconds());
+        reporter.Report("found", (double)found, "uris");
+    }
+    {
+        std::string uri_string;
+        Benchmark::Timer timer;
+        for (size_t id = 0; id < dictionary.Size(); ++id)
+        {
+            (void)dictionary.GetString(id, uri_string);
+        }
+        reporter.ReportThroughput("get_string", dictionary.Size(), timer.ElapsedSeconds());
+    }
+    {
+        Uri::Uri uri;
+        Benchmark::Timer timer;
+        for (size_t id = 0; id < dictionary.Size(); ++id)
+        {
+            (void)dictionary.GetUri(id, uri);
+        }
+        reporter.ReportThroughput("get_uri", dictionary.Size(), timer.ElapsedSeconds());
+    }
+}
@@ -0,0 +1,131 @@
+#include "Benchmark.hpp"
+#include <Uri/Uri.hpp>
+#include <Uri/UriMatcher.hpp>
+#include <Uri/UriView.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const size_t URL_COUNT = 100000;
+    const size_t NUM_RULES = 200000;
+    const size_t NUM_SCANNED_URLS = 200;
+
+    // What callers did before: check every rule, keeping the most specific
+    // one that matches.
+    size_t LinearFindRule(const std::vector< Uri::UriMatcher::Rule >& rules, const Uri::Uri& uri)
+    {
+        const auto host = uri.GetHostView();
+        size_t best = Uri::UriMatcher::NO_RULE;
+        size_t best_host_length = 0;
+        for (size_t i = 0; i < rules.size(); ++i)
+        {
+            const auto& rule = rules[i];
+            std::string_view pattern(rule.host);
+            const bool subdomains = (pattern.substr(0, 2) == "*.");
+            if (subdomains)
+            {
+                pattern.remove_prefix(1);
+                if ((host.length() <= pattern.length())
+                    || (host.substr(host.length() - pattern.length()) != pattern))
+                {
+                    continue;
+                }
+            }
+            else if (host != pattern)
+            {
+                continue;
+            }
+            const auto host_length = pattern.length() + (subdomains ? 0 : 1);
+            if ((best == Uri::UriMatcher::NO_RULE) || (host_length > best_host_length))
+            {
+                best = i;
+                best_host_length = host_length;
+            }
+        }
+        return best;
+    }
+}
+
+BENCHMARK(UriMatcher)
+{
+    std::vector< Uri::UriMatcher::Rule > rules(NUM_RULES);
+    for (size_t i = 0; i < NUM_RULES; ++i)
+    {
+        auto& rule = rules[i];
+        switch (i % 4)
+        {
+            case 0:
+            {
+                rule.host = "www.host" + std::to_string(i) + ".example.com";
+            } break;
+
+            case 1:
+            {
+                rule.host = "*.host" + std::to_string(i) + ".example.com";
+            } break;
+
+            case 2:
+            {
+                rule.host = "www.host" + std::to_string(i) + ".example.com";
+                rule.path_prefix = {"path" + std::to_string(i % 10)};
+            } break;
+
+            default:
+            {
+                rule.scheme = "https";
+                rule.host = "tracker" + std::to_string(i) + ".example.net";
+            } break;
+        }
+        rule.action = (((i / 4) % 2) == 0) ? Uri::UriMatcher::Action::ALLOW : Uri::UriMatcher::Action::DENY;
+    }
+    Uri::UriMatcher matcher;
+    {
+        Benchmark::Timer timer;
+        (void)matcher.Build(rules);
+        reporter.Report("build_seconds", timer.ElapsedSeconds(), "s");
+    }
+
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    std::vector< Uri::Uri > uris(urls.size());
+    std::vector< Uri::UriView > views(urls.size());
+    for (size_t i = 0; i < urls.size(); ++i)
+    {
+        (void)uris[i].ParseFromString(urls[i]);
+        (void)views[i].ParseFromString(urls[i]);
+    }
+    size_t num_allowed = 0;
+    {
+        Benchmark::Timer timer;
+        for (const auto& uri: uris)
+        {
+            num_allowed += (matcher.Match(uri) == Uri::UriMatcher::Action::ALLOW) ? 1 : 0;
+        }
+        reporter.ReportThroughput("match_uri", uris.size(), timer.ElapsedSeconds());
+    }
+    {
+        Benchmark::Timer timer;
+        for (const auto& view: views)
+        {
+            num_allowed += (matcher.Match(view) == Uri::UriMatcher::Action::ALLOW) ? 1 : 0;
+        }
+        reporter.ReportThroughput("match_view", views.size(), timer.ElapsedSeconds());
+    }
+    {
+        std::vector< Uri::UriMatcher::Action > actions;
+        Benchmark::Timer timer;
+        matcher.Match(uris, actions);
+        reporter.ReportThroughput("match_batch", uris.size(), timer.ElapsedSeconds());
+    }
+    reporter.Report("allowed", (double)num_allowed, "");
+    {
+        size_t num_found = 0;
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < NUM_SCANNED_URLS; ++i)
+        {
+            num_found += (LinearFindRule(rules, uris[i]) == Uri::UriMatcher::NO_RULE) ? 0 : 1;
+        }
+        reporter.ReportThroughput("match_linear_scan", NUM_SCANNED_URLS, timer.ElapsedSeconds());
+        reporter.Report("linear_scan_found", (double)num_found, "");
+    }
+}
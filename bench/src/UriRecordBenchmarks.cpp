@@ -0,0 +1,54 @@
+#include "Benchmark.hpp"
+#include <Uri/Uri.hpp>
+#include <Uri/UriRecord.hpp>
+
+namespace
+{
+    const size_t URL_COUNT = 200000;
+}
+
+BENCHMARK(UriRecord)
+{
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    std::vector< Uri::Uri > uris(urls.size());
+    {
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < urls.size(); ++i)
+        {
+            (void)uris[i].ParseFromString(urls[i]);
+        }
+        reporter.ReportThroughput("parse_from_string", urls.size(), timer.ElapsedSeconds());
+    }
+    std::vector< uint8_t > buffer;
+    {
+        Benchmark::Timer timer;
+        Uri::UriRecord::AppendAll(uris, buffer);
+        reporter.ReportThroughput("append_all", uris.size(), timer.ElapsedSeconds());
+    }
+    reporter.Report("bytes_per_uri", (double)buffer.size() / uris.size(), "bytes");
+    {
+        size_t count, offset;
+        (void)Uri::UriRecord::ReadArrayHeader(buffer.data(), buffer.size(), count, offset);
+        Uri::UriRecord record;
+        size_t total_host_length = 0;
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t consumed;
+            if (!record.Attach(buffer.data() + offset, buffer.size() - offset, consumed))
+            {
+                break;
+            }
+            total_host_length += record.GetHost().length();
+            offset += consumed;
+        }
+        reporter.ReportThroughput("attach", count, timer.ElapsedSeconds());
+        reporter.Report("average_host_length", (double)total_host_length / count, "characters");
+    }
+    {
+        std::vector< Uri::Uri > read;
+        Benchmark::Timer timer;
+        (void)Uri::UriRecord::ReadAll(buffer.data(), buffer.size(), read);
+        reporter.ReportThroughput("read_all", read.size(), timer.ElapsedSeconds());
+    }
+}
@@ -0,0 +1,82 @@
+#include "Benchmark.hpp"
+#include <string>
+#include <Uri/Uri.hpp>
+#include <Uri/UriScanner.hpp>
+#include <Uri/UriView.hpp>
+#include <vector>
+
+namespace
+{
+    const size_t URL_COUNT = 200000;
+    const size_t CHUNK_SIZE = 16;
+}
+
+BENCHMARK(UriScanner)
+{
+    const auto urls = Benchmark::MakeUrls(URL_COUNT, 0);
+    size_t total_length = 0;
+    for (const auto& url: urls)
+    {
+        total_length += url.length();
+    }
+
+    // Validating and finding the components only.
+    {
+        size_t accepted = 0;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            Uri::UriView view;
+            accepted += view.ParseFromString(url) ? 1 : 0;
+        }
+        reporter.ReportThroughput("uri_view_scan_bytes", total_length, timer.ElapsedSeconds());
+        reporter.Report("uri_view_accepted", (double)accepted, "");
+    }
+    {
+        size_t accepted = 0;
+        Uri::UriScanner::Layout layout;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            accepted += Uri::UriScanner::Scan(url, &layout) ? 1 : 0;
+        }
+        reporter.ReportThroughput("dfa_scan_bytes", total_length, timer.ElapsedSeconds());
+        reporter.Report("dfa_accepted", (double)accepted, "");
+    }
+    {
+        size_t accepted = 0;
+        Uri::UriScanner scanner;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            scanner.Reset();
+            for (size_t i = 0; i < url.length(); i += CHUNK_SIZE)
+            {
+                scanner.Feed(std::string_view(url).substr(i, CHUNK_SIZE));
+            }
+            accepted += scanner.Finish() ? 1 : 0;
+        }
+        reporter.ReportThroughput("dfa_streaming_scan_bytes", total_length, timer.ElapsedSeconds());
+        reporter.Report("dfa_streaming_accepted", (double)accepted, "");
+    }
+
+    // Full parses, decoding included.
+    {
+        Uri::Uri uri;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            (void)uri.ParseFromString(url);
+        }
+        reporter.ReportThroughput("uri_parse", urls.size(), timer.ElapsedSeconds());
+    }
+    {
+        Uri::Uri uri;
+        Benchmark::Timer timer;
+        for (const auto& url: urls)
+        {
+            (void)Uri::UriScanner::Parse(url, uri);
+        }
+        reporter.ReportThroughput("dfa_parse", urls.size(), timer.ElapsedSeconds());
+    }
+}
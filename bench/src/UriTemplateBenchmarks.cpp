@@ -0,0 +1,73 @@
+#include "Benchmark.hpp"
+#include <ctype.h>
+#include <string>
+#include <Uri/UriTemplate.hpp>
+#include <vector>
+
+namespace
+{
+    const size_t NUM_EXPANSIONS = 1000000;
+
+    // What callers did before: concatenation and a hand-rolled encoder.
+    void AppendEncoded(std::string& buffer, const std::string& value)
+    {
+        static const char HEX[] = "0123456789ABCDEF";
+        for (const auto c: value)
+        {
+            if (isalnum((unsigned char)c) || (c == '-') || (c == '.') || (c == '_') || (c == '~'))
+            {
+                buffer += c;
+            }
+            else
+            {
+                buffer += '%';
+                buffer += HEX[(unsigned char)c >> 4];
+                buffer += HEX[(unsigned char)c & 0x0F];
+            }
+        }
+    }
+}
+
+BENCHMARK(UriTemplate)
+{
+    std::vector< std::string > queries;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        queries.push_back("search terms " + std::to_string(i) + " & more");
+    }
+    const std::string host = "www.example.com";
+    const std::string lang = "en";
+
+    Uri::UriTemplate uri_template;
+    (void)uri_template.Parse("https://{host}/search{?q,lang,page}");
+    size_t total_length = 0;
+    {
+        std::vector< Uri::UriTemplate::Value > values(4);
+        values[0] = std::string_view(host);
+        values[2] = std::string_view(lang);
+        std::string page;
+        std::string expansion;
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < NUM_EXPANSIONS; ++i)
+        {
+            page = std::to_string(i % 50);
+            values[1] = std::string_view(queries[i % queries.size()]);
+            values[3] = std::string_view(page);
+            uri_template.Expand(values, expansion);
+            total_length += expansion.length();
+        }
+        reporter.ReportThroughput("expand_template", NUM_EXPANSIONS, timer.ElapsedSeconds());
+    }
+    {
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < NUM_EXPANSIONS; ++i)
+        {
+            std::string expansion = "https://" + host + "/search?q=";
+            AppendEncoded(expansion, queries[i % queries.size()]);
+            expansion += "&lang=" + lang + "&page=" + std::to_string(i % 50);
+            total_length -= expansion.length();
+        }
+        reporter.ReportThroughput("expand_concatenation", NUM_EXPANSIONS, timer.ElapsedSeconds());
+    }
+    reporter.Report("results_differ", (total_length == 0) ? 0 : 1, "");
+}
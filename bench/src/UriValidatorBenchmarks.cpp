@@ -0,0 +1,53 @@
+#include "Benchmark.hpp"
+#include <Uri/Uri.hpp>
+#include <Uri/UriValidator.hpp>
+
+namespace
+{
+    const size_t URL_COUNT = 100000;
+}
+
+BENCHMARK(UriValidator)
+{
+    auto valid = Benchmark::MakeUrls(URL_COUNT, 0);
+    auto invalid = valid;
+    for (auto& url: invalid)
+    {
+        url[url.length() * 3 / 4] = ' ';
+    }
+    // Long components, such as tracking queries, where character classes
+    // are checked sixteen at a time.
+    auto long_valid = valid;
+    for (auto& url: long_valid)
+    {
+        url += "&utm_source=newsletter-2024-spring&utm_campaign=Product.Launch_Q2";
+        url += "&session=0123456789abcdefABCDEF0123456789abcdefABCDEF0123456789abcdef";
+    }
+    for (const auto* urls: {&valid, &invalid, &long_valid})
+    {
+        const std::string suffix = (
+            (urls == &valid) ? "_valid"
+            : (urls == &invalid) ? "_invalid"
+            : "_long_valid"
+        );
+        size_t num_valid = 0;
+        {
+            Benchmark::Timer timer;
+            for (const auto& url: *urls)
+            {
+                Uri::Uri uri;
+                num_valid += uri.ParseFromString(url);
+            }
+            reporter.ReportThroughput("parse" + suffix, urls->size(), timer.ElapsedSeconds());
+        }
+        {
+            Benchmark::Timer timer;
+            for (const auto& url: *urls)
+            {
+                num_valid += Uri::UriValidator::IsValid(url);
+            }
+            reporter.ReportThroughput("is_valid" + suffix, urls->size(), timer.ElapsedSeconds());
+        }
+        reporter.Report("accepted" + suffix, (double)num_valid / (2 * urls->size()), "");
+    }
+}
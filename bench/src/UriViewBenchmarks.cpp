@@ -0,0 +1,50 @@
+#include "Benchmark.hpp"
+#include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
+
+using namespace Uri::Literals;
+
+namespace
+{
+    const size_t ITERATIONS = 100000;
+
+    constexpr Uri::UriView ENDPOINTS[] = {
+        "https://api.internal:8443/v1/users?limit=100"_uri,
+        "https://auth.internal/oauth2/token"_uri,
+        "http://metrics.internal:9090/api/v1/query"_uri,
+        "https://storage.internal/buckets/logs/objects"_uri,
+    };
+
+    const char* const ENDPOINT_STRINGS[] = {
+        "https://api.internal:8443/v1/users?limit=100",
+        "https://auth.internal/oauth2/token",
+        "http://metrics.internal:9090/api/v1/query",
+        "https://storage.internal/buckets/logs/objects",
+    };
+}
+
+BENCHMARK(UriViewLiterals)
+{
+    const size_t num_endpoints = sizeof(ENDPOINTS) / sizeof(ENDPOINTS[0]);
+    size_t total_length = 0;
+    {
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < ITERATIONS; ++i)
+        {
+            Uri::Uri uri;
+            (void)uri.ParseFromString(ENDPOINT_STRINGS[i % num_endpoints]);
+            total_length += uri.GetHostView().length();
+        }
+        reporter.ReportThroughput("parse_from_string", ITERATIONS, timer.ElapsedSeconds());
+    }
+    {
+        Benchmark::Timer timer;
+        for (size_t i = 0; i < ITERATIONS; ++i)
+        {
+            const Uri::Uri uri(ENDPOINTS[i % num_endpoints]);
+            total_length += uri.GetHostView().length();
+        }
+        reporter.ReportThroughput("from_literal", ITERATIONS, timer.ElapsedSeconds());
+    }
+    reporter.Report("average_host_length", (double)total_length / (2 * ITERATIONS), "characters");
+}
@@ -0,0 +1,63 @@
+#ifndef URI_BATCH_SERIALIZER_HPP
+#define URI_BATCH_SERIALIZER_HPP
+
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/uio.h>
+#endif
+
+namespace Uri
+{
+    class Uri;
+
+    // Serializes many URIs at once, each as GenerateString would and each
+    // followed by a separator, without a string per URI.
+    class BatchSerializer
+    {
+    public:
+        BatchSerializer() = delete;
+
+        // The exact length of GenerateString's result, worked out without
+        // serializing.
+        static size_t SerializedLength(const Uri& uri);
+
+        // Appends count URIs to buffer, which grows at most once, since
+        // the total length is worked out first.  If offsets is given, it
+        // gets count + 1 entries: where each URI starts in buffer, then
+        // where the last separator ends, for GetSlice.
+        static void Serialize(const Uri* uris,
+                              size_t count,
+                              std::string_view separator,
+                              std::string& buffer,
+                              std::vector< size_t >* offsets = nullptr);
+        static void Serialize(const std::vector< Uri >& uris,
+                              std::string_view separator,
+                              std::string& buffer,
+                              std::vector< size_t >* offsets = nullptr);
+
+        // URI index of a buffer Serialize wrote with offsets, without its
+        // separator.
+        static std::string_view GetSlice(std::string_view buffer,
+                                         const std::vector< size_t >& offsets,
+                                         size_t separator_length,
+                                         size_t index);
+
+#if !defined(_WIN32)
+        // Fills the caller's buffers in order, a URI possibly spanning two,
+        // and sets each iov_len to the bytes written to it (0 for those not
+        // reached).  Stops before the first URI and separator that no
+        // longer fit, returning how many were written, so the rest can go
+        // in the next writev.
+        static size_t Serialize(const Uri* uris,
+                                size_t count,
+                                std::string_view separator,
+                                struct iovec* iovecs,
+                                size_t num_iovecs);
+#endif
+    };
+}
+
+#endif
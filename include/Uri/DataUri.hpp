@@ -0,0 +1,97 @@
+#ifndef URI_DATA_URI_HPP
+#define URI_DATA_URI_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <string_view>
+
+namespace Uri
+{
+    // A "data" URI (RFC 2397), "data:[<mediatype>][;base64],<data>",
+    // split without copying or decoding anything.  It only refers to the
+    // characters it was parsed from, which must outlive it.  Unlike
+    // Uri::ParseFromString, the payload is left encoded, however big it
+    // is, for DataUriDecoder to decode a buffer at a time.
+    class DataUri
+    {
+    public:
+        // A ";name=value" after the media type, still percent-encoded.
+        struct Parameter
+        {
+            std::string_view name;
+            std::string_view value;
+        };
+
+        static const size_t MAX_PARAMETERS = 16;
+
+    public:
+        ~DataUri() noexcept;
+        DataUri(const DataUri&);
+        DataUri(DataUri&&) noexcept;
+        DataUri& operator=(const DataUri&);
+        DataUri& operator=(DataUri&&) noexcept;
+
+    public:
+        DataUri();
+
+        // Fails on anything but a "data" URI, on a media type that isn't
+        // "type/subtype", on a parameter without '=', on more than
+        // MAX_PARAMETERS parameters, and on a missing ','.  A fragment
+        // after the payload is dropped.
+        bool ParseFromString(std::string_view uri_string);
+
+        // "text/plain" if the URI gives no media type (RFC 2397 section 2).
+        std::string_view GetMediaType() const;
+
+        size_t GetNumParameters() const;
+        const Parameter& GetParameter(size_t index) const;
+
+        // The value of the first parameter with the given name, matched
+        // without regard to case, or an empty view.
+        std::string_view GetParameter(std::string_view name) const;
+
+        bool IsBase64() const;
+
+        // The payload as it appears in the URI, not yet decoded.
+        std::string_view GetPayload() const;
+
+        // At least as many bytes as the payload decodes to.
+        size_t GetMaxDecodedLength() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+
+    // Decodes the payload of a DataUri into caller buffers, a buffer at a
+    // time, so memory use doesn't grow with the payload.  Base64 follows
+    // RFC 4648 with padding optional; otherwise the payload is percent-
+    // decoded.  The DataUri's characters must outlive the decoder.
+    class DataUriDecoder
+    {
+    public:
+        ~DataUriDecoder() noexcept;
+        DataUriDecoder(const DataUriDecoder&);
+        DataUriDecoder(DataUriDecoder&&) noexcept;
+        DataUriDecoder& operator=(const DataUriDecoder&);
+        DataUriDecoder& operator=(DataUriDecoder&&) noexcept;
+
+    public:
+        explicit DataUriDecoder(const DataUri& data_uri);
+
+        // Fills buffer with up to capacity more bytes of the payload,
+        // setting written to how many.  Fails, for good, on a character
+        // outside the base64 alphabet, misplaced padding, or a '%' not
+        // followed by two hex digits; the bytes before it are written.
+        bool Read(char* buffer, size_t capacity, size_t& written);
+
+        // Whether the whole payload has been read.
+        bool Done() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef URI_FORM_CODEC_HPP
+#define URI_FORM_CODEC_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Uri
+{
+    // One name=value pair of application/x-www-form-urlencoded text, as
+    // in POST bodies and query strings.
+    struct FormPair
+    {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    // Decodes application/x-www-form-urlencoded text as the WHATWG URL
+    // standard does: pairs are separated by '&', empty ones are skipped,
+    // the first '=' splits name from value, '+' is a space, and a '%'
+    // not followed by two hex digits is kept as is.  The text must be
+    // raw, as in UriView::GetQuery, not already percent-decoded.
+    class FormDecoder
+    {
+    public:
+        ~FormDecoder() noexcept;
+        FormDecoder(const FormDecoder&);
+        FormDecoder(FormDecoder&&) noexcept;
+        FormDecoder& operator=(const FormDecoder&);
+        FormDecoder& operator=(FormDecoder&&) noexcept;
+
+    public:
+        FormDecoder();
+
+        // Decodes the pairs completed by the next chunk of a body,
+        // replacing pairs, whose views point into storage.  Storage is
+        // replaced too, reserved once up front, so the views stay valid
+        // until it next changes.  The pair cut off at the end of the
+        // chunk is held back until the next Decode or Finish.
+        void Decode(std::string_view chunk,
+                    std::vector< FormPair >& pairs,
+                    std::string& storage);
+
+        // Decodes the pair held back, if any, and readies the decoder
+        // for another body.
+        void Finish(std::vector< FormPair >& pairs, std::string& storage);
+
+        // Decodes a whole body or query string at once.
+        static void DecodeAll(std::string_view form,
+                              std::vector< FormPair >& pairs,
+                              std::string& storage);
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+
+    // Builds application/x-www-form-urlencoded text, encoding all but
+    // ASCII letters, digits and "*-._", with spaces as '+'.  The encoded
+    // length is kept up to date as pairs are added, so Build allocates
+    // exactly once.
+    class FormBuilder
+    {
+    public:
+        ~FormBuilder() noexcept;
+        FormBuilder(const FormBuilder&);
+        FormBuilder(FormBuilder&&) noexcept;
+        FormBuilder& operator=(const FormBuilder&);
+        FormBuilder& operator=(FormBuilder&&) noexcept;
+
+    public:
+        FormBuilder();
+
+        // Copies the pair, so the views need not outlive the call.
+        void Add(std::string_view name, std::string_view value);
+        size_t Size() const;
+        void Clear();
+
+        // The exact length of what Build returns.
+        size_t EncodedLength() const;
+        std::string Build() const;
+        void AppendTo(std::string& form) const;
+
+        // Encodes pairs without copying them first.
+        static size_t EncodedLength(const std::vector< FormPair >& pairs);
+        static void Encode(const std::vector< FormPair >& pairs, std::string& form);
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef URI_IDNA_HPP
+#define URI_IDNA_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+
+namespace Uri
+{
+    // Conversion of internationalized host names between the UTF-8 form
+    // (as Uri::ParseFromIriString leaves them) and the ASCII form with
+    // "xn--" Punycode labels (RFC 3490, RFC 3492).
+    //
+    // Case folding is ASCII-only: there is no nameprep or other Unicode
+    // mapping, so non-ASCII characters are encoded exactly as given.
+    //
+    // Hosts that are all ASCII with no "xn--" label need no conversion and
+    // skip the cache.  Others are remembered in a bounded cache, safe to
+    // share between threads, since a workload sees few distinct hosts.
+    class Idna
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            size_t entries = 0;
+        };
+
+    public:
+        ~Idna() noexcept;
+        Idna(const Idna&) = delete;
+        Idna(Idna&&) noexcept;
+        Idna& operator=(const Idna&) = delete;
+        Idna& operator=(Idna&&) noexcept;
+
+    public:
+        static const size_t DEFAULT_CACHE_CAPACITY = 4096;
+
+        Idna();
+        explicit Idna(size_t cache_capacity);
+
+        // RFC 3492 on a single label, without the "xn--" prefix.  Encoding
+        // fails on malformed UTF-8, decoding on anything that is not valid
+        // Punycode for a sequence of Unicode scalar values.
+        static bool EncodePunycode(std::string_view label, std::string& encoded);
+        static bool DecodePunycode(std::string_view encoded, std::string& label);
+
+        // Lowercases ASCII and replaces each label with non-ASCII characters
+        // by "xn--" and its Punycode.  The ideographic full stops U+3002,
+        // U+FF0E and U+FF61 separate labels too.  Fails on malformed UTF-8,
+        // on an "xn--" label that doesn't decode, and on a converted label
+        // longer than 63 characters.
+        bool ToAscii(std::string_view host, std::string& ascii_host);
+
+        // Lowercases ASCII and decodes each "xn--" label.  As in RFC 3490,
+        // a label that doesn't decode is kept as it is; only malformed
+        // UTF-8 fails.
+        bool ToUnicode(std::string_view host, std::string& unicode_host);
+
+        void ClearCache();
+        Statistics GetStatistics() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
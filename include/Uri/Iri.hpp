@@ -0,0 +1,32 @@
+#ifndef URI_IRI_HPP
+#define URI_IRI_HPP
+
+#include <string>
+#include <string_view>
+
+namespace Uri
+{
+    // Mapping between IRIs (RFC 3987) and the URIs Uri parses.  An IRI may
+    // hold raw UTF-8 where a URI needs percent-encoding; everything ASCII
+    // is the same in both.
+    class Iri
+    {
+    public:
+        Iri() = delete;
+
+        static bool IsValidUtf8(std::string_view input);
+
+        // RFC 3987 section 3.1: percent-encodes every non-ASCII byte and
+        // copies the rest as it is.  Fails, leaving uri unspecified, if iri
+        // is not well-formed UTF-8.
+        static bool ToUri(std::string_view iri, std::string& uri);
+
+        // RFC 3987 section 3.2: decodes the percent-encoded octets that form
+        // well-formed UTF-8 for non-ASCII characters; everything else,
+        // including encoded ASCII, stays encoded, so ToUri maps the result
+        // back to an equivalent URI.
+        static std::string ToIri(std::string_view uri);
+    };
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef URI_LAZY_URI_HPP
+#define URI_LAZY_URI_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+
+namespace Uri
+{
+    class Uri;
+
+    // A URI whose components are percent-decoded only when first asked
+    // for.  Parsing validates the string and finds where the components
+    // are, as UriView does, keeping the string as it is; each getter then
+    // decodes its component once and keeps the result.  Components with
+    // nothing to decode are views of the string itself.
+    //
+    // The getters return what the same getters of a Uri parsed from the
+    // same string would, as views that stay valid until the LazyUri is
+    // parsed again or destroyed.  Since they fill in the decoded
+    // components, not even they may be called from several threads at
+    // once.
+    class LazyUri
+    {
+    public:
+        ~LazyUri() noexcept;
+        LazyUri(const LazyUri&);
+        LazyUri(LazyUri&&) noexcept;
+        LazyUri& operator=(const LazyUri&);
+        LazyUri& operator=(LazyUri&&) noexcept;
+
+    public:
+        LazyUri();
+
+        // Accepts what UriView::ParseFromString accepts.  On failure, the
+        // LazyUri is left empty.
+        bool ParseFromString(std::string_view uri_string);
+
+        // The string parsed, still percent-encoded.
+        std::string_view GetString() const;
+
+        // In lower case.
+        std::string_view GetScheme() const;
+
+        bool HasAuthority() const;
+        std::string_view GetUserInfo() const;
+
+        // Without the brackets of an IP literal; a name is in lower case.
+        std::string_view GetHost() const;
+        bool HasPort() const;
+        uint16_t GetPort() const;
+
+        const std::vector< std::string_view >& GetPath() const;
+
+        bool HasQuery() const;
+        std::string_view GetQuery() const;
+        bool HasFragment() const;
+        std::string_view GetFragment() const;
+
+        // Decodes everything, as ParseFromString would have.
+        Uri ToUri() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef URI_PARSE_CACHE_HPP
+#define URI_PARSE_CACHE_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <Uri/Uri.hpp>
+
+namespace Uri
+{
+    // A bounded cache from input strings to the Uri ParseFromString makes
+    // of them, safe to share between threads.  Entries are immutable and
+    // handed out as shared handles, so evicting one never invalidates a
+    // handle already returned.
+    class ParseCache
+    {
+    public:
+        typedef std::shared_ptr< const Uri > Handle;
+
+        struct Statistics
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            size_t entries = 0;
+            size_t memory_usage = 0;
+        };
+
+    public:
+        ~ParseCache() noexcept;
+        ParseCache(const ParseCache&) = delete;
+        ParseCache(ParseCache&&) noexcept;
+        ParseCache& operator=(const ParseCache&) = delete;
+        ParseCache& operator=(ParseCache&&) noexcept;
+
+    public:
+        static const size_t DEFAULT_MEMORY_CAP = 64 * 1024 * 1024;
+        static const size_t DEFAULT_NUM_SHARDS = 16;
+
+        ParseCache();
+        explicit ParseCache(size_t memory_cap, size_t num_shards = DEFAULT_NUM_SHARDS);
+
+        // Returns an empty handle if the string is not a valid URI;
+        // failures are not cached.
+        Handle Parse(const std::string&);
+        Handle Find(const std::string&) const;
+
+        void Clear();
+        Statistics GetStatistics() const;
+        size_t GetMemoryCap() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
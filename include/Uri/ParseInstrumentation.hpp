@@ -0,0 +1,90 @@
+#ifndef URI_PARSE_INSTRUMENTATION_HPP
+#define URI_PARSE_INSTRUMENTATION_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace Uri
+{
+    // Per-stage statistics of parsing, serializing and resolving, kept per
+    // thread.  Recording is compiled in only when the library is built with
+    // URI_INSTRUMENTATION defined (the URI_INSTRUMENTATION CMake option);
+    // otherwise every snapshot is all zeros and the stages cost nothing.
+    //
+    // Every call is counted, but only one top-level call in every sample
+    // interval, together with the stages nested in it, is timed.  Ticks are
+    // CPU timestamp counter cycles on x86 and steady_clock ticks elsewhere.
+    //
+    // Compiled in, counting is inline and slows an optimized parse by at
+    // most about 3% when one call in 64 is timed, and by about 15% when
+    // every call is.
+    class ParseInstrumentation
+    {
+    public:
+        enum class Stage
+        {
+            PARSE,
+            PARSE_SCHEME,
+            PARSE_AUTHORITY,
+            VALIDATE_IPV6_ADDRESS,
+            PARSE_PATH,
+            PARSE_QUERY,
+            PARSE_FRAGMENT,
+            GENERATE_STRING,
+            RESOLVE,
+        };
+
+        static const size_t NUM_STAGES = (size_t)Stage::RESOLVE + 1;
+
+        struct StageStatistics
+        {
+            uint64_t calls = 0;
+            uint64_t failures = 0;
+            uint64_t bytes = 0;
+            uint64_t timed_calls = 0;
+            uint64_t ticks = 0;
+        };
+
+        struct Snapshot
+        {
+            StageStatistics stages[NUM_STAGES];
+
+            const StageStatistics& operator[](Stage stage) const
+            {
+                return stages[(size_t)stage];
+            }
+        };
+
+    public:
+        ParseInstrumentation() = delete;
+
+        static constexpr bool IsCompiledIn()
+        {
+#ifdef URI_INSTRUMENTATION
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        // 1 times every call; n times one top-level call in n.
+        static void SetSampleInterval(uint32_t interval);
+        static uint32_t GetSampleInterval();
+
+        // The calling thread's statistics.
+        static Snapshot GetThreadSnapshot();
+        static void ResetThread();
+
+        // Every thread's statistics summed, including threads that exited.
+        static Snapshot GetSnapshot();
+
+        static const char* GetStageName(Stage stage);
+
+        // One line per stage: its name, then "calls=... failures=...
+        // bytes=... timed_calls=... ticks=...".
+        static std::string Export(const Snapshot& snapshot);
+    };
+}
+
+#endif
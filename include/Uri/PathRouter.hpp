@@ -0,0 +1,84 @@
+#ifndef URI_PATH_ROUTER_HPP
+#define URI_PATH_ROUTER_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Uri
+{
+    class Uri;
+
+    // Routes paths to templates such as "/v1/users/{id}/orders/{orderId}",
+    // compiled into a trie of path segments.  Matching walks the path's
+    // decoded segments once, taking time independent of the number of
+    // routes, and doesn't allocate.
+    //
+    // Where several routes match, a literal segment beats a parameter,
+    // which beats a "{*}" wildcard, deciding from the leftmost segment
+    // where they differ.
+    class PathRouter
+    {
+    public:
+        // What AddRoute returns for a template it rejects.
+        static const size_t NO_ROUTE = (size_t)-1;
+
+        static const size_t MAX_PARAMETERS = 16;
+
+        // Views into the router's templates and the matched path.
+        struct Parameter
+        {
+            std::string_view name;
+            std::string_view value;
+        };
+
+        struct Match
+        {
+            size_t route = NO_ROUTE;
+            size_t num_parameters = 0;
+            Parameter parameters[MAX_PARAMETERS];
+
+            // The index of the first path segment matched by a "{*}"
+            // wildcard, or of the end of the path if there is none.
+            size_t rest_start = 0;
+
+            // The value of the parameter with the given name, or an empty
+            // view if the route has no such parameter.
+            std::string_view Get(std::string_view name) const;
+        };
+
+    public:
+        ~PathRouter() noexcept;
+        PathRouter(const PathRouter&);
+        PathRouter(PathRouter&&) noexcept;
+        PathRouter& operator=(const PathRouter&);
+        PathRouter& operator=(PathRouter&&) noexcept;
+
+    public:
+        PathRouter();
+
+        // Takes an absolute path whose segments are each literal text,
+        // possibly percent-encoded, "{name}" for any one non-empty segment,
+        // or, last only, "{*}" for the rest of the path, however many
+        // segments.  Returns the new route's index, which is also the
+        // number of routes added before it, or NO_ROUTE if the template
+        // is malformed or has the same shape as one already added.
+        size_t AddRoute(std::string_view path_template);
+
+        size_t Size() const;
+
+        // Matches the path of a URI, or segments as Uri::GetPath returns
+        // them; the empty first segment of an absolute path is skipped.
+        // The views in match stay valid while the router and the path do.
+        bool Find(const Uri& uri, Match& match) const;
+        bool Find(const std::vector< std::string >& path, Match& match) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef URI_PUBLIC_SUFFIX_LIST_HPP
+#define URI_PUBLIC_SUFFIX_LIST_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+
+namespace Uri
+{
+    // The rules of a public suffix list (https://publicsuffix.org/list/),
+    // compiled into a trie of reversed labels for matching host names.
+    //
+    // Rules written in Unicode match hosts in either their UTF-8 or their
+    // "xn--" form.  Hosts match case-insensitively.
+    class PublicSuffixList
+    {
+    public:
+        ~PublicSuffixList() noexcept;
+        PublicSuffixList(const PublicSuffixList&);
+        PublicSuffixList(PublicSuffixList&&) noexcept;
+        PublicSuffixList& operator=(const PublicSuffixList&);
+        PublicSuffixList& operator=(PublicSuffixList&&) noexcept;
+
+    public:
+        PublicSuffixList();
+
+        // Takes the list in its published format: one rule per line, "//"
+        // comments, "*." wildcard and "!" exception rules.  Fails, leaving
+        // the list as it was, on a malformed rule or if there are no rules.
+        bool Build(std::string_view list);
+        bool LoadFromFile(const std::string&);
+
+        size_t Size() const;
+        size_t MemoryUsage() const;
+
+        // Views into host, found in one walk over its labels from the right
+        // without allocating.  A host no rule matches has its last label as
+        // public suffix; an IP address or empty host has neither.  The
+        // registrable domain is empty if the host is itself a public
+        // suffix.
+        std::string_view GetPublicSuffix(std::string_view host) const;
+        std::string_view GetRegistrableDomain(std::string_view host) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef URI_RESOLVED_BASE_HPP
+#define URI_RESOLVED_BASE_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <Uri/Uri.hpp>
+
+namespace Uri
+{
+    class ResolvedBase
+    {
+    public:
+        ~ResolvedBase() noexcept;
+        ResolvedBase(const ResolvedBase&);
+        ResolvedBase(ResolvedBase&&) noexcept;
+        ResolvedBase& operator=(const ResolvedBase&);
+        ResolvedBase& operator=(ResolvedBase&&) noexcept;
+
+    public:
+        explicit ResolvedBase(const Uri&);
+
+        const Uri& GetBase() const;
+        Uri Resolve(const Uri&) const;
+        void ResolveInto(const Uri&, Uri&) const;
+        bool ResolveInto(const std::string&, Uri&) const;
+        void ResolveInto(const Uri&, std::string&) const;
+        bool ResolveInto(const std::string&, std::string&) const;
+
+        void ResolveAll(const std::vector<Uri>&, std::vector<Uri>&) const;
+        void ResolveAll(const std::vector<Uri>&, std::vector<std::string>&) const;
+        size_t ResolveAll(const std::vector<std::string>&, std::vector<Uri>&) const;
+        size_t ResolveAll(const std::vector<std::string>&, std::vector<std::string>&) const;
+
+        // Uri::MakeRelative against this base, for many targets.
+        Uri MakeRelative(const Uri&) const;
+        void MakeRelativeAll(const std::vector<Uri>&, std::vector<Uri>&) const;
+        void MakeRelativeAll(const std::vector<Uri>&, std::vector<std::string>&) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef URI_SCHEME_REGISTRY_HPP
+#define URI_SCHEME_REGISTRY_HPP
+
+#include <stdint.h>
+#include <string_view>
+
+namespace Uri
+{
+    // A small integer naming a scheme, so that storing or comparing the
+    // scheme of a parsed Uri is an integer operation.  The built-in schemes
+    // have fixed IDs; custom ones are numbered in registration order.
+    typedef uint16_t SchemeId;
+
+    // What a scheme implies about the URIs that use it.
+    struct SchemePolicy
+    {
+        // In lower case.
+        std::string_view name;
+
+        bool has_default_port = false;
+        uint16_t default_port = 0;
+
+        // Whether a URI of this scheme is meaningless without a host.
+        bool requires_host = false;
+
+        // Whether Uri::Normalize turns an empty path into "/".
+        bool empty_path_is_root = false;
+    };
+
+    struct HttpScheme
+    {
+        static constexpr SchemeId ID = 2;
+        static constexpr SchemePolicy POLICY{"http", true, 80, true, true};
+    };
+
+    struct HttpsScheme
+    {
+        static constexpr SchemeId ID = 3;
+        static constexpr SchemePolicy POLICY{"https", true, 443, true, true};
+    };
+
+    struct WsScheme
+    {
+        static constexpr SchemeId ID = 4;
+        static constexpr SchemePolicy POLICY{"ws", true, 80, true, true};
+    };
+
+    struct WssScheme
+    {
+        static constexpr SchemeId ID = 5;
+        static constexpr SchemePolicy POLICY{"wss", true, 443, true, true};
+    };
+
+    struct FtpScheme
+    {
+        static constexpr SchemeId ID = 6;
+        static constexpr SchemePolicy POLICY{"ftp", true, 21, true, true};
+    };
+
+    struct FileScheme
+    {
+        static constexpr SchemeId ID = 7;
+        static constexpr SchemePolicy POLICY{"file", false, 0, false, true};
+    };
+
+    struct MailtoScheme
+    {
+        static constexpr SchemeId ID = 8;
+        static constexpr SchemePolicy POLICY{"mailto"};
+    };
+
+    struct UrnScheme
+    {
+        static constexpr SchemeId ID = 9;
+        static constexpr SchemePolicy POLICY{"urn"};
+    };
+
+    struct DataScheme
+    {
+        static constexpr SchemeId ID = 10;
+        static constexpr SchemePolicy POLICY{"data"};
+    };
+
+    // The schemes whose policies Uri consults.  The ones above are built
+    // in; others may be registered, typically at startup, and stay
+    // registered for the life of the process.  Lookups are safe from any
+    // thread.
+    class SchemeRegistry
+    {
+    public:
+        // The ID of a Uri without a scheme.
+        static constexpr SchemeId NO_SCHEME = 0;
+
+        // The ID of a scheme that is legal but not registered.
+        static constexpr SchemeId UNREGISTERED_SCHEME = 1;
+
+        static constexpr SchemeId FIRST_CUSTOM_SCHEME = DataScheme::ID + 1;
+
+    public:
+        SchemeRegistry() = delete;
+
+        // Fails if the name is not a legal scheme, is already registered or
+        // if every custom ID is taken.
+        static bool Register(const SchemePolicy& policy);
+
+        // Scheme is a type with a static constexpr SchemePolicy POLICY.
+        template< typename Scheme >
+        static bool Register()
+        {
+            return Register(Scheme::POLICY);
+        }
+
+        // Scheme names match case-insensitively; returns nullptr for a
+        // scheme that is not registered.
+        static const SchemePolicy* Find(std::string_view scheme);
+        static const SchemePolicy* Find(SchemeId id);
+
+        // As Find, but returns the scheme's ID: NO_SCHEME for an empty
+        // string and UNREGISTERED_SCHEME for any other unknown name.
+        static SchemeId FindId(std::string_view scheme);
+    };
+}
+
+#endif
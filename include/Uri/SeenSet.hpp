@@ -0,0 +1,63 @@
+#ifndef URI_SEEN_SET_HPP
+#define URI_SEEN_SET_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <Uri/Uri.hpp>
+
+namespace Uri
+{
+    class SeenSet
+    {
+    public:
+        enum class FingerprintBits
+        {
+            BITS_64,
+            BITS_128,
+        };
+
+        enum class InsertResult
+        {
+            INSERTED,
+            ALREADY_PRESENT,
+            INVALID_URI,
+        };
+
+    public:
+        ~SeenSet() noexcept;
+        SeenSet(const SeenSet&);
+        SeenSet(SeenSet&&) noexcept;
+        SeenSet& operator=(const SeenSet&);
+        SeenSet& operator=(SeenSet&&) noexcept;
+
+    public:
+        SeenSet();
+        explicit SeenSet(size_t expected_count, FingerprintBits bits = FingerprintBits::BITS_64);
+
+        InsertResult Insert(const Uri&);
+        InsertResult Insert(const std::string&);
+        bool Contains(const Uri&) const;
+        bool Contains(const std::string&) const;
+
+        size_t InsertAll(const std::vector<Uri>&, std::vector<InsertResult>&);
+        size_t InsertAll(const std::vector<std::string>&, std::vector<InsertResult>&);
+
+        void Clear();
+        size_t Size() const;
+        size_t Capacity() const;
+        size_t MemoryUsage() const;
+        FingerprintBits GetFingerprintBits() const;
+
+        bool SaveToFile(const std::string&) const;
+        bool LoadFromFile(const std::string&);
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -2,12 +2,18 @@
 #define URI_HPP
 
 #include <memory>
+#include <stddef.h>
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <Uri/SchemeRegistry.hpp>
 
 namespace Uri
 {
+    class PublicSuffixList;
+    class UriView;
+
     class Uri
     {
     public:
@@ -21,13 +27,37 @@ namespace Uri
 
     public:
         Uri();
+
+        // Decodes a view that has already been validated and split, so
+        // there are no delimiters to search for and nothing to fail.
+        Uri(const UriView&);
+
         Uri Resolve (const Uri&) const;
+        std::string ResolveToString(const Uri&) const;
+        void ResolveInto(const Uri&, std::string&) const;
+        bool ResolveInto(const std::string&, std::string&) const;
+        static bool ResolveInto(const std::string&, const std::string&, std::string&);
+
+        // The inverse of Resolve: the shortest reference that this Uri
+        // resolves to the given target, found by comparing components
+        // rather than serialized strings.  The target's path should be
+        // normalized.  A target with another scheme, or any target of a
+        // base without one, comes back whole.
+        Uri MakeRelative(const Uri& target) const;
         bool HasPort() const;
         bool HasQuery() const;
         bool HasFragment() const;
         bool IsRelativeReference() const;
         bool ContainsRelativePath() const;
         bool ParseFromString(const std::string&);
+        bool ParseFromString(const char*);
+        bool ParseFromString(const char*, size_t);
+        bool ParseFromString(std::string_view);
+
+        // Parses an IRI (RFC 3987): raw UTF-8 is taken as if it were
+        // percent-encoded, so the components hold the same decoded bytes
+        // either way.  Fails on malformed UTF-8.
+        bool ParseFromIriString(std::string_view);
 
         uint16_t GetPort() const;
         void ClearPort();
@@ -35,6 +65,14 @@ namespace Uri
         void ClearFragment();
         void NormalizePath();
 
+        // NormalizePath, then the rules of the scheme's SchemePolicy, if it
+        // has one: drops a port equal to the scheme's default and turns an
+        // empty path into "/".
+        void Normalize();
+
+        // False if the scheme's SchemePolicy requires a host this Uri lacks.
+        bool IsValidForScheme() const;
+
         void SetScheme(const std::string&);
         void SetPort(uint16_t);
         void SetUserInfo(const std::string&);
@@ -43,16 +81,54 @@ namespace Uri
         void SetHost(const std::string&);
         void SetQuery(const std::string&);
 
+        void SetScheme(std::string&&);
+        void SetUserInfo(std::string&&);
+        void SetFragment(std::string&&);
+        void SetPath(std::vector<std::string>&&);
+        void SetHost(std::string&&);
+        void SetQuery(std::string&&);
+
 
         std::string GetUserInfo() const;     
         std::string GetScheme() const;
+
+        // The registered scheme's ID, SchemeRegistry::UNREGISTERED_SCHEME
+        // for any other scheme, or SchemeRegistry::NO_SCHEME.
+        SchemeId GetSchemeId() const;
         std::string GetHost() const;
         std::string GetFragment() const;
         std::string GetQuery() const;
         std::string GenerateString() const;
+
+        // GenerateString, with non-ASCII characters written as UTF-8.
+        std::string GenerateIriString() const;
         std::vector<std::string> GetPath() const;
+
+        // Views into this Uri's own storage, valid until it is next
+        // modified or destroyed.
+        std::string_view GetSchemeView() const;
+        std::string_view GetUserInfoView() const;
+        std::string_view GetHostView() const;
+        std::string_view GetQueryView() const;
+        std::string_view GetFragmentView() const;
+        size_t GetPathSegmentCount() const;
+        std::string_view GetPathSegment(size_t) const;
+
+        // Views into the host, as PublicSuffixList finds them: the public
+        // suffix ("co.uk") and the registrable domain, one label longer
+        // ("example.co.uk").
+        std::string_view GetPublicSuffix(const PublicSuffixList&) const;
+        std::string_view GetRegistrableDomain(const PublicSuffixList&) const;
         
     private:
+        friend class BatchSerializer;
+        friend class UriScanner;
+        friend class ResolvedBase;
+        friend class SeenSet;
+        friend class UriDictionary;
+        friend class UriRecord;
+        friend class ParseCache;
+
         struct Impl;
         std::unique_ptr< struct Impl> impl_;
     };
@@ -0,0 +1,54 @@
+#ifndef URI_URI_DICTIONARY_HPP
+#define URI_URI_DICTIONARY_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <Uri/Uri.hpp>
+
+namespace Uri
+{
+    // A read-only, sorted set of serialized URIs, front coded in blocks.
+    // IDs are positions in sorted order, so they are stable for a given
+    // dictionary and ID ranges correspond to string prefixes.
+    class UriDictionary
+    {
+    public:
+        ~UriDictionary() noexcept;
+        UriDictionary(const UriDictionary&);
+        UriDictionary(UriDictionary&&) noexcept;
+        UriDictionary& operator=(const UriDictionary&);
+        UriDictionary& operator=(UriDictionary&&) noexcept;
+
+    public:
+        static const size_t DEFAULT_BLOCK_SIZE = 16;
+
+        UriDictionary();
+
+        bool Build(const std::vector<Uri>&, size_t block_size = DEFAULT_BLOCK_SIZE);
+        bool Build(const std::vector<std::string>&, size_t block_size = DEFAULT_BLOCK_SIZE);
+
+        size_t Size() const;
+        size_t GetBlockSize() const;
+        size_t MemoryUsage() const;
+
+        bool Find(const Uri&, size_t& id) const;
+        bool Find(const std::string&, size_t& id) const;
+        bool GetString(size_t id, std::string&) const;
+        bool GetUri(size_t id, Uri&) const;
+
+        // IDs [first, last) of every entry whose serialized form starts
+        // with the given prefix; returns whether there are any.
+        bool FindPrefix(const std::string& prefix, size_t& first, size_t& last) const;
+
+        bool SaveToFile(const std::string&) const;
+        bool LoadFromFile(const std::string&);
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
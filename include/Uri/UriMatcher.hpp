@@ -0,0 +1,94 @@
+#ifndef URI_URI_MATCHER_HPP
+#define URI_URI_MATCHER_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Uri
+{
+    class Uri;
+    class UriView;
+
+    // Decides whether URIs are allowed by a set of scheme, host and path
+    // prefix rules, compiled into a trie of reversed host labels whose
+    // nodes lead to tries of path segments.  Matching takes time in
+    // proportion to the URI, not to the number of rules.
+    //
+    // Build compiles a new rule set and swaps it in atomically, so rules
+    // may be rebuilt while other threads match; each match sees either the
+    // old rules or the new ones.
+    class UriMatcher
+    {
+    public:
+        enum class Action
+        {
+            ALLOW,
+            DENY,
+        };
+
+        struct Rule
+        {
+            // Lower case; empty for any scheme.
+            std::string scheme;
+
+            // "example.com" for that host only, "*.example.com" for hosts
+            // under it but not itself, "*" for any host.  Matched
+            // case-insensitively.
+            std::string host;
+
+            // Segments a path must start with, without the empty one of an
+            // absolute path; empty for any path.
+            std::vector< std::string > path_prefix;
+
+            Action action = Action::DENY;
+        };
+
+        // What FindRule returns when no rule matches.
+        static const size_t NO_RULE = (size_t)-1;
+
+    public:
+        ~UriMatcher() noexcept;
+        UriMatcher(const UriMatcher&) = delete;
+        UriMatcher(UriMatcher&&) noexcept;
+        UriMatcher& operator=(const UriMatcher&) = delete;
+        UriMatcher& operator=(UriMatcher&&) noexcept;
+
+    public:
+        // Until the first Build, no rules and everything allowed.
+        UriMatcher();
+
+        // Makes a rule from a URI reference such as
+        // "https://*.example.com/api/" or "//example.com": a missing scheme
+        // means any, as does a missing path.
+        static bool ParseRule(std::string_view pattern, Action action, Rule& rule);
+
+        // Replaces the rules, and the action for URIs no rule matches.
+        // Fails, keeping the current rules, on a malformed host pattern.
+        bool Build(const std::vector< Rule >& rules, Action default_action = Action::DENY);
+
+        size_t Size() const;
+
+        // The index in the rules given to Build of the rule deciding a URI:
+        // the one with the most specific host, then the longest path prefix,
+        // then a scheme over none.  Among equals, DENY wins, then the
+        // earlier rule.
+        size_t FindRule(const Uri&) const;
+        size_t FindRule(const UriView&) const;
+
+        Action Match(const Uri&) const;
+        Action Match(const UriView&) const;
+
+        // Matches every URI against the same rule set, even if another
+        // thread rebuilds it meanwhile.
+        void Match(const std::vector< Uri >& uris, std::vector< Action >& actions) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
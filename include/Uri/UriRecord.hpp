@@ -0,0 +1,69 @@
+#ifndef URI_URI_RECORD_HPP
+#define URI_URI_RECORD_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <vector>
+#include <Uri/Uri.hpp>
+
+namespace Uri
+{
+    // A parsed Uri in a compact, versioned binary form.  Attaching to an
+    // encoded record only checks bounds and points into the buffer, so the
+    // buffer must outlive the views returned by the getters.
+    class UriRecord
+    {
+    public:
+        enum class HostType
+        {
+            NO_AUTHORITY,
+            REG_NAME,
+            IPV4_ADDRESS,
+            IP_LITERAL,
+        };
+
+    public:
+        ~UriRecord() noexcept;
+        UriRecord(const UriRecord&);
+        UriRecord(UriRecord&&) noexcept;
+        UriRecord& operator=(const UriRecord&);
+        UriRecord& operator=(UriRecord&&) noexcept;
+
+    public:
+        static const uint8_t FORMAT_VERSION = 1;
+
+        UriRecord();
+
+        static void Append(const Uri&, std::vector<uint8_t>& buffer);
+        static void AppendAll(const std::vector<Uri>&, std::vector<uint8_t>& buffer);
+        static bool ReadAll(const uint8_t* data, size_t size, std::vector<Uri>&);
+
+        // The number of records in an AppendAll array and where the first
+        // one starts, for walking the array with Attach.
+        static bool ReadArrayHeader(const uint8_t* data, size_t size, size_t& count, size_t& header_size);
+
+        bool Attach(const uint8_t* data, size_t size, size_t& consumed);
+        void ToUri(Uri&) const;
+
+        std::string_view GetScheme() const;
+        std::string_view GetUserInfo() const;
+        std::string_view GetHost() const;
+        HostType GetHostType() const;
+        bool HasPort() const;
+        uint16_t GetPort() const;
+        size_t GetPathSegmentCount() const;
+        std::string_view GetPathSegment(size_t) const;
+        bool HasQuery() const;
+        std::string_view GetQuery() const;
+        bool HasFragment() const;
+        std::string_view GetFragment() const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef URI_URI_SCANNER_HPP
+#define URI_URI_SCANNER_HPP
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+
+namespace Uri
+{
+    class Uri;
+
+    // Validates a URI reference and finds its component boundaries in one
+    // pass, a character at a time, with a transition table built at
+    // compile time from the grammar: one lookup per character, with no
+    // branches but the loop's.  It accepts exactly what
+    // UriView::ParseFromString accepts.
+    //
+    // That is RFC 3986, which Uri::ParseFromString, and so UriValidator,
+    // follows less strictly: they also take a '%' with fewer than two
+    // hexadecimal digits at the end of a component or path segment, and
+    // a port of "-0".  Validate with UriValidator what is to go to
+    // Uri::ParseFromString, and with Scan what is to go to UriView,
+    // LazyUri or Parse.
+    //
+    // The characters may come in chunks, as they arrive, with Feed; only
+    // the few characters checked after the scan, those of an IPv6 literal
+    // and of a port, are kept between chunks.
+    class UriScanner
+    {
+    public:
+        // Where the components are, as offsets into the whole input, as
+        // UriView has them: the scheme includes its ':', the authority
+        // its "//" and the query its '?'.  The host excludes the brackets
+        // of an IP literal.
+        struct Layout
+        {
+            size_t scheme_end = 0;
+            size_t authority_end = 0;
+            size_t path_end = 0;
+            size_t query_end = 0;
+            size_t user_info_length = 0;
+            size_t host_begin = 0;
+            size_t host_end = 0;
+            bool has_port = false;
+            uint16_t port = 0;
+        };
+
+    public:
+        ~UriScanner() noexcept;
+        UriScanner(const UriScanner&);
+        UriScanner(UriScanner&&) noexcept;
+        UriScanner& operator=(const UriScanner&);
+        UriScanner& operator=(UriScanner&&) noexcept;
+
+    public:
+        UriScanner();
+
+        // Readies the scanner for another input.
+        void Reset();
+
+        // Scans the next characters of the input.
+        void Feed(std::string_view characters);
+
+        // Ends the input, returning whether it is a valid URI reference
+        // and, if so and layout is given, where its components are.
+        bool Finish(Layout* layout = nullptr);
+
+        // Scans a whole input at once.
+        static bool Scan(std::string_view uri_string, Layout* layout = nullptr);
+
+        // Scans uri_string, then has uri decode the components found,
+        // without searching for them again.  On failure, uri is unchanged.
+        static bool Parse(std::string_view uri_string, Uri& uri);
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef URI_URI_TEMPLATE_HPP
+#define URI_URI_TEMPLATE_HPP
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Uri
+{
+    class Uri;
+
+    // A URI Template (RFC 6570), up to level 4, such as
+    // "https://{host}/search{?q,lang,page}".  Parse compiles it once into a
+    // list of literal spans, already encoded, and expressions whose
+    // variables each have their operator's separators and encoding;
+    // Expand then only looks up values and encodes them.
+    class UriTemplate
+    {
+    public:
+        // What a variable is set to.  The views must outlive expansion.
+        // Per RFC 6570, an empty list or map is as good as undefined.
+        struct Value
+        {
+            enum class Type
+            {
+                UNDEFINED,
+                STRING,
+                LIST,
+                MAP,
+            };
+
+            Type type = Type::UNDEFINED;
+            std::string_view string;
+            std::vector< std::string_view > list;
+            std::vector< std::pair< std::string_view, std::string_view > > map;
+
+            Value() = default;
+            Value(std::string_view new_string);
+            Value(const char* new_string);
+            Value(std::vector< std::string_view > new_list);
+            Value(std::vector< std::pair< std::string_view, std::string_view > > new_map);
+        };
+
+        typedef std::map< std::string, Value, std::less<> > Variables;
+
+        // What GetVariableIndex returns for a name not in the template.
+        static const size_t NO_VARIABLE = (size_t)-1;
+
+    public:
+        ~UriTemplate() noexcept;
+        UriTemplate(const UriTemplate&);
+        UriTemplate(UriTemplate&&) noexcept;
+        UriTemplate& operator=(const UriTemplate&);
+        UriTemplate& operator=(UriTemplate&&) noexcept;
+
+    public:
+        // An empty template, expanding to nothing.
+        UriTemplate();
+
+        // Fails, leaving the template as it was, on a malformed expression
+        // or a character not allowed in a literal.
+        bool Parse(std::string_view template_string);
+
+        // The distinct variables of the template, in the order they first
+        // appear; their indices are those of the values Expand takes.
+        const std::vector< std::string >& GetVariableNames() const;
+        size_t GetVariableIndex(std::string_view name) const;
+
+        // Replaces expansion with the expansion of the template, reserving
+        // room for it first so that it grows at most once.  Values past
+        // the end of the vector are undefined.
+        void Expand(const std::vector< Value >& values, std::string& expansion) const;
+        void Expand(const Variables& variables, std::string& expansion) const;
+
+        // Expands the template and parses the result as a URI reference.
+        bool Expand(const std::vector< Value >& values, Uri& uri) const;
+
+    private:
+        struct Impl;
+        std::unique_ptr< Impl > impl_;
+    };
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef URI_URI_VALIDATOR_HPP
+#define URI_URI_VALIDATOR_HPP
+
+#include <stddef.h>
+#include <string_view>
+
+namespace Uri
+{
+    // Checks a string against the grammar Uri::ParseFromString applies,
+    // accepting exactly the strings it accepts, without decoding or
+    // copying any component.
+    //
+    // That grammar is looser than RFC 3986 in two ways: a '%' at the end
+    // of the user info, a path segment, the query or the fragment may
+    // have fewer than two hexadecimal digits after it, and the port may
+    // be "-0".  This validator keeps to it so that whatever it passes can
+    // be parsed into a Uri.  UriScanner::Scan checks the strict grammar
+    // UriView and LazyUri accept, and is the one to use ahead of them.
+    class UriValidator
+    {
+    public:
+        enum class Component
+        {
+            NONE,
+            SCHEME,
+            USER_INFO,
+            HOST,
+            PORT,
+            PATH,
+            QUERY,
+            FRAGMENT,
+        };
+
+        // Where the first error is: the offset into the string of the first
+        // character that cannot be part of a valid URI there, and the
+        // component it falls in.  A host or port that is wrong as a whole
+        // (an IPv6 address with too many groups, a port over 65535) is
+        // reported at its start.
+        struct Error
+        {
+            size_t offset = 0;
+            Component component = Component::NONE;
+        };
+
+    public:
+        UriValidator() = delete;
+
+        static bool IsValid(std::string_view uri_string);
+        static bool IsValid(std::string_view uri_string, Error& error);
+    };
+}
+
+#endif
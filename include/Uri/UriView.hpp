@@ -0,0 +1,543 @@
+#ifndef URI_URI_VIEW_HPP
+#define URI_URI_VIEW_HPP
+
+#include <stddef.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <string_view>
+
+namespace Uri
+{
+    class Uri;
+
+    // A URI validated and split into its still percent-encoded components
+    // without allocating, so that it can be parsed in a constant expression.
+    // It only refers to the characters it was parsed from, which must
+    // outlive it; string literals always do.
+    //
+    // It accepts what Uri::ParseFromString accepts, except that every '%'
+    // must be followed by two hexadecimal digits, and converts to an equal
+    // Uri without searching for delimiters again.
+    class UriView
+    {
+    public:
+        constexpr UriView() = default;
+
+        constexpr bool ParseFromString(std::string_view uri_string)
+        {
+            *this = UriView();
+            uri_string_ = uri_string;
+            auto authority_or_path_delimiter_start = uri_string.find('/');
+            if (authority_or_path_delimiter_start == std::string_view::npos)
+            {
+                authority_or_path_delimiter_start = uri_string.length();
+            }
+            const auto scheme_end = uri_string.substr(0, authority_or_path_delimiter_start).find(':');
+            if (scheme_end != std::string_view::npos)
+            {
+                if (!IsValidScheme(uri_string.substr(0, scheme_end)))
+                {
+                    return false;
+                }
+                scheme_end_ = scheme_end + 1;
+            }
+            auto path_end = uri_string.find_first_of("?#", scheme_end_);
+            if (path_end == std::string_view::npos)
+            {
+                path_end = uri_string.length();
+            }
+            authority_end_ = scheme_end_;
+            if (uri_string.substr(scheme_end_, 2) == "//")
+            {
+                const auto authority_start = scheme_end_ + 2;
+                auto authority_end = uri_string.substr(0, path_end).find('/', authority_start);
+                if (authority_end == std::string_view::npos)
+                {
+                    authority_end = path_end;
+                }
+                if (!ParseAuthority(uri_string.substr(authority_start, authority_end - authority_start),
+                                    authority_start))
+                {
+                    return false;
+                }
+                authority_end_ = authority_end;
+            }
+            if (!IsValidElement(uri_string.substr(authority_end_, path_end - authority_end_),
+                                IsPathCharacter))
+            {
+                return false;
+            }
+            path_end_ = path_end;
+            query_end_ = uri_string.find('#', path_end_);
+            if (query_end_ == std::string_view::npos)
+            {
+                query_end_ = uri_string.length();
+            }
+            return (
+                IsValidElement(GetQuery(), IsQueryOrFragmentCharacter)
+                && IsValidElement(GetFragment(), IsQueryOrFragmentCharacter)
+            );
+        }
+
+        constexpr std::string_view GetString() const
+        {
+            return uri_string_;
+        }
+
+        // Without its ':'.
+        constexpr std::string_view GetScheme() const
+        {
+            return uri_string_.substr(0, (scheme_end_ > 0) ? scheme_end_ - 1 : 0);
+        }
+
+        constexpr bool HasAuthority() const
+        {
+            return (authority_end_ > scheme_end_);
+        }
+
+        constexpr std::string_view GetUserInfo() const
+        {
+            return (HasAuthority()
+                ? uri_string_.substr(scheme_end_ + 2, user_info_length_)
+                : std::string_view());
+        }
+
+        // Without the brackets of an IP literal.
+        constexpr std::string_view GetHost() const
+        {
+            return uri_string_.substr(host_begin_, host_end_ - host_begin_);
+        }
+
+        constexpr bool HasPort() const
+        {
+            return has_port_;
+        }
+
+        constexpr uint16_t GetPort() const
+        {
+            return port_;
+        }
+
+        constexpr std::string_view GetPath() const
+        {
+            return uri_string_.substr(authority_end_, path_end_ - authority_end_);
+        }
+
+        constexpr bool HasQuery() const
+        {
+            return (query_end_ > path_end_);
+        }
+
+        // Without its '?'.
+        constexpr std::string_view GetQuery() const
+        {
+            return (HasQuery()
+                ? uri_string_.substr(path_end_ + 1, query_end_ - path_end_ - 1)
+                : std::string_view());
+        }
+
+        constexpr bool HasFragment() const
+        {
+            return (query_end_ < uri_string_.length());
+        }
+
+        // Without its '#'.
+        constexpr std::string_view GetFragment() const
+        {
+            return (HasFragment()
+                ? uri_string_.substr(query_end_ + 1)
+                : std::string_view());
+        }
+
+    private:
+        friend class Uri;
+
+        static constexpr bool IsAlpha(char c)
+        {
+            return (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')));
+        }
+
+        static constexpr bool IsDigit(char c)
+        {
+            return ((c >= '0') && (c <= '9'));
+        }
+
+        static constexpr bool IsHexDigit(char c)
+        {
+            return (IsDigit(c) || ((c >= 'a') && (c <= 'f')) || ((c >= 'A') && (c <= 'F')));
+        }
+
+        static constexpr bool IsUnreservedOrSubDelim(char c)
+        {
+            return (
+                IsAlpha(c) || IsDigit(c)
+                || (std::string_view("-._~!$&'()*+,;=").find(c) != std::string_view::npos)
+            );
+        }
+
+        static constexpr bool IsUserInfoCharacter(char c)
+        {
+            return (IsUnreservedOrSubDelim(c) || (c == ':'));
+        }
+
+        static constexpr bool IsPathCharacter(char c)
+        {
+            return (IsUnreservedOrSubDelim(c) || (c == ':') || (c == '@') || (c == '/'));
+        }
+
+        static constexpr bool IsQueryOrFragmentCharacter(char c)
+        {
+            return (IsPathCharacter(c) || (c == '?'));
+        }
+
+        static constexpr bool IsValidElement(std::string_view element, bool (*is_allowed)(char))
+        {
+            for (size_t i = 0; i < element.length(); ++i)
+            {
+                if (element[i] == '%')
+                {
+                    if ((i + 2 >= element.length())
+                        || !IsHexDigit(element[i + 1])
+                        || !IsHexDigit(element[i + 2]))
+                    {
+                        return false;
+                    }
+                    i += 2;
+                }
+                else if (!is_allowed(element[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static constexpr bool IsValidScheme(std::string_view scheme)
+        {
+            if (scheme.empty() || !IsAlpha(scheme[0]))
+            {
+                return false;
+            }
+            for (const auto c: scheme.substr(1))
+            {
+                if (!IsAlpha(c) && !IsDigit(c) && (c != '+') && (c != '-') && (c != '.'))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Mirrors ValidateIpv4Adress, quirks included, so that anything
+        // accepted here is accepted by Uri::ParseFromString.
+        static constexpr bool IsValidIpv4Address(std::string_view address)
+        {
+            size_t num_groups = 0;
+            size_t octet_length = 0;
+            int octet = 0;
+            for (const auto c: address)
+            {
+                if (IsDigit(c))
+                {
+                    octet = octet * 10 + (c - '0');
+                    if ((++octet_length > 3) || (octet > 255))
+                    {
+                        return false;
+                    }
+                }
+                else if ((octet_length > 0) && (c == '.'))
+                {
+                    if (num_groups++ >= 4)
+                    {
+                        return false;
+                    }
+                    octet = 0;
+                    octet_length = 0;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            if (octet_length > 0)
+            {
+                ++num_groups;
+            }
+            return (num_groups == 4);
+        }
+
+        // Mirrors ValidateIpv6Address.
+        static constexpr bool IsValidIpv6Address(std::string_view address)
+        {
+            enum class ValidationState
+            {
+                NO_GROUPS_YET,
+                COLON_BUT_NO_GROUPS_YET,
+                AFTER_COLON_EXPECT_GROUP_OR_IPV4,
+                IN_GROUP_NOT_IPV4,
+                IN_GROUP_COULD_BE_IPV4,
+                COLON_AFTER_GROUP,
+            } state = ValidationState::NO_GROUPS_YET;
+            size_t num_groups = 0;
+            size_t num_digits = 0;
+            size_t ipv4_address_start = 0;
+            size_t position = 0;
+            bool double_colon_encountered = false;
+            bool ipv4_address_encountered = false;
+            for (; position < address.length(); ++position)
+            {
+                const auto c = address[position];
+                switch (state)
+                {
+                    case ValidationState::NO_GROUPS_YET:
+                    case ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4:
+                    case ValidationState::COLON_AFTER_GROUP:
+                    {
+                        if ((c == ':') && (state != ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4))
+                        {
+                            if (state == ValidationState::NO_GROUPS_YET)
+                            {
+                                state = ValidationState::COLON_BUT_NO_GROUPS_YET;
+                            }
+                            else if (double_colon_encountered)
+                            {
+                                return false;
+                            }
+                            else
+                            {
+                                double_colon_encountered = true;
+                                state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
+                            }
+                        }
+                        else if (IsHexDigit(c))
+                        {
+                            if (++num_digits > 4)
+                            {
+                                return false;
+                            }
+                            if (IsDigit(c))
+                            {
+                                ipv4_address_start = position;
+                                state = ValidationState::IN_GROUP_COULD_BE_IPV4;
+                            }
+                            else
+                            {
+                                state = ValidationState::IN_GROUP_NOT_IPV4;
+                            }
+                        }
+                        else
+                        {
+                            return false;
+                        }
+                    } break;
+
+                    case ValidationState::COLON_BUT_NO_GROUPS_YET:
+                    {
+                        if (c != ':')
+                        {
+                            return false;
+                        }
+                        double_colon_encountered = true;
+                        state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
+                    } break;
+
+                    case ValidationState::IN_GROUP_NOT_IPV4:
+                    case ValidationState::IN_GROUP_COULD_BE_IPV4:
+                    {
+                        if (c == ':')
+                        {
+                            num_digits = 0;
+                            ++num_groups;
+                            state = ((state == ValidationState::IN_GROUP_NOT_IPV4)
+                                ? ValidationState::COLON_AFTER_GROUP
+                                : ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4);
+                        }
+                        else if ((c == '.') && (state == ValidationState::IN_GROUP_COULD_BE_IPV4))
+                        {
+                            ipv4_address_encountered = true;
+                        }
+                        else if (IsHexDigit(c))
+                        {
+                            if (++num_digits > 4)
+                            {
+                                return false;
+                            }
+                            if (!IsDigit(c))
+                            {
+                                state = ValidationState::IN_GROUP_NOT_IPV4;
+                            }
+                        }
+                        else
+                        {
+                            return false;
+                        }
+                    } break;
+                }
+                if (ipv4_address_encountered)
+                {
+                    break;
+                }
+            }
+            if ((state == ValidationState::IN_GROUP_NOT_IPV4)
+                || (state == ValidationState::IN_GROUP_COULD_BE_IPV4))
+            {
+                ++num_groups;
+            }
+            if ((position == address.length())
+                && ((state == ValidationState::COLON_BUT_NO_GROUPS_YET)
+                    || (state == ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4)
+                    || (state == ValidationState::COLON_AFTER_GROUP)))
+            {
+                return false;
+            }
+            if (ipv4_address_encountered)
+            {
+                if (!IsValidIpv4Address(address.substr(ipv4_address_start)))
+                {
+                    return false;
+                }
+                num_groups += 2;
+            }
+            return (double_colon_encountered ? (num_groups <= 7) : (num_groups == 8));
+        }
+
+        // What follows the 'v' of an IPvFuture literal.
+        static constexpr bool IsValidIpvFuture(std::string_view address)
+        {
+            const auto version_end = address.find('.');
+            if (version_end == std::string_view::npos)
+            {
+                return false;
+            }
+            for (const auto c: address.substr(0, version_end))
+            {
+                if (!IsHexDigit(c))
+                {
+                    return false;
+                }
+            }
+            for (const auto c: address.substr(version_end + 1))
+            {
+                if (!IsUserInfoCharacter(c))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr bool ParseAuthority(std::string_view authority, size_t authority_start)
+        {
+            auto host_port = authority;
+            auto host_port_start = authority_start;
+            const auto user_info_delimiter = authority.find('@');
+            if (user_info_delimiter != std::string_view::npos)
+            {
+                if (!IsValidElement(authority.substr(0, user_info_delimiter), IsUserInfoCharacter))
+                {
+                    return false;
+                }
+                user_info_length_ = user_info_delimiter;
+                host_port = authority.substr(user_info_delimiter + 1);
+                host_port_start += user_info_delimiter + 1;
+            }
+            size_t host_length = 0;
+            if (!host_port.empty() && (host_port[0] == '['))
+            {
+                const auto literal_end = host_port.find(']');
+                if (literal_end == std::string_view::npos)
+                {
+                    return false;
+                }
+                const auto literal = host_port.substr(1, literal_end - 1);
+                if ((!literal.empty() && (literal[0] == 'v'))
+                    ? !IsValidIpvFuture(literal.substr(1))
+                    : !IsValidIpv6Address(literal))
+                {
+                    return false;
+                }
+                host_begin_ = host_port_start + 1;
+                host_end_ = host_port_start + literal_end;
+                host_length = literal_end + 1;
+                if ((host_length < host_port.length()) && (host_port[host_length] != ':'))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                host_length = host_port.find(':');
+                if (host_length == std::string_view::npos)
+                {
+                    host_length = host_port.length();
+                }
+                if (!IsValidElement(host_port.substr(0, host_length), IsUnreservedOrSubDelim))
+                {
+                    return false;
+                }
+                host_begin_ = host_port_start;
+                host_end_ = host_port_start + host_length;
+            }
+            if (host_length + 1 >= host_port.length())
+            {
+                return true;
+            }
+            return ParsePort(host_port.substr(host_length + 1));
+        }
+
+        constexpr bool ParsePort(std::string_view port_string)
+        {
+            if ((port_string[0] == '0') && (port_string.length() > 1))
+            {
+                return false;
+            }
+            uint32_t port = 0;
+            for (const auto c: port_string)
+            {
+                if (!IsDigit(c))
+                {
+                    return false;
+                }
+                port = port * 10 + (uint32_t)(c - '0');
+                if (port > 65535)
+                {
+                    return false;
+                }
+            }
+            has_port_ = true;
+            port_ = (uint16_t)port;
+            return true;
+        }
+
+        // Component boundaries as in SerializedLayout: the scheme includes
+        // its ':', the authority its "//" and the query its '?'.
+        std::string_view uri_string_;
+        size_t scheme_end_ = 0;
+        size_t authority_end_ = 0;
+        size_t path_end_ = 0;
+        size_t query_end_ = 0;
+        size_t user_info_length_ = 0;
+        size_t host_begin_ = 0;
+        size_t host_end_ = 0;
+        bool has_port_ = false;
+        uint16_t port_ = 0;
+    };
+
+    namespace Literals
+    {
+        // "https://example.com/"_uri.  A malformed literal fails to compile
+        // wherever the result must be a constant expression, such as a
+        // constexpr variable, and throws std::invalid_argument otherwise.
+        constexpr UriView operator""_uri(const char* characters, size_t length)
+        {
+            UriView view;
+            if (!view.ParseFromString(std::string_view(characters, length)))
+            {
+                throw std::invalid_argument("malformed URI literal");
+            }
+            return view;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include "ReferenceResolver.hpp"
+#include "UriImpl.hpp"
+#include <algorithm>
+#include <string.h>
+#include <Uri/BatchSerializer.hpp>
+
+namespace Uri
+{
+    size_t BatchSerializer::SerializedLength(const Uri& uri)
+    {
+        return DecodedSource< Uri::Impl >(*uri.impl_).SerializedLength();
+    }
+
+    void BatchSerializer::Serialize(const Uri* uris,
+                                    size_t count,
+                                    std::string_view separator,
+                                    std::string& buffer,
+                                    std::vector< size_t >* offsets)
+    {
+        auto total_length = count * separator.length();
+        for (size_t i = 0; i < count; ++i)
+        {
+            total_length += SerializedLength(uris[i]);
+        }
+        buffer.reserve(buffer.length() + total_length);
+        if (offsets != nullptr)
+        {
+            offsets->resize(count + 1);
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (offsets != nullptr)
+            {
+                (*offsets)[i] = buffer.length();
+            }
+            (void)SerializeToBuffer(DecodedSource< Uri::Impl >(*uris[i].impl_), buffer);
+            buffer.append(separator);
+        }
+        if (offsets != nullptr)
+        {
+            (*offsets)[count] = buffer.length();
+        }
+    }
+
+    void BatchSerializer::Serialize(const std::vector< Uri >& uris,
+                                    std::string_view separator,
+                                    std::string& buffer,
+                                    std::vector< size_t >* offsets)
+    {
+        Serialize(uris.data(), uris.size(), separator, buffer, offsets);
+    }
+
+    std::string_view BatchSerializer::GetSlice(std::string_view buffer,
+                                               const std::vector< size_t >& offsets,
+                                               size_t separator_length,
+                                               size_t index)
+    {
+        return buffer.substr(
+            offsets[index],
+            offsets[index + 1] - offsets[index] - separator_length
+        );
+    }
+
+#if !defined(_WIN32)
+    size_t BatchSerializer::Serialize(const Uri* uris,
+                                      size_t count,
+                                      std::string_view separator,
+                                      struct iovec* iovecs,
+                                      size_t num_iovecs)
+    {
+        size_t capacity = 0;
+        for (size_t i = 0; i < num_iovecs; ++i)
+        {
+            capacity += iovecs[i].iov_len;
+        }
+
+        // Each URI is serialized into scratch, then copied across as many
+        // of the caller's buffers as it takes.
+        std::string scratch;
+        size_t iovec_index = 0;
+        size_t iovec_used = 0;
+        size_t written = 0;
+        for (; written < count; ++written)
+        {
+            scratch.clear();
+            (void)SerializeToBuffer(DecodedSource< Uri::Impl >(*uris[written].impl_), scratch);
+            scratch.append(separator);
+            if (scratch.length() > capacity)
+            {
+                break;
+            }
+            capacity -= scratch.length();
+            std::string_view rest(scratch);
+            while (!rest.empty())
+            {
+                // Empty buffers, which may have no base at all, are skipped.
+                while (iovecs[iovec_index].iov_len == iovec_used)
+                {
+                    ++iovec_index;
+                    iovec_used = 0;
+                }
+                const auto room = iovecs[iovec_index].iov_len - iovec_used;
+                const auto chunk = std::min(room, rest.length());
+                memcpy((char*)iovecs[iovec_index].iov_base + iovec_used, rest.data(), chunk);
+                rest.remove_prefix(chunk);
+                iovec_used += chunk;
+                if (iovec_used == iovecs[iovec_index].iov_len)
+                {
+                    ++iovec_index;
+                    iovec_used = 0;
+                }
+            }
+        }
+        if (iovec_index < num_iovecs)
+        {
+            iovecs[iovec_index++].iov_len = iovec_used;
+        }
+        for (; iovec_index < num_iovecs; ++iovec_index)
+        {
+            iovecs[iovec_index].iov_len = 0;
+        }
+        return written;
+    }
+#endif
+}
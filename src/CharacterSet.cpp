@@ -1,12 +1,125 @@
 #include "CharacterSet.hpp"
 
-#include <set>
+#include <stddef.h>
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // How many ranges of characters CountLeading tests sixteen at a time.
+    const size_t NUM_RANGES = 4;
+}
 
 namespace Uri
 {
+        // One flag per character value, so membership is a single load.
         struct CharacterSet::Impl 
         {
-            std::set< char > characters_set;
+            bool members[256] = {};
+
+            void Insert(char c)
+            {
+                members[(unsigned char)c] = true;
+            }
+
+            bool Contains(char c) const
+            {
+                return members[(unsigned char)c];
+            }
+
+#if defined(__SSE2__)
+            // The widest runs of members, each as its first character and
+            // its length less one.  A block of characters all in them is
+            // all in the set; one that isn't is checked a character at a
+            // time.  Unused ranges repeat the first, or are empty.
+            uint8_t range_first[NUM_RANGES] = {};
+            uint8_t range_span[NUM_RANGES] = {};
+            bool has_ranges = false;
+
+            // The same, in every byte, to compare with sixteen at once.
+            __m128i range_first_bytes[NUM_RANGES];
+            __m128i range_span_bytes[NUM_RANGES];
+
+            void FindRanges()
+            {
+                size_t num_ranges = 0;
+                for (size_t first = 0; first < 256;)
+                {
+                    if (!members[first])
+                    {
+                        ++first;
+                        continue;
+                    }
+                    auto last = first;
+                    while ((last + 1 < 256) && members[last + 1])
+                    {
+                        ++last;
+                    }
+
+                    // Once all the ranges are taken, a wider one replaces
+                    // the narrowest.
+                    auto slot = num_ranges;
+                    if (num_ranges < NUM_RANGES)
+                    {
+                        ++num_ranges;
+                    }
+                    else
+                    {
+                        slot = 0;
+                        for (size_t i = 1; i < NUM_RANGES; ++i)
+                        {
+                            if (range_span[i] < range_span[slot])
+                            {
+                                slot = i;
+                            }
+                        }
+                        if (range_span[slot] >= last - first)
+                        {
+                            slot = NUM_RANGES;
+                        }
+                    }
+                    if (slot < NUM_RANGES)
+                    {
+                        range_first[slot] = (uint8_t)first;
+                        range_span[slot] = (uint8_t)(last - first);
+                    }
+                    first = last + 1;
+                }
+                has_ranges = (num_ranges > 0);
+                for (size_t i = num_ranges; i < NUM_RANGES; ++i)
+                {
+                    range_first[i] = range_first[0];
+                    range_span[i] = range_span[0];
+                }
+                for (size_t i = 0; i < NUM_RANGES; ++i)
+                {
+                    range_first_bytes[i] = _mm_set1_epi8((char)range_first[i]);
+                    range_span_bytes[i] = _mm_set1_epi8((char)range_span[i]);
+                }
+            }
+
+            // A bit for each of the 16 characters at data that is in none
+            // of the ranges.
+            uint32_t MatchOutsideRanges(const char* data) const
+            {
+                const auto block = _mm_loadu_si128((const __m128i*)data);
+                auto inside = _mm_setzero_si128();
+                for (size_t i = 0; i < NUM_RANGES; ++i)
+                {
+                    // Unsigned: (c - first) <= span.
+                    const auto offset = _mm_sub_epi8(block, range_first_bytes[i]);
+                    const auto clamped = _mm_min_epu8(offset, range_span_bytes[i]);
+                    inside = _mm_or_si128(inside, _mm_cmpeq_epi8(offset, clamped));
+                }
+                return (uint32_t)_mm_movemask_epi8(inside) ^ 0xFFFF;
+            }
+#else
+            void FindRanges()
+            {
+            }
+#endif
         };
 
         CharacterSet::~CharacterSet()noexcept = default;
@@ -32,16 +145,18 @@ namespace Uri
         CharacterSet::CharacterSet(char c)
             : impl_(new Impl)
             {
-                (void)impl_->characters_set.insert(c);
+                impl_->Insert(c);
+                impl_->FindRanges();
             }
 
         CharacterSet::CharacterSet(char first, char last)
           : impl_(new Impl)
         {
-            for (char c = first; c < last + 1; ++c) 
+            for (int c = first; c < last + 1; ++c) 
             {
-                (void)impl_->characters_set.insert(c);
+                impl_->Insert((char)c);
             }
+            impl_->FindRanges();
         }
 
         CharacterSet::CharacterSet(std::initializer_list<const CharacterSet> sets)
@@ -51,15 +166,46 @@ namespace Uri
                       characterSet != sets.end();
                       ++characterSet) 
             {
-                impl_->characters_set.insert(
-                       characterSet->impl_->characters_set.begin(),
-                       characterSet->impl_->characters_set.end());
+                for (size_t i = 0; i < 256; ++i)
+                {
+                    impl_->members[i] |= characterSet->impl_->members[i];
+                }
             }
+            impl_->FindRanges();
         }
 
         bool CharacterSet::Contains(char c) const
         {
-            return impl_->characters_set.find(c) != impl_->characters_set.end();
+            return impl_->Contains(c);
+        }
+
+        size_t CharacterSet::CountLeading(std::string_view characters) const
+        {
+            const auto& impl = *impl_;
+            size_t count = 0;
+#if defined(__SSE2__)
+            if (impl.has_ranges)
+            {
+                for (; count + 16 <= characters.length(); count += 16)
+                {
+                    auto outside = impl.MatchOutsideRanges(characters.data() + count);
+                    while (outside != 0)
+                    {
+                        const auto position = count + (size_t)__builtin_ctz(outside);
+                        if (!impl.Contains(characters[position]))
+                        {
+                            return position;
+                        }
+                        outside &= outside - 1;
+                    }
+                }
+            }
+#endif
+            while ((count < characters.length()) && impl.Contains(characters[count]))
+            {
+                ++count;
+            }
+            return count;
         }
 
 }
\ No newline at end of file
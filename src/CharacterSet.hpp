@@ -3,6 +3,8 @@
 
 #include <initializer_list>
 #include <memory>
+#include <stddef.h>
+#include <string_view>
 
 namespace Uri
 {
@@ -21,6 +23,9 @@ namespace Uri
         CharacterSet(char, char);
         CharacterSet(std::initializer_list<const CharacterSet>);
         bool Contains(char) const;
+
+        // How many of the first characters are in the set.
+        size_t CountLeading(std::string_view) const;
     private:
         struct Impl;
         std::unique_ptr< Impl > impl_;
@@ -0,0 +1,220 @@
+#ifndef URI_CLOCK_CACHE_HPP
+#define URI_CLOCK_CACHE_HPP
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Uri
+{
+    // A sharded cache of values by key, looked up by the key's 64-bit
+    // hash.  Each shard is a CLOCK cache: a hit only sets the entry's
+    // referenced bit, so lookups share the shard lock, and the clock hand
+    // gives every referenced entry a second chance before evicting it.
+    // Entries are charged whatever the caller says they cost, and each
+    // shard keeps its charges within an equal part of the capacity.
+    template< typename Key, typename Value >
+    class ClockCache
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            size_t entries = 0;
+            size_t charge = 0;
+        };
+
+    private:
+        struct Slot
+        {
+            bool occupied = false;
+            mutable std::atomic< bool > referenced{false};
+            uint64_t hash = 0;
+            Key key;
+            Value value;
+            size_t charge = 0;
+        };
+
+    public:
+        // What each entry costs the cache besides its key and value.
+        static const size_t SLOT_SIZE = sizeof(Slot);
+
+        ClockCache(size_t capacity, size_t num_shards)
+        {
+            size_t rounded_num_shards = 1;
+            while (rounded_num_shards < num_shards)
+            {
+                rounded_num_shards *= 2;
+            }
+            shards_.resize(rounded_num_shards);
+            for (auto& shard: shards_)
+            {
+                shard.reset(new Shard);
+                shard->capacity = capacity / shards_.size();
+            }
+        }
+
+        // Copies the value cached for a key equal to probe, if any, into
+        // value.
+        template< typename Probe >
+        bool Find(uint64_t hash, const Probe& probe, Value& value) const
+        {
+            auto& shard = ShardFor(hash);
+            {
+                std::shared_lock< std::shared_mutex > lock(shard.mutex);
+                const auto entry = shard.index.find(hash);
+                if ((entry != shard.index.end())
+                    && (shard.slots[entry->second].key == probe))
+                {
+                    const auto& slot = shard.slots[entry->second];
+                    slot.referenced.store(true, std::memory_order_relaxed);
+                    value = slot.value;
+                    shard.hits.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            shard.misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Caches value for key, evicting as needed, unless its charge alone
+        // exceeds the shard's part of the capacity.  Returns the value
+        // cached for key, which is an earlier one if another thread got
+        // there first.
+        Value Insert(uint64_t hash, Key key, Value value, size_t charge)
+        {
+            auto& shard = ShardFor(hash);
+            std::unique_lock< std::shared_mutex > lock(shard.mutex);
+            const auto entry = shard.index.find(hash);
+            if (entry != shard.index.end())
+            {
+                const auto& slot = shard.slots[entry->second];
+                if (slot.key == key)
+                {
+                    return slot.value;
+                }
+                shard.Evict(entry->second);
+            }
+            if (charge > shard.capacity)
+            {
+                return value;
+            }
+            while ((shard.charge + charge > shard.capacity) && !shard.index.empty())
+            {
+                auto& slot = shard.slots[shard.hand];
+                const auto candidate = shard.hand;
+                shard.hand = (shard.hand + 1) % shard.slots.size();
+                if (!slot.occupied)
+                {
+                    continue;
+                }
+                if (slot.referenced.exchange(false, std::memory_order_relaxed))
+                {
+                    continue;
+                }
+                shard.Evict(candidate);
+            }
+            size_t position;
+            if (shard.free_slots.empty())
+            {
+                position = shard.slots.size();
+                shard.slots.emplace_back();
+            }
+            else
+            {
+                position = shard.free_slots.back();
+                shard.free_slots.pop_back();
+            }
+            auto& slot = shard.slots[position];
+            slot.occupied = true;
+            slot.referenced.store(false, std::memory_order_relaxed);
+            slot.hash = hash;
+            slot.key = std::move(key);
+            slot.value = std::move(value);
+            slot.charge = charge;
+            shard.index[hash] = position;
+            shard.charge += charge;
+            return slot.value;
+        }
+
+        void Clear()
+        {
+            for (auto& shard: shards_)
+            {
+                std::unique_lock< std::shared_mutex > lock(shard->mutex);
+                shard->slots.clear();
+                shard->free_slots.clear();
+                shard->index.clear();
+                shard->hand = 0;
+                shard->charge = 0;
+            }
+        }
+
+        Statistics GetStatistics() const
+        {
+            Statistics statistics;
+            for (const auto& shard: shards_)
+            {
+                statistics.hits += shard->hits.load(std::memory_order_relaxed);
+                statistics.misses += shard->misses.load(std::memory_order_relaxed);
+                statistics.evictions += shard->evictions.load(std::memory_order_relaxed);
+                std::shared_lock< std::shared_mutex > lock(shard->mutex);
+                statistics.entries += shard->index.size();
+                statistics.charge += shard->charge;
+            }
+            return statistics;
+        }
+
+    private:
+        struct Shard
+        {
+            mutable std::shared_mutex mutex;
+            std::deque< Slot > slots;
+            std::vector< size_t > free_slots;
+            std::unordered_map< uint64_t, size_t > index;
+            size_t hand = 0;
+            size_t charge = 0;
+            size_t capacity = 0;
+            mutable std::atomic< uint64_t > hits{0};
+            mutable std::atomic< uint64_t > misses{0};
+            std::atomic< uint64_t > evictions{0};
+
+            void Evict(size_t position)
+            {
+                auto& slot = slots[position];
+                (void)index.erase(slot.hash);
+                charge -= slot.charge;
+                slot.occupied = false;
+                // Swapped out rather than assigned, so that their memory is
+                // released now.
+                Key released_key;
+                Value released_value;
+                std::swap(slot.key, released_key);
+                std::swap(slot.value, released_value);
+                free_slots.push_back(position);
+                evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+        };
+
+        Shard& ShardFor(uint64_t hash) const
+        {
+            return *shards_[(size_t)(hash >> 32) & (shards_.size() - 1)];
+        }
+
+        std::vector< std::unique_ptr< Shard > > shards_;
+    };
+
+    template< typename Key, typename Value >
+    const size_t ClockCache< Key, Value >::SLOT_SIZE;
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef URI_COPY_ON_WRITE_HPP
+#define URI_COPY_ON_WRITE_HPP
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace Uri
+{
+    // A value shared between copies until one of them writes to it.
+    // Empty values share one instance, so they cost no allocation; T is a
+    // container such as std::string.
+    template< typename T >
+    class CopyOnWrite
+    {
+    public:
+        CopyOnWrite()
+            : value_(Empty())
+        {
+        }
+
+        CopyOnWrite& operator=(T value)
+        {
+            if (Unique())
+            {
+                *value_ = std::move(value);
+            }
+            else if (value.empty())
+            {
+                value_ = Empty();
+            }
+            else
+            {
+                value_ = std::make_shared< T >(std::move(value));
+            }
+            return *this;
+        }
+
+        bool operator==(const CopyOnWrite& other) const
+        {
+            return (value_ == other.value_) || (*value_ == *other.value_);
+        }
+
+        bool operator!=(const CopyOnWrite& other) const
+        {
+            return !(*this == other);
+        }
+
+        const T& operator*() const
+        {
+            return *value_;
+        }
+
+        const T* operator->() const
+        {
+            return value_.get();
+        }
+
+        // The value, copied first if it is shared.
+        T& Write()
+        {
+            if (!Unique())
+            {
+                value_ = std::make_shared< T >(*value_);
+            }
+            return *value_;
+        }
+
+        // A value of this copy's own, for replacing the contents
+        // entirely; its current contents are unspecified.
+        T& Overwrite()
+        {
+            if (!Unique())
+            {
+                value_ = std::make_shared< T >();
+            }
+            return *value_;
+        }
+
+        // Moves the value out if this copy is its only owner, otherwise
+        // copies it, leaving this copy empty either way.
+        T Take()
+        {
+            T value = Unique() ? std::move(*value_) : *value_;
+            Clear();
+            return value;
+        }
+
+        void Clear()
+        {
+            value_ = Empty();
+        }
+
+        bool SharesWith(const CopyOnWrite& other) const
+        {
+            return (value_ == other.value_);
+        }
+
+    private:
+        bool Unique() const
+        {
+            if (value_.use_count() != 1)
+            {
+                return false;
+            }
+            // Pairs with the release in another copy's destructor, so its
+            // last reads of the value happen before this copy writes.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+
+        static const std::shared_ptr< T >& Empty()
+        {
+            static const auto empty = std::make_shared< T >();
+            return empty;
+        }
+
+        std::shared_ptr< T > value_;
+    };
+}
+
+#endif
@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+#include <Uri/DataUri.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Marks a character outside the base64 alphabet, '=' included, in
+    // BASE64_VALUES.
+    const uint8_t INVALID = 0x80;
+
+    struct Base64Values
+    {
+        uint8_t values[256];
+
+        Base64Values()
+        {
+            static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            memset(values, INVALID, sizeof(values));
+            for (uint8_t i = 0; i < 64; ++i)
+            {
+                values[(uint8_t)ALPHABET[i]] = i;
+            }
+        }
+    };
+
+    const Base64Values BASE64_VALUES;
+
+#if defined(__SSE2__)
+    // Whether each character of block is in [first, last], all within
+    // ASCII, so that the signed comparisons see them in order.
+    __m128i InRange(__m128i block, char first, char last)
+    {
+        return _mm_and_si128(
+            _mm_cmpgt_epi8(block, _mm_set1_epi8((char)(first - 1))),
+            _mm_cmplt_epi8(block, _mm_set1_epi8((char)(last + 1)))
+        );
+    }
+
+    // Decodes 16 base64 characters, none of them padding, into 12 bytes,
+    // or returns false without writing anything if any is invalid.  Writes
+    // 14 bytes; the last 2 are garbage.
+    bool DecodeBlock(const char* characters, char* buffer)
+    {
+        const auto block = _mm_loadu_si128((const __m128i*)characters);
+        const auto upper = InRange(block, 'A', 'Z');
+        const auto lower = InRange(block, 'a', 'z');
+        const auto digit = InRange(block, '0', '9');
+        const auto plus = _mm_cmpeq_epi8(block, _mm_set1_epi8('+'));
+        const auto slash = _mm_cmpeq_epi8(block, _mm_set1_epi8('/'));
+        const auto valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+        {
+            return false;
+        }
+        auto values = _mm_and_si128(upper, _mm_sub_epi8(block, _mm_set1_epi8('A')));
+        values = _mm_or_si128(values, _mm_and_si128(lower, _mm_sub_epi8(block, _mm_set1_epi8('a' - 26))));
+        values = _mm_or_si128(values, _mm_and_si128(digit, _mm_add_epi8(block, _mm_set1_epi8(52 - '0'))));
+        values = _mm_or_si128(values, _mm_and_si128(plus, _mm_set1_epi8(62)));
+        values = _mm_or_si128(values, _mm_and_si128(slash, _mm_set1_epi8(63)));
+
+        // Pairs of 6-bit values into 12 bits per 16-bit lane, then pairs of
+        // those into 24 bits per 32-bit lane, most significant byte first.
+        const auto pairs = _mm_or_si128(
+            _mm_slli_epi16(_mm_and_si128(values, _mm_set1_epi16(0x00FF)), 6),
+            _mm_srli_epi16(values, 8)
+        );
+        const auto quads = _mm_or_si128(
+            _mm_slli_epi32(_mm_and_si128(pairs, _mm_set1_epi32(0x0000FFFF)), 12),
+            _mm_srli_epi32(pairs, 16)
+        );
+
+        // Into memory order, then the two quads of each 64-bit lane next
+        // to each other.
+        const auto bytes = _mm_or_si128(
+            _mm_or_si128(_mm_srli_epi32(quads, 16), _mm_and_si128(quads, _mm_set1_epi32(0x0000FF00))),
+            _mm_slli_epi32(_mm_and_si128(quads, _mm_set1_epi32(0x000000FF)), 16)
+        );
+        const auto low_quads = _mm_set_epi32(0, -1, 0, -1);
+        const auto packed = _mm_or_si128(
+            _mm_and_si128(bytes, low_quads),
+            _mm_srli_epi64(_mm_andnot_si128(low_quads, bytes), 8)
+        );
+        _mm_storel_epi64((__m128i*)buffer, packed);
+        _mm_storel_epi64((__m128i*)(buffer + 6), _mm_unpackhi_epi64(packed, packed));
+        return true;
+    }
+#endif
+
+    char ToLowerAscii(char c)
+    {
+        return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+    }
+
+    bool EqualsIgnoringCase(std::string_view a, std::string_view b)
+    {
+        if (a.length() != b.length())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.length(); ++i)
+        {
+            if (ToLowerAscii(a[i]) != ToLowerAscii(b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int HexValue(char c)
+    {
+        if ((c >= '0') && (c <= '9'))
+        {
+            return c - '0';
+        }
+        if ((c >= 'A') && (c <= 'F'))
+        {
+            return c - 'A' + 10;
+        }
+        if ((c >= 'a') && (c <= 'f'))
+        {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+}
+
+namespace Uri
+{
+    struct DataUri::Impl
+    {
+        std::string_view media_type;
+        size_t num_parameters = 0;
+        Parameter parameters[MAX_PARAMETERS];
+        bool is_base64 = false;
+        std::string_view payload;
+    };
+
+    const size_t DataUri::MAX_PARAMETERS;
+
+    DataUri::~DataUri() noexcept = default;
+    DataUri::DataUri(const DataUri& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    DataUri::DataUri(DataUri&&) noexcept = default;
+    DataUri& DataUri::operator=(const DataUri& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    DataUri& DataUri::operator=(DataUri&&) noexcept = default;
+
+    DataUri::DataUri()
+        : impl_(new Impl)
+    {
+    }
+
+    bool DataUri::ParseFromString(std::string_view uri_string)
+    {
+        if (!EqualsIgnoringCase(uri_string.substr(0, 5), "data:"))
+        {
+            return false;
+        }
+        uri_string.remove_prefix(5);
+        const auto comma = uri_string.find(',');
+        if (comma == std::string_view::npos)
+        {
+            return false;
+        }
+        Impl parsed;
+        auto header = uri_string.substr(0, comma);
+        auto payload = uri_string.substr(comma + 1);
+        payload = payload.substr(0, payload.find('#'));
+        auto parameter_start = header.find(';');
+        parsed.media_type = header.substr(0, parameter_start);
+        if (!parsed.media_type.empty())
+        {
+            const auto slash = parsed.media_type.find('/');
+            if ((slash == 0)
+                || (slash == std::string_view::npos)
+                || (slash + 1 == parsed.media_type.length()))
+            {
+                return false;
+            }
+        }
+        while (parameter_start != std::string_view::npos)
+        {
+            header.remove_prefix(parameter_start + 1);
+            parameter_start = header.find(';');
+            const auto parameter = header.substr(0, parameter_start);
+            const auto equals = parameter.find('=');
+            if (equals == std::string_view::npos)
+            {
+                // Only the last may lack a value, and only if it's "base64".
+                if ((parameter_start != std::string_view::npos)
+                    || !EqualsIgnoringCase(parameter, "base64"))
+                {
+                    return false;
+                }
+                parsed.is_base64 = true;
+                break;
+            }
+            if ((equals == 0) || (parsed.num_parameters == MAX_PARAMETERS))
+            {
+                return false;
+            }
+            auto& new_parameter = parsed.parameters[parsed.num_parameters++];
+            new_parameter.name = parameter.substr(0, equals);
+            new_parameter.value = parameter.substr(equals + 1);
+        }
+        parsed.payload = payload;
+        *impl_ = parsed;
+        return true;
+    }
+
+    std::string_view DataUri::GetMediaType() const
+    {
+        return (impl_->media_type.empty() ? "text/plain" : impl_->media_type);
+    }
+
+    size_t DataUri::GetNumParameters() const
+    {
+        return impl_->num_parameters;
+    }
+
+    const DataUri::Parameter& DataUri::GetParameter(size_t index) const
+    {
+        return impl_->parameters[index];
+    }
+
+    std::string_view DataUri::GetParameter(std::string_view name) const
+    {
+        for (size_t i = 0; i < impl_->num_parameters; ++i)
+        {
+            if (EqualsIgnoringCase(impl_->parameters[i].name, name))
+            {
+                return impl_->parameters[i].value;
+            }
+        }
+        return std::string_view();
+    }
+
+    bool DataUri::IsBase64() const
+    {
+        return impl_->is_base64;
+    }
+
+    std::string_view DataUri::GetPayload() const
+    {
+        return impl_->payload;
+    }
+
+    size_t DataUri::GetMaxDecodedLength() const
+    {
+        const auto length = impl_->payload.length();
+        if (impl_->is_base64)
+        {
+            return length / 4 * 3 + (length % 4) * 3 / 4;
+        }
+        return length;
+    }
+
+    struct DataUriDecoder::Impl
+    {
+        // What is left to decode.
+        std::string_view input;
+
+        bool is_base64 = false;
+        bool failed = false;
+
+        // The bytes of a base64 quantum that didn't fit in the last
+        // buffer.
+        char pending[3];
+        size_t pending_start = 0;
+        size_t pending_end = 0;
+
+        // Decodes the next base64 quantum, which may be the last one,
+        // short or padded, into pending.
+        bool DecodeQuantum()
+        {
+            const auto quantum = input.substr(0, 4);
+            size_t length = quantum.length();
+            if (quantum.length() == 4)
+            {
+                if (quantum[3] == '=')
+                {
+                    length = ((quantum[2] == '=') ? 2 : 3);
+                }
+                if ((length < 4) && (input.length() > 4))
+                {
+                    return false;
+                }
+            }
+            if (length < 2)
+            {
+                return false;
+            }
+            uint32_t bits = 0;
+            for (size_t i = 0; i < length; ++i)
+            {
+                const auto value = BASE64_VALUES.values[(uint8_t)quantum[i]];
+                if (value == INVALID)
+                {
+                    return false;
+                }
+                bits = (bits << 6) | value;
+            }
+            bits <<= 6 * (4 - length);
+            pending[0] = (char)(bits >> 16);
+            pending[1] = (char)(bits >> 8);
+            pending[2] = (char)bits;
+            pending_start = 0;
+            pending_end = length - 1;
+            input.remove_prefix(quantum.length());
+            return true;
+        }
+
+        // Decodes as many whole 8-character groups, without padding, as
+        // fit, looking up all 8 before checking any, and writing 6 bytes
+        // at once; with SSE2, 16-character blocks go first.  Stops short
+        // at anything else, for DecodeQuantum.
+        size_t DecodeGroups(char* buffer, size_t capacity)
+        {
+            size_t written = 0;
+#if defined(__SSE2__)
+            while ((input.length() >= 16)
+                && (capacity - written >= 14)
+                && DecodeBlock(input.data(), buffer + written))
+            {
+                written += 12;
+                input.remove_prefix(16);
+            }
+#endif
+            while ((input.length() >= 8) && (capacity - written >= 6))
+            {
+                const auto* characters = (const uint8_t*)input.data();
+                uint64_t bits = 0;
+                uint8_t invalid = 0;
+                for (size_t i = 0; i < 8; ++i)
+                {
+                    const auto value = BASE64_VALUES.values[characters[i]];
+                    invalid |= value;
+                    bits = (bits << 6) | value;
+                }
+                if (invalid & INVALID)
+                {
+                    break;
+                }
+                for (size_t i = 0; i < 6; ++i)
+                {
+                    buffer[written + i] = (char)(bits >> (40 - 8 * i));
+                }
+                written += 6;
+                input.remove_prefix(8);
+            }
+            return written;
+        }
+
+        bool ReadBase64(char* buffer, size_t capacity, size_t& written)
+        {
+            for (;;)
+            {
+                const auto from_pending = std::min(capacity - written, pending_end - pending_start);
+                memcpy(buffer + written, pending + pending_start, from_pending);
+                written += from_pending;
+                pending_start += from_pending;
+                written += DecodeGroups(buffer + written, capacity - written);
+                if ((written == capacity) || input.empty())
+                {
+                    return true;
+                }
+                if (!DecodeQuantum())
+                {
+                    return false;
+                }
+            }
+        }
+
+        bool ReadPercentEncoded(char* buffer, size_t capacity, size_t& written)
+        {
+            while ((written < capacity) && !input.empty())
+            {
+                if (input[0] == '%')
+                {
+                    const auto high = ((input.length() >= 3) ? HexValue(input[1]) : -1);
+                    const auto low = ((high >= 0) ? HexValue(input[2]) : -1);
+                    if (low < 0)
+                    {
+                        return false;
+                    }
+                    buffer[written++] = (char)((high << 4) | low);
+                    input.remove_prefix(3);
+                    continue;
+                }
+                auto run = std::min(capacity - written, input.length());
+                const auto* percent = (const char*)memchr(input.data(), '%', run);
+                if (percent != nullptr)
+                {
+                    run = (size_t)(percent - input.data());
+                }
+                memcpy(buffer + written, input.data(), run);
+                written += run;
+                input.remove_prefix(run);
+            }
+            return true;
+        }
+    };
+
+    DataUriDecoder::~DataUriDecoder() noexcept = default;
+    DataUriDecoder::DataUriDecoder(const DataUriDecoder& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    DataUriDecoder::DataUriDecoder(DataUriDecoder&&) noexcept = default;
+    DataUriDecoder& DataUriDecoder::operator=(const DataUriDecoder& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    DataUriDecoder& DataUriDecoder::operator=(DataUriDecoder&&) noexcept = default;
+
+    DataUriDecoder::DataUriDecoder(const DataUri& data_uri)
+        : impl_(new Impl)
+    {
+        impl_->input = data_uri.GetPayload();
+        impl_->is_base64 = data_uri.IsBase64();
+    }
+
+    bool DataUriDecoder::Read(char* buffer, size_t capacity, size_t& written)
+    {
+        written = 0;
+        if (impl_->failed)
+        {
+            return false;
+        }
+        const auto ok = (
+            impl_->is_base64
+            ? impl_->ReadBase64(buffer, capacity, written)
+            : impl_->ReadPercentEncoded(buffer, capacity, written)
+        );
+        impl_->failed = !ok;
+        return ok;
+    }
+
+    bool DataUriDecoder::Done() const
+    {
+        return (
+            !impl_->failed
+            && impl_->input.empty()
+            && (impl_->pending_start == impl_->pending_end)
+        );
+    }
+}
@@ -0,0 +1,418 @@
+#include "CharacterSet.hpp"
+#include <stdint.h>
+#include <Uri/FormCodec.hpp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    // What the form encoding leaves alone; everything else but the space
+    // is percent-encoded.  Built from ranges rather than ALPHA and DIGIT,
+    // which live in another translation unit and may not be constructed
+    // yet.
+    const Uri::CharacterSet FORM_NOT_PCT_ENCODED{
+        Uri::CharacterSet('a', 'z'),
+        Uri::CharacterSet('A', 'Z'),
+        Uri::CharacterSet('0', '9'),
+        '*', '-', '.', '_',
+    };
+
+    bool IsSpecial(char c)
+    {
+        return (c == '&') || (c == '=') || (c == '+') || (c == '%');
+    }
+
+    // Where the first '&', '=', '+' or '%' is, or length if there is
+    // none.  Everything before it is copied through unchanged.
+    size_t FindSpecial(const char* data, size_t length)
+    {
+        size_t i = 0;
+#if defined(__SSE2__)
+        const auto ampersand = _mm_set1_epi8('&');
+        const auto equals = _mm_set1_epi8('=');
+        const auto plus = _mm_set1_epi8('+');
+        const auto percent = _mm_set1_epi8('%');
+        for (; i + 16 <= length; i += 16)
+        {
+            const auto block = _mm_loadu_si128((const __m128i*)(data + i));
+            const auto matches = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(block, ampersand), _mm_cmpeq_epi8(block, equals)),
+                _mm_or_si128(_mm_cmpeq_epi8(block, plus), _mm_cmpeq_epi8(block, percent))
+            );
+            const auto mask = (uint32_t)_mm_movemask_epi8(matches);
+            if (mask != 0)
+            {
+                return i + (size_t)__builtin_ctz(mask);
+            }
+        }
+#endif
+        for (; i < length; ++i)
+        {
+            if (IsSpecial(data[i]))
+            {
+                break;
+            }
+        }
+        return i;
+    }
+
+    int HexValue(char c)
+    {
+        if ((c >= '0') && (c <= '9'))
+        {
+            return c - '0';
+        }
+        if ((c >= 'A') && (c <= 'F'))
+        {
+            return c - 'A' + 10;
+        }
+        if ((c >= 'a') && (c <= 'f'))
+        {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    char MakeHexDigit(unsigned int value)
+    {
+        return (char)((value < 10) ? (value + '0') : (value - 10 + 'A'));
+    }
+
+    // Decodes the pairs of form, which must hold whole pairs, appending
+    // them to pairs and their text to storage.  Storage must already have
+    // room for form, so that it never moves under the views.
+    void DecodePairs(std::string_view form,
+                     std::vector< Uri::FormPair >& pairs,
+                     std::string& storage)
+    {
+        size_t pair_start = 0;
+        size_t name_start = storage.length();
+        size_t name_end = 0;
+        bool in_value = false;
+        const auto end_pair = [&](size_t position)
+        {
+            if (position != pair_start)
+            {
+                const auto* text = storage.data();
+                Uri::FormPair pair;
+                if (in_value)
+                {
+                    pair.name = std::string_view(text + name_start, name_end - name_start);
+                    pair.value = std::string_view(text + name_end, storage.length() - name_end);
+                }
+                else
+                {
+                    pair.name = std::string_view(text + name_start, storage.length() - name_start);
+                }
+                pairs.push_back(pair);
+            }
+            pair_start = position + 1;
+            name_start = storage.length();
+            in_value = false;
+        };
+        size_t position = 0;
+        for (;;)
+        {
+            const auto run_length = FindSpecial(form.data() + position, form.length() - position);
+            storage.append(form.data() + position, run_length);
+            position += run_length;
+            if (position == form.length())
+            {
+                break;
+            }
+            switch (form[position])
+            {
+                case '&':
+                {
+                    end_pair(position);
+                } break;
+
+                case '=':
+                {
+                    if (in_value)
+                    {
+                        storage.push_back('=');
+                    }
+                    else
+                    {
+                        name_end = storage.length();
+                        in_value = true;
+                    }
+                } break;
+
+                case '+':
+                {
+                    storage.push_back(' ');
+                } break;
+
+                default:
+                {
+                    const auto high = (position + 2 < form.length()) ? HexValue(form[position + 1]) : -1;
+                    const auto low = (high >= 0) ? HexValue(form[position + 2]) : -1;
+                    if (low >= 0)
+                    {
+                        storage.push_back((char)((high << 4) | low));
+                        position += 2;
+                    }
+                    else
+                    {
+                        storage.push_back('%');
+                    }
+                } break;
+            }
+            ++position;
+        }
+        end_pair(position);
+    }
+
+    size_t EncodedElementLength(std::string_view element)
+    {
+        auto length = element.length();
+        while (!element.empty())
+        {
+            element.remove_prefix(FORM_NOT_PCT_ENCODED.CountLeading(element));
+            if (!element.empty())
+            {
+                if (element[0] != ' ')
+                {
+                    length += 2;
+                }
+                element.remove_prefix(1);
+            }
+        }
+        return length;
+    }
+
+    void AppendEncodedElement(std::string& form, std::string_view element)
+    {
+        while (!element.empty())
+        {
+            const auto run_length = FORM_NOT_PCT_ENCODED.CountLeading(element);
+            form.append(element.data(), run_length);
+            element.remove_prefix(run_length);
+            if (element.empty())
+            {
+                break;
+            }
+            const auto c = (uint8_t)element[0];
+            element.remove_prefix(1);
+            if (c == ' ')
+            {
+                form.push_back('+');
+            }
+            else
+            {
+                form.push_back('%');
+                form.push_back(MakeHexDigit((unsigned int)c >> 4));
+                form.push_back(MakeHexDigit((unsigned int)c & 0x0F));
+            }
+        }
+    }
+
+    size_t EncodedPairLength(std::string_view name, std::string_view value)
+    {
+        return EncodedElementLength(name) + 1 + EncodedElementLength(value);
+    }
+
+    void AppendEncodedPair(std::string& form, std::string_view name, std::string_view value, bool first)
+    {
+        if (!first)
+        {
+            form.push_back('&');
+        }
+        AppendEncodedElement(form, name);
+        form.push_back('=');
+        AppendEncodedElement(form, value);
+    }
+}
+
+namespace Uri
+{
+    struct FormDecoder::Impl
+    {
+        // The raw text of the pair cut off at the end of the last chunk.
+        std::string held_back;
+    };
+
+    FormDecoder::~FormDecoder() noexcept = default;
+    FormDecoder::FormDecoder(const FormDecoder& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    FormDecoder::FormDecoder(FormDecoder&&) noexcept = default;
+    FormDecoder& FormDecoder::operator=(const FormDecoder& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    FormDecoder& FormDecoder::operator=(FormDecoder&&) noexcept = default;
+
+    FormDecoder::FormDecoder()
+        : impl_(new Impl)
+    {
+    }
+
+    void FormDecoder::Decode(std::string_view chunk,
+                             std::vector< FormPair >& pairs,
+                             std::string& storage)
+    {
+        pairs.clear();
+        storage.clear();
+        const auto last_ampersand = chunk.rfind('&');
+        if (last_ampersand == std::string_view::npos)
+        {
+            impl_->held_back.append(chunk);
+            return;
+        }
+        storage.reserve(impl_->held_back.length() + last_ampersand);
+
+        // Only the first pair of the chunk can be partly held back; the
+        // rest is decoded straight from the chunk.
+        const auto first_ampersand = chunk.find('&');
+        impl_->held_back.append(chunk.substr(0, first_ampersand));
+        DecodePairs(impl_->held_back, pairs, storage);
+        if (last_ampersand > first_ampersand)
+        {
+            DecodePairs(chunk.substr(first_ampersand + 1, last_ampersand - first_ampersand - 1), pairs, storage);
+        }
+        impl_->held_back.assign(chunk.substr(last_ampersand + 1));
+    }
+
+    void FormDecoder::Finish(std::vector< FormPair >& pairs, std::string& storage)
+    {
+        pairs.clear();
+        storage.clear();
+        storage.reserve(impl_->held_back.length());
+        DecodePairs(impl_->held_back, pairs, storage);
+        impl_->held_back.clear();
+    }
+
+    void FormDecoder::DecodeAll(std::string_view form,
+                                std::vector< FormPair >& pairs,
+                                std::string& storage)
+    {
+        pairs.clear();
+        storage.clear();
+        storage.reserve(form.length());
+        DecodePairs(form, pairs, storage);
+    }
+
+    struct FormBuilder::Impl
+    {
+        struct Pair
+        {
+            size_t name_offset = 0;
+            size_t name_length = 0;
+            size_t value_length = 0;
+        };
+
+        // The names and values added, unencoded, back to back.
+        std::string text;
+
+        std::vector< Pair > pairs;
+        size_t encoded_length = 0;
+    };
+
+    FormBuilder::~FormBuilder() noexcept = default;
+    FormBuilder::FormBuilder(const FormBuilder& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    FormBuilder::FormBuilder(FormBuilder&&) noexcept = default;
+    FormBuilder& FormBuilder::operator=(const FormBuilder& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    FormBuilder& FormBuilder::operator=(FormBuilder&&) noexcept = default;
+
+    FormBuilder::FormBuilder()
+        : impl_(new Impl)
+    {
+    }
+
+    void FormBuilder::Add(std::string_view name, std::string_view value)
+    {
+        Impl::Pair pair;
+        pair.name_offset = impl_->text.length();
+        pair.name_length = name.length();
+        pair.value_length = value.length();
+        impl_->text.append(name);
+        impl_->text.append(value);
+        if (!impl_->pairs.empty())
+        {
+            ++impl_->encoded_length;
+        }
+        impl_->encoded_length += EncodedPairLength(name, value);
+        impl_->pairs.push_back(pair);
+    }
+
+    size_t FormBuilder::Size() const
+    {
+        return impl_->pairs.size();
+    }
+
+    void FormBuilder::Clear()
+    {
+        impl_->text.clear();
+        impl_->pairs.clear();
+        impl_->encoded_length = 0;
+    }
+
+    size_t FormBuilder::EncodedLength() const
+    {
+        return impl_->encoded_length;
+    }
+
+    std::string FormBuilder::Build() const
+    {
+        std::string form;
+        AppendTo(form);
+        return form;
+    }
+
+    void FormBuilder::AppendTo(std::string& form) const
+    {
+        form.reserve(form.length() + impl_->encoded_length);
+        const std::string_view text(impl_->text);
+        bool first = true;
+        for (const auto& pair: impl_->pairs)
+        {
+            AppendEncodedPair(
+                form,
+                text.substr(pair.name_offset, pair.name_length),
+                text.substr(pair.name_offset + pair.name_length, pair.value_length),
+                first
+            );
+            first = false;
+        }
+    }
+
+    size_t FormBuilder::EncodedLength(const std::vector< FormPair >& pairs)
+    {
+        size_t length = (pairs.empty() ? 0 : pairs.size() - 1);
+        for (const auto& pair: pairs)
+        {
+            length += EncodedPairLength(pair.name, pair.value);
+        }
+        return length;
+    }
+
+    void FormBuilder::Encode(const std::vector< FormPair >& pairs, std::string& form)
+    {
+        form.reserve(form.length() + EncodedLength(pairs));
+        bool first = true;
+        for (const auto& pair: pairs)
+        {
+            AppendEncodedPair(form, pair.name, pair.value, first);
+            first = false;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#include "Hash.hpp"
+#include <string.h>
+
+namespace
+{
+    const uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+
+    uint64_t RotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t Finalize(uint64_t value)
+    {
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDULL;
+        value ^= value >> 33;
+        value *= 0xC4CEB9FE1A85EC53ULL;
+        value ^= value >> 33;
+        return value;
+    }
+
+    uint64_t ReadWord(const char* data, size_t length)
+    {
+        uint64_t word = 0;
+        memcpy(&word, data, length);
+        return word;
+    }
+
+    void HashLanes(std::string_view data, uint64_t& lane_1, uint64_t& lane_2)
+    {
+        size_t i = 0;
+        for (; i + 8 <= data.size(); i += 8)
+        {
+            const auto word = ReadWord(data.data() + i, 8);
+            lane_1 = RotateLeft(lane_1 ^ (word * PRIME_2), 31) * PRIME_1;
+            lane_2 = RotateLeft(lane_2 + (word * PRIME_3), 27) * PRIME_2;
+        }
+        if (i < data.size())
+        {
+            const auto word = ReadWord(data.data() + i, data.size() - i);
+            lane_1 = RotateLeft(lane_1 ^ (word * PRIME_2), 31) * PRIME_1;
+            lane_2 = RotateLeft(lane_2 + (word * PRIME_3), 27) * PRIME_2;
+        }
+        lane_1 ^= (uint64_t)data.size();
+        lane_2 += (uint64_t)data.size() * PRIME_3;
+    }
+}
+
+namespace Uri
+{
+    uint64_t HashString64(std::string_view data, uint64_t seed)
+    {
+        uint64_t lane_1 = seed + PRIME_1;
+        uint64_t lane_2 = seed ^ PRIME_2;
+        HashLanes(data, lane_1, lane_2);
+        return Finalize(lane_1 ^ RotateLeft(lane_2, 17));
+    }
+
+    Hash128 HashString128(std::string_view data)
+    {
+        uint64_t lane_1 = PRIME_1;
+        uint64_t lane_2 = PRIME_2;
+        HashLanes(data, lane_1, lane_2);
+        Hash128 hash;
+        hash.low = Finalize(lane_1 + lane_2);
+        hash.high = Finalize(lane_2 ^ RotateLeft(lane_1, 29));
+        return hash;
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef URI_HASH_HPP
+#define URI_HASH_HPP
+
+#include <stdint.h>
+#include <string_view>
+
+namespace Uri
+{
+    struct Hash128
+    {
+        uint64_t low = 0;
+        uint64_t high = 0;
+    };
+
+    uint64_t HashString64(std::string_view data, uint64_t seed = 0);
+    Hash128 HashString128(std::string_view data);
+}
+
+#endif
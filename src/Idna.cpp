@@ -0,0 +1,486 @@
+#include "ClockCache.hpp"
+#include "Hash.hpp"
+#include "Utf8.hpp"
+#include <Uri/Idna.hpp>
+
+namespace
+{
+    // RFC 3492 section 5.
+    const uint32_t BASE = 36;
+    const uint32_t TMIN = 1;
+    const uint32_t TMAX = 26;
+    const uint32_t SKEW = 38;
+    const uint32_t DAMP = 700;
+    const uint32_t INITIAL_BIAS = 72;
+    const uint32_t INITIAL_N = 128;
+    const uint32_t MAX_VALUE = UINT32_MAX;
+
+    const std::string_view ACE_PREFIX = "xn--";
+    const size_t MAX_LABEL_LENGTH = 63;
+
+    // UTF-8 for the full stops RFC 3490 section 3.1 treats like '.'.
+    const std::string_view IDEOGRAPHIC_FULL_STOPS[] = {
+        "\xE3\x80\x82",
+        "\xEF\xBC\x8E",
+        "\xEF\xBD\xA1",
+    };
+
+    uint32_t Adapt(uint32_t delta, uint32_t num_points, bool first_time)
+    {
+        delta = first_time ? (delta / DAMP) : (delta / 2);
+        delta += delta / num_points;
+        uint32_t k = 0;
+        while (delta > ((BASE - TMIN) * TMAX) / 2)
+        {
+            delta /= BASE - TMIN;
+            k += BASE;
+        }
+        return k + (BASE - TMIN + 1) * delta / (delta + SKEW);
+    }
+
+    uint32_t Threshold(uint32_t k, uint32_t bias)
+    {
+        if (k <= bias)
+        {
+            return TMIN;
+        }
+        if (k >= bias + TMAX)
+        {
+            return TMAX;
+        }
+        return k - bias;
+    }
+
+    char EncodeDigit(uint32_t digit)
+    {
+        return (char)((digit < 26) ? ('a' + digit) : ('0' + digit - 26));
+    }
+
+    // BASE if c is not a Punycode digit.
+    uint32_t DecodeDigit(char c)
+    {
+        if ((c >= 'a') && (c <= 'z'))
+        {
+            return (uint32_t)(c - 'a');
+        }
+        if ((c >= 'A') && (c <= 'Z'))
+        {
+            return (uint32_t)(c - 'A');
+        }
+        if ((c >= '0') && (c <= '9'))
+        {
+            return (uint32_t)(c - '0' + 26);
+        }
+        return BASE;
+    }
+
+    char ToLowerAscii(char c)
+    {
+        return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+    }
+
+    bool HasAcePrefix(std::string_view label)
+    {
+        if (label.length() < ACE_PREFIX.length())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < ACE_PREFIX.length(); ++i)
+        {
+            if (ToLowerAscii(label[i]) != ACE_PREFIX[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // True for hosts that are already in both forms: all ASCII and no label
+    // to decode.
+    bool IsPlainAscii(std::string_view host)
+    {
+        if (Uri::CountLeadingAscii(host) != host.length())
+        {
+            return false;
+        }
+        for (size_t label_start = 0;;)
+        {
+            if (HasAcePrefix(host.substr(label_start)))
+            {
+                return false;
+            }
+            const auto label_end = host.find('.', label_start);
+            if (label_end == std::string_view::npos)
+            {
+                return true;
+            }
+            label_start = label_end + 1;
+        }
+    }
+
+    void AppendLowerAscii(std::string& buffer, std::string_view input)
+    {
+        for (const auto c: input)
+        {
+            buffer.push_back(ToLowerAscii(c));
+        }
+    }
+
+    std::string ReplaceIdeographicFullStops(std::string_view host)
+    {
+        std::string replaced(host);
+        for (const auto full_stop: IDEOGRAPHIC_FULL_STOPS)
+        {
+            for (
+                auto position = replaced.find(full_stop);
+                position != std::string::npos;
+                position = replaced.find(full_stop, position + 1)
+            )
+            {
+                (void)replaced.replace(position, full_stop.length(), ".");
+            }
+        }
+        return replaced;
+    }
+
+    enum class Direction
+    {
+        TO_ASCII,
+        TO_UNICODE,
+    };
+
+    // Conversions are cached by input and direction.
+    struct CacheKey
+    {
+        Direction direction = Direction::TO_ASCII;
+        std::string input;
+    };
+
+    struct CacheProbe
+    {
+        Direction direction;
+        std::string_view input;
+    };
+
+    bool operator==(const CacheKey& key, const CacheProbe& probe)
+    {
+        return (key.direction == probe.direction) && (key.input == probe.input);
+    }
+
+    bool operator==(const CacheKey& key, const CacheKey& other)
+    {
+        return (key.direction == other.direction) && (key.input == other.input);
+    }
+}
+
+namespace Uri
+{
+    // Conversions in both directions share one CLOCK cache, charged one
+    // per entry.
+    struct Idna::Impl
+    {
+        ClockCache< CacheKey, std::string > cache;
+
+        explicit Impl(size_t capacity)
+            : cache(capacity, 1)
+        {
+        }
+
+        static uint64_t Hash(std::string_view input, Direction direction)
+        {
+            return HashString64(input, (uint64_t)direction);
+        }
+
+        bool Find(std::string_view input, Direction direction, uint64_t hash, std::string& output) const
+        {
+            return cache.Find(hash, CacheProbe{direction, input}, output);
+        }
+
+        void Insert(std::string_view input, Direction direction, uint64_t hash, const std::string& output)
+        {
+            (void)cache.Insert(hash, CacheKey{direction, std::string(input)}, output, 1);
+        }
+    };
+
+    const size_t Idna::DEFAULT_CACHE_CAPACITY;
+
+    Idna::~Idna() noexcept = default;
+    Idna::Idna(Idna&&) noexcept = default;
+    Idna& Idna::operator=(Idna&&) noexcept = default;
+
+    Idna::Idna()
+        : impl_(new Impl(DEFAULT_CACHE_CAPACITY))
+    {
+    }
+
+    Idna::Idna(size_t cache_capacity)
+        : impl_(new Impl(cache_capacity))
+    {
+    }
+
+    bool Idna::EncodePunycode(std::string_view label, std::string& encoded)
+    {
+        std::u32string code_points;
+        if (!DecodeUtf8(label, code_points))
+        {
+            return false;
+        }
+        encoded.clear();
+        for (const auto code_point: code_points)
+        {
+            if (code_point < INITIAL_N)
+            {
+                encoded.push_back((char)code_point);
+            }
+        }
+        const auto num_basic = (uint32_t)encoded.length();
+        if (num_basic > 0)
+        {
+            encoded.push_back('-');
+        }
+        uint32_t n = INITIAL_N;
+        uint32_t delta = 0;
+        uint32_t bias = INITIAL_BIAS;
+        for (uint32_t handled = num_basic; handled < code_points.length();)
+        {
+            uint32_t next = MAX_VALUE;
+            for (const auto code_point: code_points)
+            {
+                if ((code_point >= n) && (code_point < next))
+                {
+                    next = code_point;
+                }
+            }
+            if (next - n > (MAX_VALUE - delta) / (handled + 1))
+            {
+                return false;
+            }
+            delta += (next - n) * (handled + 1);
+            n = next;
+            for (const auto code_point: code_points)
+            {
+                if ((code_point < n) && (++delta == 0))
+                {
+                    return false;
+                }
+                if (code_point != n)
+                {
+                    continue;
+                }
+                auto q = delta;
+                for (auto k = BASE;; k += BASE)
+                {
+                    const auto t = Threshold(k, bias);
+                    if (q < t)
+                    {
+                        break;
+                    }
+                    encoded.push_back(EncodeDigit(t + (q - t) % (BASE - t)));
+                    q = (q - t) / (BASE - t);
+                }
+                encoded.push_back(EncodeDigit(q));
+                bias = Adapt(delta, handled + 1, handled == num_basic);
+                delta = 0;
+                ++handled;
+            }
+            ++delta;
+            ++n;
+        }
+        return true;
+    }
+
+    bool Idna::DecodePunycode(std::string_view encoded, std::string& label)
+    {
+        std::u32string code_points;
+        auto delimiter = encoded.rfind('-');
+        if (delimiter == std::string_view::npos)
+        {
+            delimiter = 0;
+        }
+        for (size_t i = 0; i < delimiter; ++i)
+        {
+            if ((uint8_t)encoded[i] >= INITIAL_N)
+            {
+                return false;
+            }
+            code_points.push_back((char32_t)encoded[i]);
+        }
+        uint32_t n = INITIAL_N;
+        uint32_t i = 0;
+        uint32_t bias = INITIAL_BIAS;
+        for (auto in = (delimiter > 0) ? delimiter + 1 : 0; in < encoded.length();)
+        {
+            const auto old_i = i;
+            uint32_t w = 1;
+            for (auto k = BASE;; k += BASE)
+            {
+                if (in == encoded.length())
+                {
+                    return false;
+                }
+                const auto digit = DecodeDigit(encoded[in++]);
+                if ((digit == BASE) || (digit > (MAX_VALUE - i) / w))
+                {
+                    return false;
+                }
+                i += digit * w;
+                const auto t = Threshold(k, bias);
+                if (digit < t)
+                {
+                    break;
+                }
+                if (w > MAX_VALUE / (BASE - t))
+                {
+                    return false;
+                }
+                w *= BASE - t;
+            }
+            const auto num_points = (uint32_t)code_points.length() + 1;
+            bias = Adapt(i - old_i, num_points, old_i == 0);
+            if (i / num_points > MAX_VALUE - n)
+            {
+                return false;
+            }
+            n += i / num_points;
+            i %= num_points;
+            if ((n > 0x10FFFF) || ((n >= 0xD800) && (n <= 0xDFFF)))
+            {
+                return false;
+            }
+            (void)code_points.insert(code_points.begin() + i, (char32_t)n);
+            ++i;
+        }
+        label.clear();
+        for (const auto code_point: code_points)
+        {
+            AppendUtf8(label, code_point);
+        }
+        return true;
+    }
+
+    bool Idna::ToAscii(std::string_view host, std::string& ascii_host)
+    {
+        ascii_host.clear();
+        if (IsPlainAscii(host))
+        {
+            AppendLowerAscii(ascii_host, host);
+            return true;
+        }
+        const auto hash = Impl::Hash(host, Direction::TO_ASCII);
+        if (impl_->Find(host, Direction::TO_ASCII, hash, ascii_host))
+        {
+            return true;
+        }
+        const auto separated_host = ReplaceIdeographicFullStops(host);
+        std::string lower_label;
+        std::string encoded_label;
+        for (size_t label_start = 0;;)
+        {
+            auto label_end = separated_host.find('.', label_start);
+            if (label_end == std::string::npos)
+            {
+                label_end = separated_host.length();
+            }
+            lower_label.clear();
+            AppendLowerAscii(
+                lower_label,
+                std::string_view(separated_host).substr(label_start, label_end - label_start)
+            );
+            if (CountLeadingAscii(lower_label) == lower_label.length())
+            {
+                if (
+                    HasAcePrefix(lower_label)
+                    && !DecodePunycode(std::string_view(lower_label).substr(ACE_PREFIX.length()), encoded_label)
+                )
+                {
+                    return false;
+                }
+                ascii_host += lower_label;
+            }
+            else
+            {
+                if (
+                    !EncodePunycode(lower_label, encoded_label)
+                    || (ACE_PREFIX.length() + encoded_label.length() > MAX_LABEL_LENGTH)
+                )
+                {
+                    return false;
+                }
+                ascii_host += ACE_PREFIX;
+                ascii_host += encoded_label;
+            }
+            if (label_end == separated_host.length())
+            {
+                break;
+            }
+            ascii_host.push_back('.');
+            label_start = label_end + 1;
+        }
+        impl_->Insert(host, Direction::TO_ASCII, hash, ascii_host);
+        return true;
+    }
+
+    bool Idna::ToUnicode(std::string_view host, std::string& unicode_host)
+    {
+        unicode_host.clear();
+        if (IsPlainAscii(host))
+        {
+            AppendLowerAscii(unicode_host, host);
+            return true;
+        }
+        const auto hash = Impl::Hash(host, Direction::TO_UNICODE);
+        if (impl_->Find(host, Direction::TO_UNICODE, hash, unicode_host))
+        {
+            return true;
+        }
+        if (!IsValidUtf8(host))
+        {
+            return false;
+        }
+        std::string decoded_label;
+        for (size_t label_start = 0;;)
+        {
+            auto label_end = host.find('.', label_start);
+            if (label_end == std::string_view::npos)
+            {
+                label_end = host.length();
+            }
+            const auto label = host.substr(label_start, label_end - label_start);
+            if (
+                HasAcePrefix(label)
+                && DecodePunycode(label.substr(ACE_PREFIX.length()), decoded_label)
+            )
+            {
+                AppendLowerAscii(unicode_host, decoded_label);
+            }
+            else
+            {
+                AppendLowerAscii(unicode_host, label);
+            }
+            if (label_end == host.length())
+            {
+                break;
+            }
+            unicode_host.push_back('.');
+            label_start = label_end + 1;
+        }
+        impl_->Insert(host, Direction::TO_UNICODE, hash, unicode_host);
+        return true;
+    }
+
+    void Idna::ClearCache()
+    {
+        impl_->cache.Clear();
+    }
+
+    Idna::Statistics Idna::GetStatistics() const
+    {
+        const auto cache_statistics = impl_->cache.GetStatistics();
+        Statistics statistics;
+        statistics.hits = cache_statistics.hits;
+        statistics.misses = cache_statistics.misses;
+        statistics.evictions = cache_statistics.evictions;
+        statistics.entries = cache_statistics.entries;
+        return statistics;
+    }
+}
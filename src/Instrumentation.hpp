@@ -0,0 +1,148 @@
+#ifndef URI_INSTRUMENTATION_HPP
+#define URI_INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <Uri/ParseInstrumentation.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Uri
+{
+    namespace Instrumentation
+    {
+        // Written only by the owning thread, read by any; relaxed atomics
+        // make that well defined without read-modify-write instructions.
+        struct Counter
+        {
+            std::atomic< uint64_t > value{0};
+
+            void Add(uint64_t amount)
+            {
+                value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+
+            uint64_t Get() const
+            {
+                return value.load(std::memory_order_relaxed);
+            }
+        };
+
+        struct StageCounters
+        {
+            Counter calls;
+            Counter failures;
+            Counter bytes;
+            Counter timed_calls;
+            Counter ticks;
+        };
+
+        // Constant-initialized and trivially destructible, so that reaching
+        // it needs no guard; the thread is registered for GetSnapshot by the
+        // first outermost stage it runs, which always takes the sampling path
+        // below because until_sample starts at zero.
+        struct ThreadCounters
+        {
+            StageCounters stages[ParseInstrumentation::NUM_STAGES];
+            size_t depth = 0;
+            bool timing = false;
+            bool registered = false;
+            uint32_t until_sample = 0;
+        };
+
+        inline thread_local ThreadCounters thread_counters;
+
+        // Decides whether the outermost stage now starting is timed, and
+        // registers the thread if it isn't yet.
+        void BeginOutermostStage(ThreadCounters& counters);
+    }
+
+#ifdef URI_INSTRUMENTATION
+    // Counts a stage for as long as it is in scope, and times it if the
+    // outermost stage on this thread was sampled.  Only sampled and timed
+    // scopes call out of line.
+    class StageScope
+    {
+    public:
+        StageScope(ParseInstrumentation::Stage stage, size_t bytes)
+            : counters_(Instrumentation::thread_counters)
+            , stage_(counters_.stages[(size_t)stage])
+        {
+            if (counters_.depth++ == 0)
+            {
+                if (counters_.until_sample > 1)
+                {
+                    --counters_.until_sample;
+                }
+                else
+                {
+                    Instrumentation::BeginOutermostStage(counters_);
+                }
+            }
+            stage_.calls.Add(1);
+            stage_.bytes.Add(bytes);
+            if (counters_.timing)
+            {
+                StartTiming();
+            }
+        }
+
+        ~StageScope() noexcept
+        {
+            if (timed_)
+            {
+                StopTiming();
+            }
+            if (--counters_.depth == 0)
+            {
+                counters_.timing = false;
+            }
+        }
+
+        StageScope(const StageScope&) = delete;
+        StageScope& operator=(const StageScope&) = delete;
+
+        bool Finish(bool succeeded)
+        {
+            if (!succeeded)
+            {
+                stage_.failures.Add(1);
+            }
+            return succeeded;
+        }
+
+    private:
+        void StartTiming();
+        void StopTiming() noexcept;
+
+    private:
+        Instrumentation::ThreadCounters& counters_;
+        Instrumentation::StageCounters& stage_;
+        bool timed_ = false;
+        uint64_t start_ = 0;
+    };
+#else
+    class StageScope
+    {
+    public:
+        StageScope(ParseInstrumentation::Stage, size_t)
+        {
+        }
+
+        bool Finish(bool succeeded)
+        {
+            return succeeded;
+        }
+    };
+#endif
+
+    // Runs one stage of a larger operation, counting a false result as a
+    // failure of that stage.
+    template< typename Operation >
+    bool InstrumentStage(ParseInstrumentation::Stage stage, size_t bytes, Operation&& operation)
+    {
+        StageScope scope(stage, bytes);
+        return scope.Finish(operation());
+    }
+}
+
+#endif
@@ -0,0 +1,133 @@
+#include "Utf8.hpp"
+#include <Uri/Iri.hpp>
+#include <stdint.h>
+
+namespace
+{
+    const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    // The octet "%XX" at the start of input encodes, or -1.
+    int DecodeOctet(std::string_view input)
+    {
+        if ((input.length() < 3) || (input[0] != '%'))
+        {
+            return -1;
+        }
+        int octet = 0;
+        for (size_t i = 1; i < 3; ++i)
+        {
+            const char c = input[i];
+            octet <<= 4;
+            if ((c >= '0') && (c <= '9'))
+            {
+                octet += c - '0';
+            }
+            else if ((c >= 'A') && (c <= 'F'))
+            {
+                octet += c - 'A' + 10;
+            }
+            else if ((c >= 'a') && (c <= 'f'))
+            {
+                octet += c - 'a' + 10;
+            }
+            else
+            {
+                return -1;
+            }
+        }
+        return octet;
+    }
+}
+
+namespace Uri
+{
+    bool Iri::IsValidUtf8(std::string_view input)
+    {
+        return ::Uri::IsValidUtf8(input);
+    }
+
+    bool Iri::ToUri(std::string_view iri, std::string& uri)
+    {
+        uri.clear();
+        uri.reserve(iri.length());
+        size_t i = 0;
+        for (;;)
+        {
+            const auto ascii_length = CountLeadingAscii(iri.substr(i));
+            uri.append(iri.data() + i, ascii_length);
+            i += ascii_length;
+            if (i == iri.length())
+            {
+                return true;
+            }
+
+            // Validate the whole run of non-ASCII characters first, then
+            // encode it with one resize instead of a push_back per digit.
+            auto run_end = i;
+            while ((run_end < iri.length()) && ((uint8_t)iri[run_end] >= 0x80))
+            {
+                const auto length = Utf8SequenceLength(iri.substr(run_end));
+                if (length == 0)
+                {
+                    return false;
+                }
+                run_end += length;
+            }
+            auto out = uri.length();
+            uri.resize(out + 3 * (run_end - i));
+            for (; i < run_end; ++i)
+            {
+                const auto c = (uint8_t)iri[i];
+                uri[out++] = '%';
+                uri[out++] = HEX_DIGITS[c >> 4];
+                uri[out++] = HEX_DIGITS[c & 0x0F];
+            }
+        }
+    }
+
+    std::string Iri::ToIri(std::string_view uri)
+    {
+        std::string iri;
+        iri.reserve(uri.length());
+        size_t i = 0;
+        for (;;)
+        {
+            auto percent = uri.find('%', i);
+            if (percent == std::string_view::npos)
+            {
+                percent = uri.length();
+            }
+            iri.append(uri.data() + i, percent - i);
+            i = percent;
+            if (i == uri.length())
+            {
+                return iri;
+            }
+            char sequence[4];
+            size_t num_octets = 0;
+            for (
+                int octet = DecodeOctet(uri.substr(i));
+                (octet >= 0x80) && (num_octets < sizeof(sequence));
+                octet = DecodeOctet(uri.substr(i + 3 * num_octets))
+            )
+            {
+                sequence[num_octets++] = (char)octet;
+                if (Utf8SequenceLength(std::string_view(sequence, num_octets)) == num_octets)
+                {
+                    break;
+                }
+            }
+            const auto length = Utf8SequenceLength(std::string_view(sequence, num_octets));
+            if ((length > 1) && (length == num_octets))
+            {
+                iri.append(sequence, length);
+                i += 3 * length;
+            }
+            else
+            {
+                iri.push_back('%');
+                ++i;
+            }
+        }
+    }
+}
@@ -0,0 +1,262 @@
+#include <string>
+#include <Uri/LazyUri.hpp>
+#include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
+
+namespace
+{
+    int HexValue(char c)
+    {
+        if ((c >= '0') && (c <= '9'))
+        {
+            return c - '0';
+        }
+        if ((c >= 'A') && (c <= 'F'))
+        {
+            return c - 'A' + 10;
+        }
+        return c - 'a' + 10;
+    }
+
+    bool HasUpperCase(std::string_view s)
+    {
+        for (const auto c: s)
+        {
+            if ((c >= 'A') && (c <= 'Z'))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A component that is written to once, on first use.
+    struct Memo
+    {
+        bool done = false;
+        std::string_view value;
+    };
+}
+
+namespace Uri
+{
+    struct LazyUri::Impl
+    {
+        std::string uri_string;
+        UriView view;
+
+        // What the components decode to, back to back.  It is reserved
+        // up front for the whole string, which they can't outgrow, so it
+        // never moves under the views of them.
+        std::string decoded;
+
+        Memo scheme;
+        Memo user_info;
+        Memo host;
+        Memo query;
+        Memo fragment;
+        bool path_done = false;
+        std::vector< std::string_view > path;
+
+        Impl() = default;
+
+        Impl(const Impl& other)
+            : uri_string(other.uri_string)
+        {
+            (void)view.ParseFromString(uri_string);
+        }
+
+        Impl& operator=(const Impl& other)
+        {
+            Reset();
+            uri_string = other.uri_string;
+            (void)view.ParseFromString(uri_string);
+            return *this;
+        }
+
+        void Reset()
+        {
+            uri_string.clear();
+            view = UriView();
+            decoded.clear();
+            scheme = Memo();
+            user_info = Memo();
+            host = Memo();
+            query = Memo();
+            fragment = Memo();
+            path_done = false;
+            path.clear();
+        }
+
+        // The view needs no work if it has no '%', and no upper case
+        // letter to lower; otherwise it's decoded into the end of decoded.
+        // The view has been validated, so every '%' starts a whole triplet.
+        std::string_view Decode(std::string_view encoded, bool lower_case = false)
+        {
+            if ((encoded.find('%') == std::string_view::npos)
+                && (!lower_case || !HasUpperCase(encoded)))
+            {
+                return encoded;
+            }
+            if (decoded.capacity() < uri_string.length())
+            {
+                decoded.reserve(uri_string.length());
+            }
+            const auto start = decoded.length();
+            for (size_t i = 0; i < encoded.length(); ++i)
+            {
+                auto c = encoded[i];
+                if (c == '%')
+                {
+                    c = (char)((HexValue(encoded[i + 1]) << 4) | HexValue(encoded[i + 2]));
+                    i += 2;
+                }
+                if (lower_case && (c >= 'A') && (c <= 'Z'))
+                {
+                    c = (char)(c - 'A' + 'a');
+                }
+                decoded.push_back(c);
+            }
+            return std::string_view(decoded).substr(start);
+        }
+
+        std::string_view Get(Memo& memo, std::string_view encoded, bool lower_case = false)
+        {
+            if (!memo.done)
+            {
+                memo.value = Decode(encoded, lower_case);
+                memo.done = true;
+            }
+            return memo.value;
+        }
+    };
+
+    LazyUri::~LazyUri() noexcept = default;
+    LazyUri::LazyUri(const LazyUri& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    LazyUri::LazyUri(LazyUri&&) noexcept = default;
+    LazyUri& LazyUri::operator=(const LazyUri& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    LazyUri& LazyUri::operator=(LazyUri&&) noexcept = default;
+
+    LazyUri::LazyUri()
+        : impl_(new Impl)
+    {
+    }
+
+    bool LazyUri::ParseFromString(std::string_view uri_string)
+    {
+        impl_->Reset();
+        impl_->uri_string.assign(uri_string);
+        if (!impl_->view.ParseFromString(impl_->uri_string))
+        {
+            impl_->Reset();
+            return false;
+        }
+        return true;
+    }
+
+    std::string_view LazyUri::GetString() const
+    {
+        return impl_->uri_string;
+    }
+
+    std::string_view LazyUri::GetScheme() const
+    {
+        return impl_->Get(impl_->scheme, impl_->view.GetScheme(), true);
+    }
+
+    bool LazyUri::HasAuthority() const
+    {
+        return impl_->view.HasAuthority();
+    }
+
+    std::string_view LazyUri::GetUserInfo() const
+    {
+        return impl_->Get(impl_->user_info, impl_->view.GetUserInfo());
+    }
+
+    std::string_view LazyUri::GetHost() const
+    {
+        // Names are in lower case, but not IP literals, which are within
+        // brackets.
+        const auto host = impl_->view.GetHost();
+        const auto is_ip_literal = (
+            (host.data() > impl_->uri_string.data())
+            && (host.data()[-1] == '[')
+        );
+        return impl_->Get(impl_->host, host, !is_ip_literal);
+    }
+
+    bool LazyUri::HasPort() const
+    {
+        return impl_->view.HasPort();
+    }
+
+    uint16_t LazyUri::GetPort() const
+    {
+        return impl_->view.GetPort();
+    }
+
+    const std::vector< std::string_view >& LazyUri::GetPath() const
+    {
+        if (!impl_->path_done)
+        {
+            auto& path = impl_->path;
+            auto path_string = impl_->view.GetPath();
+            if ((path_string == "/")
+                || (path_string.empty() && !impl_->view.GetHost().empty()))
+            {
+                path.emplace_back();
+            }
+            else if (!path_string.empty())
+            {
+                for (;;)
+                {
+                    const auto delimiter = path_string.find('/');
+                    path.push_back(impl_->Decode(path_string.substr(0, delimiter)));
+                    if (delimiter == std::string_view::npos)
+                    {
+                        break;
+                    }
+                    path_string.remove_prefix(delimiter + 1);
+                }
+            }
+            impl_->path_done = true;
+        }
+        return impl_->path;
+    }
+
+    bool LazyUri::HasQuery() const
+    {
+        return impl_->view.HasQuery();
+    }
+
+    std::string_view LazyUri::GetQuery() const
+    {
+        return impl_->Get(impl_->query, impl_->view.GetQuery());
+    }
+
+    bool LazyUri::HasFragment() const
+    {
+        return impl_->view.HasFragment();
+    }
+
+    std::string_view LazyUri::GetFragment() const
+    {
+        return impl_->Get(impl_->fragment, impl_->view.GetFragment());
+    }
+
+    Uri LazyUri::ToUri() const
+    {
+        return Uri(impl_->view);
+    }
+}
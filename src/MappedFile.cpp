@@ -0,0 +1,94 @@
+#include "MappedFile.hpp"
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Uri
+{
+    MappedFile::~MappedFile() noexcept
+    {
+        Close();
+    }
+
+    MappedFile::MappedFile() = default;
+
+    bool MappedFile::Open(const std::string& file_path)
+    {
+        Close();
+#if defined(_WIN32)
+        std::ifstream file(file_path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return false;
+        }
+        contents_.resize((size_t)file.tellg());
+        file.seekg(0);
+        if (!file.read((char*)contents_.data(), contents_.size()))
+        {
+            contents_.clear();
+            return false;
+        }
+        data_ = contents_.data();
+        size_ = contents_.size();
+        return true;
+#else
+        const int descriptor = open(file_path.c_str(), O_RDONLY);
+        if (descriptor < 0)
+        {
+            return false;
+        }
+        struct stat status;
+        if (fstat(descriptor, &status) != 0)
+        {
+            (void)close(descriptor);
+            return false;
+        }
+        size_ = (size_t)status.st_size;
+        if (size_ == 0)
+        {
+            (void)close(descriptor);
+            data_ = contents_.data();
+            return true;
+        }
+        void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        (void)close(descriptor);
+        if (mapping == MAP_FAILED)
+        {
+            size_ = 0;
+            return false;
+        }
+        data_ = (const uint8_t*)mapping;
+        mapped_ = true;
+        return true;
+#endif
+    }
+
+    const uint8_t* MappedFile::Data() const
+    {
+        return data_;
+    }
+
+    size_t MappedFile::Size() const
+    {
+        return size_;
+    }
+
+    void MappedFile::Close()
+    {
+#if !defined(_WIN32)
+        if (mapped_)
+        {
+            (void)munmap((void*)data_, size_);
+        }
+#endif
+        mapped_ = false;
+        data_ = nullptr;
+        size_ = 0;
+        contents_.clear();
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef URI_MAPPED_FILE_HPP
+#define URI_MAPPED_FILE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Uri
+{
+    // A read-only view of a whole file: memory-mapped where the platform
+    // supports it, otherwise read into memory.
+    class MappedFile
+    {
+    public:
+        ~MappedFile() noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) = delete;
+
+    public:
+        MappedFile();
+        bool Open(const std::string& file_path);
+        const uint8_t* Data() const;
+        size_t Size() const;
+
+    private:
+        void Close();
+
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+        bool mapped_ = false;
+        std::vector< uint8_t > contents_;
+    };
+}
+
+#endif
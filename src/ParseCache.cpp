@@ -0,0 +1,110 @@
+#include "ClockCache.hpp"
+#include "Hash.hpp"
+#include "UriImpl.hpp"
+#include <Uri/ParseCache.hpp>
+
+namespace
+{
+    // Per-entry bookkeeping besides the slot and the strings themselves:
+    // the index node and the shared handle's control block.
+    const size_t ENTRY_OVERHEAD = 64;
+}
+
+namespace Uri
+{
+    struct ParseCache::Impl
+    {
+        typedef ClockCache< std::string, Handle > Cache;
+
+        size_t memory_cap = DEFAULT_MEMORY_CAP;
+        Cache cache;
+
+        Impl(size_t new_memory_cap, size_t num_shards)
+            : memory_cap(new_memory_cap)
+            , cache(new_memory_cap, num_shards)
+        {
+        }
+
+        static size_t Charge(const std::string& input, const Uri& uri)
+        {
+            const auto& components = *uri.impl_;
+            auto charge = Cache::SLOT_SIZE + ENTRY_OVERHEAD
+                + input.length()
+                + sizeof(Uri) + sizeof(Uri::Impl)
+                + components.scheme->capacity()
+                + components.host->capacity()
+                + components.user_info->capacity()
+                + components.query->capacity()
+                + components.fragment->capacity()
+                + components.path->capacity() * sizeof(std::string);
+            for (const auto& segment: *components.path)
+            {
+                charge += segment.capacity();
+            }
+            return charge;
+        }
+    };
+
+    const size_t ParseCache::DEFAULT_MEMORY_CAP;
+    const size_t ParseCache::DEFAULT_NUM_SHARDS;
+
+    ParseCache::~ParseCache() noexcept = default;
+    ParseCache::ParseCache(ParseCache&&) noexcept = default;
+    ParseCache& ParseCache::operator=(ParseCache&&) noexcept = default;
+
+    ParseCache::ParseCache()
+        : impl_(new Impl(DEFAULT_MEMORY_CAP, DEFAULT_NUM_SHARDS))
+    {
+    }
+
+    ParseCache::ParseCache(size_t memory_cap, size_t num_shards)
+        : impl_(new Impl(memory_cap, num_shards))
+    {
+    }
+
+    ParseCache::Handle ParseCache::Parse(const std::string& uri_string)
+    {
+        const auto hash = HashString64(uri_string);
+        Handle uri;
+        if (impl_->cache.Find(hash, uri_string, uri))
+        {
+            return uri;
+        }
+        auto parsed = std::make_shared< Uri >();
+        if (!parsed->ParseFromString(uri_string))
+        {
+            return nullptr;
+        }
+        const auto charge = Impl::Charge(uri_string, *parsed);
+        return impl_->cache.Insert(hash, uri_string, std::move(parsed), charge);
+    }
+
+    ParseCache::Handle ParseCache::Find(const std::string& uri_string) const
+    {
+        Handle uri;
+        (void)impl_->cache.Find(HashString64(uri_string), uri_string, uri);
+        return uri;
+    }
+
+    void ParseCache::Clear()
+    {
+        impl_->cache.Clear();
+    }
+
+    ParseCache::Statistics ParseCache::GetStatistics() const
+    {
+        const auto cache_statistics = impl_->cache.GetStatistics();
+        Statistics statistics;
+        statistics.hits = cache_statistics.hits;
+        statistics.misses = cache_statistics.misses;
+        statistics.evictions = cache_statistics.evictions;
+        statistics.entries = cache_statistics.entries;
+        statistics.memory_usage = cache_statistics.charge;
+        return statistics;
+    }
+
+    size_t ParseCache::GetMemoryCap() const
+    {
+        return impl_->memory_cap;
+    }
+}
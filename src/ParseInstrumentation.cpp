@@ -0,0 +1,210 @@
+#include "Instrumentation.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define URI_HAVE_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define URI_HAVE_RDTSC
+#endif
+
+namespace
+{
+    const char* const STAGE_NAMES[] = {
+        "parse",
+        "parse_scheme",
+        "parse_authority",
+        "validate_ipv6_address",
+        "parse_path",
+        "parse_query",
+        "parse_fragment",
+        "generate_string",
+        "resolve",
+    };
+
+    static_assert(
+        sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == Uri::ParseInstrumentation::NUM_STAGES,
+        "every stage needs a name"
+    );
+
+    std::atomic< uint32_t > sample_interval{1};
+
+    typedef Uri::Instrumentation::StageCounters StageCounters;
+    typedef Uri::Instrumentation::ThreadCounters ThreadCounters;
+
+    void AddTo(const StageCounters& counters, Uri::ParseInstrumentation::StageStatistics& statistics)
+    {
+        statistics.calls += counters.calls.Get();
+        statistics.failures += counters.failures.Get();
+        statistics.bytes += counters.bytes.Get();
+        statistics.timed_calls += counters.timed_calls.Get();
+        statistics.ticks += counters.ticks.Get();
+    }
+
+    void AddTo(const ThreadCounters& counters, Uri::ParseInstrumentation::Snapshot& snapshot)
+    {
+        for (size_t i = 0; i < Uri::ParseInstrumentation::NUM_STAGES; ++i)
+        {
+            AddTo(counters.stages[i], snapshot.stages[i]);
+        }
+    }
+
+    void Reset(StageCounters& counters)
+    {
+        counters.calls.value.store(0, std::memory_order_relaxed);
+        counters.failures.value.store(0, std::memory_order_relaxed);
+        counters.bytes.value.store(0, std::memory_order_relaxed);
+        counters.timed_calls.value.store(0, std::memory_order_relaxed);
+        counters.ticks.value.store(0, std::memory_order_relaxed);
+    }
+
+    // Registered threads' counters, plus the totals of threads that exited.
+    struct Registry
+    {
+        std::mutex mutex;
+        std::unordered_set< const ThreadCounters* > threads;
+        Uri::ParseInstrumentation::Snapshot exited;
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    // Keeps a thread's counters in the registry until the thread exits,
+    // then folds them into the exited totals.  Stages run after that, from
+    // other thread-local destructors, are not counted anywhere.
+    struct ThreadRegistration
+    {
+        const ThreadCounters& counters;
+
+        explicit ThreadRegistration(const ThreadCounters& counters)
+            : counters(counters)
+        {
+            auto& registry = GetRegistry();
+            std::lock_guard< std::mutex > lock(registry.mutex);
+            (void)registry.threads.insert(&counters);
+        }
+
+        ~ThreadRegistration() noexcept
+        {
+            auto& registry = GetRegistry();
+            std::lock_guard< std::mutex > lock(registry.mutex);
+            AddTo(counters, registry.exited);
+            (void)registry.threads.erase(&counters);
+        }
+
+        ThreadRegistration(const ThreadRegistration&) = delete;
+        ThreadRegistration& operator=(const ThreadRegistration&) = delete;
+    };
+
+#ifdef URI_INSTRUMENTATION
+    uint64_t ReadTicks()
+    {
+#ifdef URI_HAVE_RDTSC
+        return __rdtsc();
+#else
+        return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+#endif
+}
+
+namespace Uri
+{
+    namespace Instrumentation
+    {
+        void BeginOutermostStage(ThreadCounters& counters)
+        {
+            if (!counters.registered)
+            {
+                static thread_local ThreadRegistration registration(counters);
+                counters.registered = true;
+            }
+            if (counters.until_sample == 0)
+            {
+                counters.until_sample = sample_interval.load(std::memory_order_relaxed);
+            }
+            counters.timing = (--counters.until_sample == 0);
+        }
+    }
+
+#ifdef URI_INSTRUMENTATION
+    void StageScope::StartTiming()
+    {
+        timed_ = true;
+        start_ = ReadTicks();
+    }
+
+    void StageScope::StopTiming() noexcept
+    {
+        stage_.ticks.Add(ReadTicks() - start_);
+        stage_.timed_calls.Add(1);
+    }
+#endif
+
+    const size_t ParseInstrumentation::NUM_STAGES;
+
+    void ParseInstrumentation::SetSampleInterval(uint32_t interval)
+    {
+        sample_interval.store((interval == 0) ? 1 : interval, std::memory_order_relaxed);
+    }
+
+    uint32_t ParseInstrumentation::GetSampleInterval()
+    {
+        return sample_interval.load(std::memory_order_relaxed);
+    }
+
+    ParseInstrumentation::Snapshot ParseInstrumentation::GetThreadSnapshot()
+    {
+        Snapshot snapshot;
+        AddTo(Instrumentation::thread_counters, snapshot);
+        return snapshot;
+    }
+
+    void ParseInstrumentation::ResetThread()
+    {
+        for (auto& stage: Instrumentation::thread_counters.stages)
+        {
+            Reset(stage);
+        }
+    }
+
+    ParseInstrumentation::Snapshot ParseInstrumentation::GetSnapshot()
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard< std::mutex > lock(registry.mutex);
+        auto snapshot = registry.exited;
+        for (const auto thread: registry.threads)
+        {
+            AddTo(*thread, snapshot);
+        }
+        return snapshot;
+    }
+
+    const char* ParseInstrumentation::GetStageName(Stage stage)
+    {
+        return STAGE_NAMES[(size_t)stage];
+    }
+
+    std::string ParseInstrumentation::Export(const Snapshot& snapshot)
+    {
+        std::string exported;
+        for (size_t i = 0; i < NUM_STAGES; ++i)
+        {
+            const auto& stage = snapshot.stages[i];
+            exported += STAGE_NAMES[i];
+            exported += " calls=" + std::to_string(stage.calls);
+            exported += " failures=" + std::to_string(stage.failures);
+            exported += " bytes=" + std::to_string(stage.bytes);
+            exported += " timed_calls=" + std::to_string(stage.timed_calls);
+            exported += " ticks=" + std::to_string(stage.ticks);
+            exported += '\n';
+        }
+        return exported;
+    }
+}
@@ -0,0 +1,344 @@
+#include "UriGrammar.hpp"
+#include <algorithm>
+#include <stdint.h>
+#include <Uri/PathRouter.hpp>
+#include <Uri/Uri.hpp>
+
+namespace
+{
+    const uint32_t NO_NODE = UINT32_MAX;
+
+    struct Node
+    {
+        // Literal segments, sorted.
+        std::vector< std::pair< std::string, uint32_t > > literal_children;
+
+        uint32_t parameter_child = NO_NODE;
+
+        // The routes ending here, and whose "{*}" follows here.
+        size_t route = Uri::PathRouter::NO_ROUTE;
+        size_t rest_route = Uri::PathRouter::NO_ROUTE;
+    };
+
+    bool CompareLiteral(const std::pair< std::string, uint32_t >& child, std::string_view segment)
+    {
+        return (std::string_view(child.first) < segment);
+    }
+
+    // The segments of a Uri's path, without the empty first one of an
+    // absolute path.
+    struct UriSegments
+    {
+        const Uri::Uri& uri;
+        size_t first;
+
+        explicit UriSegments(const Uri::Uri& new_uri)
+            : uri(new_uri)
+            , first(((uri.GetPathSegmentCount() > 1) && uri.GetPathSegment(0).empty()) ? 1 : 0)
+        {
+        }
+
+        size_t Size() const
+        {
+            return uri.GetPathSegmentCount() - first;
+        }
+
+        std::string_view operator[](size_t index) const
+        {
+            return uri.GetPathSegment(first + index);
+        }
+    };
+
+    // The same, from a path as Uri::GetPath returns it.
+    struct VectorSegments
+    {
+        const std::vector< std::string >& path;
+        size_t first;
+
+        explicit VectorSegments(const std::vector< std::string >& new_path)
+            : path(new_path)
+            , first(((path.size() > 1) && path[0].empty()) ? 1 : 0)
+        {
+        }
+
+        size_t Size() const
+        {
+            return path.size() - first;
+        }
+
+        std::string_view operator[](size_t index) const
+        {
+            return path[first + index];
+        }
+    };
+}
+
+namespace Uri
+{
+    struct PathRouter::Impl
+    {
+        std::vector< Node > nodes = std::vector< Node >(1);
+
+        // The parameter names of each route, in the order they appear.
+        std::vector< std::vector< std::string > > route_parameters;
+
+        // Depth first, trying literal, then parameter, then wildcard
+        // children, and backing out of any that lead nowhere.
+        template< typename Segments >
+        bool Search(uint32_t node_index,
+                    const Segments& segments,
+                    size_t next,
+                    size_t num_parameters,
+                    Match& match) const
+        {
+            const auto& node = nodes[node_index];
+            if (next == segments.Size())
+            {
+                if (node.route != NO_ROUTE)
+                {
+                    match.route = node.route;
+                    match.num_parameters = num_parameters;
+                    match.rest_start = next;
+                    return true;
+                }
+            }
+            else
+            {
+                const auto segment = segments[next];
+                const auto& literals = node.literal_children;
+                const auto literal = std::lower_bound(literals.begin(), literals.end(), segment, CompareLiteral);
+                if ((literal != literals.end())
+                    && (literal->first == segment)
+                    && Search(literal->second, segments, next + 1, num_parameters, match))
+                {
+                    return true;
+                }
+                if ((node.parameter_child != NO_NODE) && !segment.empty())
+                {
+                    match.parameters[num_parameters].value = segment;
+                    if (Search(node.parameter_child, segments, next + 1, num_parameters + 1, match))
+                    {
+                        return true;
+                    }
+                }
+            }
+            if (node.rest_route != NO_ROUTE)
+            {
+                match.route = node.rest_route;
+                match.num_parameters = num_parameters;
+                match.rest_start = next;
+                return true;
+            }
+            return false;
+        }
+
+        template< typename Segments >
+        bool Find(const Segments& segments, Match& match) const
+        {
+            match.route = NO_ROUTE;
+            match.num_parameters = 0;
+            if (!Search(0, segments, 0, 0, match))
+            {
+                return false;
+            }
+            const auto& names = route_parameters[match.route];
+            for (size_t i = 0; i < match.num_parameters; ++i)
+            {
+                match.parameters[i].name = names[i];
+            }
+            return true;
+        }
+    };
+
+    const size_t PathRouter::NO_ROUTE;
+    const size_t PathRouter::MAX_PARAMETERS;
+
+    std::string_view PathRouter::Match::Get(std::string_view name) const
+    {
+        for (size_t i = 0; i < num_parameters; ++i)
+        {
+            if (parameters[i].name == name)
+            {
+                return parameters[i].value;
+            }
+        }
+        return std::string_view();
+    }
+
+    PathRouter::~PathRouter() noexcept = default;
+    PathRouter::PathRouter(const PathRouter& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    PathRouter::PathRouter(PathRouter&&) noexcept = default;
+    PathRouter& PathRouter::operator=(const PathRouter& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    PathRouter& PathRouter::operator=(PathRouter&&) noexcept = default;
+
+    PathRouter::PathRouter()
+        : impl_(new Impl)
+    {
+    }
+
+    size_t PathRouter::AddRoute(std::string_view path_template)
+    {
+        if (path_template.empty() || (path_template[0] != '/'))
+        {
+            return NO_ROUTE;
+        }
+
+        // Check the whole template before changing the trie, so a bad one
+        // leaves no nodes behind.
+        enum class Kind
+        {
+            LITERAL,
+            PARAMETER,
+            REST,
+        };
+        std::vector< std::pair< Kind, std::string > > segments;
+        std::vector< std::string > parameter_names;
+        for (size_t start = 1;;)
+        {
+            auto end = path_template.find('/', start);
+            const bool last = (end == std::string_view::npos);
+            if (last)
+            {
+                end = path_template.length();
+            }
+            std::string segment(path_template.substr(start, end - start));
+            if (segment == "{*}")
+            {
+                if (!last)
+                {
+                    return NO_ROUTE;
+                }
+                segments.emplace_back(Kind::REST, std::string());
+            }
+            else if (!segment.empty() && (segment[0] == '{'))
+            {
+                auto name = segment.substr(1, segment.length() - 2);
+                if ((segment.back() != '}')
+                    || name.empty()
+                    || (name.find_first_of("{}") != std::string::npos)
+                    || (std::find(parameter_names.begin(), parameter_names.end(), name) != parameter_names.end())
+                    || (parameter_names.size() == MAX_PARAMETERS))
+                {
+                    return NO_ROUTE;
+                }
+                parameter_names.push_back(std::move(name));
+                segments.emplace_back(Kind::PARAMETER, std::string());
+            }
+            else
+            {
+                if (!DecodeElement(segment, PCHAR_NOT_PCT_ENCODED))
+                {
+                    return NO_ROUTE;
+                }
+                segments.emplace_back(Kind::LITERAL, std::move(segment));
+            }
+            if (last)
+            {
+                break;
+            }
+            start = end + 1;
+        }
+
+        // Find where the route ends, then make sure no route ends there.
+        auto& nodes = impl_->nodes;
+        uint32_t node_index = 0;
+        size_t segments_in_trie = 0;
+        for (; segments_in_trie < segments.size(); ++segments_in_trie)
+        {
+            const auto& segment = segments[segments_in_trie];
+            uint32_t child = NO_NODE;
+            if (segment.first == Kind::LITERAL)
+            {
+                const auto& literals = nodes[node_index].literal_children;
+                const auto literal = std::lower_bound(
+                    literals.begin(), literals.end(), segment.second, CompareLiteral
+                );
+                if ((literal != literals.end()) && (literal->first == segment.second))
+                {
+                    child = literal->second;
+                }
+            }
+            else if (segment.first == Kind::PARAMETER)
+            {
+                child = nodes[node_index].parameter_child;
+            }
+            else
+            {
+                if (nodes[node_index].rest_route != NO_ROUTE)
+                {
+                    return NO_ROUTE;
+                }
+                break;
+            }
+            if (child == NO_NODE)
+            {
+                break;
+            }
+            node_index = child;
+        }
+        if ((segments_in_trie == segments.size()) && (nodes[node_index].route != NO_ROUTE))
+        {
+            return NO_ROUTE;
+        }
+
+        const auto route = impl_->route_parameters.size();
+        for (; segments_in_trie < segments.size(); ++segments_in_trie)
+        {
+            auto& segment = segments[segments_in_trie];
+            if (segment.first == Kind::REST)
+            {
+                break;
+            }
+            const auto child = (uint32_t)nodes.size();
+            nodes.emplace_back();
+            if (segment.first == Kind::LITERAL)
+            {
+                auto& literals = nodes[node_index].literal_children;
+                const auto literal = std::lower_bound(
+                    literals.begin(), literals.end(), segment.second, CompareLiteral
+                );
+                literals.emplace(literal, std::move(segment.second), child);
+            }
+            else
+            {
+                nodes[node_index].parameter_child = child;
+            }
+            node_index = child;
+        }
+        if (segments.back().first == Kind::REST)
+        {
+            nodes[node_index].rest_route = route;
+        }
+        else
+        {
+            nodes[node_index].route = route;
+        }
+        impl_->route_parameters.push_back(std::move(parameter_names));
+        return route;
+    }
+
+    size_t PathRouter::Size() const
+    {
+        return impl_->route_parameters.size();
+    }
+
+    bool PathRouter::Find(const Uri& uri, Match& match) const
+    {
+        return impl_->Find(UriSegments(uri), match);
+    }
+
+    bool PathRouter::Find(const std::vector< std::string >& path, Match& match) const
+    {
+        return impl_->Find(VectorSegments(path), match);
+    }
+}
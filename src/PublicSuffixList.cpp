@@ -0,0 +1,398 @@
+#include "MappedFile.hpp"
+#include <Uri/Idna.hpp>
+#include <Uri/PublicSuffixList.hpp>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    const size_t MAX_LABEL_LENGTH = 63;
+
+    // A node per label of some rule, read right to left.
+    struct Node
+    {
+        enum Flags : uint8_t
+        {
+            // A rule ends here.
+            RULE = 1,
+
+            // An exception rule ends here.
+            EXCEPTION = 2,
+        };
+
+        uint32_t label_offset = 0;
+        uint32_t first_child = 0;
+        uint32_t num_children = 0;
+
+        // The "*" child, if any; 0 otherwise, since the root is no child.
+        uint32_t wildcard_child = 0;
+        uint8_t label_length = 0;
+        uint8_t flags = 0;
+    };
+
+    struct BuildNode
+    {
+        std::map< std::string, std::unique_ptr< BuildNode > > children;
+        std::unique_ptr< BuildNode > wildcard;
+        uint8_t flags = 0;
+    };
+
+    char ToLowerAscii(char c)
+    {
+        return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+    }
+
+    // Orders a host label against a lower-case rule label, ignoring the
+    // host label's case.
+    int CompareLabel(std::string_view host_label, std::string_view rule_label)
+    {
+        const auto length = std::min(host_label.length(), rule_label.length());
+        for (size_t i = 0; i < length; ++i)
+        {
+            const auto a = (uint8_t)ToLowerAscii(host_label[i]);
+            const auto b = (uint8_t)rule_label[i];
+            if (a != b)
+            {
+                return (a < b) ? -1 : 1;
+            }
+        }
+        if (host_label.length() == rule_label.length())
+        {
+            return 0;
+        }
+        return (host_label.length() < rule_label.length()) ? -1 : 1;
+    }
+
+    // Adds one rule, lower-case and without its "!", to the tree.
+    bool AddRule(BuildNode& root, std::string_view rule, bool is_exception)
+    {
+        auto node = &root;
+        size_t num_labels = 0;
+        for (auto end = rule.length();; ++num_labels)
+        {
+            const auto dot = (end == 0) ? std::string_view::npos : rule.rfind('.', end - 1);
+            const auto label_start = (dot == std::string_view::npos) ? 0 : dot + 1;
+            const auto label = rule.substr(label_start, end - label_start);
+            if (label.empty() || (label.length() > MAX_LABEL_LENGTH))
+            {
+                return false;
+            }
+            if (label == "*")
+            {
+                if (is_exception)
+                {
+                    return false;
+                }
+                if (!node->wildcard)
+                {
+                    node->wildcard.reset(new BuildNode);
+                }
+                node = node->wildcard.get();
+            }
+            else if (label.find('*') != std::string_view::npos)
+            {
+                return false;
+            }
+            else
+            {
+                auto& child = node->children[std::string(label)];
+                if (!child)
+                {
+                    child.reset(new BuildNode);
+                }
+                node = child.get();
+            }
+            if (dot == std::string_view::npos)
+            {
+                break;
+            }
+            end = dot;
+        }
+        if (is_exception && (num_labels == 0))
+        {
+            return false;
+        }
+        node->flags |= (is_exception ? Node::EXCEPTION : Node::RULE);
+        return true;
+    }
+}
+
+namespace Uri
+{
+    struct PublicSuffixList::Impl
+    {
+        // Breadth first, so each node's children are contiguous and sorted
+        // by label.
+        std::vector< Node > nodes;
+        std::string labels;
+        size_t num_rules = 0;
+
+        std::string_view GetLabel(const Node& node) const
+        {
+            return std::string_view(labels).substr(node.label_offset, node.label_length);
+        }
+
+        // The child of node labeled label, or 0.
+        uint32_t FindChild(const Node& node, std::string_view label) const
+        {
+            auto first = node.first_child;
+            auto count = node.num_children;
+            while (count > 0)
+            {
+                const auto half = count / 2;
+                const auto middle = first + half;
+                const auto order = CompareLabel(label, GetLabel(nodes[middle]));
+                if (order == 0)
+                {
+                    return middle;
+                }
+                if (order > 0)
+                {
+                    first = middle + 1;
+                    count -= half + 1;
+                }
+                else
+                {
+                    count = half;
+                }
+            }
+            return node.wildcard_child;
+        }
+
+        void Flatten(const BuildNode& root)
+        {
+            std::unordered_map< std::string, uint32_t > label_offsets;
+            auto intern = [&](const std::string& label)
+            {
+                const auto offset = label_offsets.find(label);
+                if (offset != label_offsets.end())
+                {
+                    return offset->second;
+                }
+                const auto new_offset = (uint32_t)labels.length();
+                labels += label;
+                label_offsets[label] = new_offset;
+                return new_offset;
+            };
+            std::deque< std::pair< const BuildNode*, uint32_t > > queue{{&root, 0}};
+            nodes.assign(1, Node());
+            while (!queue.empty())
+            {
+                const auto build_node = queue.front().first;
+                const auto index = queue.front().second;
+                queue.pop_front();
+                nodes[index].flags = build_node->flags;
+                nodes[index].first_child = (uint32_t)nodes.size();
+                nodes[index].num_children = (uint32_t)build_node->children.size();
+                for (const auto& child: build_node->children)
+                {
+                    Node node;
+                    node.label_offset = intern(child.first);
+                    node.label_length = (uint8_t)child.first.length();
+                    queue.emplace_back(child.second.get(), (uint32_t)nodes.size());
+                    nodes.push_back(node);
+                }
+                if (build_node->wildcard)
+                {
+                    nodes[index].wildcard_child = (uint32_t)nodes.size();
+                    queue.emplace_back(build_node->wildcard.get(), (uint32_t)nodes.size());
+                    nodes.push_back(Node());
+                }
+            }
+            nodes.shrink_to_fit();
+            labels.shrink_to_fit();
+        }
+
+        // Where in host the public suffix starts, or npos if it has none.
+        size_t FindPublicSuffix(std::string_view host) const
+        {
+            auto name = host;
+            if (!name.empty() && (name.back() == '.'))
+            {
+                name.remove_suffix(1);
+            }
+            if (name.empty() || (name[0] == '[') || nodes.empty())
+            {
+                return std::string_view::npos;
+            }
+            const auto last_dot = name.rfind('.');
+            const auto last_label = name.substr((last_dot == std::string_view::npos) ? 0 : last_dot + 1);
+            if (last_label.empty()
+                || (last_label.find_first_not_of("0123456789") == std::string_view::npos))
+            {
+                return std::string_view::npos;
+            }
+
+            // With no rule matching, the last label is the public suffix.
+            size_t suffix_start = name.length() - last_label.length();
+            auto previous_label_start = name.length();
+            const Node* node = &nodes[0];
+            for (auto end = name.length();;)
+            {
+                const auto dot = (end == 0) ? std::string_view::npos : name.rfind('.', end - 1);
+                const auto label_start = (dot == std::string_view::npos) ? 0 : dot + 1;
+                const auto label = name.substr(label_start, end - label_start);
+                if (label.empty())
+                {
+                    break;
+                }
+                const auto child = FindChild(*node, label);
+                if (child == 0)
+                {
+                    break;
+                }
+                node = &nodes[child];
+                if ((node->flags & Node::EXCEPTION) != 0)
+                {
+                    suffix_start = previous_label_start;
+                    break;
+                }
+                if ((node->flags & Node::RULE) != 0)
+                {
+                    suffix_start = label_start;
+                }
+                if (dot == std::string_view::npos)
+                {
+                    break;
+                }
+                previous_label_start = label_start;
+                end = dot;
+            }
+            return suffix_start;
+        }
+    };
+
+    PublicSuffixList::~PublicSuffixList() noexcept = default;
+    PublicSuffixList::PublicSuffixList(const PublicSuffixList& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    PublicSuffixList::PublicSuffixList(PublicSuffixList&&) noexcept = default;
+    PublicSuffixList& PublicSuffixList::operator=(const PublicSuffixList& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    PublicSuffixList& PublicSuffixList::operator=(PublicSuffixList&&) noexcept = default;
+
+    PublicSuffixList::PublicSuffixList()
+        : impl_(new Impl)
+    {
+    }
+
+    bool PublicSuffixList::Build(std::string_view list)
+    {
+        BuildNode root;
+        Idna idna(0);
+        std::string rule;
+        std::string ascii_rule;
+        size_t num_rules = 0;
+        for (size_t line_start = 0; line_start < list.length();)
+        {
+            auto line_end = list.find('\n', line_start);
+            if (line_end == std::string_view::npos)
+            {
+                line_end = list.length();
+            }
+            auto line = list.substr(line_start, line_end - line_start);
+            line_start = line_end + 1;
+            const auto rule_start = line.find_first_not_of(" \t\r");
+            if ((rule_start == std::string_view::npos) || (line.substr(rule_start, 2) == "//"))
+            {
+                continue;
+            }
+            line = line.substr(rule_start);
+            const auto rule_end = line.find_first_of(" \t\r");
+            line = line.substr(0, rule_end);
+            const bool is_exception = (line[0] == '!');
+            if (is_exception)
+            {
+                line.remove_prefix(1);
+            }
+            rule.clear();
+            for (const auto c: line)
+            {
+                rule.push_back(ToLowerAscii(c));
+            }
+            if (!AddRule(root, rule, is_exception))
+            {
+                return false;
+            }
+            if (!idna.ToAscii(rule, ascii_rule))
+            {
+                return false;
+            }
+            if ((ascii_rule != rule) && !AddRule(root, ascii_rule, is_exception))
+            {
+                return false;
+            }
+            ++num_rules;
+        }
+        if (num_rules == 0)
+        {
+            return false;
+        }
+        Impl built;
+        built.Flatten(root);
+        built.num_rules = num_rules;
+        *impl_ = std::move(built);
+        return true;
+    }
+
+    bool PublicSuffixList::LoadFromFile(const std::string& file_path)
+    {
+        MappedFile file;
+        if (!file.Open(file_path))
+        {
+            return false;
+        }
+        return Build(std::string_view((const char*)file.Data(), file.Size()));
+    }
+
+    size_t PublicSuffixList::Size() const
+    {
+        return impl_->num_rules;
+    }
+
+    size_t PublicSuffixList::MemoryUsage() const
+    {
+        return (
+            sizeof(Impl)
+            + impl_->nodes.capacity() * sizeof(Node)
+            + impl_->labels.capacity()
+        );
+    }
+
+    std::string_view PublicSuffixList::GetPublicSuffix(std::string_view host) const
+    {
+        const auto suffix_start = impl_->FindPublicSuffix(host);
+        if (suffix_start == std::string_view::npos)
+        {
+            return std::string_view();
+        }
+        return host.substr(suffix_start);
+    }
+
+    std::string_view PublicSuffixList::GetRegistrableDomain(std::string_view host) const
+    {
+        const auto suffix_start = impl_->FindPublicSuffix(host);
+        if ((suffix_start == std::string_view::npos) || (suffix_start < 2))
+        {
+            return std::string_view();
+        }
+        const auto dot = host.rfind('.', suffix_start - 2);
+        const auto domain_start = (dot == std::string_view::npos) ? 0 : dot + 1;
+        if (domain_start == suffix_start - 1)
+        {
+            return std::string_view();
+        }
+        return host.substr(domain_start);
+    }
+}
@@ -0,0 +1,619 @@
+#include "ReferenceResolver.hpp"
+#include <algorithm>
+#include <ctype.h>
+#include <limits>
+
+namespace
+{
+    bool IsLegalIpvFuture(std::string_view address)
+    {
+        size_t i = 1;
+        while ((i < address.size()) && (address[i] != '.'))
+        {
+            if (!Uri::HEXDIG.Contains(address[i++]))
+            {
+                return false;
+            }
+        }
+        if (i++ == address.size())
+        {
+            return false;
+        }
+        for (; i < address.size(); ++i)
+        {
+            if (!Uri::IPV_FUTURE_LAST_PART.Contains(address[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool AppendPort(std::string& buffer, std::string_view port_string)
+    {
+        if (port_string.empty())
+        {
+            return true;
+        }
+        intmax_t port_as_int;
+        if (Uri::ToInteger(std::string(port_string), port_as_int) != Uri::ToIntegerResult::SUCCESS)
+        {
+            return false;
+        }
+        if ((port_as_int < 0)
+            || (port_as_int > (intmax_t)std::numeric_limits< uint16_t >::max()))
+        {
+            return false;
+        }
+        buffer.push_back(':');
+        buffer += std::to_string(port_as_int);
+        return true;
+    }
+
+    // Mirrors Uri::Impl::ParseAuthority followed by the authority part of
+    // Uri::GenerateString.
+    bool AppendNormalizedAuthority(std::string& buffer, std::string_view authority, bool& has_host)
+    {
+        has_host = false;
+        const auto mark = buffer.size();
+        buffer += "//";
+        const auto authority_start = buffer.size();
+        auto host_port = authority;
+        const auto user_info_delimiter = authority.find('@');
+        if (user_info_delimiter != std::string_view::npos)
+        {
+            if (!Uri::AppendNormalizedElement(
+                    buffer,
+                    authority.substr(0, user_info_delimiter),
+                    Uri::USER_INFO_NOT_PCT_ENCODED,
+                    Uri::USER_INFO_NOT_PCT_ENCODED))
+            {
+                return false;
+            }
+            if (buffer.size() > authority_start)
+            {
+                buffer.push_back('@');
+            }
+            host_port = authority.substr(user_info_delimiter + 1);
+        }
+        std::string_view port_string;
+        if (!host_port.empty() && (host_port[0] == '['))
+        {
+            const auto literal_end = host_port.find(']');
+            if (literal_end == std::string_view::npos)
+            {
+                return false;
+            }
+            const auto address = host_port.substr(1, literal_end - 1);
+            const auto after_literal = host_port.substr(literal_end + 1);
+            if (!after_literal.empty())
+            {
+                if (after_literal[0] != ':')
+                {
+                    return false;
+                }
+                port_string = after_literal.substr(1);
+            }
+            if (!address.empty() && (address[0] == 'v'))
+            {
+                if (!IsLegalIpvFuture(address))
+                {
+                    return false;
+                }
+                Uri::AppendEncodedElement(buffer, address, Uri::REG_NAME_NOT_PCT_ENCODED);
+            }
+            else
+            {
+                if (!Uri::ValidateIpv6Address(address))
+                {
+                    return false;
+                }
+                buffer.push_back('[');
+                for (auto c: address)
+                {
+                    buffer.push_back((char)tolower((unsigned char)c));
+                }
+                buffer.push_back(']');
+            }
+            has_host = true;
+        }
+        else
+        {
+            const auto port_delimiter = host_port.find(':');
+            const auto host = host_port.substr(0, port_delimiter);
+            if (port_delimiter != std::string_view::npos)
+            {
+                port_string = host_port.substr(port_delimiter + 1);
+            }
+            if (((host.size() >= 1) && (host[host.size() - 1] == '%'))
+                || ((host.size() >= 2) && (host[host.size() - 2] == '%')))
+            {
+                return false;
+            }
+            if (!Uri::AppendNormalizedElement(
+                    buffer,
+                    host,
+                    Uri::REG_NAME_NOT_PCT_ENCODED,
+                    Uri::REG_NAME_NOT_PCT_ENCODED,
+                    true))
+            {
+                return false;
+            }
+            has_host = !host.empty();
+        }
+        if (!AppendPort(buffer, port_string))
+        {
+            return false;
+        }
+        if (buffer.size() == authority_start)
+        {
+            buffer.resize(mark);
+        }
+        return true;
+    }
+}
+
+namespace Uri
+{
+    DotSegmentRemover::DotSegmentRemover(std::string& buffer, bool remove_dot_segments)
+        : buffer_(buffer)
+        , remove_dot_segments_(remove_dot_segments)
+        , path_start_(buffer.size())
+    {
+    }
+
+    std::string& DotSegmentRemover::Buffer()
+    {
+        return buffer_;
+    }
+
+    size_t DotSegmentRemover::NumSegments() const
+    {
+        return num_segments_;
+    }
+
+    void DotSegmentRemover::BeginSegment()
+    {
+        if (num_segments_ > 0)
+        {
+            buffer_.push_back('/');
+        }
+        segment_start_ = buffer_.size();
+    }
+
+    void DotSegmentRemover::EndSegment()
+    {
+        const auto segment_length = buffer_.size() - segment_start_;
+        bool is_dot = false;
+        bool is_dot_dot = false;
+        if (remove_dot_segments_)
+        {
+            is_dot = (segment_length == 1) && (buffer_[segment_start_] == '.');
+            is_dot_dot = (segment_length == 2)
+                && (buffer_[segment_start_] == '.')
+                && (buffer_[segment_start_ + 1] == '.');
+        }
+        if (is_dot
+            || is_dot_dot
+            || (remove_dot_segments_ && directory_level_ && (segment_length == 0)))
+        {
+            buffer_.resize((num_segments_ > 0) ? (segment_start_ - 1) : segment_start_);
+            if (is_dot_dot
+                && (num_segments_ > 0)
+                && (!absolute_ || (num_segments_ > 1)))
+            {
+                PopSegment();
+            }
+            directory_level_ = true;
+        }
+        else
+        {
+            if (num_segments_ == 0)
+            {
+                absolute_ = (segment_length == 0);
+            }
+            ++num_segments_;
+            directory_level_ = (segment_length == 0);
+        }
+    }
+
+    void DotSegmentRemover::Finish()
+    {
+        if (remove_dot_segments_
+            && directory_level_
+            && (num_segments_ > 0)
+            && !LastSegmentEmpty())
+        {
+            BeginSegment();
+            ++num_segments_;
+        }
+        if (absolute_ && (num_segments_ == 1))
+        {
+            buffer_.push_back('/');
+        }
+    }
+
+    bool DotSegmentRemover::LastSegmentEmpty() const
+    {
+        if (num_segments_ == 1)
+        {
+            return (buffer_.size() == path_start_);
+        }
+        return (buffer_.back() == '/');
+    }
+
+    void DotSegmentRemover::PopSegment()
+    {
+        if (num_segments_ == 1)
+        {
+            buffer_.resize(path_start_);
+            absolute_ = false;
+        }
+        else
+        {
+            buffer_.resize(buffer_.rfind('/'));
+        }
+        --num_segments_;
+    }
+
+    bool EncodedSource::Parse(std::string_view uri_string, std::string& scratch)
+    {
+        auto authority_or_path_delimiter_start = uri_string.find('/');
+        if (authority_or_path_delimiter_start == std::string_view::npos)
+        {
+            authority_or_path_delimiter_start = uri_string.length();
+        }
+        const auto scheme_end = uri_string.substr(0, authority_or_path_delimiter_start).find(':');
+        auto rest = uri_string;
+        scheme_ = std::string_view();
+        if (scheme_end != std::string_view::npos)
+        {
+            scheme_ = uri_string.substr(0, scheme_end);
+            if (!IsLegalScheme(scheme_))
+            {
+                return false;
+            }
+            rest = uri_string.substr(scheme_end + 1);
+        }
+
+        const auto path_end = std::min(rest.find_first_of("?#"), rest.length());
+        auto authority_and_path = rest.substr(0, path_end);
+        const auto query_and_or_fragment = rest.substr(path_end);
+        has_authority_delimiter_ = (authority_and_path.substr(0, 2) == "//");
+        if (has_authority_delimiter_)
+        {
+            authority_and_path = authority_and_path.substr(2);
+            const auto authority_end = std::min(authority_and_path.find('/'), authority_and_path.length());
+            authority_ = authority_and_path.substr(0, authority_end);
+            path_ = authority_and_path.substr(authority_end);
+        }
+        else
+        {
+            authority_ = std::string_view();
+            path_ = authority_and_path;
+        }
+
+        const auto fragment_delimiter = query_and_or_fragment.find('#');
+        has_fragment_ = (fragment_delimiter != std::string_view::npos);
+        fragment_ = has_fragment_
+            ? query_and_or_fragment.substr(fragment_delimiter + 1)
+            : std::string_view();
+        const auto query_with_delimiter = query_and_or_fragment.substr(0, fragment_delimiter);
+        has_query_ = !query_with_delimiter.empty();
+        query_ = has_query_ ? query_with_delimiter.substr(1) : std::string_view();
+
+        has_host_ = false;
+        has_authority_ = false;
+        if (has_authority_delimiter_)
+        {
+            scratch.clear();
+            if (!AppendNormalizedAuthority(scratch, authority_, has_host_))
+            {
+                return false;
+            }
+            has_authority_ = !scratch.empty();
+        }
+        if (!path_.empty() && (path_ != "/"))
+        {
+            auto path_rest = path_;
+            for (;;)
+            {
+                const auto path_delimiter = path_rest.find('/');
+                if (!IsValidElement(path_rest.substr(0, path_delimiter), PCHAR_NOT_PCT_ENCODED))
+                {
+                    return false;
+                }
+                if (path_delimiter == std::string_view::npos)
+                {
+                    break;
+                }
+                path_rest = path_rest.substr(path_delimiter + 1);
+            }
+        }
+        return IsValidElement(query_, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED)
+            && IsValidElement(fragment_, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED);
+    }
+
+    bool EncodedSource::HasScheme() const
+    {
+        return !scheme_.empty();
+    }
+
+    void EncodedSource::AppendScheme(std::string& buffer) const
+    {
+        for (auto c: scheme_)
+        {
+            buffer.push_back((char)tolower((unsigned char)c));
+        }
+        buffer.push_back(':');
+    }
+
+    bool EncodedSource::HasAuthority() const
+    {
+        return has_authority_;
+    }
+
+    bool EncodedSource::AppendAuthority(std::string& buffer) const
+    {
+        if (!has_authority_)
+        {
+            return true;
+        }
+        bool has_host;
+        return AppendNormalizedAuthority(buffer, authority_, has_host);
+    }
+
+    bool EncodedSource::PathIsEmpty() const
+    {
+        return path_.empty() && !has_host_;
+    }
+
+    bool EncodedSource::IsPathAbsolute() const
+    {
+        return path_.empty() ? has_host_ : FirstSegmentIsEmpty();
+    }
+
+    bool EncodedSource::FirstSegmentIsEmpty() const
+    {
+        // A truncated percent-encoding ("%" or "%4") decodes to nothing, as
+        // in DecodeElement.
+        const auto first_segment = path_.substr(0, path_.find('/'));
+        return first_segment.empty()
+            || ((first_segment[0] == '%') && (first_segment.length() < 3));
+    }
+
+    bool EncodedSource::FeedSegment(DotSegmentRemover& remover, std::string_view segment) const
+    {
+        remover.BeginSegment();
+        if (!AppendNormalizedElement(
+                remover.Buffer(),
+                segment,
+                PCHAR_NOT_PCT_ENCODED,
+                PCHAR_NOT_PCT_ENCODED))
+        {
+            return false;
+        }
+        remover.EndSegment();
+        return true;
+    }
+
+    bool EncodedSource::FeedPath(DotSegmentRemover& remover, bool merge_prefix) const
+    {
+        if (path_.empty())
+        {
+            if (has_host_ || (merge_prefix && has_authority_))
+            {
+                remover.BeginSegment();
+                remover.EndSegment();
+            }
+            return true;
+        }
+        if (path_ == "/")
+        {
+            remover.BeginSegment();
+            remover.EndSegment();
+            return true;
+        }
+        auto path_rest = path_;
+        for (;;)
+        {
+            const auto path_delimiter = path_rest.find('/');
+            if (path_delimiter == std::string_view::npos)
+            {
+                // Merging keeps a path that is one empty segment, as
+                // DecodedSource does.
+                if (merge_prefix && ((path_rest.length() < path_.length()) || !FirstSegmentIsEmpty()))
+                {
+                    return true;
+                }
+                return FeedSegment(remover, path_rest);
+            }
+            if (!FeedSegment(remover, path_rest.substr(0, path_delimiter)))
+            {
+                return false;
+            }
+            path_rest = path_rest.substr(path_delimiter + 1);
+        }
+    }
+
+    bool EncodedSource::HasQuery() const
+    {
+        return has_query_;
+    }
+
+    bool EncodedSource::AppendQuery(std::string& buffer) const
+    {
+        if (!has_query_)
+        {
+            return true;
+        }
+        buffer.push_back('?');
+        return AppendNormalizedElement(
+            buffer,
+            query_,
+            QUERY_OR_FRAGMENT_NOT_PCT_ENCODED,
+            QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS
+        );
+    }
+
+    bool EncodedSource::AppendFragment(std::string& buffer) const
+    {
+        if (!has_fragment_)
+        {
+            return true;
+        }
+        buffer.push_back('#');
+        return AppendNormalizedElement(
+            buffer,
+            fragment_,
+            QUERY_OR_FRAGMENT_NOT_PCT_ENCODED,
+            QUERY_OR_FRAGMENT_NOT_PCT_ENCODED
+        );
+    }
+
+    bool SerializedSource::HasScheme() const
+    {
+        return !scheme_.empty();
+    }
+
+    void SerializedSource::AppendScheme(std::string& buffer) const
+    {
+        buffer += scheme_;
+    }
+
+    bool SerializedSource::HasAuthority() const
+    {
+        return !authority_.empty();
+    }
+
+    bool SerializedSource::AppendAuthority(std::string& buffer) const
+    {
+        buffer += authority_;
+        return true;
+    }
+
+    bool SerializedSource::PathIsEmpty() const
+    {
+        return path_.empty();
+    }
+
+    bool SerializedSource::IsPathAbsolute() const
+    {
+        return !path_.empty() && path_[0].empty();
+    }
+
+    bool SerializedSource::FeedPath(DotSegmentRemover& remover, bool merge_prefix) const
+    {
+        const auto& segments = merge_prefix ? merge_prefix_ : path_;
+        for (const auto& segment: segments)
+        {
+            remover.BeginSegment();
+            remover.Buffer() += segment;
+            remover.EndSegment();
+        }
+        return true;
+    }
+
+    bool SerializedSource::HasQuery() const
+    {
+        return has_query_;
+    }
+
+    bool SerializedSource::AppendQuery(std::string& buffer) const
+    {
+        buffer += query_;
+        return true;
+    }
+
+    bool SerializedSource::AppendFragment(std::string& buffer) const
+    {
+        buffer += fragment_;
+        return true;
+    }
+
+    void SerializedSource::SplitSegments(const std::string& joined,
+                                         size_t num_segments,
+                                         std::vector< std::string >& segments)
+    {
+        segments.clear();
+        if (num_segments == 0)
+        {
+            return;
+        }
+        size_t segment_start = 0;
+        for (;;)
+        {
+            const auto segment_end = joined.find('/', segment_start);
+            segments.push_back(joined.substr(segment_start, segment_end - segment_start));
+            if (segment_end == std::string::npos)
+            {
+                break;
+            }
+            segment_start = segment_end + 1;
+        }
+    }
+
+    void AppendAuthority(std::string& buffer,
+                         const std::string& user_info,
+                         const std::string& host,
+                         bool has_port,
+                         uint16_t port)
+    {
+        buffer += "//";
+        if (!user_info.empty())
+        {
+            AppendEncodedElement(buffer, user_info, USER_INFO_NOT_PCT_ENCODED);
+            buffer.push_back('@');
+        }
+        if (!host.empty())
+        {
+            if (ValidateIpv6Address(host))
+            {
+                buffer.push_back('[');
+                buffer += ToLower(host);
+                buffer.push_back(']');
+            }
+            else
+            {
+                AppendEncodedElement(buffer, host, REG_NAME_NOT_PCT_ENCODED);
+            }
+        }
+        if (has_port)
+        {
+            buffer.push_back(':');
+            buffer += std::to_string(port);
+        }
+    }
+
+    size_t AuthorityLength(const std::string& user_info,
+                           const std::string& host,
+                           bool has_port,
+                           uint16_t port)
+    {
+        size_t length = 2;
+        if (!user_info.empty())
+        {
+            length += EncodedLength(user_info, USER_INFO_NOT_PCT_ENCODED) + 1;
+        }
+        if (!host.empty())
+        {
+            if (ValidateIpv6Address(host))
+            {
+                length += host.length() + 2;
+            }
+            else
+            {
+                length += EncodedLength(host, REG_NAME_NOT_PCT_ENCODED);
+            }
+        }
+        if (has_port)
+        {
+            length += 2;
+            for (auto rest = port / 10; rest != 0; rest /= 10)
+            {
+                ++length;
+            }
+        }
+        return length;
+    }
+}
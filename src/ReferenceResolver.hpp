@@ -0,0 +1,430 @@
+#ifndef URI_REFERENCE_RESOLVER_HPP
+#define URI_REFERENCE_RESOLVER_HPP
+
+#include "UriGrammar.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Uri
+{
+    // Writes path segments into a serialized buffer, removing dot segments
+    // exactly as Uri::Impl::NormalizePath does, but without a segment vector:
+    // segments never contain an unencoded '/', so popping one is a truncation
+    // at the last '/'.
+    class DotSegmentRemover
+    {
+    public:
+        DotSegmentRemover(std::string& buffer, bool remove_dot_segments);
+
+        std::string& Buffer();
+        size_t NumSegments() const;
+        void BeginSegment();
+        void EndSegment();
+        void Finish();
+
+    private:
+        bool LastSegmentEmpty() const;
+        void PopSegment();
+
+        std::string& buffer_;
+        bool remove_dot_segments_;
+        size_t path_start_;
+        size_t segment_start_ = 0;
+        size_t num_segments_ = 0;
+        bool absolute_ = false;
+        bool directory_level_ = false;
+    };
+
+    // A URI reference held as raw, still percent-encoded, component spans.
+    class EncodedSource
+    {
+    public:
+        bool Parse(std::string_view uri_string, std::string& scratch);
+
+        bool HasScheme() const;
+        void AppendScheme(std::string& buffer) const;
+        bool HasAuthority() const;
+        bool AppendAuthority(std::string& buffer) const;
+        bool PathIsEmpty() const;
+        bool IsPathAbsolute() const;
+        bool FeedPath(DotSegmentRemover& remover, bool merge_prefix) const;
+        bool HasQuery() const;
+        bool AppendQuery(std::string& buffer) const;
+        bool AppendFragment(std::string& buffer) const;
+
+    private:
+        bool FirstSegmentIsEmpty() const;
+        bool FeedSegment(DotSegmentRemover& remover, std::string_view segment) const;
+
+        std::string_view scheme_;
+        bool has_authority_delimiter_ = false;
+        std::string_view authority_;
+        std::string_view path_;
+        bool has_query_ = false;
+        std::string_view query_;
+        bool has_fragment_ = false;
+        std::string_view fragment_;
+        bool has_authority_ = false;
+        bool has_host_ = false;
+    };
+
+    void AppendAuthority(std::string& buffer,
+                         const std::string& user_info,
+                         const std::string& host,
+                         bool has_port,
+                         uint16_t port);
+
+    // The length AppendAuthority would append.
+    size_t AuthorityLength(const std::string& user_info,
+                           const std::string& host,
+                           bool has_port,
+                           uint16_t port);
+
+    // A parsed (decoded) reference; Components is Uri::Impl.
+    template< typename Components >
+    class DecodedSource
+    {
+    public:
+        explicit DecodedSource(const Components& components)
+            : components_(components)
+        {
+        }
+
+        bool HasScheme() const
+        {
+            return !components_.scheme->empty();
+        }
+
+        void AppendScheme(std::string& buffer) const
+        {
+            buffer += *components_.scheme;
+            buffer.push_back(':');
+        }
+
+        bool HasAuthority() const
+        {
+            return components_.HasAuthority();
+        }
+
+        bool AppendAuthority(std::string& buffer) const
+        {
+            if (components_.HasAuthority())
+            {
+                ::Uri::AppendAuthority(
+                    buffer,
+                    *components_.user_info,
+                    *components_.host,
+                    components_.has_port,
+                    components_.port
+                );
+            }
+            return true;
+        }
+
+        bool PathIsEmpty() const
+        {
+            return components_.path->empty();
+        }
+
+        bool IsPathAbsolute() const
+        {
+            return components_.IsPathAbsolute();
+        }
+
+        bool FeedPath(DotSegmentRemover& remover, bool merge_prefix) const
+        {
+            const auto& path = *components_.path;
+            if (merge_prefix && components_.HasAuthority() && path.empty())
+            {
+                remover.BeginSegment();
+                remover.EndSegment();
+                return true;
+            }
+            auto num_segments = path.size();
+            if (merge_prefix
+                && (num_segments > 0)
+                && !((num_segments == 1) && path[0].empty()))
+            {
+                --num_segments;
+            }
+            for (size_t i = 0; i < num_segments; ++i)
+            {
+                remover.BeginSegment();
+                AppendEncodedElement(remover.Buffer(), path[i], PCHAR_NOT_PCT_ENCODED);
+                remover.EndSegment();
+            }
+            return true;
+        }
+
+        bool HasQuery() const
+        {
+            return components_.has_query;
+        }
+
+        bool AppendQuery(std::string& buffer) const
+        {
+            if (components_.has_query)
+            {
+                buffer.push_back('?');
+                AppendEncodedElement(buffer, *components_.query, QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS);
+            }
+            return true;
+        }
+
+        bool AppendFragment(std::string& buffer) const
+        {
+            if (components_.has_fragment)
+            {
+                buffer.push_back('#');
+                AppendEncodedElement(buffer, *components_.fragment, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED);
+            }
+            return true;
+        }
+
+        // What SerializeToBuffer appends without removing dot segments,
+        // worked out without writing it.
+        size_t SerializedLength() const
+        {
+            size_t length = 0;
+            if (HasScheme())
+            {
+                length += components_.scheme->length() + 1;
+            }
+            if (components_.HasAuthority())
+            {
+                length += AuthorityLength(
+                    *components_.user_info,
+                    *components_.host,
+                    components_.has_port,
+                    components_.port
+                );
+            }
+            const auto& path = *components_.path;
+            for (const auto& segment: path)
+            {
+                length += EncodedLength(segment, PCHAR_NOT_PCT_ENCODED) + 1;
+            }
+            if (!path.empty() && !((path.size() == 1) && path[0].empty()))
+            {
+                --length;
+            }
+            if (components_.has_query)
+            {
+                length += EncodedLength(*components_.query, QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS) + 1;
+            }
+            if (components_.has_fragment)
+            {
+                length += EncodedLength(*components_.fragment, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED) + 1;
+            }
+            return length;
+        }
+
+    private:
+        const Components& components_;
+    };
+
+    // Any source with its components serialized once up front, for a base
+    // that many references are resolved against.
+    class SerializedSource
+    {
+    public:
+        template< typename Source >
+        explicit SerializedSource(const Source& source)
+        {
+            if (source.HasScheme())
+            {
+                source.AppendScheme(scheme_);
+            }
+            source.AppendAuthority(authority_);
+            std::string joined;
+            DotSegmentRemover path_remover(joined, false);
+            source.FeedPath(path_remover, false);
+            SplitSegments(joined, path_remover.NumSegments(), path_);
+            joined.clear();
+            DotSegmentRemover merge_prefix_remover(joined, false);
+            source.FeedPath(merge_prefix_remover, true);
+            SplitSegments(joined, merge_prefix_remover.NumSegments(), merge_prefix_);
+            has_query_ = source.HasQuery();
+            source.AppendQuery(query_);
+            source.AppendFragment(fragment_);
+        }
+
+        bool HasScheme() const;
+        void AppendScheme(std::string& buffer) const;
+        bool HasAuthority() const;
+        bool AppendAuthority(std::string& buffer) const;
+        bool PathIsEmpty() const;
+        bool IsPathAbsolute() const;
+        bool FeedPath(DotSegmentRemover& remover, bool merge_prefix) const;
+        bool HasQuery() const;
+        bool AppendQuery(std::string& buffer) const;
+        bool AppendFragment(std::string& buffer) const;
+
+    private:
+        static void SplitSegments(const std::string& joined,
+                                  size_t num_segments,
+                                  std::vector< std::string >& segments);
+
+        std::string scheme_;
+        std::string authority_;
+        std::vector< std::string > path_;
+        std::vector< std::string > merge_prefix_;
+        bool has_query_ = false;
+        std::string query_;
+        std::string fragment_;
+    };
+
+    // Where each component of a serialized URI ends, relative to where
+    // serialization started: the scheme includes its ':', the authority its
+    // "//" and the query its '?'.  The fragment is whatever follows.
+    struct SerializedLayout
+    {
+        size_t scheme_end = 0;
+        size_t authority_end = 0;
+        size_t path_end = 0;
+        size_t query_end = 0;
+    };
+
+    // Serializes a single source the way Uri::GenerateString does,
+    // optionally removing dot segments as Uri::NormalizePath would.
+    template< typename Source >
+    bool SerializeToBuffer(const Source& source,
+                           std::string& buffer,
+                           bool remove_dot_segments = false,
+                           SerializedLayout* layout = nullptr)
+    {
+        const auto start = buffer.size();
+        if (source.HasScheme())
+        {
+            source.AppendScheme(buffer);
+        }
+        const auto scheme_end = buffer.size() - start;
+        if (!source.AppendAuthority(buffer))
+        {
+            return false;
+        }
+        const auto authority_end = buffer.size() - start;
+        DotSegmentRemover remover(buffer, remove_dot_segments);
+        if (!source.FeedPath(remover, false))
+        {
+            return false;
+        }
+        remover.Finish();
+        const auto path_end = buffer.size() - start;
+        if (!source.AppendQuery(buffer))
+        {
+            return false;
+        }
+        if (layout != nullptr)
+        {
+            layout->scheme_end = scheme_end;
+            layout->authority_end = authority_end;
+            layout->path_end = path_end;
+            layout->query_end = buffer.size() - start;
+        }
+        return source.AppendFragment(buffer);
+    }
+
+    // RFC 3986 5.2.2 over two sources, serialized straight into buffer.
+    // Produces the same string as Resolve(...).GenerateString().
+    template< typename Base, typename Reference >
+    bool ResolveToBuffer(const Base& base, const Reference& relative_ref, std::string& buffer)
+    {
+        buffer.clear();
+        if (relative_ref.HasScheme())
+        {
+            relative_ref.AppendScheme(buffer);
+            if (!relative_ref.AppendAuthority(buffer))
+            {
+                return false;
+            }
+            DotSegmentRemover remover(buffer, true);
+            if (!relative_ref.FeedPath(remover, false))
+            {
+                return false;
+            }
+            remover.Finish();
+            if (!relative_ref.AppendQuery(buffer))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            if (base.HasScheme())
+            {
+                base.AppendScheme(buffer);
+            }
+            if (relative_ref.HasAuthority())
+            {
+                if (!relative_ref.AppendAuthority(buffer))
+                {
+                    return false;
+                }
+                DotSegmentRemover remover(buffer, true);
+                if (!relative_ref.FeedPath(remover, false))
+                {
+                    return false;
+                }
+                remover.Finish();
+                if (!relative_ref.AppendQuery(buffer))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                if (!base.AppendAuthority(buffer))
+                {
+                    return false;
+                }
+                if (relative_ref.PathIsEmpty())
+                {
+                    DotSegmentRemover remover(buffer, false);
+                    if (!base.FeedPath(remover, false))
+                    {
+                        return false;
+                    }
+                    remover.Finish();
+                    if (relative_ref.HasQuery())
+                    {
+                        if (!relative_ref.AppendQuery(buffer))
+                        {
+                            return false;
+                        }
+                    }
+                    else if (!base.AppendQuery(buffer))
+                    {
+                        return false;
+                    }
+                }
+                else
+                {
+                    DotSegmentRemover remover(buffer, true);
+                    if (!relative_ref.IsPathAbsolute())
+                    {
+                        if (!base.FeedPath(remover, true))
+                        {
+                            return false;
+                        }
+                    }
+                    if (!relative_ref.FeedPath(remover, false))
+                    {
+                        return false;
+                    }
+                    remover.Finish();
+                    if (!relative_ref.AppendQuery(buffer))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return relative_ref.AppendFragment(buffer);
+    }
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef URI_REGISTERED_SCHEME_HPP
+#define URI_REGISTERED_SCHEME_HPP
+
+#include "CopyOnWrite.hpp"
+#include <Uri/SchemeRegistry.hpp>
+#include <string>
+#include <string_view>
+
+namespace Uri
+{
+    // A registry entry.  Parsed URIs share the entry's name rather than
+    // each allocating their own lower-cased copy of the scheme.
+    struct RegisteredScheme
+    {
+        CopyOnWrite< std::string > name;
+        SchemePolicy policy;
+        SchemeId id = SchemeRegistry::UNREGISTERED_SCHEME;
+    };
+
+    // Matches case-insensitively.  The built-in schemes are found without
+    // taking any lock.
+    const RegisteredScheme* FindRegisteredScheme(std::string_view scheme);
+
+    // nullptr for NO_SCHEME, UNREGISTERED_SCHEME or an unused ID.
+    const RegisteredScheme* FindRegisteredScheme(SchemeId id);
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include "ReferenceResolver.hpp"
+#include "UriImpl.hpp"
+#include <Uri/ResolvedBase.hpp>
+
+namespace Uri
+{
+    struct ResolvedBase::Impl
+    {
+        Uri base;
+        std::vector<std::string> merge_prefix;
+        std::vector<std::string> normalized_merge_prefix;
+        SerializedSource serialized_base;
+
+        explicit Impl(const Uri& base_uri)
+            : base(base_uri)
+            , serialized_base(DecodedSource< Uri::Impl >(*base.impl_))
+        {
+            Uri::Impl merge;
+            merge.CopyMergePrefix(*base.impl_);
+            merge_prefix = merge.path.Take();
+            merge.CopyNormalizedMergePrefix(*base.impl_);
+            normalized_merge_prefix = merge.path.Take();
+        }
+
+        void ResolveInto(const Uri& relative_ref, Uri& target) const
+        {
+            target.impl_->Resolve(*base.impl_, *relative_ref.impl_, &merge_prefix);
+        }
+
+        void ResolveInto(const Uri& relative_ref, std::string& target) const
+        {
+            (void)ResolveToBuffer(
+                serialized_base,
+                DecodedSource< Uri::Impl >(*relative_ref.impl_),
+                target
+            );
+        }
+
+        void MakeRelativeInto(const Uri& target, Uri& relative_ref) const
+        {
+            relative_ref.impl_->MakeRelative(*base.impl_, *target.impl_, &normalized_merge_prefix);
+        }
+
+        bool ResolveInto(const std::string& relative_ref, std::string& target) const
+        {
+            EncodedSource reference;
+            if (!reference.Parse(relative_ref, target)
+                || !ResolveToBuffer(serialized_base, reference, target))
+            {
+                target.clear();
+                return false;
+            }
+            return true;
+        }
+    };
+
+    ResolvedBase::~ResolvedBase() noexcept = default;
+
+    ResolvedBase::ResolvedBase(const ResolvedBase& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+
+    ResolvedBase::ResolvedBase(ResolvedBase&&) noexcept = default;
+
+    ResolvedBase& ResolvedBase::operator=(const ResolvedBase& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+
+    ResolvedBase& ResolvedBase::operator=(ResolvedBase&&) noexcept = default;
+
+    ResolvedBase::ResolvedBase(const Uri& base)
+        : impl_(new Impl(base))
+    {
+    }
+
+    const Uri& ResolvedBase::GetBase() const
+    {
+        return impl_->base;
+    }
+
+    Uri ResolvedBase::Resolve(const Uri& relative_ref) const
+    {
+        Uri target;
+        impl_->ResolveInto(relative_ref, target);
+        return target;
+    }
+
+    void ResolvedBase::ResolveInto(const Uri& relative_ref, Uri& target) const
+    {
+        impl_->ResolveInto(relative_ref, target);
+    }
+
+    bool ResolvedBase::ResolveInto(const std::string& relative_ref, Uri& target) const
+    {
+        Uri reference;
+        if (!reference.ParseFromString(relative_ref))
+        {
+            return false;
+        }
+        impl_->ResolveInto(reference, target);
+        return true;
+    }
+
+    void ResolvedBase::ResolveInto(const Uri& relative_ref, std::string& target) const
+    {
+        impl_->ResolveInto(relative_ref, target);
+    }
+
+    bool ResolvedBase::ResolveInto(const std::string& relative_ref, std::string& target) const
+    {
+        return impl_->ResolveInto(relative_ref, target);
+    }
+
+    void ResolvedBase::ResolveAll(const std::vector<Uri>& relative_refs,
+                                  std::vector<Uri>& targets) const
+    {
+        targets.resize(relative_refs.size());
+        for (size_t i = 0; i < relative_refs.size(); ++i)
+        {
+            impl_->ResolveInto(relative_refs[i], targets[i]);
+        }
+    }
+
+    void ResolvedBase::ResolveAll(const std::vector<Uri>& relative_refs,
+                                  std::vector<std::string>& targets) const
+    {
+        targets.resize(relative_refs.size());
+        for (size_t i = 0; i < relative_refs.size(); ++i)
+        {
+            impl_->ResolveInto(relative_refs[i], targets[i]);
+        }
+    }
+
+    size_t ResolvedBase::ResolveAll(const std::vector<std::string>& relative_refs,
+                                    std::vector<Uri>& targets) const
+    {
+        targets.resize(relative_refs.size());
+        size_t resolved = 0;
+        Uri reference;
+        for (size_t i = 0; i < relative_refs.size(); ++i)
+        {
+            if (reference.ParseFromString(relative_refs[i]))
+            {
+                impl_->ResolveInto(reference, targets[i]);
+                ++resolved;
+            }
+            else
+            {
+                targets[i] = Uri();
+            }
+        }
+        return resolved;
+    }
+
+    size_t ResolvedBase::ResolveAll(const std::vector<std::string>& relative_refs,
+                                    std::vector<std::string>& targets) const
+    {
+        targets.resize(relative_refs.size());
+        size_t resolved = 0;
+        for (size_t i = 0; i < relative_refs.size(); ++i)
+        {
+            if (impl_->ResolveInto(relative_refs[i], targets[i]))
+            {
+                ++resolved;
+            }
+        }
+        return resolved;
+    }
+
+    Uri ResolvedBase::MakeRelative(const Uri& target) const
+    {
+        Uri relative_ref;
+        impl_->MakeRelativeInto(target, relative_ref);
+        return relative_ref;
+    }
+
+    void ResolvedBase::MakeRelativeAll(const std::vector<Uri>& targets,
+                                       std::vector<Uri>& relative_refs) const
+    {
+        relative_refs.resize(targets.size());
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            impl_->MakeRelativeInto(targets[i], relative_refs[i]);
+        }
+    }
+
+    void ResolvedBase::MakeRelativeAll(const std::vector<Uri>& targets,
+                                       std::vector<std::string>& relative_refs) const
+    {
+        relative_refs.resize(targets.size());
+        Uri relative_ref;
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            impl_->MakeRelativeInto(targets[i], relative_ref);
+            relative_refs[i] = relative_ref.GenerateString();
+        }
+    }
+}
@@ -0,0 +1,261 @@
+#include "RegisteredScheme.hpp"
+#include "UriGrammar.hpp"
+#include <atomic>
+#include <ctype.h>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+    constexpr Uri::SchemePolicy BUILTIN_POLICIES[] = {
+        Uri::HttpScheme::POLICY,
+        Uri::HttpsScheme::POLICY,
+        Uri::WsScheme::POLICY,
+        Uri::WssScheme::POLICY,
+        Uri::FtpScheme::POLICY,
+        Uri::FileScheme::POLICY,
+        Uri::MailtoScheme::POLICY,
+        Uri::UrnScheme::POLICY,
+        Uri::DataScheme::POLICY,
+    };
+
+    constexpr Uri::SchemeId FIRST_BUILTIN_SCHEME = Uri::HttpScheme::ID;
+    constexpr size_t NUM_BUILTINS = sizeof(BUILTIN_POLICIES) / sizeof(BUILTIN_POLICIES[0]);
+    static_assert(
+        FIRST_BUILTIN_SCHEME + NUM_BUILTINS == Uri::SchemeRegistry::FIRST_CUSTOM_SCHEME,
+        "built-in scheme IDs must be consecutive"
+    );
+
+    // The built-in names are all letters and at most this long, so one
+    // masked word comparison matches them case-insensitively: setting bit
+    // 5 of every byte lower-cases letters, and only the two cases of a
+    // letter become that letter.
+    constexpr size_t MAX_BUILTIN_LENGTH = sizeof(uint64_t);
+    const uint64_t CASE_BITS = 0x2020202020202020;
+
+    // A perfect hash of the built-in names, from their lengths and their
+    // first and last letters in either case.
+    constexpr size_t BUILTIN_TABLE_SIZE = 16;
+    constexpr uint8_t NO_BUILTIN = 0xFF;
+
+    constexpr size_t BuiltinSlot(size_t length, char first, char last)
+    {
+        return (
+            (size_t)(uint8_t)(first | 0x20)
+            + 7 * (size_t)(uint8_t)(last | 0x20)
+            + 8 * length
+        ) % BUILTIN_TABLE_SIZE;
+    }
+
+    struct BuiltinTable
+    {
+        uint8_t slots[BUILTIN_TABLE_SIZE] = {};
+        bool is_perfect = true;
+    };
+
+    constexpr bool IsLowerCaseWord(std::string_view name)
+    {
+        if (name.empty() || (name.length() > MAX_BUILTIN_LENGTH))
+        {
+            return false;
+        }
+        for (const auto c: name)
+        {
+            if ((c < 'a') || (c > 'z'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr BuiltinTable MakeBuiltinTable()
+    {
+        BuiltinTable table;
+        for (auto& slot: table.slots)
+        {
+            slot = NO_BUILTIN;
+        }
+        for (size_t i = 0; i < NUM_BUILTINS; ++i)
+        {
+            const auto name = BUILTIN_POLICIES[i].name;
+            if (!IsLowerCaseWord(name))
+            {
+                table.is_perfect = false;
+                continue;
+            }
+            auto& slot = table.slots[BuiltinSlot(name.length(), name.front(), name.back())];
+            if (slot != NO_BUILTIN)
+            {
+                table.is_perfect = false;
+            }
+            slot = (uint8_t)i;
+        }
+        return table;
+    }
+
+    constexpr BuiltinTable BUILTIN_TABLE = MakeBuiltinTable();
+    static_assert(BUILTIN_TABLE.is_perfect, "built-in scheme names must hash without collisions");
+
+    uint64_t LoadFoldedWord(std::string_view name)
+    {
+        uint64_t word = 0;
+        (void)memcpy(&word, name.data(), name.length());
+        return word | CASE_BITS;
+    }
+
+    Uri::RegisteredScheme MakeEntry(const Uri::SchemePolicy& policy, Uri::SchemeId id)
+    {
+        Uri::RegisteredScheme entry;
+        std::string name(policy.name);
+        for (auto& c: name)
+        {
+            c = (char)tolower((unsigned char)c);
+        }
+        entry.name = std::move(name);
+        entry.policy = policy;
+        entry.policy.name = *entry.name;
+        entry.id = id;
+        return entry;
+    }
+
+    struct Registry
+    {
+        Uri::RegisteredScheme builtins[NUM_BUILTINS];
+        uint64_t builtin_words[NUM_BUILTINS];
+
+        // Entries are never removed, so pointers to them stay valid.
+        std::shared_mutex mutex;
+        std::deque< Uri::RegisteredScheme > custom;
+        std::unordered_map< std::string, const Uri::RegisteredScheme* > index;
+        std::atomic< bool > has_custom{false};
+
+        Registry()
+        {
+            for (size_t i = 0; i < NUM_BUILTINS; ++i)
+            {
+                builtins[i] = MakeEntry(BUILTIN_POLICIES[i], (Uri::SchemeId)(FIRST_BUILTIN_SCHEME + i));
+                builtin_words[i] = LoadFoldedWord(*builtins[i].name);
+            }
+        }
+
+        const Uri::RegisteredScheme* FindBuiltin(std::string_view scheme) const
+        {
+            if (scheme.empty() || (scheme.length() > MAX_BUILTIN_LENGTH))
+            {
+                return nullptr;
+            }
+            const auto i = BUILTIN_TABLE.slots[BuiltinSlot(scheme.length(), scheme.front(), scheme.back())];
+            if ((i == NO_BUILTIN)
+                || (builtins[i].name->length() != scheme.length())
+                || (builtin_words[i] != LoadFoldedWord(scheme)))
+            {
+                return nullptr;
+            }
+            return &builtins[i];
+        }
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+}
+
+namespace Uri
+{
+    const RegisteredScheme* FindRegisteredScheme(std::string_view scheme)
+    {
+        auto& registry = GetRegistry();
+        const auto builtin = registry.FindBuiltin(scheme);
+        if ((builtin != nullptr)
+            || !registry.has_custom.load(std::memory_order_acquire))
+        {
+            return builtin;
+        }
+        std::shared_lock< std::shared_mutex > lock(registry.mutex);
+        const auto name = ToLower(std::string(scheme));
+        const auto entry = registry.index.find(name);
+        return ((entry == registry.index.end()) ? nullptr : entry->second);
+    }
+
+    const RegisteredScheme* FindRegisteredScheme(SchemeId id)
+    {
+        auto& registry = GetRegistry();
+        if (id < FIRST_BUILTIN_SCHEME)
+        {
+            return nullptr;
+        }
+        if (id < SchemeRegistry::FIRST_CUSTOM_SCHEME)
+        {
+            return &registry.builtins[id - FIRST_BUILTIN_SCHEME];
+        }
+        if (!registry.has_custom.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        std::shared_lock< std::shared_mutex > lock(registry.mutex);
+        const size_t position = id - SchemeRegistry::FIRST_CUSTOM_SCHEME;
+        return ((position < registry.custom.size()) ? &registry.custom[position] : nullptr);
+    }
+
+    constexpr SchemeId SchemeRegistry::NO_SCHEME;
+    constexpr SchemeId SchemeRegistry::UNREGISTERED_SCHEME;
+    constexpr SchemeId SchemeRegistry::FIRST_CUSTOM_SCHEME;
+
+    bool SchemeRegistry::Register(const SchemePolicy& policy)
+    {
+        if (!IsLegalScheme(policy.name))
+        {
+            return false;
+        }
+        auto& registry = GetRegistry();
+        if (registry.FindBuiltin(policy.name) != nullptr)
+        {
+            return false;
+        }
+        std::unique_lock< std::shared_mutex > lock(registry.mutex);
+        const size_t id = FIRST_CUSTOM_SCHEME + registry.custom.size();
+        if (id > UINT16_MAX)
+        {
+            return false;
+        }
+        auto entry = MakeEntry(policy, (SchemeId)id);
+        if (registry.index.find(*entry.name) != registry.index.end())
+        {
+            return false;
+        }
+        registry.custom.push_back(std::move(entry));
+        registry.index[*registry.custom.back().name] = &registry.custom.back();
+        registry.has_custom.store(true, std::memory_order_release);
+        return true;
+    }
+
+    const SchemePolicy* SchemeRegistry::Find(std::string_view scheme)
+    {
+        const auto entry = FindRegisteredScheme(scheme);
+        return ((entry == nullptr) ? nullptr : &entry->policy);
+    }
+
+    const SchemePolicy* SchemeRegistry::Find(SchemeId id)
+    {
+        const auto entry = FindRegisteredScheme(id);
+        return ((entry == nullptr) ? nullptr : &entry->policy);
+    }
+
+    SchemeId SchemeRegistry::FindId(std::string_view scheme)
+    {
+        if (scheme.empty())
+        {
+            return NO_SCHEME;
+        }
+        const auto entry = FindRegisteredScheme(scheme);
+        return ((entry == nullptr) ? UNREGISTERED_SCHEME : entry->id);
+    }
+}
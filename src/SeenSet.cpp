@@ -0,0 +1,506 @@
+#include "Hash.hpp"
+#include "ReferenceResolver.hpp"
+#include "UriImpl.hpp"
+#include <Uri/SeenSet.hpp>
+#include <fstream>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#endif
+#endif
+
+namespace
+{
+    const size_t GROUP_SIZE = 16;
+    const size_t MINIMUM_CAPACITY = GROUP_SIZE;
+    const uint8_t EMPTY = 0x80;
+
+    const uint32_t FILE_MAGIC = 0x4E455355;
+    const uint32_t FILE_VERSION = 1;
+    const uint32_t FILE_BYTE_ORDER_MARK = 0x01020304;
+
+    struct Fingerprint
+    {
+        uint64_t low = 0;
+        uint64_t high = 0;
+    };
+
+    uint32_t MatchTag(const uint8_t* group, uint8_t tag)
+    {
+#if defined(__SSE2__)
+        const auto control = _mm_loadu_si128((const __m128i*)group);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8((char)tag)));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i)
+        {
+            if (group[i] == tag)
+            {
+                mask |= (1u << i);
+            }
+        }
+        return mask;
+#endif
+    }
+
+    uint32_t MatchEmpty(const uint8_t* group)
+    {
+#if defined(__SSE2__)
+        return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_SIZE; ++i)
+        {
+            if (group[i] & EMPTY)
+            {
+                mask |= (1u << i);
+            }
+        }
+        return mask;
+#endif
+    }
+
+    // mask must not be zero.
+    size_t LowestBit(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        (void)_BitScanForward(&index, mask);
+        return (size_t)index;
+#else
+        return (size_t)__builtin_ctz(mask);
+#endif
+    }
+
+    void PrefetchForRead(const void* address)
+    {
+#if defined(_MSC_VER)
+#if defined(_M_X64) || defined(_M_IX86)
+        _mm_prefetch((const char*)address, _MM_HINT_T0);
+#else
+        (void)address;
+#endif
+#else
+        __builtin_prefetch(address);
+#endif
+    }
+
+    size_t CapacityFor(size_t expected_count)
+    {
+        size_t capacity = MINIMUM_CAPACITY;
+        while (capacity - capacity / 8 < expected_count)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    template< typename T >
+    void WriteValue(std::ofstream& file, T value)
+    {
+        file.write((const char*)&value, sizeof(value));
+    }
+
+    template< typename T >
+    bool ReadValue(std::ifstream& file, T& value)
+    {
+        return (bool)file.read((char*)&value, sizeof(value));
+    }
+}
+
+namespace Uri
+{
+    struct SeenSet::Impl
+    {
+        bool wide = false;
+        size_t size = 0;
+        std::vector< uint8_t > control;
+        std::vector< uint64_t > low;
+        std::vector< uint64_t > high;
+        std::string scratch;
+
+        void Allocate(size_t capacity)
+        {
+            size = 0;
+            control.assign(capacity, EMPTY);
+            low.assign(capacity, 0);
+            high.assign(wide ? capacity : 0, 0);
+        }
+
+        size_t Capacity() const
+        {
+            return control.size();
+        }
+
+        static uint8_t Tag(const Fingerprint& fingerprint)
+        {
+            return (uint8_t)(fingerprint.low >> 57);
+        }
+
+        size_t FirstGroup(const Fingerprint& fingerprint) const
+        {
+            return (size_t)fingerprint.low & (Capacity() / GROUP_SIZE - 1);
+        }
+
+        Fingerprint FingerprintOf(const std::string& normalized) const
+        {
+            Fingerprint fingerprint;
+            if (wide)
+            {
+                const auto hash = HashString128(normalized);
+                fingerprint.low = hash.low;
+                fingerprint.high = hash.high;
+            }
+            else
+            {
+                fingerprint.low = HashString64(normalized);
+            }
+            return fingerprint;
+        }
+
+        static void Normalize(const Uri& uri, std::string& buffer)
+        {
+            buffer.clear();
+            (void)SerializeToBuffer(DecodedSource< Uri::Impl >(*uri.impl_), buffer, true);
+        }
+
+        static bool Normalize(const std::string& uri_string, std::string& buffer)
+        {
+            EncodedSource source;
+            if (!source.Parse(uri_string, buffer))
+            {
+                return false;
+            }
+            buffer.clear();
+            return SerializeToBuffer(source, buffer, true);
+        }
+
+        // Returns whether the fingerprint is present; if it is not, slot is
+        // where it would be inserted.
+        bool Find(const Fingerprint& fingerprint, size_t& slot) const
+        {
+            const auto tag = Tag(fingerprint);
+            const auto group_mask = Capacity() / GROUP_SIZE - 1;
+            auto group = FirstGroup(fingerprint);
+            for (size_t step = 1; ; ++step)
+            {
+                const auto group_start = group * GROUP_SIZE;
+                const auto* group_control = &control[group_start];
+                for (auto matches = MatchTag(group_control, tag); matches != 0; matches &= matches - 1)
+                {
+                    const auto candidate = group_start + LowestBit(matches);
+                    if ((low[candidate] == fingerprint.low)
+                        && (!wide || (high[candidate] == fingerprint.high)))
+                    {
+                        slot = candidate;
+                        return true;
+                    }
+                }
+                const auto empties = MatchEmpty(group_control);
+                if (empties != 0)
+                {
+                    slot = group_start + LowestBit(empties);
+                    return false;
+                }
+                group = (group + step) & group_mask;
+            }
+        }
+
+        void Place(const Fingerprint& fingerprint, size_t slot)
+        {
+            control[slot] = Tag(fingerprint);
+            low[slot] = fingerprint.low;
+            if (wide)
+            {
+                high[slot] = fingerprint.high;
+            }
+            ++size;
+        }
+
+        void Reserve(size_t count)
+        {
+            const auto capacity = CapacityFor(count);
+            if (capacity <= Capacity())
+            {
+                return;
+            }
+            const auto old_control = std::move(control);
+            const auto old_low = std::move(low);
+            const auto old_high = std::move(high);
+            Allocate(capacity);
+            for (size_t i = 0; i < old_control.size(); ++i)
+            {
+                if ((old_control[i] & EMPTY) == 0)
+                {
+                    Fingerprint fingerprint;
+                    fingerprint.low = old_low[i];
+                    fingerprint.high = wide ? old_high[i] : 0;
+                    size_t slot;
+                    (void)Find(fingerprint, slot);
+                    Place(fingerprint, slot);
+                }
+            }
+        }
+
+        InsertResult Insert(const Fingerprint& fingerprint)
+        {
+            size_t slot;
+            if (Find(fingerprint, slot))
+            {
+                return InsertResult::ALREADY_PRESENT;
+            }
+            if (size + 1 > Capacity() - Capacity() / 8)
+            {
+                Reserve(size + 1);
+                (void)Find(fingerprint, slot);
+            }
+            Place(fingerprint, slot);
+            return InsertResult::INSERTED;
+        }
+
+        void Prefetch(const Fingerprint& fingerprint) const
+        {
+            const auto group_start = FirstGroup(fingerprint) * GROUP_SIZE;
+            PrefetchForRead(&control[group_start]);
+            PrefetchForRead(&low[group_start]);
+        }
+
+        size_t InsertBatch(const std::vector< Fingerprint >& fingerprints,
+                           std::vector< InsertResult >& results)
+        {
+            const size_t PREFETCH_DISTANCE = 8;
+            size_t inserted = 0;
+            for (size_t i = 0; i < fingerprints.size(); ++i)
+            {
+                if (i + PREFETCH_DISTANCE < fingerprints.size())
+                {
+                    Prefetch(fingerprints[i + PREFETCH_DISTANCE]);
+                }
+                if (results[i] == InsertResult::INVALID_URI)
+                {
+                    continue;
+                }
+                results[i] = Insert(fingerprints[i]);
+                if (results[i] == InsertResult::INSERTED)
+                {
+                    ++inserted;
+                }
+            }
+            return inserted;
+        }
+    };
+
+    SeenSet::~SeenSet() noexcept = default;
+
+    SeenSet::SeenSet(const SeenSet& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+
+    SeenSet::SeenSet(SeenSet&&) noexcept = default;
+
+    SeenSet& SeenSet::operator=(const SeenSet& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+
+    SeenSet& SeenSet::operator=(SeenSet&&) noexcept = default;
+
+    SeenSet::SeenSet()
+        : SeenSet(0)
+    {
+    }
+
+    SeenSet::SeenSet(size_t expected_count, FingerprintBits bits)
+        : impl_(new Impl)
+    {
+        impl_->wide = (bits == FingerprintBits::BITS_128);
+        impl_->Allocate(CapacityFor(expected_count));
+    }
+
+    SeenSet::InsertResult SeenSet::Insert(const Uri& uri)
+    {
+        Impl::Normalize(uri, impl_->scratch);
+        return impl_->Insert(impl_->FingerprintOf(impl_->scratch));
+    }
+
+    SeenSet::InsertResult SeenSet::Insert(const std::string& uri_string)
+    {
+        if (!Impl::Normalize(uri_string, impl_->scratch))
+        {
+            return InsertResult::INVALID_URI;
+        }
+        return impl_->Insert(impl_->FingerprintOf(impl_->scratch));
+    }
+
+    bool SeenSet::Contains(const Uri& uri) const
+    {
+        std::string normalized;
+        Impl::Normalize(uri, normalized);
+        size_t slot;
+        return impl_->Find(impl_->FingerprintOf(normalized), slot);
+    }
+
+    bool SeenSet::Contains(const std::string& uri_string) const
+    {
+        std::string normalized;
+        if (!Impl::Normalize(uri_string, normalized))
+        {
+            return false;
+        }
+        size_t slot;
+        return impl_->Find(impl_->FingerprintOf(normalized), slot);
+    }
+
+    size_t SeenSet::InsertAll(const std::vector<Uri>& uris, std::vector<InsertResult>& results)
+    {
+        std::vector< Fingerprint > fingerprints(uris.size());
+        results.assign(uris.size(), InsertResult::INSERTED);
+        for (size_t i = 0; i < uris.size(); ++i)
+        {
+            Impl::Normalize(uris[i], impl_->scratch);
+            fingerprints[i] = impl_->FingerprintOf(impl_->scratch);
+        }
+        return impl_->InsertBatch(fingerprints, results);
+    }
+
+    size_t SeenSet::InsertAll(const std::vector<std::string>& uri_strings, std::vector<InsertResult>& results)
+    {
+        std::vector< Fingerprint > fingerprints(uri_strings.size());
+        results.assign(uri_strings.size(), InsertResult::INSERTED);
+        for (size_t i = 0; i < uri_strings.size(); ++i)
+        {
+            if (Impl::Normalize(uri_strings[i], impl_->scratch))
+            {
+                fingerprints[i] = impl_->FingerprintOf(impl_->scratch);
+            }
+            else
+            {
+                results[i] = InsertResult::INVALID_URI;
+            }
+        }
+        return impl_->InsertBatch(fingerprints, results);
+    }
+
+    void SeenSet::Clear()
+    {
+        impl_->Allocate(MINIMUM_CAPACITY);
+    }
+
+    size_t SeenSet::Size() const
+    {
+        return impl_->size;
+    }
+
+    size_t SeenSet::Capacity() const
+    {
+        return impl_->Capacity();
+    }
+
+    size_t SeenSet::MemoryUsage() const
+    {
+        return sizeof(Impl)
+            + impl_->control.capacity()
+            + impl_->low.capacity() * sizeof(uint64_t)
+            + impl_->high.capacity() * sizeof(uint64_t)
+            + impl_->scratch.capacity();
+    }
+
+    SeenSet::FingerprintBits SeenSet::GetFingerprintBits() const
+    {
+        return impl_->wide ? FingerprintBits::BITS_128 : FingerprintBits::BITS_64;
+    }
+
+    bool SeenSet::SaveToFile(const std::string& file_path) const
+    {
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+        WriteValue(file, FILE_MAGIC);
+        WriteValue(file, FILE_VERSION);
+        WriteValue(file, FILE_BYTE_ORDER_MARK);
+        WriteValue(file, (uint32_t)(impl_->wide ? 128 : 64));
+        WriteValue(file, (uint64_t)impl_->Capacity());
+        WriteValue(file, (uint64_t)impl_->size);
+        file.write((const char*)impl_->control.data(), impl_->control.size());
+        file.write((const char*)impl_->low.data(), impl_->low.size() * sizeof(uint64_t));
+        file.write((const char*)impl_->high.data(), impl_->high.size() * sizeof(uint64_t));
+        return (bool)file;
+    }
+
+    bool SeenSet::LoadFromFile(const std::string& file_path)
+    {
+        std::ifstream file(file_path, std::ios::binary);
+        uint32_t magic, version, byte_order_mark, bits;
+        uint64_t capacity, size;
+        if (!file
+            || !ReadValue(file, magic)
+            || !ReadValue(file, version)
+            || !ReadValue(file, byte_order_mark)
+            || !ReadValue(file, bits)
+            || !ReadValue(file, capacity)
+            || !ReadValue(file, size))
+        {
+            return false;
+        }
+        if ((magic != FILE_MAGIC)
+            || (version != FILE_VERSION)
+            || (byte_order_mark != FILE_BYTE_ORDER_MARK)
+            || ((bits != 64) && (bits != 128))
+            || (capacity < MINIMUM_CAPACITY)
+            || ((capacity & (capacity - 1)) != 0)
+            || (size > capacity - capacity / 8))
+        {
+            return false;
+        }
+
+        // Check that the file holds the whole table before allocating it,
+        // so that a corrupt capacity fails here rather than allocating.
+        const uint64_t bytes_per_slot = 1 + sizeof(uint64_t) * ((bits == 128) ? 2 : 1);
+        const auto header_end = file.tellg();
+        file.seekg(0, std::ios::end);
+        const auto file_end = file.tellg();
+        file.seekg(header_end);
+        if (!file
+            || (header_end < 0)
+            || (file_end < header_end)
+            || (capacity > (uint64_t)(file_end - header_end) / bytes_per_slot))
+        {
+            return false;
+        }
+        Impl loaded;
+        loaded.wide = (bits == 128);
+        loaded.Allocate((size_t)capacity);
+        loaded.size = (size_t)size;
+        if (!file.read((char*)loaded.control.data(), loaded.control.size())
+            || !file.read((char*)loaded.low.data(), loaded.low.size() * sizeof(uint64_t))
+            || !file.read((char*)loaded.high.data(), loaded.high.size() * sizeof(uint64_t)))
+        {
+            return false;
+        }
+        size_t occupied = 0;
+        for (auto control_byte: loaded.control)
+        {
+            if ((control_byte & EMPTY) == 0)
+            {
+                ++occupied;
+            }
+        }
+        if (occupied != loaded.size)
+        {
+            return false;
+        }
+        *impl_ = std::move(loaded);
+        return true;
+    }
+}
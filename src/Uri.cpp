@@ -1,1047 +1,894 @@
 
 
 #include "CharacterSet.hpp"
+#include "Instrumentation.hpp"
 #include "PercentEncodedCharacterDecoder.hpp"
+#include "ReferenceResolver.hpp"
+#include "RegisteredScheme.hpp"
+#include "UriGrammar.hpp"
+#include "UriImpl.hpp"
+#include "Utf8.hpp"
 #include <algorithm>
 #include <limits>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <inttypes.h>
 #include <stdint.h>
 #include <functional>
+#include <Uri/Iri.hpp>
+#include <Uri/PublicSuffixList.hpp>
 #include <Uri/Uri.hpp>
+#include <Uri/UriView.hpp>
 
 
-namespace 
+namespace
 {
-    const Uri::CharacterSet ALPHA{
-        Uri::CharacterSet('a', 'z'),
-        Uri::CharacterSet('A', 'Z')
-    };
-
-    const Uri::CharacterSet DIGIT('0', '9');
-
-    const Uri::CharacterSet HEXDIG{
-        Uri::CharacterSet('0', '9'),
-        Uri::CharacterSet('A', 'F'),
-        Uri::CharacterSet('a', 'f')
-    };
-
-    const Uri::CharacterSet UNRESERVED{
-        ALPHA,
-        DIGIT,
-        '-', '.', '_', '~'
-    };
-
-    const Uri::CharacterSet SUB_DELIMS{
-        '!', '$', '&', '\'', '(', ')',
-        '*', '+', ',', ';', '='
-    };
-
-    const Uri::CharacterSet SCHEME_NOT_FIRST{
-        ALPHA,
-        DIGIT,
-        '+', '-', '.',
-    };
-
-    const Uri::CharacterSet PCHAR_NOT_PCT_ENCODED{
-        UNRESERVED,
-        SUB_DELIMS,
-        ':', '@'
-    };
-
-    const Uri::CharacterSet QUERY_OR_FRAGMENT_NOT_PCT_ENCODED{
-        PCHAR_NOT_PCT_ENCODED,
-        '/', '?'
-    };
-
-    const Uri::CharacterSet QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS{
-        UNRESERVED,
-        '!', '$', '&', '\'', '(', ')',
-        '*', ',', ';', '=',
-        ':', '@',
-        '/', '?'
-    };
-
-  
-    const Uri::CharacterSet USER_INFO_NOT_PCT_ENCODED{
-        UNRESERVED,
-        SUB_DELIMS,
-        ':',
-    };
-
-   
-    const Uri::CharacterSet REG_NAME_NOT_PCT_ENCODED{
-        UNRESERVED,
-        SUB_DELIMS
-    };
-    const Uri::CharacterSet IPV_FUTURE_LAST_PART{
-        UNRESERVED,
-        SUB_DELIMS,
-        ':'
-    };
-
-    std::function< bool(char, bool) > LegalSchemeCheckStrategy() 
-    {
-        auto is_first_character = std::make_shared< bool >(true);
-        return [is_first_character](char c, bool end)
-        {
-            if (end) 
-            {
-                return !*is_first_character;
-            } 
-            else 
-            {
-                bool check;
-                if (*is_first_character) 
-                {
-                    check = ALPHA.Contains(c);
-                } 
-                else 
-                {
-                    check = SCHEME_NOT_FIRST.Contains(c);
-                }
-                *is_first_character = false;
-                return check;
-            }
-        };
-    }
-
-    enum class ToIntegerResult 
+    // Whether Uri::Impl::NormalizePath would change the path: it removes
+    // "." and ".." segments and collapses runs of empty segments.
+    bool PathHasDotSegmentsOrEmptyRuns(const std::vector<std::string>& path)
     {
-        SUCCESS,
-        NOTNUMBER,
-        OVERFLOW_
-    };
-
-    ToIntegerResult ToInteger( const std::string& number_string, intmax_t& number) 
-    {
-        size_t index = 0;
-        size_t state = 0;
-        bool negative = false;
-        intmax_t value = 0;
-        while (index < number_string.size()) 
+        bool previous_empty = false;
+        for (const auto& segment: path)
         {
-            switch (state) 
+            if ((segment == ".")
+                || (segment == "..")
+                || (previous_empty && segment.empty()))
             {
-                case 0: 
-                {
-                    if (number_string[index] == '-') 
-                    {
-                        negative = true;
-                        ++index;
-                    }
-                    state = 1;
-                } break;
-
-                case 1:
-                {
-                    if (number_string[index] == '0') {
-                        state = 2;
-                    } 
-                    else if ((number_string[index] >= '1') && (number_string[index] <= '9'))
-                    {
-                        state = 3;
-                        value = (decltype(value))(number_string[index] - '0');
-                        value = (value * (negative ? -1 : 1));
-                    } 
-                    else 
-                    {
-                        return ToIntegerResult::NOTNUMBER;
-                    }
-                    ++index;
-                } break;
-
-                case 2: 
-                { 
-                    return ToIntegerResult::NOTNUMBER;
-                } break;
-
-                case 3: 
-                { 
-                    if ((number_string[index] >= '0') && (number_string[index] <= '9')) 
-                    {
-                        const auto digit = (decltype(value))(number_string[index] - '0');
-                        if (negative) 
-                        {
-                            if ((std::numeric_limits< decltype(value) >::lowest() + digit) / 10 > value) 
-                            {
-                                return ToIntegerResult::OVERFLOW_;
-                            }
-                        } 
-                        else 
-                        {
-                            if ((std::numeric_limits< decltype(value) >::max() - digit) / 10 < value) 
-                            {
-                                return ToIntegerResult::OVERFLOW_;
-                            }
-                        }
-                        value *= 10;
-                        if (negative) 
-                        {
-                            value -= digit;
-                        } 
-                        else 
-                        {
-                            value += digit;
-                        }
-                        ++index;
-                    } 
-                    else
-                    {
-                        return ToIntegerResult::NOTNUMBER;
-                    }
-                } break;
+                return true;
             }
+            previous_empty = segment.empty();
         }
-        if (state >= 2) 
-        {
-            number = value;
-            return ToIntegerResult::SUCCESS;
-        } 
-        else 
-        {
-            return ToIntegerResult::NOTNUMBER;
-        }
+        return false;
     }
+}
 
-    
-
-    std::string ToLower(const std::string& in_string) 
+namespace Uri
+{
+    bool Uri::Impl::ParseAuthority(std::string_view authority_string)
     {
-        std::string out_string;
-        out_string.reserve(in_string.size());
-        for (char c: in_string) 
+        enum class HostParsingState
         {
-            out_string.push_back(tolower(c));
-        }
-        return out_string;
-    }
+            FIRST_CHARACTER,
+            NOT_IP_LITERAL,
+            PERCENT_ENCODED_CHARACTER,
+            IP_LITERAL,
+            IPV6_ADDRESS,
+            IPV_FUTURE_NUMBER,
+            IPV_FUTURE_BODY,
+            GARBAGE_CHECK,
+            PORT,
+        };
 
-    bool FailsMatch(const std::string& candidate, std::function< bool(char, bool) > still_passing) {
-        for (const auto c: candidate) 
+        const auto user_info_delimiter = authority_string.find('@');
+        std::string_view host_port_string;
+        user_info.Clear();
+        if (user_info_delimiter == std::string_view::npos)
         {
-            if (!still_passing(c, false)) 
-            {
-                return true;
-            }
-        }
-        return !still_passing(' ', true);
-    }
-
-    bool ValidateOctet(const std::string& octet_string) 
-    {
-        int octet = 0;
-        for (auto c: octet_string) 
+            host_port_string = authority_string;
+        } 
+        else 
         {
-            if (DIGIT.Contains(c)) 
-            {
-                octet *= 10;
-                octet += (int)(c - '0');
-            } 
-            else 
+            std::string decoded_user_info(authority_string.substr(0, user_info_delimiter));
+            if (!DecodeElement(decoded_user_info, USER_INFO_NOT_PCT_ENCODED)) 
             {
                 return false;
             }
+            user_info = std::move(decoded_user_info);
+            host_port_string = authority_string.substr(user_info_delimiter + 1);
         }
-        return (octet <= 255);
-    }
 
-       bool ValidateIpv4Adress(const std::string& address) {
-        size_t num_groups = 0;
-        size_t state = 0;
-        std::string octet_buffer;
-        for (auto c: address) 
+       
+        std::string port_string;
+        HostParsingState host_parsing_state = HostParsingState::FIRST_CHARACTER;
+        std::string parsed_host;
+        PercentEncodedCharacterDecoder pec_decoder;
+        bool hostIsRegName = false;
+        for (const auto c: host_port_string) 
         {
-            switch (state) 
+            switch(host_parsing_state) 
             {
-                case 0: 
+                case HostParsingState::FIRST_CHARACTER: 
                 {
-                    if (DIGIT.Contains(c)) 
+                    if (c == '[') 
                     {
-                        octet_buffer.push_back(c);
-                        state = 1;
+                        host_parsing_state = HostParsingState::IP_LITERAL;
+                        break;
                     } 
                     else 
                     {
-                        return false;
+                        host_parsing_state = HostParsingState::NOT_IP_LITERAL;
+                        hostIsRegName = true;
                     }
-                } break;
+                }
 
-                case 1: 
-                { 
-                    if (c == '.') 
+                case HostParsingState::NOT_IP_LITERAL: 
+                {
+                    if (c == '%') 
                     {
-                        if (num_groups++ >= 4) 
-                        {
-                            return false;
-                        }
-                        if (!ValidateOctet(octet_buffer)) 
-                        {
-                            return false;
-                        }
-                        octet_buffer.clear();
-                        state = 0;
+                        pec_decoder = PercentEncodedCharacterDecoder();
+                        host_parsing_state = HostParsingState::PERCENT_ENCODED_CHARACTER;
                     } 
-                    else if (DIGIT.Contains(c)) 
+                    else if (c == ':')
                     {
-                        octet_buffer.push_back(c);
+                        host_parsing_state = HostParsingState::PORT;
                     } 
                     else 
                     {
-                        return false;
+                        if (REG_NAME_NOT_PCT_ENCODED.Contains(c)) 
+                        {
+                            parsed_host.push_back(c);
+                        }
+                        else 
+                        {
+                            return false;
+                        }
                     }
                 } break;
-            }
-        }
-        if (!octet_buffer.empty()) 
-        {
-            ++num_groups;
-            if (!ValidateOctet(octet_buffer)) {
-                return false;
-            }
-        }
-        return (num_groups == 4);
-    }
-
-    bool ValidateIpv6Address(const std::string& address) 
-    {
-        
-        enum class ValidationState 
-        {
-            NO_GROUPS_YET,
-            COLON_BUT_NO_GROUPS_YET,
-            AFTER_COLON_EXPECT_GROUP_OR_IPV4,
-            IN_GROUP_NOT_IPV4,
-            IN_GROUP_COULD_BE_IPV4,
-            COLON_AFTER_GROUP,
-        } state = ValidationState::NO_GROUPS_YET;
-       
-        size_t num_groups = 0;
-        size_t num_digits = 0;
-        size_t ipv4_address_start = 0;
-        size_t position = 0;
-
-        bool double_colon_encountered = false;
-        bool ipv4_address_encountered = false;
 
-        for (auto c: address) 
-        {
-            switch (state) 
-            {
-                case ValidationState::NO_GROUPS_YET: 
+                case HostParsingState::PERCENT_ENCODED_CHARACTER: 
                 {
-                    if (c == ':') 
-                    {
-                        state = ValidationState::COLON_BUT_NO_GROUPS_YET;
-                    } 
-                    else if (DIGIT.Contains(c)) 
-                    {
-                        ipv4_address_start = position;
-                        ++num_digits = 1;
-                        state = ValidationState::IN_GROUP_COULD_BE_IPV4;
-                    } 
-                    else if (HEXDIG.Contains(c)) 
-                    {
-                        ++num_digits = 1;
-                        state = ValidationState::IN_GROUP_NOT_IPV4;
-                    } 
-                    else 
+                    if (!pec_decoder.NextEncodedCharacter(c)) 
                     {
                         return false;
                     }
+                    if (pec_decoder.Done()) 
+                    {
+                        host_parsing_state = HostParsingState::NOT_IP_LITERAL;
+                        parsed_host.push_back((char)pec_decoder.GetDecodedCharacter());
+                    }
                 } break;
 
-                case ValidationState::COLON_BUT_NO_GROUPS_YET: 
+                case HostParsingState::IP_LITERAL: 
                 {
-                    if (c == ':') 
+                    if (c == 'v') 
                     {
-                        if (double_colon_encountered) 
-                        {
-                            return false;
-                        } 
-                        else 
-                        {
-                            double_colon_encountered = true;
-                            state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
-                        }
+                        parsed_host.push_back(c);
+                        host_parsing_state = HostParsingState::IPV_FUTURE_NUMBER;
+                        break;
                     } 
                     else 
                     {
-                        return false;
+                        host_parsing_state = HostParsingState::IPV6_ADDRESS;
                     }
-                } break;
+                }
 
-                case ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4: 
+                case HostParsingState::IPV6_ADDRESS: 
                 {
-                    if (DIGIT.Contains(c)) 
+                    if (c == ']') 
                     {
-                        ipv4_address_start = position;
-                        if (++num_digits > 4) 
+                        if (!InstrumentStage(
+                                ParseInstrumentation::Stage::VALIDATE_IPV6_ADDRESS,
+                                parsed_host.length(),
+                                [&]{ return ValidateIpv6Address(parsed_host); }
+                            ))
                         {
                             return false;
                         }
-                        state = ValidationState::IN_GROUP_COULD_BE_IPV4;
-                    } 
-                    else if (HEXDIG.Contains(c)) 
-                    {
-                        if (++num_digits > 4) 
-                        {
-                            return false;
-                        }
-                        state = ValidationState::IN_GROUP_NOT_IPV4;
+                        host_parsing_state = HostParsingState::GARBAGE_CHECK;
                     } 
                     else 
                     {
-                        return false;
+                        parsed_host.push_back(c);
                     }
                 } break;
 
-                case ValidationState::IN_GROUP_NOT_IPV4: 
+                case HostParsingState::IPV_FUTURE_NUMBER: 
                 {
-                    if (c == ':') 
+                    if (c == '.')
                     {
-                        num_digits = 0;
-                        ++num_groups;
-                        state = ValidationState::COLON_AFTER_GROUP;
+                       host_parsing_state = HostParsingState::IPV_FUTURE_BODY;
                     } 
-                    else if (HEXDIG.Contains(c)) 
-                    {
-                        if (++num_digits > 4) 
-                        {
-                            return false;
-                        }
-                    } 
-                    else 
+                    else if (!HEXDIG.Contains(c)) 
                     {
                         return false;
                     }
+                    parsed_host.push_back(c);
                 } break;
 
-                case ValidationState::IN_GROUP_COULD_BE_IPV4: 
+                case HostParsingState::IPV_FUTURE_BODY: 
                 {
-                    if (c == ':') 
-                    {
-                        num_digits = 0;
-                        ++num_groups;
-                        state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
-                    } 
-                    else if (c == '.') 
-                    {
-                        ipv4_address_encountered = true;
-                        break;
-                    } 
-                    else if (DIGIT.Contains(c)) 
+                    if (c == ']') 
                     {
-                        if (++num_digits > 4) 
-                        {
-                            return false;
-                        }
+                        host_parsing_state = HostParsingState::GARBAGE_CHECK;
                     } 
-                    else if (HEXDIG.Contains(c)) 
+                    else if (!IPV_FUTURE_LAST_PART.Contains(c))
                     {
-                        if (++num_digits > 4) 
-                        {
-                            return false;
-                        }
-                        state = ValidationState::IN_GROUP_NOT_IPV4;
+                        return false;
                     } 
                     else 
                     {
-                        return false;
+                        parsed_host.push_back(c);
                     }
                 } break;
 
-                case ValidationState::COLON_AFTER_GROUP: 
-                {
+                case HostParsingState::GARBAGE_CHECK: 
+                {                
                     if (c == ':') 
                     {
-                        if (double_colon_encountered) 
-                        {
-                            return false;
-                        } 
-                        else 
-                        {
-                            double_colon_encountered = true;
-                            state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
-                        }
-                    } 
-                    else if (DIGIT.Contains(c)) 
-                    {
-                        ipv4_address_start = position;
-                        ++num_digits;
-                        state = ValidationState::IN_GROUP_COULD_BE_IPV4;
-                    } 
-                    else if (HEXDIG.Contains(c)) 
-                    {
-                        ++num_digits;
-                        state = ValidationState::IN_GROUP_NOT_IPV4;
+                        host_parsing_state = HostParsingState::PORT;
                     } 
                     else 
                     {
                         return false;
                     }
                 } break;
+
+                case HostParsingState::PORT:
+                {
+                    port_string.push_back(c);
+                } break;
             }
-            if (ipv4_address_encountered) 
-            {
-                break;
-            }
-            ++position;
         }
-        if ((state == ValidationState::IN_GROUP_NOT_IPV4)
-            || (state == ValidationState::IN_GROUP_COULD_BE_IPV4)) 
+        if (   (host_parsing_state != HostParsingState::FIRST_CHARACTER)
+            && (host_parsing_state != HostParsingState::NOT_IP_LITERAL)
+            && (host_parsing_state != HostParsingState::GARBAGE_CHECK)
+            && (host_parsing_state != HostParsingState::PORT))
         {
-            ++num_groups;
-        }
-        if ((position == address.length())
-            && ((state == ValidationState::COLON_BUT_NO_GROUPS_YET)
-             || (state == ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4)
-             || (state == ValidationState::COLON_AFTER_GROUP))) 
-        { 
             return false;
         }
-        if (ipv4_address_encountered) 
+        if (hostIsRegName) 
+        {
+            parsed_host = ToLower(parsed_host);
+        }
+        host = std::move(parsed_host);
+        if (port_string.empty()) 
+        {
+            has_port = false;
+        } else 
         {
-            if (!ValidateIpv4Adress(address.substr(ipv4_address_start))) 
+            intmax_t port_as_int;
+            if (ToInteger(
+                    port_string,
+                    port_as_int
+                ) != ToIntegerResult::SUCCESS) 
+            {
+                return false;
+            }
+            if ((port_as_int < 0)
+                || (port_as_int > (decltype(port_as_int))std::numeric_limits< decltype(port) >::max())) 
             {
                 return false;
             }
-            num_groups += 2;
+            port = (decltype(port))port_as_int;
+            has_port = true;
         }
-        if (double_colon_encountered) 
-        {
-            return (num_groups <= 7);
-        } 
-        else 
+        return true;
+    }
+
+    bool Uri::Impl::ParseScheme (std::string_view uri_string, std::string_view& rest)
+    {
+        auto authority_or_path_delimiter_start = uri_string.find('/');
+        if (authority_or_path_delimiter_start == std::string_view::npos) 
         {
-            return (num_groups == 8);
+            authority_or_path_delimiter_start = uri_string.length();
         }
+        const auto scheme_end = uri_string.substr(0, authority_or_path_delimiter_start).find(':');
+        if (scheme_end == std::string_view::npos) {
+            scheme.Clear();
+            scheme_id = SchemeRegistry::NO_SCHEME;
+            rest = uri_string;
+        } else {
+            if (!SetParsedScheme(uri_string.substr(0, scheme_end)))
+            {
+                return false;
+            }
+            rest = uri_string.substr(scheme_end + 1);
+        }
+        return true;
     }
 
-    bool DecodeElement(std::string& element, const Uri::CharacterSet& allowed_characters)
+    bool Uri::Impl::SetParsedScheme(std::string_view parsed_scheme)
     {
-        const auto original_segment = std::move(element);
-        element.clear();
-        bool decoding_pec = false;
-        Uri::PercentEncodedCharacterDecoder pec_decoder;
-        for (const auto c: original_segment) 
+        const auto registered = FindRegisteredScheme(parsed_scheme);
+        if (registered != nullptr)
         {
-            if (decoding_pec) 
-            {
-                if (!pec_decoder.NextEncodedCharacter(c)) 
-                {
-                    return false;
-                }
-                if (pec_decoder.Done()) 
-                {
-                    decoding_pec = false;
-                    element.push_back((char)pec_decoder.GetDecodedCharacter());
-                }
-            } 
-            else if (c == '%') 
-            {
-                decoding_pec = true;
-                pec_decoder = Uri::PercentEncodedCharacterDecoder();
-            } 
-            else 
+            scheme = registered->name;
+            scheme_id = registered->id;
+            return true;
+        }
+        if (!IsLegalScheme(parsed_scheme))
+        {
+            return false;
+        }
+        auto& lower_case = scheme.Overwrite();
+        lower_case.assign(parsed_scheme);
+        for (auto& c: lower_case)
+        {
+            if ((c >= 'A') && (c <= 'Z'))
             {
-                if (allowed_characters.Contains(c)) 
-                {
-                    element.push_back(c);
-                } 
-                else 
-                {
-                    return false;
-                }
+                c = (char)(c - 'A' + 'a');
             }
         }
+        scheme_id = SchemeRegistry::UNREGISTERED_SCHEME;
         return true;
     }
 
-    char MakeHexDigit(unsigned int value)
+    void Uri::Impl::UpdateSchemeId()
     {
-        if ((value >= 0) && (value < 10))
+        if (scheme->empty())
         {
-            return (char)(value + '0');
+            scheme_id = SchemeRegistry::NO_SCHEME;
+            return;
         }
+        const auto registered = FindRegisteredScheme(*scheme);
+        scheme_id = (
+            ((registered != nullptr) && (*registered->name == *scheme))
+            ? registered->id
+            : SchemeRegistry::UNREGISTERED_SCHEME
+        );
+    }
 
-        if ((value >= 10) && (value < 16))
+    const RegisteredScheme* Uri::Impl::GetRegisteredScheme() const
+    {
+        if (scheme_id == SchemeRegistry::NO_SCHEME)
         {
-            return (char)(value - 10 + 'A');
+            return nullptr;
         }
-
-        return (char)value;
+        if (scheme_id == SchemeRegistry::UNREGISTERED_SCHEME)
+        {
+            return FindRegisteredScheme(*scheme);
+        }
+        return FindRegisteredScheme(scheme_id);
     }
 
-    std::string EncodeElement(const std::string& element, const Uri::CharacterSet& allowed_characters) 
+    bool Uri::Impl::HasSameScheme(const Impl& other) const
     {
-        std::string encoded_element;
-        for (uint8_t c: element) 
+        if ((scheme_id > SchemeRegistry::UNREGISTERED_SCHEME)
+            && (other.scheme_id > SchemeRegistry::UNREGISTERED_SCHEME))
         {
-            if (allowed_characters.Contains(c)) 
-            {
-                encoded_element.push_back(c);
-            } 
-            else 
-            {
-                encoded_element.push_back('%');
-                encoded_element.push_back(MakeHexDigit((unsigned int)c >> 4));
-                encoded_element.push_back(MakeHexDigit((unsigned int)c & 0x0F));
-            }
+            return (scheme_id == other.scheme_id);
         }
-        return encoded_element;
+        return (scheme == other.scheme);
     }
 
-    bool DecodeQueryOrFragment(std::string& query_or_fragment)
+    bool Uri::Impl::ParseFragment(std::string_view query_fragment, std::string_view& rest)
     {
-        return DecodeElement(query_or_fragment, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED);
+        const auto fragment_delimiter = query_fragment.find('#');
+        if (fragment_delimiter == std::string_view::npos) {
+            has_fragment = false;
+            fragment.Clear();
+            rest = query_fragment;
+        } else {
+            has_fragment = true;
+            std::string decoded_fragment(query_fragment.substr(fragment_delimiter + 1));
+            rest = query_fragment.substr(0, fragment_delimiter);
+            if (!DecodeQueryOrFragment(decoded_fragment))
+            {
+                return false;
+            }
+            fragment = std::move(decoded_fragment);
+        }
+        return true;
     }
 
-  
-
-} 
-
-namespace Uri
-{
-    struct Uri::Impl
+    bool Uri::Impl::ParsePath(std::string_view path_string)
     {
-       
-        std::string scheme;
-        std::string host;
-        std::string user_info;
-        bool has_port = false;
-        uint16_t port = 0;
-        bool has_query = false;
-        std::string  query;
-        bool has_fragment = false;
-        std::string fragment;
-        std::vector<std::string> path;
-       
-        bool ParseAuthority(const std::string& authority_string)
+        std::vector<std::string> segments;
+        if(path_string == "/")
         {
-            enum class HostParsingState
-            {
-                FIRST_CHARACTER,
-                NOT_IP_LITERAL,
-                PERCENT_ENCODED_CHARACTER,
-                IP_LITERAL,
-                IPV6_ADDRESS,
-                IPV_FUTURE_NUMBER,
-                IPV_FUTURE_BODY,
-                GARBAGE_CHECK,
-                PORT,
-            };
-
-            const auto user_info_delimiter = authority_string.find('@');
-            std::string host_port_string;
-            user_info.clear();
-            if (user_info_delimiter == std::string::npos)
-            {
-                host_port_string = authority_string;
-            } 
-            else 
+            segments.push_back("");
+        }
+        else if(!path_string.empty())
+        {
+            for(;;)
             {
-                user_info = authority_string.substr(0, user_info_delimiter);
-                if (!DecodeElement(user_info, USER_INFO_NOT_PCT_ENCODED)) 
+                auto path_delimiter = path_string.find('/');
+                if(path_delimiter == std::string_view::npos)
                 {
-                    return false;
+                    segments.emplace_back(path_string);
+                    break;
                 }
-                host_port_string = authority_string.substr(user_info_delimiter + 1);
-            }
-
-           
-            std::string port_string;
-            HostParsingState host_parsing_state = HostParsingState::FIRST_CHARACTER;
-            host.clear();
-            PercentEncodedCharacterDecoder pec_decoder;
-            bool hostIsRegName = false;
-            for (const auto c: host_port_string) 
-            {
-                switch(host_parsing_state) 
+                else
                 {
-                    case HostParsingState::FIRST_CHARACTER: 
-                    {
-                        if (c == '[') 
-                        {
-                            host_parsing_state = HostParsingState::IP_LITERAL;
-                            break;
-                        } 
-                        else 
-                        {
-                            host_parsing_state = HostParsingState::NOT_IP_LITERAL;
-                            hostIsRegName = true;
-                        }
-                    }
-
-                    case HostParsingState::NOT_IP_LITERAL: 
-                    {
-                        if (c == '%') 
-                        {
-                            pec_decoder = PercentEncodedCharacterDecoder();
-                            host_parsing_state = HostParsingState::PERCENT_ENCODED_CHARACTER;
-                        } 
-                        else if (c == ':')
-                        {
-                            host_parsing_state = HostParsingState::PORT;
-                        } 
-                        else 
-                        {
-                            if (REG_NAME_NOT_PCT_ENCODED.Contains(c)) 
-                            {
-                                host.push_back(c);
-                            }
-                            else 
-                            {
-                                return false;
-                            }
-                        }
-                    } break;
-
-                    case HostParsingState::PERCENT_ENCODED_CHARACTER: 
-                    {
-                        if (!pec_decoder.NextEncodedCharacter(c)) 
-                        {
-                            return false;
-                        }
-                        if (pec_decoder.Done()) 
-                        {
-                            host_parsing_state = HostParsingState::NOT_IP_LITERAL;
-                            host.push_back((char)pec_decoder.GetDecodedCharacter());
-                        }
-                    } break;
-
-                    case HostParsingState::IP_LITERAL: 
-                    {
-                        if (c == 'v') 
-                        {
-                            host.push_back(c);
-                            host_parsing_state = HostParsingState::IPV_FUTURE_NUMBER;
-                            break;
-                        } 
-                        else 
-                        {
-                            host_parsing_state = HostParsingState::IPV6_ADDRESS;
-                        }
-                    }
-
-                    case HostParsingState::IPV6_ADDRESS: 
-                    {
-                        if (c == ']') 
-                        {
-                            if (!ValidateIpv6Address(host)) 
-                            {
-                                return false;
-                            }
-                            host_parsing_state = HostParsingState::GARBAGE_CHECK;
-                        } 
-                        else 
-                        {
-                            host.push_back(c);
-                        }
-                    } break;
-
-                    case HostParsingState::IPV_FUTURE_NUMBER: 
-                    {
-                        if (c == '.')
-                        {
-                           host_parsing_state = HostParsingState::IPV_FUTURE_BODY;
-                        } 
-                        else if (!HEXDIG.Contains(c)) 
-                        {
-                            return false;
-                        }
-                        host.push_back(c);
-                    } break;
-
-                    case HostParsingState::IPV_FUTURE_BODY: 
-                    {
-                        if (c == ']') 
-                        {
-                            host_parsing_state = HostParsingState::GARBAGE_CHECK;
-                        } 
-                        else if (!IPV_FUTURE_LAST_PART.Contains(c))
-                        {
-                            return false;
-                        } 
-                        else 
-                        {
-                            host.push_back(c);
-                        }
-                    } break;
-
-                    case HostParsingState::GARBAGE_CHECK: 
-                    {                
-                        if (c == ':') 
-                        {
-                            host_parsing_state = HostParsingState::PORT;
-                        } 
-                        else 
-                        {
-                            return false;
-                        }
-                    } break;
-
-                    case HostParsingState::PORT:
-                    {
-                        port_string.push_back(c);
-                    } break;
+                    segments.emplace_back(path_string.substr(0, path_delimiter));
+                    path_string.remove_prefix(path_delimiter + 1);
                 }
+                
             }
-            if (   (host_parsing_state != HostParsingState::FIRST_CHARACTER)
-                && (host_parsing_state != HostParsingState::NOT_IP_LITERAL)
-                && (host_parsing_state != HostParsingState::GARBAGE_CHECK)
-                && (host_parsing_state != HostParsingState::PORT))
+        }
+        for(auto& segment : segments)
+        {
+            if(!DecodeElement(segment, PCHAR_NOT_PCT_ENCODED))
             {
                 return false;
             }
-            if (hostIsRegName) 
+        }
+        path = std::move(segments);
+        return true;
+
+    }
+
+    bool Uri::Impl::ParseQuery(std::string_view query_with_delimiter)
+    {
+        has_query = !query_with_delimiter.empty();
+        if(has_query)
+        {
+            std::string decoded_query(query_with_delimiter.substr(1));
+            if (!DecodeQueryOrFragment(decoded_query))
             {
-                host = ToLower(host);
+                return false;
             }
-            if (port_string.empty()) 
+            query = std::move(decoded_query);
+        }
+        else
+        {
+            query.Clear();
+        }
+        return true;
+    }
+
+    bool Uri::Impl::SplitAuthorityFromPathAndParseIt( std::string_view author_path_string, 
+                                                      std::string_view& path_string)
+    {
+        if (author_path_string.substr(0, 2) == "//") 
+        {
+            author_path_string = author_path_string.substr(2);
+            auto authorityEnd =author_path_string.find('/');
+            if (authorityEnd == std::string_view::npos) 
             {
-                has_port = false;
-            } else 
+                authorityEnd = author_path_string.length();
+            }
+
+            path_string = author_path_string.substr(authorityEnd);
+            auto authorityString = author_path_string.substr(0, authorityEnd);
+
+            if (!InstrumentStage(
+                    ParseInstrumentation::Stage::PARSE_AUTHORITY,
+                    authorityString.length(),
+                    [&]{ return ParseAuthority(authorityString); }
+                ))
             {
-                intmax_t port_as_int;
-                if (ToInteger(
-                        port_string,
-                        port_as_int
-                    ) != ToIntegerResult::SUCCESS) 
-                {
-                    return false;
-                }
-                if ((port_as_int < 0)
-                    || (port_as_int > (decltype(port_as_int))std::numeric_limits< decltype(port) >::max())) 
-                {
-                    return false;
-                }
-                port = (decltype(port))port_as_int;
-                has_port = true;
+                return false;
             }
-            return true;
         }
+        else 
+        {
+            user_info.Clear();
+            host.Clear();
+            has_port = false;
+            path_string = author_path_string;
+        }
+        return true;
+    }
+  
+    void Uri::Impl::SetDefaultPathIfAuthorityPresentAndPathEmpty()
+    {
+        if(!host->empty() && path->empty())
+        {
+            path.Write().push_back("");
+        }
+    }
 
-        bool ParseScheme (const std::string& uri_string, std::string& rest)
+    bool Uri::Impl::Parse(std::string_view uri_string)
+    {
+        std::string_view rest;
+        if (!InstrumentStage(
+                ParseInstrumentation::Stage::PARSE_SCHEME,
+                uri_string.length(),
+                [&]{ return ParseScheme(uri_string, rest); }
+            ))
         {
-            auto authority_or_path_delimiter_start = uri_string.find('/');
-            if (authority_or_path_delimiter_start == std::string::npos) 
+            return false;
+        }
+        const auto path_end = rest.find_first_of("?#");
+        const auto authority_and_path_string = rest.substr(0, path_end);
+        const auto query_and_or_fragment = rest.substr(authority_and_path_string.length());
+        std::string_view path_string;
+        if (!SplitAuthorityFromPathAndParseIt(authority_and_path_string, path_string))
+        {
+            return false;
+        }
+        if (!InstrumentStage(
+                ParseInstrumentation::Stage::PARSE_PATH,
+                path_string.length(),
+                [&]{ return ParsePath(path_string); }
+            ))
+        {
+            return false;
+        }
+        SetDefaultPathIfAuthorityPresentAndPathEmpty();
+        if (!InstrumentStage(
+                ParseInstrumentation::Stage::PARSE_FRAGMENT,
+                query_and_or_fragment.length(),
+                [&]{ return ParseFragment(query_and_or_fragment, rest); }
+            ))
+        {
+            return false;
+        }
+        return InstrumentStage(
+            ParseInstrumentation::Stage::PARSE_QUERY,
+            rest.length(),
+            [&]{ return ParseQuery(rest); }
+        );
+    }
+
+    bool Uri::Impl::ParseSerialized(std::string_view uri_string, const SerializedLayout& layout)
+    {
+        if ((layout.scheme_end > layout.authority_end)
+            || (layout.authority_end > layout.path_end)
+            || (layout.path_end > layout.query_end)
+            || (layout.query_end > uri_string.length()))
+        {
+            return false;
+        }
+        if (layout.scheme_end > 0)
+        {
+            if (!SetParsedScheme(uri_string.substr(0, layout.scheme_end - 1)))
             {
-                authority_or_path_delimiter_start = uri_string.length();
-            }
-            const auto scheme_end = uri_string.substr(0, authority_or_path_delimiter_start).find(':');
-            if (scheme_end == std::string::npos) {
-                scheme.clear();
-                rest = uri_string;
-            } else {
-                scheme = uri_string.substr(0, scheme_end);
-                if (
-                    FailsMatch(
-                        scheme,
-                        LegalSchemeCheckStrategy()
-                    )
-                ) {
-                    return false;
-                }
-                scheme = ToLower(scheme);
-                rest = uri_string.substr(scheme_end + 1);
+                return false;
             }
-            return true;
         }
-        bool ParseFragment(const std::string& query_fragment, std::string rest)
+        else
         {
-            const auto fragment_delimiter = query_fragment.find('#');
-            if (fragment_delimiter == std::string::npos) {
-                has_fragment = false;
-                fragment.clear();
-                rest = query_fragment;
-            } else {
-                has_fragment = true;
-                fragment = query_fragment.substr(fragment_delimiter + 1);
-                rest = query_fragment.substr(0, fragment_delimiter);
+            scheme.Clear();
+            scheme_id = SchemeRegistry::NO_SCHEME;
+        }
+        if (layout.authority_end > layout.scheme_end)
+        {
+            const auto authority = uri_string.substr(layout.scheme_end, layout.authority_end - layout.scheme_end);
+            if ((authority.length() < 2)
+                || !ParseAuthority(authority.substr(2)))
+            {
+                return false;
             }
-            return DecodeQueryOrFragment(fragment);
         }
-        bool ParsePath(std::string path_string)
+        else
         {
-            path.clear();
-            if(path_string == "/")
+            user_info.Clear();
+            host.Clear();
+            has_port = false;
+        }
+        if (!ParsePath(uri_string.substr(layout.authority_end, layout.path_end - layout.authority_end)))
+        {
+            return false;
+        }
+        SetDefaultPathIfAuthorityPresentAndPathEmpty();
+        if (!ParseQuery(uri_string.substr(layout.path_end, layout.query_end - layout.path_end)))
+        {
+            return false;
+        }
+        has_fragment = (layout.query_end < uri_string.length());
+        if (has_fragment)
+        {
+            std::string decoded_fragment(uri_string.substr(layout.query_end + 1));
+            if (!DecodeQueryOrFragment(decoded_fragment))
             {
-                path.push_back("");
-                path_string.clear();
+                return false;
             }
-            else if(!path_string.empty())
+            fragment = std::move(decoded_fragment);
+        }
+        else
+        {
+            fragment.Clear();
+        }
+        return true;
+    }
+
+    void Uri::Impl::NormalizePath() 
+    {
+        if (!PathHasDotSegmentsOrEmptyRuns(*path))
+        {
+            return;
+        }
+        auto old_path = path.Take();
+        auto& normalized = path.Overwrite();
+        normalized.clear();
+        bool directory_level = false;
+        for (auto& segment: old_path) 
+        {
+            if (segment == ".") 
+            {
+                directory_level = true;
+            } 
+            else if (segment == "..") 
             {
-                for(;;)
+                if (!normalized.empty()) 
                 {
-                    auto path_delimiter = path_string.find('/');
-                    if(path_delimiter == std::string::npos)
+                    if (CanNavigatePathUpOneLevel()) 
                     {
-                        path.push_back(path_string);
-                        path_string.clear();
-                        break;
+                        normalized.pop_back();
                     }
-                    else
-                    {
-                        path.emplace_back(path_string.begin(), path_string.begin() + path_delimiter);
-                        path_string = path_string.substr(path_delimiter + 1);    
-                    }
-                    
                 }
-            }
-            for(auto& segment : path)
-            {
-                if(!DecodeElement(segment, PCHAR_NOT_PCT_ENCODED))
+                directory_level = true;
+            } 
+            else 
+            {  
+                const bool is_empty = segment.empty();
+                if (!directory_level || !is_empty) 
                 {
-                    return false;
+                    normalized.push_back(std::move(segment));
                 }
+                directory_level = is_empty;
             }
-            return true;
+        }
+        if (directory_level&& (!normalized.empty()&& !normalized.back().empty())) 
+        {
+            normalized.push_back("");
+        }
+    }
+
+    void Uri::Impl::CopyScheme(const Impl& other)
+    {
+        scheme = other.scheme;
+        scheme_id = other.scheme_id;
+    }
+
+    void Uri::Impl::CopyAuthority(const Impl& other)
+    {
+        host = other.host;
+        user_info = other.user_info;
+        has_port = other.has_port;
+        port = other.port;
+    }
+
+    void Uri::Impl::CopyPath(const Impl& other)
+    {
+        path = other.path;
+    }
+
+    void Uri::Impl::CopyQuery(const Impl& other)
+    {
+        has_query = other.has_query;
+        query = other.query;
+    }
 
-        }
+    void Uri::Impl::CopyFragment(const Impl& other)
+    {
+        has_fragment = other.has_fragment;
+        fragment = other.fragment;
+    }
+
+    void Uri::Impl::CopyAndNormalizePath(const Impl& other)
+    {
+        CopyPath(other);
+        NormalizePath();
+    }
 
-        bool ParseQuery(const std::string& query_with_delimiter)
+    void Uri::Impl::CopyMergePrefix(const Impl& base)
+    {
+        if (base.HasAuthority() && base.path->empty())
         {
-            has_query = !query_with_delimiter.empty();
-            if(has_query)
-            {
-                query = query_with_delimiter.substr(1);
-            }
-            else
-            {
-                query.clear();
-            }
-            return DecodeQueryOrFragment(query);
+            path = std::vector<std::string>(1, "");
         }
-
-        bool SplitAuthorityFromPathAndParseIt( std::string author_path_string, 
-                                               std::string& path_string)
+        else
         {
-                if (author_path_string.substr(0, 2) == "//") 
-                {
-                author_path_string = author_path_string.substr(2);
-                auto authorityEnd =author_path_string.find('/');
-                if (authorityEnd == std::string::npos) 
-                {
-                    authorityEnd = author_path_string.length();
-                }
-
-                path_string = author_path_string.substr(authorityEnd);
-                auto authorityString = author_path_string.substr(0, authorityEnd);
-
-                if (!ParseAuthority(authorityString)) 
-                {
-                    return false;
-                }
-            }
-            else 
+            CopyPath(base);
+            if (!path->empty() && !((path->size() == 1) && (*path)[0].empty()))
             {
-                user_info.clear();
-                host.clear();
-                has_port = false;
-                path_string = author_path_string;
+                path.Write().pop_back();
             }
-            return true;
         }
-      
-        void SetDefaultPathIfAuthorityPresentAndPathEmpty()
+    }
+
+    void Uri::Impl::CopyNormalizedMergePrefix(const Impl& base)
+    {
+        CopyMergePrefix(base);
+        if (!PathHasDotSegmentsOrEmptyRuns(*path))
         {
-            if(!host.empty() && path.empty())
-            {
-                path.push_back("");
-            }
+            return;
         }
 
-    
+        // A segment stands in for whatever is merged, so that the prefix
+        // is normalized as the directory it is, then goes again.
+        path.Write().push_back("-");
+        NormalizePath();
+        path.Write().pop_back();
+    }
 
-        void NormalizePath() 
+    void Uri::Impl::Resolve(const Impl& base,
+                            const Impl& relative_ref,
+                            const std::vector<std::string>* merge_prefix)
+    {
+        if (!relative_ref.scheme->empty()) 
         {
-            auto old_path = std::move(path);
-            path.clear();
-            bool directory_level = false;
-            for (const auto segment: old_path) 
+            CopyScheme(relative_ref);
+            CopyAuthority(relative_ref);
+            CopyAndNormalizePath(relative_ref);
+            CopyQuery(relative_ref);
+        }
+        else 
+        {
+            if (relative_ref.HasAuthority()) 
             {
-                if (segment == ".") 
-                {
-                    directory_level = true;
-                } 
-                else if (segment == "..") 
+                CopyAuthority(relative_ref);
+                CopyAndNormalizePath(relative_ref);
+                CopyQuery(relative_ref);
+            } 
+            else 
+            {
+                if (relative_ref.path->empty()) 
                 {
-                    if (!path.empty()) 
+                    CopyPath(base);
+                    if (relative_ref.has_query)
                     {
-                        if (CanNavigatePathUpOneLevel()) 
-                        {
-                            path.pop_back();
-                        }
+                        CopyQuery(relative_ref);
+                    } 
+                    else 
+                    {
+                        CopyQuery(base);
                     }
-                    directory_level = true;
                 } 
                 else 
-                {  
-                    if (!directory_level || !segment.empty()) 
+                {
+                    if (relative_ref.IsPathAbsolute()) 
+                    {
+                        CopyAndNormalizePath(relative_ref);
+                    }
+                    else 
                     {
-                        path.push_back(segment);
+                        if (merge_prefix == nullptr)
+                        {
+                            CopyMergePrefix(base);
+                        }
+                        else
+                        {
+                            path = *merge_prefix;
+                        }
+                        auto& merged_path = path.Write();
+                        merged_path.insert(merged_path.end(),
+                                           relative_ref.path->begin(),
+                                           relative_ref.path->end());
+                        NormalizePath();
                     }
-                    directory_level = segment.empty();
+                    CopyQuery(relative_ref);
                 }
+                CopyAuthority(base);
             }
-            if (directory_level&& (!path.empty()&& !path.back().empty())) 
-            {
-                path.push_back("");
-            }
+            CopyScheme(base);
         }
+        CopyFragment(relative_ref);
+    }
 
-        void CopyScheme(const Uri& other)
+    void Uri::Impl::MakeRelative(const Impl& base,
+                                 const Impl& target,
+                                 const std::vector<std::string>* merge_prefix)
+    {
+        *this = target;
+        if (base.scheme->empty() || !HasSameScheme(base))
         {
-            scheme = other.impl_->scheme;
+            return;
         }
-
-        void CopyAuthority(const Uri& other)
+        if (!HasSameAuthority(base))
         {
-            host = other.impl_->host;
-            user_info = other.impl_->user_info;
-            has_port = other.impl_->has_port;
-            port = other.impl_->port;
+            if (HasAuthority())
+            {
+                scheme.Clear();
+                scheme_id = SchemeRegistry::NO_SCHEME;
+            }
+            return;
         }
-
-        void CopyPath(const Uri& other)
+        scheme.Clear();
+        scheme_id = SchemeRegistry::NO_SCHEME;
+        host.Clear();
+        user_info.Clear();
+        has_port = false;
+        port = 0;
+
+        // The same path takes the base's query unless it brings its own.
+        if (*target.path == *base.path)
         {
-            path = other.impl_->path;
+            if (target.has_query || !base.has_query)
+            {
+                if (target.has_query
+                    && base.has_query
+                    && (*target.query == *base.query))
+                {
+                    has_query = false;
+                    query.Clear();
+                }
+                path.Clear();
+                return;
+            }
         }
 
-        void CopyQuery(const Uri& other)
+        // Otherwise the path is needed: a relative one climbing out of the
+        // base's directory, or an absolute one, whichever is shorter.
+        // Segments after the first empty one can't follow a dot segment,
+        // since NormalizePath would drop them.
+        const auto& target_path = *target.path;
+        if (!target.IsPathAbsolute())
         {
-            has_query = other.impl_->has_query;
-            query = other.impl_->query;
+            CopyScheme(target);
+            CopyAuthority(target);
+            return;
         }
-
-        void CopyFragment(const Uri& other)
+        const auto first_segment = ((target_path.size() == 1) ? 0 : 1);
+        const auto num_segments = target_path.size() - first_segment;
+        const bool absolute_ok = ((target_path.size() == 1) || !target_path[1].empty());
+        size_t absolute_length = num_segments;
+        for (size_t i = first_segment; i < target_path.size(); ++i)
         {
-            has_fragment = other.impl_->has_fragment;
-            fragment = other.impl_->fragment;
+            absolute_length += target_path[i].length();
         }
-        void CopyAndNormalizePath(const Uri& other)
+
+        Impl merge;
+        if (merge_prefix == nullptr)
         {
-            CopyPath(other);
-            NormalizePath();
+            merge.CopyNormalizedMergePrefix(base);
+            merge_prefix = &*merge.path;
         }
-        bool HasAuthority() const 
+        bool relative_ok = (!merge_prefix->empty() && (*merge_prefix)[0].empty());
+        size_t num_common = 0;
+        size_t num_up = 0;
+        size_t relative_length = 0;
+        if (relative_ok)
         {
-            return(!host.empty() || !user_info.empty() || has_port);
+            const auto num_directories = merge_prefix->size() - 1;
+            while ((num_common < num_directories)
+                   && (num_common + 1 < num_segments)
+                   && ((*merge_prefix)[num_common + 1] == target_path[first_segment + num_common]))
+            {
+                ++num_common;
+            }
+            num_up = num_directories - num_common;
+            relative_length = num_up * 3;
+            for (size_t i = first_segment + num_common; i < target_path.size(); ++i)
+            {
+                relative_length += target_path[i].length() + 1;
+            }
+            --relative_length;
+            const auto& first_new = target_path[first_segment + num_common];
+            if ((num_up == 0)
+                && (first_new.empty() || (first_new.find(':') != std::string::npos)))
+            {
+                relative_length += 2;
+            }
+            relative_ok = (
+                !first_new.empty()
+                || (first_segment + num_common + 1 == target_path.size())
+            );
         }
-
-        bool IsPathAbsolute() const 
+        if (relative_ok && (!absolute_ok || (relative_length <= absolute_length)))
         {
-            return (!path.empty() && (path[0] == ""));
+            auto& relative_path = path.Overwrite();
+            relative_path.assign(num_up, "..");
+            const auto& first_new = target_path[first_segment + num_common];
+            if ((num_up == 0)
+                && (first_new.empty() || (first_new.find(':') != std::string::npos)))
+            {
+                relative_path.push_back(".");
+            }
+            if (!((num_up == 0) && first_new.empty()))
+            {
+                relative_path.insert(relative_path.end(),
+                                     target_path.begin() + first_segment + num_common,
+                                     target_path.end());
+            }
         }
-
-        bool CanNavigatePathUpOneLevel() const 
+        else if (!absolute_ok)
         {
-            return (!IsPathAbsolute()|| (path.size()>1));
+            CopyAuthority(target);
+            if (!HasAuthority())
+            {
+                CopyScheme(target);
+            }
         }
-    };
+    }
+
+    bool Uri::Impl::HasAuthority() const 
+    {
+        return(!host->empty() || !user_info->empty() || has_port);
+    }
+
+    bool Uri::Impl::HasSameAuthority(const Impl& other) const
+    {
+        return (
+            (user_info == other.user_info)
+            && (host == other.host)
+            && (has_port == other.has_port)
+            && (!has_port || (port == other.port))
+        );
+    }
+
+    bool Uri::Impl::IsPathAbsolute() const 
+    {
+        return (!path->empty() && ((*path)[0] == ""));
+    }
+
+    bool Uri::Impl::CanNavigatePathUpOneLevel() const 
+    {
+        return (!IsPathAbsolute()|| (path->size()>1));
+    }
 
 
 
@@ -1068,10 +915,21 @@ namespace Uri
     {
     }
 
+    Uri::Uri(const UriView& view)
+        : impl_(new Impl)
+    {
+        SerializedLayout layout;
+        layout.scheme_end = view.scheme_end_;
+        layout.authority_end = view.authority_end_;
+        layout.path_end = view.path_end_;
+        layout.query_end = view.query_end_;
+        (void)impl_->ParseSerialized(view.uri_string_, layout);
+    }
+
      bool Uri::operator==(const Uri& other) const 
      {
      return (
-            (impl_->scheme == other.impl_->scheme)
+            impl_->HasSameScheme(*other.impl_)
             && (impl_->user_info == other.impl_->user_info)
             && (impl_->host == other.impl_->host)
             && (
@@ -1106,44 +964,52 @@ namespace Uri
 
     bool Uri::ParseFromString(const std::string& uri_string)
     {
-        std::string rest;
-        if (!impl_->ParseScheme(uri_string, rest)) 
-        {
-            return false;
-        }
-        const auto path_end = rest.find_first_of("?#");
-        const auto authority_and_path_string = rest.substr(0, path_end);
-        const auto query_and_or_fragment = rest.substr(authority_and_path_string.length());
-        std::string path_string;
-        if (!impl_->SplitAuthorityFromPathAndParseIt(authority_and_path_string, path_string))
-        {
-            return false;
-        }
-        if (!impl_->ParsePath(path_string)) 
-        {
-            return false;
-        }
-        impl_->SetDefaultPathIfAuthorityPresentAndPathEmpty();
-        if (!impl_->ParseFragment(query_and_or_fragment, rest)) 
+        return ParseFromString(std::string_view(uri_string));
+    }
+
+    bool Uri::ParseFromString(const char* uri_string)
+    {
+        return ParseFromString(std::string_view(uri_string));
+    }
+
+    bool Uri::ParseFromString(const char* uri_string, size_t length)
+    {
+        return ParseFromString(std::string_view(uri_string, length));
+    }
+
+    bool Uri::ParseFromString(std::string_view uri_string)
+    {
+        StageScope scope(ParseInstrumentation::Stage::PARSE, uri_string.length());
+        return scope.Finish(impl_->Parse(uri_string));
+    }
+
+    bool Uri::ParseFromIriString(std::string_view iri_string)
+    {
+        if (CountLeadingAscii(iri_string) == iri_string.length())
         {
-            return false;
+            return ParseFromString(iri_string);
         }
-        return impl_->ParseQuery(rest);
-
+        std::string uri_string;
+        return Iri::ToUri(iri_string, uri_string) && ParseFromString(uri_string);
     }
 
 
     std::string Uri::GetScheme() const
     {
-        return impl_->scheme;
+        return *impl_->scheme;
+    }
+
+    SchemeId Uri::GetSchemeId() const
+    {
+        return impl_->scheme_id;
     }
     std::string Uri::GetHost() const
     {
-        return impl_->host;
+        return *impl_->host;
     }
     std::vector<std::string> Uri::GetPath() const
     {
-        return impl_->path;
+        return *impl_->path;
     }
     
     bool Uri::HasPort() const
@@ -1163,12 +1029,12 @@ namespace Uri
 
     std::string Uri::GetQuery() const
     {
-        return impl_->query;
+        return *impl_->query;
     }
 
     bool Uri::IsRelativeReference() const
     {
-        return impl_->scheme.empty();
+        return impl_->scheme->empty();
     }
 
     bool Uri::HasFragment() const
@@ -1178,7 +1044,7 @@ namespace Uri
 
     std::string Uri::GetFragment() const
     {
-        return impl_->fragment;
+        return *impl_->fragment;
     }
     
     bool Uri::ContainsRelativePath() const
@@ -1188,77 +1054,154 @@ namespace Uri
 
     std::string Uri::GetUserInfo() const
     {
-        return impl_->user_info;
+        return *impl_->user_info;
+    }
+
+    std::string_view Uri::GetSchemeView() const
+    {
+        return *impl_->scheme;
+    }
+
+    std::string_view Uri::GetUserInfoView() const
+    {
+        return *impl_->user_info;
+    }
+
+    std::string_view Uri::GetHostView() const
+    {
+        return *impl_->host;
+    }
+
+    std::string_view Uri::GetQueryView() const
+    {
+        return *impl_->query;
+    }
+
+    std::string_view Uri::GetFragmentView() const
+    {
+        return *impl_->fragment;
+    }
+
+    size_t Uri::GetPathSegmentCount() const
+    {
+        return impl_->path->size();
+    }
+
+    std::string_view Uri::GetPathSegment(size_t index) const
+    {
+        return (*impl_->path)[index];
+    }
+
+    std::string_view Uri::GetPublicSuffix(const PublicSuffixList& public_suffix_list) const
+    {
+        return public_suffix_list.GetPublicSuffix(*impl_->host);
+    }
+
+    std::string_view Uri::GetRegistrableDomain(const PublicSuffixList& public_suffix_list) const
+    {
+        return public_suffix_list.GetRegistrableDomain(*impl_->host);
     }
 
 
     void Uri::NormalizePath()
     {
+        impl_->NormalizePath();
+    }
+
+    void Uri::Normalize()
+    {
+        impl_->NormalizePath();
+        const auto registered = impl_->GetRegisteredScheme();
+        if (registered == nullptr)
+        {
+            return;
+        }
+        const auto& policy = registered->policy;
+        if (impl_->has_port
+            && policy.has_default_port
+            && (impl_->port == policy.default_port))
+        {
+            impl_->has_port = false;
+        }
+        if (policy.empty_path_is_root && impl_->path->empty())
+        {
+            impl_->path = std::vector<std::string>(1, "");
+        }
+    }
 
+    bool Uri::IsValidForScheme() const
+    {
+        const auto registered = impl_->GetRegisteredScheme();
+        return ((registered == nullptr)
+            || !registered->policy.requires_host
+            || !impl_->host->empty());
     }
     Uri Uri::Resolve (const Uri& relative_ref) const
     {
+        StageScope scope(ParseInstrumentation::Stage::RESOLVE, 0);
         Uri target;
-        if (!relative_ref.impl_->scheme.empty()) 
+        target.impl_->Resolve(*impl_, *relative_ref.impl_);
+        return target;
+    }
+
+    Uri Uri::MakeRelative(const Uri& target) const
+    {
+        Uri relative_ref;
+        relative_ref.impl_->MakeRelative(*impl_, *target.impl_);
+        return relative_ref;
+    }
+
+    std::string Uri::ResolveToString(const Uri& relative_ref) const
+    {
+        std::string target;
+        ResolveInto(relative_ref, target);
+        return target;
+    }
+
+    void Uri::ResolveInto(const Uri& relative_ref, std::string& target) const
+    {
+        StageScope scope(ParseInstrumentation::Stage::RESOLVE, 0);
+        (void)ResolveToBuffer(
+            DecodedSource< Impl >(*impl_),
+            DecodedSource< Impl >(*relative_ref.impl_),
+            target
+        );
+    }
+
+    bool Uri::ResolveInto(const std::string& relative_ref, std::string& target) const
+    {
+        StageScope scope(ParseInstrumentation::Stage::RESOLVE, relative_ref.length());
+        EncodedSource reference;
+        if (!reference.Parse(relative_ref, target)
+            || !ResolveToBuffer(DecodedSource< Impl >(*impl_), reference, target))
         {
-            target.impl_->CopyScheme(relative_ref);
-            target.impl_->CopyAuthority(relative_ref);
-            target.impl_->CopyAndNormalizePath(relative_ref);
-            target.impl_->CopyQuery(relative_ref);
+            target.clear();
+            return scope.Finish(false);
         }
-        else 
+        return true;
+    }
+
+    bool Uri::ResolveInto(const std::string& base,
+                          const std::string& relative_ref,
+                          std::string& target)
+    {
+        StageScope scope(ParseInstrumentation::Stage::RESOLVE, base.length() + relative_ref.length());
+        EncodedSource base_source;
+        EncodedSource reference;
+        if (!base_source.Parse(base, target)
+            || !reference.Parse(relative_ref, target)
+            || !ResolveToBuffer(base_source, reference, target))
         {
-            if (!relative_ref.impl_->host.empty()) 
-            {
-                target.impl_->CopyAuthority(relative_ref);
-                target.impl_->CopyAndNormalizePath(relative_ref);
-                target.impl_->CopyQuery(relative_ref);
-            } 
-            else 
-            {
-                if (relative_ref.impl_->path.empty()) 
-                {
-                    target.impl_->path = impl_->path;
-                    if (!relative_ref.impl_->query.empty())
-                    {
-                        target.impl_->CopyQuery(relative_ref);
-                    } 
-                    else 
-                    {
-                        target.impl_->CopyQuery(*this);
-                    }
-                } 
-                else 
-                {
-                    if (relative_ref.impl_->IsPathAbsolute()) 
-                    {
-                        target.impl_->CopyAndNormalizePath(relative_ref);
-                    }
-                    else 
-                    {
-                        target.impl_->CopyPath(*this);
-                        if (target.impl_->path.size() > 1) 
-                        {
-                            target.impl_->path.pop_back();
-                        }
-                        std::copy(relative_ref.impl_->path.begin(),
-                                  relative_ref.impl_->path.end(),
-                                  std::back_inserter(target.impl_->path));
-                        target.NormalizePath();
-                    }
-                    target.impl_->CopyQuery(relative_ref);
-                }
-                target.impl_->CopyAuthority(*this);
-            }
-            target.impl_->CopyScheme(*this);
+            target.clear();
+            return scope.Finish(false);
         }
-        target.impl_->CopyFragment(relative_ref);
-        return target;
+        return true;
     }
 
     void Uri::SetScheme(const std::string& scheme)
     {
         impl_->scheme = scheme;
+        impl_->UpdateSchemeId();
     }
 
     void Uri::SetUserInfo(const std::string& user_info)
@@ -1291,6 +1234,39 @@ namespace Uri
         impl_->fragment = fragment;
         impl_->has_fragment = true;
     }
+
+    void Uri::SetScheme(std::string&& scheme)
+    {
+        impl_->scheme = std::move(scheme);
+        impl_->UpdateSchemeId();
+    }
+
+    void Uri::SetUserInfo(std::string&& user_info)
+    {
+        impl_->user_info = std::move(user_info);
+    }
+
+    void Uri::SetHost(std::string&& host)
+    {
+        impl_->host = std::move(host);
+    }
+
+    void Uri::SetQuery(std::string&& query)
+    {
+        impl_->query = std::move(query);
+        impl_->has_query = true;
+    }
+
+    void Uri::SetPath(std::vector<std::string>&& path)
+    {
+        impl_->path = std::move(path);
+    }
+
+    void Uri::SetFragment(std::string&& fragment)
+    {
+        impl_->fragment = std::move(fragment);
+        impl_->has_fragment = true;
+    }
     
     void Uri::ClearQuery()
     {
@@ -1307,56 +1283,14 @@ namespace Uri
 
     std::string Uri::GenerateString() const
     {
-        std::ostringstream buffer;
-        if (!impl_->scheme.empty()) 
-        {
-            buffer << impl_->scheme << ':';
-        }
-        if (impl_->HasAuthority())
-        {
-            buffer << "//";
-            if (!impl_->user_info.empty()) 
-            {
-                buffer << EncodeElement(impl_->user_info, USER_INFO_NOT_PCT_ENCODED) << '@';
-            }
-            if (!impl_->host.empty()) 
-            {
-                if (ValidateIpv6Address(impl_->host)) 
-                {
-                    buffer << '[' << ToLower(impl_->host) << ']';
-                } 
-                else 
-                {
-                    buffer << EncodeElement(impl_->host, REG_NAME_NOT_PCT_ENCODED);
-                }
-            }
-            if (impl_->has_port) 
-            {
-                buffer << ':' << impl_->port;
-            }
-        }
-        if (impl_->IsPathAbsolute() && (impl_->path.size() == 1)) 
-        {
-            buffer << '/';
-        }
-        size_t i = 0;
-        for (const auto& segment: impl_->path) 
-        {
-            buffer << EncodeElement(segment, PCHAR_NOT_PCT_ENCODED);
-            if (i + 1 < impl_->path.size()) 
-            {
-                buffer << '/';
-            }
-            ++i;
-        }
-        if (impl_->has_query) 
-        {
-            buffer << '?' << EncodeElement(impl_->query, QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS);
-        }
-        if (impl_->has_fragment) 
-        {
-            buffer << '#' << EncodeElement(impl_->fragment, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED);
-        }
-        return buffer.str();
+        StageScope scope(ParseInstrumentation::Stage::GENERATE_STRING, 0);
+        std::string buffer;
+        (void)SerializeToBuffer(DecodedSource< Impl >(*impl_), buffer);
+        return buffer;
+    }
+
+    std::string Uri::GenerateIriString() const
+    {
+        return Iri::ToIri(GenerateString());
     }
 }
@@ -0,0 +1,568 @@
+#include "MappedFile.hpp"
+#include "ReferenceResolver.hpp"
+#include "UriImpl.hpp"
+#include "Varint.hpp"
+#include <Uri/UriDictionary.hpp>
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+#include <string_view>
+
+namespace
+{
+    const uint32_t FILE_MAGIC = 0x44495255;
+    const uint32_t FILE_VERSION = 1;
+    const uint32_t FILE_BYTE_ORDER_MARK = 0x01020304;
+
+    // magic, version, byte order mark, block size, then entry count,
+    // block count and data size; the block offsets table follows, then
+    // the block data.
+    const size_t HEADER_SIZE = 4 * sizeof(uint32_t) + 3 * sizeof(uint64_t);
+
+    template< typename T >
+    void PutValue(std::vector< uint8_t >& image, size_t offset, T value)
+    {
+        memcpy(image.data() + offset, &value, sizeof(value));
+    }
+
+    template< typename T >
+    T GetValue(const uint8_t* data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    struct Record
+    {
+        std::string serialized;
+        Uri::SerializedLayout layout;
+    };
+
+    // One front-coded entry: how many leading characters it shares with the
+    // entry before it in the block, the characters that follow, and the
+    // component boundaries of the whole string.
+    struct Entry
+    {
+        size_t shared = 0;
+        std::string_view suffix;
+        Uri::SerializedLayout layout;
+    };
+
+    void AppendEntry(std::vector< uint8_t >& data, const Record& record, size_t shared)
+    {
+        const auto& layout = record.layout;
+        Uri::AppendVarint(data, shared);
+        Uri::AppendVarint(data, record.serialized.length() - shared);
+        Uri::AppendVarint(data, layout.scheme_end);
+        Uri::AppendVarint(data, layout.authority_end - layout.scheme_end);
+        Uri::AppendVarint(data, layout.path_end - layout.authority_end);
+        Uri::AppendVarint(data, layout.query_end - layout.path_end);
+        data.insert(data.end(), record.serialized.begin() + shared, record.serialized.end());
+    }
+
+    bool ReadEntry(const uint8_t*& position, const uint8_t* end, Entry& entry)
+    {
+        size_t suffix_length, scheme_length, authority_length, path_length, query_length;
+        if (!Uri::ReadVarint(position, end, entry.shared)
+            || !Uri::ReadVarint(position, end, suffix_length)
+            || !Uri::ReadVarint(position, end, scheme_length)
+            || !Uri::ReadVarint(position, end, authority_length)
+            || !Uri::ReadVarint(position, end, path_length)
+            || !Uri::ReadVarint(position, end, query_length)
+            || (suffix_length > (size_t)(end - position)))
+        {
+            return false;
+        }
+        entry.suffix = std::string_view((const char*)position, suffix_length);
+        position += suffix_length;
+        entry.layout.scheme_end = scheme_length;
+        entry.layout.authority_end = entry.layout.scheme_end + authority_length;
+        entry.layout.path_end = entry.layout.authority_end + path_length;
+        entry.layout.query_end = entry.layout.path_end + query_length;
+        return true;
+    }
+
+    bool StartsWith(std::string_view candidate, std::string_view prefix)
+    {
+        return (candidate.substr(0, prefix.length()) == prefix);
+    }
+}
+
+namespace Uri
+{
+    struct UriDictionary::Impl
+    {
+        // Either a dictionary built in memory or a mapped file; both hold
+        // the same image, which is never modified once made.
+        struct Storage
+        {
+            std::vector< uint8_t > image;
+            MappedFile file;
+
+            const uint8_t* Data() const
+            {
+                return image.empty() ? file.Data() : image.data();
+            }
+
+            size_t Size() const
+            {
+                return image.empty() ? file.Size() : image.size();
+            }
+        };
+
+        // Walks the entries of one block, rebuilding each string from the
+        // one before it.
+        class BlockCursor
+        {
+        public:
+            BlockCursor(const Impl& dictionary, size_t block)
+                : position_(dictionary.BlockData(block))
+                , end_(dictionary.BlockEnd(block))
+                , remaining_(dictionary.EntriesInBlock(block))
+            {
+            }
+
+            bool Next()
+            {
+                if (remaining_ == 0)
+                {
+                    return false;
+                }
+                Entry entry;
+                if (!ReadEntry(position_, end_, entry)
+                    || (entry.shared > current_.length()))
+                {
+                    remaining_ = 0;
+                    return false;
+                }
+                current_.resize(entry.shared);
+                current_ += entry.suffix;
+                layout_ = entry.layout;
+                --remaining_;
+                return true;
+            }
+
+            const std::string& Current() const
+            {
+                return current_;
+            }
+
+            const SerializedLayout& Layout() const
+            {
+                return layout_;
+            }
+
+        private:
+            const uint8_t* position_;
+            const uint8_t* end_;
+            size_t remaining_;
+            std::string current_;
+            SerializedLayout layout_;
+        };
+
+        std::shared_ptr< const Storage > storage;
+        size_t block_size = DEFAULT_BLOCK_SIZE;
+        size_t size = 0;
+        size_t num_blocks = 0;
+        const uint8_t* offsets = nullptr;
+        const uint8_t* data = nullptr;
+        size_t data_size = 0;
+
+        bool Attach(std::shared_ptr< const Storage > new_storage)
+        {
+            const auto image = new_storage->Data();
+            const auto image_size = new_storage->Size();
+            if ((image_size < HEADER_SIZE)
+                || (GetValue< uint32_t >(image) != FILE_MAGIC)
+                || (GetValue< uint32_t >(image + 4) != FILE_VERSION)
+                || (GetValue< uint32_t >(image + 8) != FILE_BYTE_ORDER_MARK))
+            {
+                return false;
+            }
+            const auto new_block_size = GetValue< uint32_t >(image + 12);
+            const auto new_size = GetValue< uint64_t >(image + 16);
+            const auto new_num_blocks = GetValue< uint64_t >(image + 24);
+            const auto new_data_size = GetValue< uint64_t >(image + 32);
+            // The blocks must be exactly enough for the entries, so that the
+            // block of any ID below the size exists.  The rounding up is
+            // done without adding, which could wrap around.
+            if ((new_block_size == 0)
+                || (new_num_blocks != new_size / new_block_size + ((new_size % new_block_size) != 0))
+                || (new_num_blocks > (image_size - HEADER_SIZE) / sizeof(uint64_t))
+                || (new_data_size != image_size - HEADER_SIZE - new_num_blocks * sizeof(uint64_t)))
+            {
+                return false;
+            }
+            const auto new_offsets = image + HEADER_SIZE;
+            uint64_t previous_offset = 0;
+            for (size_t block = 0; block < new_num_blocks; ++block)
+            {
+                const auto offset = GetValue< uint64_t >(new_offsets + block * sizeof(uint64_t));
+                if (((block == 0) && (offset != 0))
+                    || ((block > 0) && (offset <= previous_offset))
+                    || (offset >= new_data_size))
+                {
+                    return false;
+                }
+                previous_offset = offset;
+            }
+            storage = std::move(new_storage);
+            block_size = new_block_size;
+            size = (size_t)new_size;
+            num_blocks = (size_t)new_num_blocks;
+            offsets = new_offsets;
+            data = new_offsets + num_blocks * sizeof(uint64_t);
+            data_size = (size_t)new_data_size;
+            return true;
+        }
+
+        bool Build(std::vector< Record >& records, size_t new_block_size)
+        {
+            if ((new_block_size == 0) || (new_block_size > UINT32_MAX))
+            {
+                return false;
+            }
+            std::sort(
+                records.begin(),
+                records.end(),
+                [](const Record& lhs, const Record& rhs)
+                {
+                    return lhs.serialized < rhs.serialized;
+                }
+            );
+            records.erase(
+                std::unique(
+                    records.begin(),
+                    records.end(),
+                    [](const Record& lhs, const Record& rhs)
+                    {
+                        return lhs.serialized == rhs.serialized;
+                    }
+                ),
+                records.end()
+            );
+            const auto new_num_blocks = (records.size() + new_block_size - 1) / new_block_size;
+            std::vector< uint8_t > block_data;
+            std::vector< uint64_t > block_offsets;
+            block_offsets.reserve(new_num_blocks);
+            for (size_t i = 0; i < records.size(); ++i)
+            {
+                size_t shared = 0;
+                if (i % new_block_size == 0)
+                {
+                    block_offsets.push_back(block_data.size());
+                }
+                else
+                {
+                    const auto& previous = records[i - 1].serialized;
+                    const auto& current = records[i].serialized;
+                    const auto limit = std::min(previous.length(), current.length());
+                    while ((shared < limit) && (previous[shared] == current[shared]))
+                    {
+                        ++shared;
+                    }
+                }
+                AppendEntry(block_data, records[i], shared);
+            }
+            auto new_storage = std::make_shared< Storage >();
+            auto& image = new_storage->image;
+            image.resize(HEADER_SIZE + new_num_blocks * sizeof(uint64_t));
+            PutValue(image, 0, FILE_MAGIC);
+            PutValue(image, 4, FILE_VERSION);
+            PutValue(image, 8, FILE_BYTE_ORDER_MARK);
+            PutValue(image, 12, (uint32_t)new_block_size);
+            PutValue(image, 16, (uint64_t)records.size());
+            PutValue(image, 24, (uint64_t)new_num_blocks);
+            PutValue(image, 32, (uint64_t)block_data.size());
+            for (size_t block = 0; block < new_num_blocks; ++block)
+            {
+                PutValue(image, HEADER_SIZE + block * sizeof(uint64_t), block_offsets[block]);
+            }
+            image.insert(image.end(), block_data.begin(), block_data.end());
+            return Attach(std::move(new_storage));
+        }
+
+        const uint8_t* BlockData(size_t block) const
+        {
+            return data + GetValue< uint64_t >(offsets + block * sizeof(uint64_t));
+        }
+
+        const uint8_t* BlockEnd(size_t block) const
+        {
+            return (block + 1 < num_blocks) ? BlockData(block + 1) : data + data_size;
+        }
+
+        size_t EntriesInBlock(size_t block) const
+        {
+            return std::min(block_size, size - block * block_size);
+        }
+
+        // The first entry of a block is stored whole.
+        bool BlockHead(size_t block, std::string_view& head) const
+        {
+            auto position = BlockData(block);
+            Entry entry;
+            if (!ReadEntry(position, BlockEnd(block), entry)
+                || (entry.shared != 0))
+            {
+                return false;
+            }
+            head = entry.suffix;
+            return true;
+        }
+
+        // Entries are sorted, so "before" (which must hold for a prefix of
+        // the entries and fail for the rest) splits them at one ID.  Returns
+        // that ID and, if there is an entry there, its string.
+        template< typename Before >
+        size_t Partition(Before before, std::string* found = nullptr) const
+        {
+            size_t low = 0;
+            size_t high = num_blocks;
+            while (low < high)
+            {
+                const auto middle = low + (high - low) / 2;
+                std::string_view head;
+                if (BlockHead(middle, head) && before(head))
+                {
+                    low = middle + 1;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+            if (low > 0)
+            {
+                BlockCursor cursor(*this, low - 1);
+                for (size_t id = (low - 1) * block_size; cursor.Next(); ++id)
+                {
+                    if (!before(cursor.Current()))
+                    {
+                        if (found != nullptr)
+                        {
+                            *found = cursor.Current();
+                        }
+                        return id;
+                    }
+                }
+            }
+            if (found != nullptr)
+            {
+                std::string_view head;
+                if ((low < num_blocks) && BlockHead(low, head))
+                {
+                    found->assign(head);
+                }
+                else
+                {
+                    found->clear();
+                }
+            }
+            return std::min(low * block_size, size);
+        }
+
+        bool Find(const std::string& serialized, size_t& id) const
+        {
+            std::string found;
+            const auto candidate = Partition(
+                [&serialized](std::string_view entry)
+                {
+                    return entry < serialized;
+                },
+                &found
+            );
+            if ((candidate == size) || (found != serialized))
+            {
+                return false;
+            }
+            id = candidate;
+            return true;
+        }
+
+        bool Seek(size_t id, BlockCursor& cursor) const
+        {
+            for (size_t skip = id % block_size; skip > 0; --skip)
+            {
+                if (!cursor.Next())
+                {
+                    return false;
+                }
+            }
+            return cursor.Next();
+        }
+    };
+
+    UriDictionary::~UriDictionary() noexcept = default;
+
+    UriDictionary::UriDictionary(const UriDictionary& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+
+    UriDictionary::UriDictionary(UriDictionary&&) noexcept = default;
+
+    UriDictionary& UriDictionary::operator=(const UriDictionary& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+
+    UriDictionary& UriDictionary::operator=(UriDictionary&&) noexcept = default;
+
+    UriDictionary::UriDictionary()
+        : impl_(new Impl)
+    {
+    }
+
+    bool UriDictionary::Build(const std::vector<Uri>& uris, size_t block_size)
+    {
+        std::vector< Record > records(uris.size());
+        for (size_t i = 0; i < uris.size(); ++i)
+        {
+            (void)SerializeToBuffer(
+                DecodedSource< Uri::Impl >(*uris[i].impl_),
+                records[i].serialized,
+                false,
+                &records[i].layout
+            );
+        }
+        return impl_->Build(records, block_size);
+    }
+
+    bool UriDictionary::Build(const std::vector<std::string>& uri_strings, size_t block_size)
+    {
+        std::vector< Record > records(uri_strings.size());
+        EncodedSource source;
+        for (size_t i = 0; i < uri_strings.size(); ++i)
+        {
+            auto& record = records[i];
+            if (!source.Parse(uri_strings[i], record.serialized))
+            {
+                return false;
+            }
+            record.serialized.clear();
+            if (!SerializeToBuffer(source, record.serialized, false, &record.layout))
+            {
+                return false;
+            }
+        }
+        return impl_->Build(records, block_size);
+    }
+
+    size_t UriDictionary::Size() const
+    {
+        return impl_->size;
+    }
+
+    size_t UriDictionary::GetBlockSize() const
+    {
+        return impl_->block_size;
+    }
+
+    size_t UriDictionary::MemoryUsage() const
+    {
+        return sizeof(Impl) + (impl_->storage ? impl_->storage->Size() : 0);
+    }
+
+    bool UriDictionary::Find(const Uri& uri, size_t& id) const
+    {
+        std::string serialized;
+        (void)SerializeToBuffer(DecodedSource< Uri::Impl >(*uri.impl_), serialized);
+        return impl_->Find(serialized, id);
+    }
+
+    bool UriDictionary::Find(const std::string& uri_string, size_t& id) const
+    {
+        std::string serialized;
+        EncodedSource source;
+        if (!source.Parse(uri_string, serialized))
+        {
+            return false;
+        }
+        serialized.clear();
+        if (!SerializeToBuffer(source, serialized))
+        {
+            return false;
+        }
+        return impl_->Find(serialized, id);
+    }
+
+    bool UriDictionary::GetString(size_t id, std::string& uri_string) const
+    {
+        if (id >= impl_->size)
+        {
+            return false;
+        }
+        Impl::BlockCursor cursor(*impl_, id / impl_->block_size);
+        if (!impl_->Seek(id, cursor))
+        {
+            return false;
+        }
+        uri_string = cursor.Current();
+        return true;
+    }
+
+    bool UriDictionary::GetUri(size_t id, Uri& uri) const
+    {
+        if (id >= impl_->size)
+        {
+            return false;
+        }
+        Impl::BlockCursor cursor(*impl_, id / impl_->block_size);
+        return impl_->Seek(id, cursor)
+            && uri.impl_->ParseSerialized(cursor.Current(), cursor.Layout());
+    }
+
+    bool UriDictionary::FindPrefix(const std::string& prefix, size_t& first, size_t& last) const
+    {
+        first = impl_->Partition(
+            [&prefix](std::string_view entry)
+            {
+                return entry < prefix;
+            }
+        );
+        last = impl_->Partition(
+            [&prefix](std::string_view entry)
+            {
+                return (entry < prefix) || StartsWith(entry, prefix);
+            }
+        );
+        return (first < last);
+    }
+
+    bool UriDictionary::SaveToFile(const std::string& file_path) const
+    {
+        std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+        if (impl_->storage)
+        {
+            file.write((const char*)impl_->storage->Data(), impl_->storage->Size());
+        }
+        else
+        {
+            std::vector< Record > no_records;
+            Impl empty;
+            (void)empty.Build(no_records, impl_->block_size);
+            file.write((const char*)empty.storage->Data(), empty.storage->Size());
+        }
+        return (bool)file;
+    }
+
+    bool UriDictionary::LoadFromFile(const std::string& file_path)
+    {
+        auto storage = std::make_shared< Impl::Storage >();
+        if (!storage->file.Open(file_path))
+        {
+            return false;
+        }
+        return impl_->Attach(std::move(storage));
+    }
+}
@@ -0,0 +1,672 @@
+#include "UriGrammar.hpp"
+#include "PercentEncodedCharacterDecoder.hpp"
+#include <ctype.h>
+#include <limits>
+#include <memory>
+
+namespace
+{
+    bool ValidateOctet(const std::string& octet_string) 
+    {
+        // No more than "255", nor so many digits as to overflow.
+        if (octet_string.length() > 3)
+        {
+            return false;
+        }
+        int octet = 0;
+        for (auto c: octet_string) 
+        {
+            if (Uri::DIGIT.Contains(c)) 
+            {
+                octet *= 10;
+                octet += (int)(c - '0');
+            } 
+            else 
+            {
+                return false;
+            }
+        }
+        return (octet <= 255);
+    }
+
+    char MakeHexDigit(unsigned int value)
+    {
+        if ((value >= 0) && (value < 10))
+        {
+            return (char)(value + '0');
+        }
+
+        if ((value >= 10) && (value < 16))
+        {
+            return (char)(value - 10 + 'A');
+        }
+
+        return (char)value;
+    }
+}
+
+namespace Uri
+{
+    const CharacterSet ALPHA{
+        CharacterSet('a', 'z'),
+        CharacterSet('A', 'Z')
+    };
+
+    const CharacterSet DIGIT('0', '9');
+
+    const CharacterSet HEXDIG{
+        CharacterSet('0', '9'),
+        CharacterSet('A', 'F'),
+        CharacterSet('a', 'f')
+    };
+
+    const CharacterSet UNRESERVED{
+        ALPHA,
+        DIGIT,
+        '-', '.', '_', '~'
+    };
+
+    const CharacterSet SUB_DELIMS{
+        '!', '$', '&', '\'', '(', ')',
+        '*', '+', ',', ';', '='
+    };
+
+    const CharacterSet SCHEME_NOT_FIRST{
+        ALPHA,
+        DIGIT,
+        '+', '-', '.',
+    };
+
+    const CharacterSet PCHAR_NOT_PCT_ENCODED{
+        UNRESERVED,
+        SUB_DELIMS,
+        ':', '@'
+    };
+
+    const CharacterSet QUERY_OR_FRAGMENT_NOT_PCT_ENCODED{
+        PCHAR_NOT_PCT_ENCODED,
+        '/', '?'
+    };
+
+    const CharacterSet QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS{
+        UNRESERVED,
+        '!', '$', '&', '\'', '(', ')',
+        '*', ',', ';', '=',
+        ':', '@',
+        '/', '?'
+    };
+
+  
+    const CharacterSet USER_INFO_NOT_PCT_ENCODED{
+        UNRESERVED,
+        SUB_DELIMS,
+        ':',
+    };
+
+   
+    const CharacterSet REG_NAME_NOT_PCT_ENCODED{
+        UNRESERVED,
+        SUB_DELIMS
+    };
+    const CharacterSet IPV_FUTURE_LAST_PART{
+        UNRESERVED,
+        SUB_DELIMS,
+        ':'
+    };
+    const CharacterSet RESERVED_OR_UNRESERVED{
+        UNRESERVED,
+        SUB_DELIMS,
+        ':', '/', '?', '#', '[', ']', '@'
+    };
+
+    bool IsLegalScheme(std::string_view scheme)
+    {
+        return (
+            !scheme.empty()
+            && ALPHA.Contains(scheme[0])
+            && (SCHEME_NOT_FIRST.CountLeading(scheme.substr(1)) == scheme.length() - 1)
+        );
+    }
+
+    ToIntegerResult ToInteger( const std::string& number_string, intmax_t& number) 
+    {
+        size_t index = 0;
+        size_t state = 0;
+        bool negative = false;
+        intmax_t value = 0;
+        while (index < number_string.size()) 
+        {
+            switch (state) 
+            {
+                case 0: 
+                {
+                    if (number_string[index] == '-') 
+                    {
+                        negative = true;
+                        ++index;
+                    }
+                    state = 1;
+                } break;
+
+                case 1:
+                {
+                    if (number_string[index] == '0') {
+                        state = 2;
+                    } 
+                    else if ((number_string[index] >= '1') && (number_string[index] <= '9'))
+                    {
+                        state = 3;
+                        value = (decltype(value))(number_string[index] - '0');
+                        value = (value * (negative ? -1 : 1));
+                    } 
+                    else 
+                    {
+                        return ToIntegerResult::NOTNUMBER;
+                    }
+                    ++index;
+                } break;
+
+                case 2: 
+                { 
+                    return ToIntegerResult::NOTNUMBER;
+                } break;
+
+                case 3: 
+                { 
+                    if ((number_string[index] >= '0') && (number_string[index] <= '9')) 
+                    {
+                        const auto digit = (decltype(value))(number_string[index] - '0');
+                        if (negative) 
+                        {
+                            if ((std::numeric_limits< decltype(value) >::lowest() + digit) / 10 > value) 
+                            {
+                                return ToIntegerResult::OVERFLOW_;
+                            }
+                        } 
+                        else 
+                        {
+                            if ((std::numeric_limits< decltype(value) >::max() - digit) / 10 < value) 
+                            {
+                                return ToIntegerResult::OVERFLOW_;
+                            }
+                        }
+                        value *= 10;
+                        if (negative) 
+                        {
+                            value -= digit;
+                        } 
+                        else 
+                        {
+                            value += digit;
+                        }
+                        ++index;
+                    } 
+                    else
+                    {
+                        return ToIntegerResult::NOTNUMBER;
+                    }
+                } break;
+            }
+        }
+        if (state >= 2) 
+        {
+            number = value;
+            return ToIntegerResult::SUCCESS;
+        } 
+        else 
+        {
+            return ToIntegerResult::NOTNUMBER;
+        }
+    }
+
+    
+
+    std::string ToLower(const std::string& in_string) 
+    {
+        std::string out_string;
+        out_string.reserve(in_string.size());
+        for (char c: in_string) 
+        {
+            out_string.push_back(tolower(c));
+        }
+        return out_string;
+    }
+
+    bool ValidateIpv4Adress(std::string_view address) 
+    {
+        size_t num_groups = 0;
+        size_t state = 0;
+        std::string octet_buffer;
+        for (auto c: address) 
+        {
+            switch (state) 
+            {
+                case 0: 
+                {
+                    if (DIGIT.Contains(c)) 
+                    {
+                        octet_buffer.push_back(c);
+                        state = 1;
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+
+                case 1: 
+                { 
+                    if (c == '.') 
+                    {
+                        if (num_groups++ >= 4) 
+                        {
+                            return false;
+                        }
+                        if (!ValidateOctet(octet_buffer)) 
+                        {
+                            return false;
+                        }
+                        octet_buffer.clear();
+                        state = 0;
+                    } 
+                    else if (DIGIT.Contains(c)) 
+                    {
+                        octet_buffer.push_back(c);
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+            }
+        }
+        if (!octet_buffer.empty()) 
+        {
+            ++num_groups;
+            if (!ValidateOctet(octet_buffer)) {
+                return false;
+            }
+        }
+        return (num_groups == 4);
+    }
+
+    bool ValidateIpv6Address(std::string_view address) 
+    {
+        
+        enum class ValidationState 
+        {
+            NO_GROUPS_YET,
+            COLON_BUT_NO_GROUPS_YET,
+            AFTER_COLON_EXPECT_GROUP_OR_IPV4,
+            IN_GROUP_NOT_IPV4,
+            IN_GROUP_COULD_BE_IPV4,
+            COLON_AFTER_GROUP,
+        } state = ValidationState::NO_GROUPS_YET;
+       
+        size_t num_groups = 0;
+        size_t num_digits = 0;
+        size_t ipv4_address_start = 0;
+        size_t position = 0;
+
+        bool double_colon_encountered = false;
+        bool ipv4_address_encountered = false;
+
+        for (auto c: address) 
+        {
+            switch (state) 
+            {
+                case ValidationState::NO_GROUPS_YET: 
+                {
+                    if (c == ':') 
+                    {
+                        state = ValidationState::COLON_BUT_NO_GROUPS_YET;
+                    } 
+                    else if (DIGIT.Contains(c)) 
+                    {
+                        ipv4_address_start = position;
+                        ++num_digits = 1;
+                        state = ValidationState::IN_GROUP_COULD_BE_IPV4;
+                    } 
+                    else if (HEXDIG.Contains(c)) 
+                    {
+                        ++num_digits = 1;
+                        state = ValidationState::IN_GROUP_NOT_IPV4;
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+
+                case ValidationState::COLON_BUT_NO_GROUPS_YET: 
+                {
+                    if (c == ':') 
+                    {
+                        if (double_colon_encountered) 
+                        {
+                            return false;
+                        } 
+                        else 
+                        {
+                            double_colon_encountered = true;
+                            state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
+                        }
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+
+                case ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4: 
+                {
+                    if (DIGIT.Contains(c)) 
+                    {
+                        ipv4_address_start = position;
+                        if (++num_digits > 4) 
+                        {
+                            return false;
+                        }
+                        state = ValidationState::IN_GROUP_COULD_BE_IPV4;
+                    } 
+                    else if (HEXDIG.Contains(c)) 
+                    {
+                        if (++num_digits > 4) 
+                        {
+                            return false;
+                        }
+                        state = ValidationState::IN_GROUP_NOT_IPV4;
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+
+                case ValidationState::IN_GROUP_NOT_IPV4: 
+                {
+                    if (c == ':') 
+                    {
+                        num_digits = 0;
+                        ++num_groups;
+                        state = ValidationState::COLON_AFTER_GROUP;
+                    } 
+                    else if (HEXDIG.Contains(c)) 
+                    {
+                        if (++num_digits > 4) 
+                        {
+                            return false;
+                        }
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+
+                case ValidationState::IN_GROUP_COULD_BE_IPV4: 
+                {
+                    if (c == ':') 
+                    {
+                        num_digits = 0;
+                        ++num_groups;
+                        state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
+                    } 
+                    else if (c == '.') 
+                    {
+                        ipv4_address_encountered = true;
+                        break;
+                    } 
+                    else if (DIGIT.Contains(c)) 
+                    {
+                        if (++num_digits > 4) 
+                        {
+                            return false;
+                        }
+                    } 
+                    else if (HEXDIG.Contains(c)) 
+                    {
+                        if (++num_digits > 4) 
+                        {
+                            return false;
+                        }
+                        state = ValidationState::IN_GROUP_NOT_IPV4;
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+
+                case ValidationState::COLON_AFTER_GROUP: 
+                {
+                    if (c == ':') 
+                    {
+                        if (double_colon_encountered) 
+                        {
+                            return false;
+                        } 
+                        else 
+                        {
+                            double_colon_encountered = true;
+                            state = ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4;
+                        }
+                    } 
+                    else if (DIGIT.Contains(c)) 
+                    {
+                        ipv4_address_start = position;
+                        ++num_digits;
+                        state = ValidationState::IN_GROUP_COULD_BE_IPV4;
+                    } 
+                    else if (HEXDIG.Contains(c)) 
+                    {
+                        ++num_digits;
+                        state = ValidationState::IN_GROUP_NOT_IPV4;
+                    } 
+                    else 
+                    {
+                        return false;
+                    }
+                } break;
+            }
+            if (ipv4_address_encountered) 
+            {
+                break;
+            }
+            ++position;
+        }
+        if ((state == ValidationState::IN_GROUP_NOT_IPV4)
+            || (state == ValidationState::IN_GROUP_COULD_BE_IPV4)) 
+        {
+            ++num_groups;
+        }
+        if ((position == address.length())
+            && ((state == ValidationState::COLON_BUT_NO_GROUPS_YET)
+             || (state == ValidationState::AFTER_COLON_EXPECT_GROUP_OR_IPV4)
+             || (state == ValidationState::COLON_AFTER_GROUP))) 
+        { 
+            return false;
+        }
+        if (ipv4_address_encountered) 
+        {
+            if (!ValidateIpv4Adress(address.substr(ipv4_address_start))) 
+            {
+                return false;
+            }
+            num_groups += 2;
+        }
+        if (double_colon_encountered) 
+        {
+            return (num_groups <= 7);
+        } 
+        else 
+        {
+            return (num_groups == 8);
+        }
+    }
+
+    bool DecodeElement(std::string& element, const CharacterSet& allowed_characters)
+    {
+        const auto original_segment = std::move(element);
+        element.clear();
+        bool decoding_pec = false;
+        PercentEncodedCharacterDecoder pec_decoder;
+        for (const auto c: original_segment) 
+        {
+            if (decoding_pec) 
+            {
+                if (!pec_decoder.NextEncodedCharacter(c)) 
+                {
+                    return false;
+                }
+                if (pec_decoder.Done()) 
+                {
+                    decoding_pec = false;
+                    element.push_back((char)pec_decoder.GetDecodedCharacter());
+                }
+            } 
+            else if (c == '%') 
+            {
+                decoding_pec = true;
+                pec_decoder = PercentEncodedCharacterDecoder();
+            } 
+            else 
+            {
+                if (allowed_characters.Contains(c)) 
+                {
+                    element.push_back(c);
+                } 
+                else 
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void AppendEncodedElement(std::string& buffer,
+                              std::string_view element,
+                              const CharacterSet& allowed_characters)
+    {
+        // Runs of allowed characters are copied whole.
+        while (!element.empty())
+        {
+            const auto run_length = allowed_characters.CountLeading(element);
+            buffer.append(element.data(), run_length);
+            element.remove_prefix(run_length);
+            if (element.empty())
+            {
+                break;
+            }
+            const auto c = (uint8_t)element[0];
+            element.remove_prefix(1);
+            buffer.push_back('%');
+            buffer.push_back(MakeHexDigit((unsigned int)c >> 4));
+            buffer.push_back(MakeHexDigit((unsigned int)c & 0x0F));
+        }
+    }
+
+    size_t EncodedLength(std::string_view element, const CharacterSet& allowed_characters)
+    {
+        auto length = element.length();
+        while (!element.empty())
+        {
+            element.remove_prefix(allowed_characters.CountLeading(element));
+            if (!element.empty())
+            {
+                length += 2;
+                element.remove_prefix(1);
+            }
+        }
+        return length;
+    }
+
+    std::string EncodeElement(const std::string& element, const CharacterSet& allowed_characters) 
+    {
+        std::string encoded_element;
+        AppendEncodedElement(encoded_element, element, allowed_characters);
+        return encoded_element;
+    }
+
+    bool AppendNormalizedElement(std::string& buffer,
+                                 std::string_view element,
+                                 const CharacterSet& allowed_characters,
+                                 const CharacterSet& output_characters,
+                                 bool to_lower)
+    {
+        for (size_t i = 0; i < element.size(); ++i)
+        {
+            char c = element[i];
+            if (c == '%')
+            {
+                PercentEncodedCharacterDecoder pec_decoder;
+                while (!pec_decoder.Done())
+                {
+                    if (++i == element.size())
+                    {
+                        return true;
+                    }
+                    if (!pec_decoder.NextEncodedCharacter(element[i]))
+                    {
+                        return false;
+                    }
+                }
+                c = pec_decoder.GetDecodedCharacter();
+            }
+            else if (!allowed_characters.Contains(c))
+            {
+                return false;
+            }
+            if (to_lower)
+            {
+                c = (char)tolower((unsigned char)c);
+            }
+            AppendEncodedElement(buffer, std::string_view(&c, 1), output_characters);
+        }
+        return true;
+    }
+
+    bool IsValidElement(std::string_view element, const CharacterSet& allowed_characters)
+    {
+        size_t error_offset;
+        return IsValidElement(element, allowed_characters, error_offset);
+    }
+
+    bool IsValidElement(std::string_view element,
+                        const CharacterSet& allowed_characters,
+                        size_t& error_offset)
+    {
+        size_t i = 0;
+        for (;;)
+        {
+            i += allowed_characters.CountLeading(element.substr(i));
+            if (i == element.size())
+            {
+                return true;
+            }
+            if (element[i] != '%')
+            {
+                error_offset = i;
+                return false;
+            }
+            for (size_t digit = 0; (digit < 2) && (++i < element.size()); ++digit)
+            {
+                if (!HEXDIG.Contains(element[i]))
+                {
+                    error_offset = i;
+                    return false;
+                }
+            }
+            if (i < element.size())
+            {
+                ++i;
+            }
+        }
+    }
+
+    bool DecodeQueryOrFragment(std::string& query_or_fragment)
+    {
+        return DecodeElement(query_or_fragment, QUERY_OR_FRAGMENT_NOT_PCT_ENCODED);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef URI_URI_GRAMMAR_HPP
+#define URI_URI_GRAMMAR_HPP
+
+#include "CharacterSet.hpp"
+#include <stdint.h>
+#include <string>
+#include <string_view>
+
+namespace Uri
+{
+    extern const CharacterSet ALPHA;
+    extern const CharacterSet DIGIT;
+    extern const CharacterSet HEXDIG;
+    extern const CharacterSet UNRESERVED;
+    extern const CharacterSet SUB_DELIMS;
+    extern const CharacterSet SCHEME_NOT_FIRST;
+    extern const CharacterSet PCHAR_NOT_PCT_ENCODED;
+    extern const CharacterSet QUERY_OR_FRAGMENT_NOT_PCT_ENCODED;
+    extern const CharacterSet QUERY_NOT_PCT_ENCODED_WITHOUT_PLUS;
+    extern const CharacterSet USER_INFO_NOT_PCT_ENCODED;
+    extern const CharacterSet REG_NAME_NOT_PCT_ENCODED;
+    extern const CharacterSet IPV_FUTURE_LAST_PART;
+    extern const CharacterSet RESERVED_OR_UNRESERVED;
+
+    enum class ToIntegerResult 
+    {
+        SUCCESS,
+        NOTNUMBER,
+        OVERFLOW_
+    };
+
+    bool IsLegalScheme(std::string_view scheme);
+    ToIntegerResult ToInteger(const std::string& number_string, intmax_t& number);
+    std::string ToLower(const std::string& in_string);
+    bool ValidateIpv4Adress(std::string_view address);
+    bool ValidateIpv6Address(std::string_view address);
+    bool DecodeElement(std::string& element, const CharacterSet& allowed_characters);
+    bool DecodeQueryOrFragment(std::string& query_or_fragment);
+    bool IsValidElement(std::string_view element, const CharacterSet& allowed_characters);
+
+    // As DecodeElement would accept it, without decoding; on failure,
+    // error_offset is where in element the first bad character is.
+    bool IsValidElement(std::string_view element,
+                        const CharacterSet& allowed_characters,
+                        size_t& error_offset);
+    std::string EncodeElement(const std::string& element, const CharacterSet& allowed_characters);
+    void AppendEncodedElement(std::string& buffer,
+                              std::string_view element,
+                              const CharacterSet& allowed_characters);
+
+    // The length AppendEncodedElement would append.
+    size_t EncodedLength(std::string_view element, const CharacterSet& allowed_characters);
+
+    // Appends EncodeElement(DecodeElement(element)) without the intermediate
+    // string: validates against allowed_characters, decodes percent-encoded
+    // characters and re-encodes with output_characters.
+    bool AppendNormalizedElement(std::string& buffer,
+                                 std::string_view element,
+                                 const CharacterSet& allowed_characters,
+                                 const CharacterSet& output_characters,
+                                 bool to_lower = false);
+}
+
+#endif
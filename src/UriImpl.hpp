@@ -0,0 +1,97 @@
+#ifndef URI_URI_IMPL_HPP
+#define URI_URI_IMPL_HPP
+
+#include "CopyOnWrite.hpp"
+#include <Uri/Uri.hpp>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Uri
+{
+    struct RegisteredScheme;
+    struct SerializedLayout;
+
+    struct Uri::Impl
+    {
+        CopyOnWrite< std::string > scheme;
+
+        // Kept in step with scheme: a registered scheme's ID only if scheme
+        // is exactly its lower-case name.
+        SchemeId scheme_id = SchemeRegistry::NO_SCHEME;
+        CopyOnWrite< std::string > host;
+        CopyOnWrite< std::string > user_info;
+        bool has_port = false;
+        uint16_t port = 0;
+        bool has_query = false;
+        CopyOnWrite< std::string > query;
+        bool has_fragment = false;
+        CopyOnWrite< std::string > fragment;
+        CopyOnWrite< std::vector<std::string> > path;
+
+        // What Uri::ParseFromString does, stage by stage.
+        bool Parse(std::string_view uri_string);
+
+        bool ParseAuthority(std::string_view authority_string);
+        bool ParseScheme(std::string_view uri_string, std::string_view& rest);
+
+        // Validates and lower-cases a scheme; registered schemes share the
+        // registry's copy of their name.
+        bool SetParsedScheme(std::string_view parsed_scheme);
+
+        // Sets scheme_id after scheme is assigned some other way.
+        void UpdateSchemeId();
+
+        // By ID where there is one; a scheme registered after this one was
+        // parsed is found by name.
+        const RegisteredScheme* GetRegisteredScheme() const;
+        bool HasSameScheme(const Impl& other) const;
+        bool ParseFragment(std::string_view query_fragment, std::string_view& rest);
+        bool ParsePath(std::string_view path_string);
+        bool ParseQuery(std::string_view query_with_delimiter);
+        bool SplitAuthorityFromPathAndParseIt(std::string_view author_path_string,
+                                              std::string_view& path_string);
+        void SetDefaultPathIfAuthorityPresentAndPathEmpty();
+
+        // Decodes a string this library serialized, splitting it at the
+        // recorded component boundaries instead of searching for delimiters.
+        bool ParseSerialized(std::string_view uri_string, const SerializedLayout& layout);
+
+        void NormalizePath();
+
+        void CopyScheme(const Impl& other);
+        void CopyAuthority(const Impl& other);
+        void CopyPath(const Impl& other);
+        void CopyQuery(const Impl& other);
+        void CopyFragment(const Impl& other);
+        void CopyAndNormalizePath(const Impl& other);
+
+        // RFC 3986 5.2.3: the base path without its last segment.
+        void CopyMergePrefix(const Impl& base);
+
+        // CopyMergePrefix, with the dot segments that Resolve would remove
+        // from any path merged with it already removed.
+        void CopyNormalizedMergePrefix(const Impl& base);
+
+        // RFC 3986 5.2.2; merge_prefix, if given, replaces CopyMergePrefix(base).
+        void Resolve(const Impl& base,
+                     const Impl& relative_ref,
+                     const std::vector<std::string>* merge_prefix = nullptr);
+
+        // The inverse of Resolve: the shortest reference that resolves
+        // against base to target, whose path must be normalized.
+        // merge_prefix, if given, is CopyNormalizedMergePrefix(base)
+        // already done.
+        void MakeRelative(const Impl& base,
+                          const Impl& target,
+                          const std::vector<std::string>* merge_prefix = nullptr);
+
+        bool HasAuthority() const;
+        bool HasSameAuthority(const Impl& other) const;
+        bool IsPathAbsolute() const;
+        bool CanNavigatePathUpOneLevel() const;
+    };
+}
+
+#endif
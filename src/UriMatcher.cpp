@@ -0,0 +1,672 @@
+#include "UriGrammar.hpp"
+#include <Uri/Uri.hpp>
+#include <Uri/UriMatcher.hpp>
+#include <Uri/UriView.hpp>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <stdint.h>
+#include <unordered_map>
+
+namespace
+{
+    typedef Uri::UriMatcher::Action Action;
+
+    const uint32_t NO_NODE = UINT32_MAX;
+
+    // The label or segment leading to a node, and where its children are.
+    struct TrieNode
+    {
+        uint32_t label_offset = 0;
+        uint32_t label_length = 0;
+        uint32_t first_child = 0;
+        uint32_t num_children = 0;
+    };
+
+    struct HostNode
+    {
+        TrieNode trie;
+
+        // Roots of the path tries of rules for this host exactly, and for
+        // hosts under it.
+        uint32_t exact_paths = NO_NODE;
+        uint32_t subdomain_paths = NO_NODE;
+    };
+
+    struct PathNode
+    {
+        TrieNode trie;
+        uint32_t first_terminal = 0;
+        uint32_t num_terminals = 0;
+    };
+
+    // A rule whose path prefix ends at some path node.
+    struct Terminal
+    {
+        uint32_t scheme_offset = 0;
+        uint32_t scheme_length = 0;
+        Action action = Action::DENY;
+        size_t rule_index = 0;
+    };
+
+    struct BuildTerminal
+    {
+        std::string scheme;
+        Action action;
+        size_t rule_index;
+
+        // Rules with a scheme first, then DENY, then earlier rules, so the
+        // first terminal that applies is the one that decides.
+        bool operator<(const BuildTerminal& other) const
+        {
+            if (scheme.empty() != other.scheme.empty())
+            {
+                return !scheme.empty();
+            }
+            if (action != other.action)
+            {
+                return (action == Action::DENY);
+            }
+            return (rule_index < other.rule_index);
+        }
+    };
+
+    struct BuildPathNode
+    {
+        std::map< std::string, std::unique_ptr< BuildPathNode > > children;
+        std::vector< BuildTerminal > terminals;
+    };
+
+    struct BuildHostNode
+    {
+        std::map< std::string, std::unique_ptr< BuildHostNode > > children;
+        std::unique_ptr< BuildPathNode > exact_paths;
+        std::unique_ptr< BuildPathNode > subdomain_paths;
+    };
+
+    template< typename Node >
+    Node& Child(std::map< std::string, std::unique_ptr< Node > >& children, const std::string& label)
+    {
+        auto& child = children[label];
+        if (!child)
+        {
+            child.reset(new Node);
+        }
+        return *child;
+    }
+
+    template< typename Node >
+    Node& Make(std::unique_ptr< Node >& node)
+    {
+        if (!node)
+        {
+            node.reset(new Node);
+        }
+        return *node;
+    }
+
+    char ToLowerAscii(char c)
+    {
+        return ((c >= 'A') && (c <= 'Z')) ? (char)(c - 'A' + 'a') : c;
+    }
+
+    int HexValue(char c)
+    {
+        if ((c >= '0') && (c <= '9'))
+        {
+            return c - '0';
+        }
+        if ((c >= 'A') && (c <= 'F'))
+        {
+            return c - 'A' + 10;
+        }
+        if ((c >= 'a') && (c <= 'f'))
+        {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    // The character at input[i], decoded if ENCODED and it starts a
+    // percent-encoded one; advances i past it.
+    template< bool ENCODED >
+    uint8_t NextCharacter(std::string_view input, size_t& i)
+    {
+        if (ENCODED && (input[i] == '%') && (i + 2 < input.length()))
+        {
+            const auto high = HexValue(input[i + 1]);
+            const auto low = HexValue(input[i + 2]);
+            if ((high >= 0) && (low >= 0))
+            {
+                i += 3;
+                return (uint8_t)((high << 4) | low);
+            }
+        }
+        return (uint8_t)input[i++];
+    }
+
+    // Orders input, decoding it if ENCODED and folding its case if
+    // FOLD_CASE, against a key stored that way.
+    template< bool ENCODED, bool FOLD_CASE >
+    int Compare(std::string_view input, std::string_view key)
+    {
+        size_t i = 0;
+        size_t j = 0;
+        while ((i < input.length()) && (j < key.length()))
+        {
+            auto c = NextCharacter< ENCODED >(input, i);
+            if (FOLD_CASE)
+            {
+                c = (uint8_t)ToLowerAscii((char)c);
+            }
+            const auto k = (uint8_t)key[j++];
+            if (c != k)
+            {
+                return (c < k) ? -1 : 1;
+            }
+        }
+        if (i < input.length())
+        {
+            return 1;
+        }
+        return (j < key.length()) ? -1 : 0;
+    }
+
+    // The path segments of a Uri, decoded, without the empty first one of
+    // an absolute path.
+    struct DecodedPath
+    {
+        static const bool ENCODED = false;
+
+        const Uri::Uri* uri;
+        size_t next;
+
+        explicit DecodedPath(const Uri::Uri& new_uri)
+            : uri(&new_uri)
+            , next(0)
+        {
+            if ((uri->GetPathSegmentCount() > 1) && uri->GetPathSegment(0).empty())
+            {
+                next = 1;
+            }
+        }
+
+        bool Next(std::string_view& segment)
+        {
+            if (next == uri->GetPathSegmentCount())
+            {
+                return false;
+            }
+            segment = uri->GetPathSegment(next++);
+            return true;
+        }
+    };
+
+    // The same, from the still percent-encoded path of a UriView.
+    struct EncodedPath
+    {
+        static const bool ENCODED = true;
+
+        std::string_view rest;
+        bool done;
+
+        explicit EncodedPath(std::string_view path)
+            : rest(path)
+            , done(path.empty())
+        {
+            if (!rest.empty() && (rest[0] == '/'))
+            {
+                rest.remove_prefix(1);
+            }
+        }
+
+        bool Next(std::string_view& segment)
+        {
+            if (done)
+            {
+                return false;
+            }
+            const auto delimiter = rest.find('/');
+            if (delimiter == std::string_view::npos)
+            {
+                segment = rest;
+                done = true;
+            }
+            else
+            {
+                segment = rest.substr(0, delimiter);
+                rest.remove_prefix(delimiter + 1);
+            }
+            return true;
+        }
+    };
+
+    bool IsLegalHostPattern(std::string_view host)
+    {
+        if (host == "*")
+        {
+            return true;
+        }
+        if ((host.substr(0, 2) == "*.") && (host.length() > 2))
+        {
+            host.remove_prefix(2);
+        }
+        if (host.find('*') != std::string_view::npos)
+        {
+            return false;
+        }
+        for (size_t label_start = 0;;)
+        {
+            const auto label_end = host.find('.', label_start);
+            if (label_end == label_start)
+            {
+                return false;
+            }
+            if (label_end == std::string_view::npos)
+            {
+                return (label_start < host.length());
+            }
+            label_start = label_end + 1;
+        }
+    }
+
+    struct CompiledRules
+    {
+        // Every host label, path segment and scheme, once each.
+        std::string pool;
+        std::vector< HostNode > host_nodes = std::vector< HostNode >(1);
+        std::vector< PathNode > path_nodes;
+        std::vector< Terminal > terminals;
+
+        // The path trie of rules for any host.
+        uint32_t any_host_paths = NO_NODE;
+        Action default_action = Action::ALLOW;
+        size_t num_rules = 0;
+
+        std::string_view GetLabel(uint32_t offset, uint32_t length) const
+        {
+            return std::string_view(pool).substr(offset, length);
+        }
+
+        template< bool ENCODED, bool FOLD_CASE, typename Node >
+        uint32_t FindChild(const std::vector< Node >& nodes, const Node& node, std::string_view label) const
+        {
+            auto first = node.trie.first_child;
+            auto count = node.trie.num_children;
+            while (count > 0)
+            {
+                const auto half = count / 2;
+                const auto middle = first + half;
+                const auto& child = nodes[middle].trie;
+                const auto order = Compare< ENCODED, FOLD_CASE >(
+                    label,
+                    GetLabel(child.label_offset, child.label_length)
+                );
+                if (order == 0)
+                {
+                    return middle;
+                }
+                if (order > 0)
+                {
+                    first = middle + 1;
+                    count -= half + 1;
+                }
+                else
+                {
+                    count = half;
+                }
+            }
+            return NO_NODE;
+        }
+
+        // The deciding terminal of the path trie at paths_root, if any: the
+        // first one applying to the scheme at the deepest node reached.
+        template< typename Path >
+        const Terminal* MatchPath(uint32_t paths_root, std::string_view scheme, Path path) const
+        {
+            const Terminal* match = nullptr;
+            auto node = &path_nodes[paths_root];
+            for (;;)
+            {
+                const auto terminals_end = node->first_terminal + node->num_terminals;
+                for (auto i = node->first_terminal; i < terminals_end; ++i)
+                {
+                    const auto& terminal = terminals[i];
+                    if ((terminal.scheme_length == 0)
+                        || (Compare< false, true >(
+                            scheme,
+                            GetLabel(terminal.scheme_offset, terminal.scheme_length)
+                        ) == 0))
+                    {
+                        match = &terminal;
+                        break;
+                    }
+                }
+                std::string_view segment;
+                if (!path.Next(segment))
+                {
+                    return match;
+                }
+                const auto child = FindChild< Path::ENCODED, false >(path_nodes, *node, segment);
+                if (child == NO_NODE)
+                {
+                    return match;
+                }
+                node = &path_nodes[child];
+            }
+        }
+
+        // Tries host patterns from the least specific to the most, each
+        // overriding the ones before it if its paths match, in one walk over
+        // the host's labels from the right.
+        template< typename Path >
+        const Terminal* Find(std::string_view scheme, std::string_view host, const Path& path) const
+        {
+            const Terminal* match = nullptr;
+            auto consider = [&](uint32_t paths_root)
+            {
+                if (paths_root == NO_NODE)
+                {
+                    return;
+                }
+                const auto candidate = MatchPath(paths_root, scheme, path);
+                if (candidate != nullptr)
+                {
+                    match = candidate;
+                }
+            };
+            consider(any_host_paths);
+            auto node = &host_nodes[0];
+            for (auto end = host.length(); end > 0;)
+            {
+                const auto dot = host.rfind('.', end - 1);
+                const auto label_start = (dot == std::string_view::npos) ? 0 : dot + 1;
+                const auto child = FindChild< Path::ENCODED, true >(
+                    host_nodes,
+                    *node,
+                    host.substr(label_start, end - label_start)
+                );
+                if (child == NO_NODE)
+                {
+                    break;
+                }
+                node = &host_nodes[child];
+                if (dot == std::string_view::npos)
+                {
+                    consider(node->exact_paths);
+                    break;
+                }
+                consider(node->subdomain_paths);
+                end = dot;
+            }
+            return match;
+        }
+
+        Action Decide(const Terminal* terminal) const
+        {
+            return ((terminal == nullptr) ? default_action : terminal->action);
+        }
+    };
+
+    class Compiler
+    {
+    public:
+        explicit Compiler(CompiledRules& compiled)
+            : compiled_(compiled)
+        {
+        }
+
+        void Compile(const BuildHostNode& host_root, const BuildPathNode* any_host_paths)
+        {
+            if (any_host_paths != nullptr)
+            {
+                compiled_.any_host_paths = FlattenPaths(*any_host_paths);
+            }
+            auto& host_nodes = compiled_.host_nodes;
+            std::deque< std::pair< const BuildHostNode*, uint32_t > > queue{{&host_root, 0}};
+            while (!queue.empty())
+            {
+                const auto build_node = queue.front().first;
+                const auto index = queue.front().second;
+                queue.pop_front();
+                host_nodes[index].trie.first_child = (uint32_t)host_nodes.size();
+                host_nodes[index].trie.num_children = (uint32_t)build_node->children.size();
+                for (const auto& child: build_node->children)
+                {
+                    HostNode node;
+                    SetLabel(node.trie, child.first);
+                    queue.emplace_back(child.second.get(), (uint32_t)host_nodes.size());
+                    host_nodes.push_back(node);
+                }
+                if (build_node->exact_paths)
+                {
+                    host_nodes[index].exact_paths = FlattenPaths(*build_node->exact_paths);
+                }
+                if (build_node->subdomain_paths)
+                {
+                    host_nodes[index].subdomain_paths = FlattenPaths(*build_node->subdomain_paths);
+                }
+            }
+            host_nodes.shrink_to_fit();
+            compiled_.path_nodes.shrink_to_fit();
+            compiled_.terminals.shrink_to_fit();
+            compiled_.pool.shrink_to_fit();
+        }
+
+    private:
+        uint32_t Intern(const std::string& label)
+        {
+            const auto offset = offsets_.find(label);
+            if (offset != offsets_.end())
+            {
+                return offset->second;
+            }
+            const auto new_offset = (uint32_t)compiled_.pool.length();
+            compiled_.pool += label;
+            offsets_[label] = new_offset;
+            return new_offset;
+        }
+
+        void SetLabel(TrieNode& node, const std::string& label)
+        {
+            node.label_offset = Intern(label);
+            node.label_length = (uint32_t)label.length();
+        }
+
+        // Breadth first, so each node's children are contiguous and sorted;
+        // returns the root's index.
+        uint32_t FlattenPaths(const BuildPathNode& root)
+        {
+            auto& path_nodes = compiled_.path_nodes;
+            const auto root_index = (uint32_t)path_nodes.size();
+            path_nodes.emplace_back();
+            std::deque< std::pair< const BuildPathNode*, uint32_t > > queue{{&root, root_index}};
+            while (!queue.empty())
+            {
+                const auto build_node = queue.front().first;
+                const auto index = queue.front().second;
+                queue.pop_front();
+                path_nodes[index].trie.first_child = (uint32_t)path_nodes.size();
+                path_nodes[index].trie.num_children = (uint32_t)build_node->children.size();
+                path_nodes[index].first_terminal = (uint32_t)compiled_.terminals.size();
+                path_nodes[index].num_terminals = (uint32_t)build_node->terminals.size();
+                auto build_terminals = build_node->terminals;
+                std::sort(build_terminals.begin(), build_terminals.end());
+                for (const auto& build_terminal: build_terminals)
+                {
+                    Terminal terminal;
+                    terminal.scheme_offset = Intern(build_terminal.scheme);
+                    terminal.scheme_length = (uint32_t)build_terminal.scheme.length();
+                    terminal.action = build_terminal.action;
+                    terminal.rule_index = build_terminal.rule_index;
+                    compiled_.terminals.push_back(terminal);
+                }
+                for (const auto& child: build_node->children)
+                {
+                    PathNode node;
+                    SetLabel(node.trie, child.first);
+                    queue.emplace_back(child.second.get(), (uint32_t)path_nodes.size());
+                    path_nodes.push_back(node);
+                }
+            }
+            return root_index;
+        }
+
+        CompiledRules& compiled_;
+        std::unordered_map< std::string, uint32_t > offsets_;
+    };
+}
+
+namespace Uri
+{
+    struct UriMatcher::Impl
+    {
+        // Swapped whole by Build; each match works on the one it loaded.
+        std::shared_ptr< const CompiledRules > rules;
+
+        std::shared_ptr< const CompiledRules > Load() const
+        {
+            return std::atomic_load(&rules);
+        }
+    };
+
+    const size_t UriMatcher::NO_RULE;
+
+    UriMatcher::~UriMatcher() noexcept = default;
+    UriMatcher::UriMatcher(UriMatcher&&) noexcept = default;
+    UriMatcher& UriMatcher::operator=(UriMatcher&&) noexcept = default;
+
+    UriMatcher::UriMatcher()
+        : impl_(new Impl)
+    {
+        impl_->rules = std::make_shared< const CompiledRules >();
+    }
+
+    bool UriMatcher::ParseRule(std::string_view pattern, Action action, Rule& rule)
+    {
+        Uri uri;
+        if (!uri.ParseFromString(pattern) || uri.GetHostView().empty())
+        {
+            return false;
+        }
+        rule.scheme = uri.GetScheme();
+        rule.host = uri.GetHost();
+        rule.path_prefix = uri.GetPath();
+        if (!rule.path_prefix.empty() && rule.path_prefix.front().empty())
+        {
+            rule.path_prefix.erase(rule.path_prefix.begin());
+        }
+        if (!rule.path_prefix.empty() && rule.path_prefix.back().empty())
+        {
+            rule.path_prefix.pop_back();
+        }
+        rule.action = action;
+        return true;
+    }
+
+    bool UriMatcher::Build(const std::vector< Rule >& rules, Action default_action)
+    {
+        BuildHostNode host_root;
+        std::unique_ptr< BuildPathNode > any_host_paths;
+        std::string host;
+        for (size_t rule_index = 0; rule_index < rules.size(); ++rule_index)
+        {
+            const auto& rule = rules[rule_index];
+            if ((!rule.scheme.empty() && !IsLegalScheme(rule.scheme))
+                || !IsLegalHostPattern(rule.host))
+            {
+                return false;
+            }
+            host.clear();
+            for (const auto c: rule.host)
+            {
+                host.push_back(ToLowerAscii(c));
+            }
+            BuildPathNode* paths;
+            if (host == "*")
+            {
+                paths = &Make(any_host_paths);
+            }
+            else
+            {
+                const bool subdomains = (host[0] == '*');
+                if (subdomains)
+                {
+                    host.erase(0, 2);
+                }
+                auto node = &host_root;
+                for (auto end = host.length();;)
+                {
+                    const auto dot = host.rfind('.', end - 1);
+                    const auto label_start = (dot == std::string::npos) ? 0 : dot + 1;
+                    node = &Child(node->children, host.substr(label_start, end - label_start));
+                    if (dot == std::string::npos)
+                    {
+                        break;
+                    }
+                    end = dot;
+                }
+                paths = &Make(subdomains ? node->subdomain_paths : node->exact_paths);
+            }
+            for (const auto& segment: rule.path_prefix)
+            {
+                paths = &Child(paths->children, segment);
+            }
+            BuildTerminal terminal{rule.scheme, rule.action, rule_index};
+            for (auto& c: terminal.scheme)
+            {
+                c = ToLowerAscii(c);
+            }
+            paths->terminals.push_back(std::move(terminal));
+        }
+        auto compiled = std::make_shared< CompiledRules >();
+        Compiler(*compiled).Compile(host_root, any_host_paths.get());
+        compiled->default_action = default_action;
+        compiled->num_rules = rules.size();
+        std::atomic_store(&impl_->rules, std::shared_ptr< const CompiledRules >(std::move(compiled)));
+        return true;
+    }
+
+    size_t UriMatcher::Size() const
+    {
+        return impl_->Load()->num_rules;
+    }
+
+    size_t UriMatcher::FindRule(const Uri& uri) const
+    {
+        const auto rules = impl_->Load();
+        const auto terminal = rules->Find(uri.GetSchemeView(), uri.GetHostView(), DecodedPath(uri));
+        return ((terminal == nullptr) ? NO_RULE : terminal->rule_index);
+    }
+
+    size_t UriMatcher::FindRule(const UriView& uri) const
+    {
+        const auto rules = impl_->Load();
+        const auto terminal = rules->Find(uri.GetScheme(), uri.GetHost(), EncodedPath(uri.GetPath()));
+        return ((terminal == nullptr) ? NO_RULE : terminal->rule_index);
+    }
+
+    UriMatcher::Action UriMatcher::Match(const Uri& uri) const
+    {
+        const auto rules = impl_->Load();
+        return rules->Decide(rules->Find(uri.GetSchemeView(), uri.GetHostView(), DecodedPath(uri)));
+    }
+
+    UriMatcher::Action UriMatcher::Match(const UriView& uri) const
+    {
+        const auto rules = impl_->Load();
+        return rules->Decide(rules->Find(uri.GetScheme(), uri.GetHost(), EncodedPath(uri.GetPath())));
+    }
+
+    void UriMatcher::Match(const std::vector< Uri >& uris, std::vector< Action >& actions) const
+    {
+        const auto rules = impl_->Load();
+        actions.resize(uris.size());
+        for (size_t i = 0; i < uris.size(); ++i)
+        {
+            const auto& uri = uris[i];
+            actions[i] = rules->Decide(rules->Find(uri.GetSchemeView(), uri.GetHostView(), DecodedPath(uri)));
+        }
+    }
+}
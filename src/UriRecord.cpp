@@ -0,0 +1,414 @@
+#include "UriGrammar.hpp"
+#include "UriImpl.hpp"
+#include "Varint.hpp"
+#include <Uri/UriRecord.hpp>
+#include <string.h>
+
+namespace
+{
+    const uint32_t ARRAY_MAGIC = 0x44524555;
+    const uint32_t ARRAY_BYTE_ORDER_MARK = 0x01020304;
+    const size_t ARRAY_HEADER_SIZE = 3 * sizeof(uint32_t) + sizeof(uint64_t);
+
+    const uint8_t HAS_PORT = 0x01;
+    const uint8_t HAS_QUERY = 0x02;
+    const uint8_t HAS_FRAGMENT = 0x04;
+    const unsigned int HOST_TYPE_SHIFT = 3;
+    const uint8_t HOST_TYPE_MASK = 0x18;
+    const uint8_t KNOWN_FLAGS = HAS_PORT | HAS_QUERY | HAS_FRAGMENT | HOST_TYPE_MASK;
+
+    Uri::UriRecord::HostType HostTypeOf(const std::string& host, bool has_authority)
+    {
+        if (!has_authority)
+        {
+            return Uri::UriRecord::HostType::NO_AUTHORITY;
+        }
+        if (host.find(':') != std::string::npos)
+        {
+            return Uri::UriRecord::HostType::IP_LITERAL;
+        }
+        if (Uri::ValidateIpv4Adress(host))
+        {
+            return Uri::UriRecord::HostType::IPV4_ADDRESS;
+        }
+        return Uri::UriRecord::HostType::REG_NAME;
+    }
+
+    size_t StringLength(const std::string& element)
+    {
+        return Uri::VarintLength(element.length()) + element.length();
+    }
+
+    void AppendString(std::vector< uint8_t >& buffer, const std::string& element)
+    {
+        Uri::AppendVarint(buffer, element.length());
+        buffer.insert(buffer.end(), element.begin(), element.end());
+    }
+
+    bool ReadString(const uint8_t*& position, const uint8_t* end, std::string_view& element)
+    {
+        size_t length;
+        if (!Uri::ReadVarint(position, end, length)
+            || (length > (size_t)(end - position)))
+        {
+            return false;
+        }
+        element = std::string_view((const char*)position, length);
+        position += length;
+        return true;
+    }
+
+    // Reuses the target's buffer when it is not shared with another Uri.
+    void Assign(Uri::CopyOnWrite< std::string >& target, std::string_view value)
+    {
+        if (value.empty())
+        {
+            target.Clear();
+        }
+        else
+        {
+            target.Overwrite().assign(value);
+        }
+    }
+
+    template< typename T >
+    void AppendValue(std::vector< uint8_t >& buffer, T value)
+    {
+        const auto offset = buffer.size();
+        buffer.resize(offset + sizeof(value));
+        memcpy(buffer.data() + offset, &value, sizeof(value));
+    }
+
+    template< typename T >
+    T GetValue(const uint8_t* data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+}
+
+namespace Uri
+{
+    // Record layout: body length, then the body: format version, flags,
+    // scheme, user info, host, port (if any), path segment count, each
+    // segment's length, the segments' characters, then query and fragment
+    // (if any).  Strings are a varint length and the decoded characters.
+    struct UriRecord::Impl
+    {
+        uint8_t flags = 0;
+        std::string_view scheme;
+        std::string_view user_info;
+        std::string_view host;
+        uint16_t port = 0;
+        std::vector< std::string_view > path;
+        std::string_view query;
+        std::string_view fragment;
+
+        bool Attach(const uint8_t* data, size_t size, size_t& consumed)
+        {
+            auto position = data;
+            size_t body_length;
+            if (!ReadVarint(position, data + size, body_length)
+                || (body_length > (size_t)(data + size - position)))
+            {
+                return false;
+            }
+            const auto end = position + body_length;
+            size_t num_segments;
+            if ((end - position < 2)
+                || (position[0] != FORMAT_VERSION)
+                || ((position[1] & ~KNOWN_FLAGS) != 0))
+            {
+                return false;
+            }
+            flags = position[1];
+            position += 2;
+            if (!ReadString(position, end, scheme)
+                || !ReadString(position, end, user_info)
+                || !ReadString(position, end, host))
+            {
+                return false;
+            }
+            port = 0;
+            if (((flags & HAS_PORT) != 0)
+                && !ReadVarint(position, end, port))
+            {
+                return false;
+            }
+            if (!ReadVarint(position, end, num_segments)
+                || (num_segments > (size_t)(end - position)))
+            {
+                return false;
+            }
+            path.resize(num_segments);
+            size_t path_length = 0;
+            for (auto& segment: path)
+            {
+                size_t segment_length;
+                if (!ReadVarint(position, end, segment_length)
+                    || (segment_length > (size_t)(end - position)))
+                {
+                    return false;
+                }
+                segment = std::string_view(nullptr, segment_length);
+                path_length += segment_length;
+            }
+            if (path_length > (size_t)(end - position))
+            {
+                return false;
+            }
+            for (auto& segment: path)
+            {
+                segment = std::string_view((const char*)position, segment.length());
+                position += segment.length();
+            }
+            query = std::string_view();
+            fragment = std::string_view();
+            if ((((flags & HAS_QUERY) != 0) && !ReadString(position, end, query))
+                || (((flags & HAS_FRAGMENT) != 0) && !ReadString(position, end, fragment))
+                || (position != end))
+            {
+                return false;
+            }
+            consumed = (size_t)(end - data);
+            return true;
+        }
+    };
+
+    const uint8_t UriRecord::FORMAT_VERSION;
+
+    UriRecord::~UriRecord() noexcept = default;
+
+    UriRecord::UriRecord(const UriRecord& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+
+    UriRecord::UriRecord(UriRecord&&) noexcept = default;
+
+    UriRecord& UriRecord::operator=(const UriRecord& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+
+    UriRecord& UriRecord::operator=(UriRecord&&) noexcept = default;
+
+    UriRecord::UriRecord()
+        : impl_(new Impl)
+    {
+    }
+
+    void UriRecord::Append(const Uri& uri, std::vector<uint8_t>& buffer)
+    {
+        const auto& components = *uri.impl_;
+        const auto host_type = HostTypeOf(*components.host, components.HasAuthority());
+        uint8_t flags = (uint8_t)((unsigned int)host_type << HOST_TYPE_SHIFT);
+        size_t body_length = 2
+            + StringLength(*components.scheme)
+            + StringLength(*components.user_info)
+            + StringLength(*components.host)
+            + VarintLength(components.path->size());
+        if (components.has_port)
+        {
+            flags |= HAS_PORT;
+            body_length += VarintLength(components.port);
+        }
+        for (const auto& segment: *components.path)
+        {
+            body_length += StringLength(segment);
+        }
+        if (components.has_query)
+        {
+            flags |= HAS_QUERY;
+            body_length += StringLength(*components.query);
+        }
+        if (components.has_fragment)
+        {
+            flags |= HAS_FRAGMENT;
+            body_length += StringLength(*components.fragment);
+        }
+        AppendVarint(buffer, body_length);
+        buffer.push_back(FORMAT_VERSION);
+        buffer.push_back(flags);
+        AppendString(buffer, *components.scheme);
+        AppendString(buffer, *components.user_info);
+        AppendString(buffer, *components.host);
+        if (components.has_port)
+        {
+            AppendVarint(buffer, components.port);
+        }
+        AppendVarint(buffer, components.path->size());
+        for (const auto& segment: *components.path)
+        {
+            AppendVarint(buffer, segment.length());
+        }
+        for (const auto& segment: *components.path)
+        {
+            buffer.insert(buffer.end(), segment.begin(), segment.end());
+        }
+        if (components.has_query)
+        {
+            AppendString(buffer, *components.query);
+        }
+        if (components.has_fragment)
+        {
+            AppendString(buffer, *components.fragment);
+        }
+    }
+
+    void UriRecord::AppendAll(const std::vector<Uri>& uris, std::vector<uint8_t>& buffer)
+    {
+        AppendValue(buffer, ARRAY_MAGIC);
+        AppendValue(buffer, (uint32_t)FORMAT_VERSION);
+        AppendValue(buffer, ARRAY_BYTE_ORDER_MARK);
+        AppendValue(buffer, (uint64_t)uris.size());
+        for (const auto& uri: uris)
+        {
+            Append(uri, buffer);
+        }
+    }
+
+    bool UriRecord::ReadArrayHeader(const uint8_t* data, size_t size, size_t& count, size_t& header_size)
+    {
+        if ((size < ARRAY_HEADER_SIZE)
+            || (GetValue< uint32_t >(data) != ARRAY_MAGIC)
+            || (GetValue< uint32_t >(data + 4) != FORMAT_VERSION)
+            || (GetValue< uint32_t >(data + 8) != ARRAY_BYTE_ORDER_MARK))
+        {
+            return false;
+        }
+        const auto array_count = GetValue< uint64_t >(data + 12);
+        if (array_count > (size - ARRAY_HEADER_SIZE))
+        {
+            return false;
+        }
+        count = (size_t)array_count;
+        header_size = ARRAY_HEADER_SIZE;
+        return true;
+    }
+
+    bool UriRecord::ReadAll(const uint8_t* data, size_t size, std::vector<Uri>& uris)
+    {
+        size_t count, offset;
+        if (!ReadArrayHeader(data, size, count, offset))
+        {
+            return false;
+        }
+        std::vector< Uri > read(count);
+        UriRecord record;
+        for (auto& uri: read)
+        {
+            size_t consumed;
+            if (!record.Attach(data + offset, size - offset, consumed))
+            {
+                return false;
+            }
+            record.ToUri(uri);
+            offset += consumed;
+        }
+        if (offset != size)
+        {
+            return false;
+        }
+        uris = std::move(read);
+        return true;
+    }
+
+    bool UriRecord::Attach(const uint8_t* data, size_t size, size_t& consumed)
+    {
+        return impl_->Attach(data, size, consumed);
+    }
+
+    void UriRecord::ToUri(Uri& uri) const
+    {
+        auto& components = *uri.impl_;
+        Assign(components.scheme, impl_->scheme);
+        components.UpdateSchemeId();
+        Assign(components.user_info, impl_->user_info);
+        Assign(components.host, impl_->host);
+        components.has_port = HasPort();
+        components.port = impl_->port;
+        if (impl_->path.empty())
+        {
+            components.path.Clear();
+        }
+        else
+        {
+            auto& path = components.path.Overwrite();
+            path.resize(impl_->path.size());
+            for (size_t i = 0; i < impl_->path.size(); ++i)
+            {
+                path[i].assign(impl_->path[i]);
+            }
+        }
+        components.has_query = HasQuery();
+        Assign(components.query, impl_->query);
+        components.has_fragment = HasFragment();
+        Assign(components.fragment, impl_->fragment);
+    }
+
+    std::string_view UriRecord::GetScheme() const
+    {
+        return impl_->scheme;
+    }
+
+    std::string_view UriRecord::GetUserInfo() const
+    {
+        return impl_->user_info;
+    }
+
+    std::string_view UriRecord::GetHost() const
+    {
+        return impl_->host;
+    }
+
+    UriRecord::HostType UriRecord::GetHostType() const
+    {
+        return (HostType)((impl_->flags & HOST_TYPE_MASK) >> HOST_TYPE_SHIFT);
+    }
+
+    bool UriRecord::HasPort() const
+    {
+        return ((impl_->flags & HAS_PORT) != 0);
+    }
+
+    uint16_t UriRecord::GetPort() const
+    {
+        return impl_->port;
+    }
+
+    size_t UriRecord::GetPathSegmentCount() const
+    {
+        return impl_->path.size();
+    }
+
+    std::string_view UriRecord::GetPathSegment(size_t index) const
+    {
+        return impl_->path[index];
+    }
+
+    bool UriRecord::HasQuery() const
+    {
+        return ((impl_->flags & HAS_QUERY) != 0);
+    }
+
+    std::string_view UriRecord::GetQuery() const
+    {
+        return impl_->query;
+    }
+
+    bool UriRecord::HasFragment() const
+    {
+        return ((impl_->flags & HAS_FRAGMENT) != 0);
+    }
+
+    std::string_view UriRecord::GetFragment() const
+    {
+        return impl_->fragment;
+    }
+}
@@ -0,0 +1,593 @@
+#include "ReferenceResolver.hpp"
+#include "UriGrammar.hpp"
+#include "UriImpl.hpp"
+#include <algorithm>
+#include <stdint.h>
+#include <string>
+#include <Uri/UriScanner.hpp>
+
+namespace
+{
+    // What the grammar tells apart about a character.  END stands for the
+    // end of the input, which goes through the table like a character.
+    enum CharacterClass : uint8_t
+    {
+        OTHER,
+        HEX_LETTER,
+        LETTER_V,
+        LETTER,
+        DIGIT,
+        PLUS,
+        MINUS,
+        DOT,
+        UNRESERVED_OTHER,
+        SUB_DELIM_OTHER,
+        COLON,
+        AT,
+        SLASH,
+        QUESTION_MARK,
+        HASH,
+        PERCENT,
+        LEFT_BRACKET,
+        RIGHT_BRACKET,
+        END,
+        NUM_CLASSES
+    };
+
+    // Sets of classes, one bit each.
+    typedef uint32_t ClassSet;
+
+    constexpr ClassSet Classes(CharacterClass character_class)
+    {
+        return (ClassSet)1 << character_class;
+    }
+
+    constexpr ClassSet HEX = Classes(HEX_LETTER) | Classes(DIGIT);
+    constexpr ClassSet ALL_LETTERS = Classes(HEX_LETTER) | Classes(LETTER_V) | Classes(LETTER);
+    constexpr ClassSet SCHEME = ALL_LETTERS | Classes(DIGIT) | Classes(PLUS) | Classes(MINUS) | Classes(DOT);
+    constexpr ClassSet UNRESERVED = (
+        ALL_LETTERS | Classes(DIGIT) | Classes(MINUS) | Classes(DOT) | Classes(UNRESERVED_OTHER)
+    );
+    constexpr ClassSet REG_NAME = UNRESERVED | Classes(PLUS) | Classes(SUB_DELIM_OTHER);
+    constexpr ClassSet USER_INFO = REG_NAME | Classes(COLON);
+    constexpr ClassSet PCHAR = USER_INFO | Classes(AT);
+    constexpr ClassSet PATH = PCHAR | Classes(SLASH);
+    constexpr ClassSet QUERY = PATH | Classes(QUESTION_MARK);
+    constexpr ClassSet IPV6 = HEX | Classes(COLON) | Classes(DOT);
+
+    enum State : uint8_t
+    {
+        // Where every mistake leads, never to leave.
+        ERROR,
+
+        START,
+
+        // The first segment, which is the scheme if a ':' ends it: while
+        // it could be, and once it can't.  Then a ':' is an error, as
+        // it is in a query or fragment before the first '/'.
+        SCHEME_OR_SEGMENT,
+        FIRST_SEGMENT,
+        FIRST_SEGMENT_PERCENT_1,
+        FIRST_SEGMENT_PERCENT_2,
+
+        LEADING_SLASH,
+        AFTER_SCHEME,
+        AFTER_SCHEME_SLASH,
+
+        // Until an '@' or the end of the authority, the characters are
+        // the user info or the host, and those after a ':' the user info
+        // or the port.
+        AUTHORITY_START,
+        USER_INFO_OR_HOST,
+        USER_INFO_OR_HOST_PERCENT_1,
+        USER_INFO_OR_HOST_PERCENT_2,
+        USER_INFO_OR_PORT,
+        USER_INFO_PART,
+        USER_INFO_PERCENT_1,
+        USER_INFO_PERCENT_2,
+
+        HOST_START,
+        HOST,
+        HOST_PERCENT_1,
+        HOST_PERCENT_2,
+        PORT,
+
+        IP_LITERAL_START,
+        IPV6_ADDRESS,
+        IPV_FUTURE_VERSION,
+        IPV_FUTURE_BODY,
+        IP_LITERAL_END,
+
+        PATH_SEGMENTS,
+        PATH_PERCENT_1,
+        PATH_PERCENT_2,
+        FIRST_QUERY,
+        FIRST_QUERY_PERCENT_1,
+        FIRST_QUERY_PERCENT_2,
+        QUERY_PART,
+        QUERY_PERCENT_1,
+        QUERY_PERCENT_2,
+        FIRST_FRAGMENT,
+        FIRST_FRAGMENT_PERCENT_1,
+        FIRST_FRAGMENT_PERCENT_2,
+        FRAGMENT,
+        FRAGMENT_PERCENT_1,
+        FRAGMENT_PERCENT_2,
+
+        ACCEPT,
+        NUM_STATES
+    };
+
+    // Where a transition records the offset of its character.  NO_SLOT
+    // is written to like the others and never read.
+    enum Slot : uint8_t
+    {
+        NO_SLOT,
+        SCHEME_COLON,
+        AUTHORITY_SLASH,
+        AUTHORITY_END,
+        PATH_END,
+        QUERY_END,
+        USER_INFO_AT,
+        FIRST_AUTHORITY_COLON,
+        PORT_COLON,
+        LEFT_BRACKET_SLOT,
+        RIGHT_BRACKET_SLOT,
+        NUM_SLOTS
+    };
+
+    // Each entry is the next state in its low byte and up to two slots
+    // in its high one.
+    typedef uint16_t Entry;
+
+    constexpr State NextState(Entry entry)
+    {
+        return (State)(entry & 0xFF);
+    }
+
+    constexpr size_t FirstSlot(Entry entry)
+    {
+        return (entry >> 8) & 0x0F;
+    }
+
+    constexpr size_t SecondSlot(Entry entry)
+    {
+        return entry >> 12;
+    }
+
+    static_assert(NUM_STATES <= 256, "states must fit in a byte");
+    static_assert(NUM_SLOTS <= 16, "slots must fit in four bits");
+
+    // Rows are padded to a power of two, so that finding one is a shift.
+    const size_t ROW_LENGTH = 32;
+    static_assert(NUM_CLASSES <= ROW_LENGTH, "classes must fit in a row");
+
+    struct Table
+    {
+        uint8_t classes[256];
+        Entry entries[NUM_STATES][ROW_LENGTH];
+    };
+
+    struct TableBuilder
+    {
+        Table table{};
+
+        constexpr void On(State from, ClassSet classes, State to, Slot first = NO_SLOT, Slot second = NO_SLOT)
+        {
+            for (size_t character_class = 0; character_class < NUM_CLASSES; ++character_class)
+            {
+                if (classes & ((ClassSet)1 << character_class))
+                {
+                    table.entries[from][character_class] = (Entry)(to | (first << 8) | (second << 12));
+                }
+            }
+        }
+
+        constexpr void Percent(State from, State percent_1, State percent_2, State back)
+        {
+            On(from, Classes(PERCENT), percent_1);
+            On(percent_1, HEX, percent_2);
+            On(percent_2, HEX, back);
+        }
+
+        // How a path, with or without a '/' so far, ends.
+        constexpr void EndPath(State from, State query, State fragment)
+        {
+            On(from, Classes(QUESTION_MARK), query, PATH_END);
+            On(from, Classes(HASH), fragment, QUERY_END);
+            On(from, Classes(END), ACCEPT);
+        }
+
+        constexpr void EndAuthority(State from)
+        {
+            On(from, Classes(SLASH), PATH_SEGMENTS, AUTHORITY_END);
+            On(from, Classes(QUESTION_MARK), QUERY_PART, AUTHORITY_END, PATH_END);
+            On(from, Classes(HASH), FRAGMENT, AUTHORITY_END, QUERY_END);
+            On(from, Classes(END), ACCEPT);
+        }
+
+        constexpr void SetClass(char first, char last, CharacterClass character_class)
+        {
+            for (auto c = first; c <= last; ++c)
+            {
+                table.classes[(uint8_t)c] = character_class;
+            }
+        }
+
+        constexpr void SetClass(const char* characters, CharacterClass character_class)
+        {
+            for (; *characters != '\0'; ++characters)
+            {
+                table.classes[(uint8_t)*characters] = character_class;
+            }
+        }
+    };
+
+    constexpr Table BuildTable()
+    {
+        TableBuilder builder;
+        builder.SetClass('a', 'z', LETTER);
+        builder.SetClass('A', 'Z', LETTER);
+        builder.SetClass('a', 'f', HEX_LETTER);
+        builder.SetClass('A', 'F', HEX_LETTER);
+        builder.SetClass('v', 'v', LETTER_V);
+        builder.SetClass('0', '9', DIGIT);
+        builder.SetClass("+", PLUS);
+        builder.SetClass("-", MINUS);
+        builder.SetClass(".", DOT);
+        builder.SetClass("_~", UNRESERVED_OTHER);
+        builder.SetClass("!$&'()*,;=", SUB_DELIM_OTHER);
+        builder.SetClass(":", COLON);
+        builder.SetClass("@", AT);
+        builder.SetClass("/", SLASH);
+        builder.SetClass("?", QUESTION_MARK);
+        builder.SetClass("#", HASH);
+        builder.SetClass("%", PERCENT);
+        builder.SetClass("[", LEFT_BRACKET);
+        builder.SetClass("]", RIGHT_BRACKET);
+
+        // Up to the first '/', '?' or '#', a ':' ends the scheme, which
+        // must then be all the characters before it.
+        builder.On(START, PCHAR & ~Classes(COLON), FIRST_SEGMENT);
+        builder.On(START, ALL_LETTERS, SCHEME_OR_SEGMENT);
+        builder.Percent(START, FIRST_SEGMENT_PERCENT_1, FIRST_SEGMENT_PERCENT_2, FIRST_SEGMENT);
+        builder.On(START, Classes(SLASH), LEADING_SLASH);
+        builder.EndPath(START, FIRST_QUERY, FIRST_FRAGMENT);
+
+        builder.On(SCHEME_OR_SEGMENT, PCHAR, FIRST_SEGMENT);
+        builder.On(SCHEME_OR_SEGMENT, SCHEME, SCHEME_OR_SEGMENT);
+        builder.On(SCHEME_OR_SEGMENT, Classes(COLON), AFTER_SCHEME, SCHEME_COLON);
+        builder.Percent(SCHEME_OR_SEGMENT, FIRST_SEGMENT_PERCENT_1, FIRST_SEGMENT_PERCENT_2, FIRST_SEGMENT);
+        builder.On(SCHEME_OR_SEGMENT, Classes(SLASH), PATH_SEGMENTS);
+        builder.EndPath(SCHEME_OR_SEGMENT, FIRST_QUERY, FIRST_FRAGMENT);
+
+        builder.On(FIRST_SEGMENT, PCHAR & ~Classes(COLON), FIRST_SEGMENT);
+        builder.Percent(FIRST_SEGMENT, FIRST_SEGMENT_PERCENT_1, FIRST_SEGMENT_PERCENT_2, FIRST_SEGMENT);
+        builder.On(FIRST_SEGMENT, Classes(SLASH), PATH_SEGMENTS);
+        builder.EndPath(FIRST_SEGMENT, FIRST_QUERY, FIRST_FRAGMENT);
+
+        // "//" starts an authority, at the start or after the scheme.
+        for (const auto from: {LEADING_SLASH, AFTER_SCHEME, AFTER_SCHEME_SLASH, PATH_SEGMENTS})
+        {
+            builder.On(from, PATH, PATH_SEGMENTS);
+            builder.Percent(from, PATH_PERCENT_1, PATH_PERCENT_2, PATH_SEGMENTS);
+            builder.EndPath(from, QUERY_PART, FRAGMENT);
+        }
+        builder.On(LEADING_SLASH, Classes(SLASH), AUTHORITY_START, AUTHORITY_SLASH);
+        builder.On(AFTER_SCHEME, Classes(SLASH), AFTER_SCHEME_SLASH);
+        builder.On(AFTER_SCHEME_SLASH, Classes(SLASH), AUTHORITY_START, AUTHORITY_SLASH);
+
+        // The first '@' ends the user info, and the ':' after the host
+        // starts the port.
+        for (const auto from: {AUTHORITY_START, USER_INFO_OR_HOST})
+        {
+            builder.On(from, REG_NAME, USER_INFO_OR_HOST);
+            builder.Percent(from, USER_INFO_OR_HOST_PERCENT_1, USER_INFO_OR_HOST_PERCENT_2, USER_INFO_OR_HOST);
+            builder.On(from, Classes(COLON), USER_INFO_OR_PORT, FIRST_AUTHORITY_COLON);
+            builder.On(from, Classes(AT), HOST_START, USER_INFO_AT);
+            builder.EndAuthority(from);
+        }
+        builder.On(AUTHORITY_START, Classes(LEFT_BRACKET), IP_LITERAL_START, LEFT_BRACKET_SLOT);
+
+        builder.On(USER_INFO_OR_PORT, USER_INFO, USER_INFO_PART);
+        builder.On(USER_INFO_OR_PORT, Classes(DIGIT), USER_INFO_OR_PORT);
+        builder.Percent(USER_INFO_OR_PORT, USER_INFO_PERCENT_1, USER_INFO_PERCENT_2, USER_INFO_PART);
+        builder.On(USER_INFO_OR_PORT, Classes(AT), HOST_START, USER_INFO_AT);
+        builder.EndAuthority(USER_INFO_OR_PORT);
+
+        builder.On(USER_INFO_PART, USER_INFO, USER_INFO_PART);
+        builder.Percent(USER_INFO_PART, USER_INFO_PERCENT_1, USER_INFO_PERCENT_2, USER_INFO_PART);
+        builder.On(USER_INFO_PART, Classes(AT), HOST_START, USER_INFO_AT);
+
+        for (const auto from: {HOST_START, HOST})
+        {
+            builder.On(from, REG_NAME, HOST);
+            builder.Percent(from, HOST_PERCENT_1, HOST_PERCENT_2, HOST);
+            builder.On(from, Classes(COLON), PORT, PORT_COLON);
+            builder.EndAuthority(from);
+        }
+        builder.On(HOST_START, Classes(LEFT_BRACKET), IP_LITERAL_START, LEFT_BRACKET_SLOT);
+
+        builder.On(PORT, Classes(DIGIT), PORT);
+        builder.EndAuthority(PORT);
+
+        // An IPv6 address is only checked for its characters here; the
+        // rest is left to ValidateIpv6Address.
+        builder.On(IP_LITERAL_START, IPV6, IPV6_ADDRESS);
+        builder.On(IP_LITERAL_START, Classes(LETTER_V), IPV_FUTURE_VERSION);
+        builder.On(IP_LITERAL_START, Classes(RIGHT_BRACKET), IP_LITERAL_END, RIGHT_BRACKET_SLOT);
+        builder.On(IPV6_ADDRESS, IPV6, IPV6_ADDRESS);
+        builder.On(IPV6_ADDRESS, Classes(RIGHT_BRACKET), IP_LITERAL_END, RIGHT_BRACKET_SLOT);
+        builder.On(IPV_FUTURE_VERSION, HEX, IPV_FUTURE_VERSION);
+        builder.On(IPV_FUTURE_VERSION, Classes(DOT), IPV_FUTURE_BODY);
+        builder.On(IPV_FUTURE_BODY, USER_INFO, IPV_FUTURE_BODY);
+        builder.On(IPV_FUTURE_BODY, Classes(RIGHT_BRACKET), IP_LITERAL_END, RIGHT_BRACKET_SLOT);
+        builder.On(IP_LITERAL_END, Classes(COLON), PORT, PORT_COLON);
+        builder.EndAuthority(IP_LITERAL_END);
+
+        // Before the first '/', a ':' would have ended a scheme.
+        builder.On(FIRST_QUERY, QUERY & ~Classes(COLON), FIRST_QUERY);
+        builder.On(FIRST_QUERY, Classes(SLASH), QUERY_PART);
+        builder.Percent(FIRST_QUERY, FIRST_QUERY_PERCENT_1, FIRST_QUERY_PERCENT_2, FIRST_QUERY);
+        builder.On(FIRST_QUERY, Classes(HASH), FIRST_FRAGMENT, QUERY_END);
+        builder.On(FIRST_QUERY, Classes(END), ACCEPT);
+
+        builder.On(QUERY_PART, QUERY, QUERY_PART);
+        builder.Percent(QUERY_PART, QUERY_PERCENT_1, QUERY_PERCENT_2, QUERY_PART);
+        builder.On(QUERY_PART, Classes(HASH), FRAGMENT, QUERY_END);
+        builder.On(QUERY_PART, Classes(END), ACCEPT);
+
+        builder.On(FIRST_FRAGMENT, QUERY & ~Classes(COLON), FIRST_FRAGMENT);
+        builder.On(FIRST_FRAGMENT, Classes(SLASH), FRAGMENT);
+        builder.Percent(FIRST_FRAGMENT, FIRST_FRAGMENT_PERCENT_1, FIRST_FRAGMENT_PERCENT_2, FIRST_FRAGMENT);
+        builder.On(FIRST_FRAGMENT, Classes(END), ACCEPT);
+
+        builder.On(FRAGMENT, QUERY, FRAGMENT);
+        builder.Percent(FRAGMENT, FRAGMENT_PERCENT_1, FRAGMENT_PERCENT_2, FRAGMENT);
+        builder.On(FRAGMENT, Classes(END), ACCEPT);
+        return builder.table;
+    }
+
+    constexpr Table TABLE = BuildTable();
+
+    static_assert(NextState(TABLE.entries[START][END]) == ACCEPT, "the empty string is a relative reference");
+    static_assert(NextState(TABLE.entries[START][COLON]) == ERROR, "a scheme can't be empty");
+
+    const size_t NOT_FOUND = (size_t)-1;
+
+    // The longest IPv6 literal and port worth keeping; anything longer
+    // is invalid anyway.
+    const size_t MAX_IPV6_ADDRESS_LENGTH = 64;
+    const size_t MAX_PORT_LENGTH = 5;
+
+    // Mirrors UriView::ParsePort; the scan has already checked that the
+    // port is all digits.
+    bool ParsePort(std::string_view port_string, uint16_t& port)
+    {
+        if ((port_string.length() > MAX_PORT_LENGTH)
+            || ((port_string[0] == '0') && (port_string.length() > 1)))
+        {
+            return false;
+        }
+        uint32_t value = 0;
+        for (const auto c: port_string)
+        {
+            value = value * 10 + (uint32_t)(c - '0');
+        }
+        if (value > 65535)
+        {
+            return false;
+        }
+        port = (uint16_t)value;
+        return true;
+    }
+}
+
+namespace Uri
+{
+    struct UriScanner::Impl
+    {
+        State state = START;
+        size_t length = 0;
+        size_t positions[NUM_SLOTS];
+
+        // The characters checked after the scan, kept from the chunks
+        // they came in, and only as many as are worth checking.
+        std::string ip_literal;
+        std::string first_authority_colon_part;
+        std::string port;
+
+        Impl()
+        {
+            Reset();
+        }
+
+        void Reset()
+        {
+            state = START;
+            length = 0;
+            std::fill(positions, positions + NUM_SLOTS, NOT_FOUND);
+            ip_literal.clear();
+            first_authority_colon_part.clear();
+            port.clear();
+        }
+
+        // Appends to kept what chunk, starting at offset chunk_start,
+        // holds of the characters after the one in slot start, up to the
+        // one in slot end or the end of the input.
+        void Keep(std::string& kept,
+                  std::string_view chunk,
+                  size_t chunk_start,
+                  Slot start,
+                  Slot end,
+                  size_t max_length)
+        {
+            if ((positions[start] == NOT_FOUND)
+                || (kept.length() > max_length))
+            {
+                return;
+            }
+            const auto begin = std::max(positions[start] + 1, chunk_start);
+            const auto finish = std::min(positions[end], chunk_start + chunk.length());
+            if (begin < finish)
+            {
+                kept.append(chunk.substr(begin - chunk_start,
+                                         std::min(finish - begin, max_length + 1 - kept.length())));
+            }
+        }
+
+        void Feed(std::string_view characters)
+        {
+            // Kept in locals for the loop, rather than written through
+            // this on every character.
+            auto current_state = state;
+            size_t current_positions[NUM_SLOTS];
+            std::copy(positions, positions + NUM_SLOTS, current_positions);
+            const auto chunk_start = length;
+            for (size_t i = 0; i < characters.length(); ++i)
+            {
+                const auto entry = TABLE.entries[current_state][TABLE.classes[(uint8_t)characters[i]]];
+                current_positions[FirstSlot(entry)] = chunk_start + i;
+                current_positions[SecondSlot(entry)] = chunk_start + i;
+                current_state = NextState(entry);
+            }
+            current_positions[NO_SLOT] = NOT_FOUND;
+            std::copy(current_positions, current_positions + NUM_SLOTS, positions);
+            state = current_state;
+            length += characters.length();
+            Keep(ip_literal, characters, chunk_start,
+                 LEFT_BRACKET_SLOT, RIGHT_BRACKET_SLOT, MAX_IPV6_ADDRESS_LENGTH);
+            Keep(first_authority_colon_part, characters, chunk_start,
+                 FIRST_AUTHORITY_COLON, AUTHORITY_END, MAX_PORT_LENGTH);
+            Keep(port, characters, chunk_start,
+                 PORT_COLON, AUTHORITY_END, MAX_PORT_LENGTH);
+        }
+
+        bool Finish(Layout* layout) const
+        {
+            if (NextState(TABLE.entries[state][END]) != ACCEPT)
+            {
+                return false;
+            }
+            const auto found = [this](Slot slot){ return positions[slot] != NOT_FOUND; };
+            Layout found_layout;
+            found_layout.scheme_end = (found(SCHEME_COLON) ? positions[SCHEME_COLON] + 1 : 0);
+            found_layout.query_end = (found(QUERY_END) ? positions[QUERY_END] : length);
+            found_layout.path_end = (found(PATH_END) ? positions[PATH_END] : found_layout.query_end);
+            found_layout.authority_end = found_layout.scheme_end;
+            if (found(AUTHORITY_SLASH))
+            {
+                const auto authority_start = positions[AUTHORITY_SLASH] + 1;
+                found_layout.authority_end = (
+                    found(AUTHORITY_END) ? positions[AUTHORITY_END] : found_layout.path_end
+                );
+                auto host_start = authority_start;
+                if (found(USER_INFO_AT))
+                {
+                    found_layout.user_info_length = positions[USER_INFO_AT] - authority_start;
+                    host_start = positions[USER_INFO_AT] + 1;
+                }
+                const std::string* port_string = &port;
+                auto port_colon = positions[PORT_COLON];
+                if (found(LEFT_BRACKET_SLOT))
+                {
+                    if ((ip_literal.empty() || (ip_literal[0] != 'v'))
+                        && ((ip_literal.length() > MAX_IPV6_ADDRESS_LENGTH)
+                            || !ValidateIpv6Address(ip_literal)))
+                    {
+                        return false;
+                    }
+                    found_layout.host_begin = positions[LEFT_BRACKET_SLOT] + 1;
+                    found_layout.host_end = positions[RIGHT_BRACKET_SLOT];
+                }
+                else
+                {
+                    if (!found(USER_INFO_AT))
+                    {
+                        port_string = &first_authority_colon_part;
+                        port_colon = positions[FIRST_AUTHORITY_COLON];
+                    }
+                    found_layout.host_begin = host_start;
+                    found_layout.host_end = ((port_colon != NOT_FOUND) ? port_colon : found_layout.authority_end);
+                }
+                if (!port_string->empty())
+                {
+                    if (!ParsePort(*port_string, found_layout.port))
+                    {
+                        return false;
+                    }
+                    found_layout.has_port = true;
+                }
+            }
+            if (layout != nullptr)
+            {
+                *layout = found_layout;
+            }
+            return true;
+        }
+    };
+
+    UriScanner::~UriScanner() noexcept = default;
+    UriScanner::UriScanner(const UriScanner& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    UriScanner::UriScanner(UriScanner&&) noexcept = default;
+    UriScanner& UriScanner::operator=(const UriScanner& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    UriScanner& UriScanner::operator=(UriScanner&&) noexcept = default;
+
+    UriScanner::UriScanner()
+        : impl_(new Impl)
+    {
+    }
+
+    void UriScanner::Reset()
+    {
+        impl_->Reset();
+    }
+
+    void UriScanner::Feed(std::string_view characters)
+    {
+        impl_->Feed(characters);
+    }
+
+    bool UriScanner::Finish(Layout* layout)
+    {
+        return impl_->Finish(layout);
+    }
+
+    bool UriScanner::Scan(std::string_view uri_string, Layout* layout)
+    {
+        Impl impl;
+        impl.Feed(uri_string);
+        return impl.Finish(layout);
+    }
+
+    bool UriScanner::Parse(std::string_view uri_string, Uri& uri)
+    {
+        Layout layout;
+        if (!Scan(uri_string, &layout))
+        {
+            return false;
+        }
+        SerializedLayout serialized_layout;
+        serialized_layout.scheme_end = layout.scheme_end;
+        serialized_layout.authority_end = layout.authority_end;
+        serialized_layout.path_end = layout.path_end;
+        serialized_layout.query_end = layout.query_end;
+        Uri parsed;
+        if (!parsed.impl_->ParseSerialized(uri_string, serialized_layout))
+        {
+            return false;
+        }
+        uri = std::move(parsed);
+        return true;
+    }
+}
@@ -0,0 +1,623 @@
+#include "UriGrammar.hpp"
+#include <stdint.h>
+#include <Uri/Uri.hpp>
+#include <Uri/UriTemplate.hpp>
+
+namespace
+{
+    typedef Uri::UriTemplate::Value Value;
+
+    // The behavior of an expression operator (RFC 6570 appendix A).
+    struct Operator
+    {
+        char symbol;
+
+        // What comes before the first defined value ('\0' for nothing) and
+        // between values.
+        char first;
+        char separator;
+
+        // Whether values come as name=value, and whether an empty one
+        // keeps its '='.
+        bool named;
+        bool empty_keeps_equals;
+
+        // Whether reserved characters and percent-encoded triplets pass
+        // through, rather than only unreserved characters.
+        bool allow_reserved;
+    };
+
+    const Operator OPERATORS[] = {
+        {'\0', '\0', ',', false, false, false},
+        {'+', '\0', ',', false, false, true},
+        {'#', '#', ',', false, false, true},
+        {'.', '.', '.', false, false, false},
+        {'/', '/', '/', false, false, false},
+        {';', ';', ';', true, false, false},
+        {'?', '?', '&', true, true, false},
+        {'&', '&', '&', true, true, false},
+    };
+
+    const size_t MAX_PREFIX_LENGTH = 9999;
+
+    struct VariableSpec
+    {
+        size_t variable = 0;
+
+        // The name as written, which needs no encoding.
+        uint32_t name_offset = 0;
+        uint32_t name_length = 0;
+
+        // 0 for the whole value.
+        size_t max_length = 0;
+        bool explode = false;
+    };
+
+    // Either a literal span or an expression.
+    struct Part
+    {
+        const Operator* op = nullptr;
+        uint32_t literal_offset = 0;
+        uint32_t literal_length = 0;
+        uint32_t first_spec = 0;
+        uint32_t num_specs = 0;
+    };
+
+    bool IsPercentEncoded(std::string_view text, size_t i)
+    {
+        return (
+            (text[i] == '%')
+            && (i + 2 < text.length())
+            && Uri::HEXDIG.Contains(text[i + 1])
+            && Uri::HEXDIG.Contains(text[i + 2])
+        );
+    }
+
+    // varname = varchar *( ["."] varchar ), varchar = ALPHA / DIGIT / "_"
+    // / pct-encoded
+    bool IsLegalVariableName(std::string_view name)
+    {
+        if (name.empty() || (name[0] == '.') || (name.back() == '.'))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < name.length();)
+        {
+            const auto c = name[i];
+            if (c == '%')
+            {
+                if (!IsPercentEncoded(name, i))
+                {
+                    return false;
+                }
+                i += 3;
+                continue;
+            }
+            if ((c == '.') && (name[i - 1] == '.'))
+            {
+                return false;
+            }
+            if (!Uri::ALPHA.Contains(c) && !Uri::DIGIT.Contains(c) && (c != '_') && (c != '.'))
+            {
+                return false;
+            }
+            ++i;
+        }
+        return true;
+    }
+
+    // The first max_length characters, not bytes, of a UTF-8 value.
+    std::string_view Prefix(std::string_view value, size_t max_length)
+    {
+        size_t num_characters = 0;
+        for (size_t i = 0; i < value.length(); ++i)
+        {
+            if (((uint8_t)value[i] & 0xC0) != 0x80)
+            {
+                if (num_characters == max_length)
+                {
+                    return value.substr(0, i);
+                }
+                ++num_characters;
+            }
+        }
+        return value;
+    }
+
+    void AppendValue(std::string& expansion, std::string_view value, bool allow_reserved)
+    {
+        if (!allow_reserved)
+        {
+            Uri::AppendEncodedElement(expansion, value, Uri::UNRESERVED);
+            return;
+        }
+        for (size_t i = 0; i < value.length();)
+        {
+            if (IsPercentEncoded(value, i))
+            {
+                expansion.append(value.substr(i, 3));
+                i += 3;
+                continue;
+            }
+            auto run_end = value.find('%', i + 1);
+            if (run_end == std::string_view::npos)
+            {
+                run_end = value.length();
+            }
+            Uri::AppendEncodedElement(expansion, value.substr(i, run_end - i), Uri::RESERVED_OR_UNRESERVED);
+            i = run_end;
+        }
+    }
+
+    bool IsDefined(const Value* value)
+    {
+        if (value == nullptr)
+        {
+            return false;
+        }
+        switch (value->type)
+        {
+            case Value::Type::STRING: return true;
+            case Value::Type::LIST: return !value->list.empty();
+            case Value::Type::MAP: return !value->map.empty();
+            default: return false;
+        }
+    }
+}
+
+namespace Uri
+{
+    struct UriTemplate::Impl
+    {
+        std::string literals;
+        std::vector< Part > parts;
+        std::vector< VariableSpec > specs;
+        std::vector< std::string > names;
+
+        std::string_view GetLiteral(uint32_t offset, uint32_t length) const
+        {
+            return std::string_view(literals).substr(offset, length);
+        }
+
+        size_t AddVariable(std::string_view name)
+        {
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                if (names[i] == name)
+                {
+                    return i;
+                }
+            }
+            names.emplace_back(name);
+            return names.size() - 1;
+        }
+
+        bool ParseExpression(std::string_view expression)
+        {
+            Part part;
+            part.op = &OPERATORS[0];
+            if (expression.empty())
+            {
+                return false;
+            }
+            for (const auto& op: OPERATORS)
+            {
+                if ((op.symbol != '\0') && (expression[0] == op.symbol))
+                {
+                    part.op = &op;
+                    expression.remove_prefix(1);
+                    break;
+                }
+            }
+            part.first_spec = (uint32_t)specs.size();
+            for (size_t start = 0;;)
+            {
+                auto end = expression.find(',', start);
+                if (end == std::string_view::npos)
+                {
+                    end = expression.length();
+                }
+                auto spec_string = expression.substr(start, end - start);
+                VariableSpec spec;
+                if (!spec_string.empty() && (spec_string.back() == '*'))
+                {
+                    spec.explode = true;
+                    spec_string.remove_suffix(1);
+                }
+                const auto colon = spec_string.find(':');
+                if (colon != std::string_view::npos)
+                {
+                    const auto digits = spec_string.substr(colon + 1);
+                    if (spec.explode || digits.empty() || (digits.length() > 4) || (digits[0] == '0'))
+                    {
+                        return false;
+                    }
+                    for (const auto digit: digits)
+                    {
+                        if (!DIGIT.Contains(digit))
+                        {
+                            return false;
+                        }
+                        spec.max_length = spec.max_length * 10 + (size_t)(digit - '0');
+                    }
+                    spec_string = spec_string.substr(0, colon);
+                }
+                if (!IsLegalVariableName(spec_string))
+                {
+                    return false;
+                }
+                spec.variable = AddVariable(spec_string);
+                spec.name_offset = (uint32_t)literals.length();
+                spec.name_length = (uint32_t)spec_string.length();
+                literals.append(spec_string);
+                specs.push_back(spec);
+                if (end == expression.length())
+                {
+                    break;
+                }
+                start = end + 1;
+            }
+            part.num_specs = (uint32_t)specs.size() - part.first_spec;
+            parts.push_back(part);
+            return true;
+        }
+
+        // Appends to the literal part last added, or starts one.
+        void AppendLiteral(std::string_view literal)
+        {
+            if (parts.empty() || (parts.back().op != nullptr))
+            {
+                Part part;
+                part.literal_offset = (uint32_t)literals.length();
+                parts.push_back(part);
+            }
+            literals.append(literal);
+            parts.back().literal_length += (uint32_t)literal.length();
+        }
+
+        bool Parse(std::string_view template_string)
+        {
+            for (size_t i = 0; i < template_string.length();)
+            {
+                const auto c = template_string[i];
+                if (c == '{')
+                {
+                    const auto close = template_string.find('}', i + 1);
+                    if ((close == std::string_view::npos)
+                        || !ParseExpression(template_string.substr(i + 1, close - i - 1)))
+                    {
+                        return false;
+                    }
+                    i = close + 1;
+                }
+                else if (c == '%')
+                {
+                    if (!IsPercentEncoded(template_string, i))
+                    {
+                        return false;
+                    }
+                    AppendLiteral(template_string.substr(i, 3));
+                    i += 3;
+                }
+                else if ((uint8_t)c >= 0x80)
+                {
+                    std::string encoded;
+                    AppendEncodedElement(encoded, template_string.substr(i, 1), RESERVED_OR_UNRESERVED);
+                    AppendLiteral(encoded);
+                    ++i;
+                }
+                else if (RESERVED_OR_UNRESERVED.Contains(c))
+                {
+                    auto run_length = RESERVED_OR_UNRESERVED.CountLeading(template_string.substr(i));
+                    AppendLiteral(template_string.substr(i, run_length));
+                    i += run_length;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // At least the length of the expansion: every value byte encoded,
+        // with a name, '=' and separator each.
+        template< typename Lookup >
+        size_t MaxLength(Lookup lookup) const
+        {
+            size_t max_length = 0;
+            for (const auto& part: parts)
+            {
+                if (part.op == nullptr)
+                {
+                    max_length += part.literal_length;
+                    continue;
+                }
+                ++max_length;
+                for (auto i = part.first_spec; i < part.first_spec + part.num_specs; ++i)
+                {
+                    const auto& spec = specs[i];
+                    const auto value = lookup(spec.variable);
+                    if (!IsDefined(value))
+                    {
+                        continue;
+                    }
+                    const auto per_item = spec.name_length + 2;
+                    switch (value->type)
+                    {
+                        case Value::Type::STRING:
+                        {
+                            max_length += per_item + 3 * value->string.length();
+                        } break;
+
+                        case Value::Type::LIST:
+                        {
+                            for (const auto item: value->list)
+                            {
+                                max_length += per_item + 3 * item.length();
+                            }
+                        } break;
+
+                        default:
+                        {
+                            for (const auto& pair: value->map)
+                            {
+                                max_length += per_item + 1 + 3 * (pair.first.length() + pair.second.length());
+                            }
+                        } break;
+                    }
+                }
+            }
+            return max_length;
+        }
+
+        // RFC 6570 appendix A.
+        template< typename Lookup >
+        void Expand(Lookup lookup, std::string& expansion) const
+        {
+            expansion.clear();
+            expansion.reserve(MaxLength(lookup));
+            for (const auto& part: parts)
+            {
+                if (part.op == nullptr)
+                {
+                    expansion.append(GetLiteral(part.literal_offset, part.literal_length));
+                    continue;
+                }
+                const auto& op = *part.op;
+                bool first = true;
+                for (auto i = part.first_spec; i < part.first_spec + part.num_specs; ++i)
+                {
+                    const auto& spec = specs[i];
+                    const auto value = lookup(spec.variable);
+                    if (!IsDefined(value))
+                    {
+                        continue;
+                    }
+                    if (first)
+                    {
+                        if (op.first != '\0')
+                        {
+                            expansion.push_back(op.first);
+                        }
+                        first = false;
+                    }
+                    else
+                    {
+                        expansion.push_back(op.separator);
+                    }
+                    const auto name = GetLiteral(spec.name_offset, spec.name_length);
+                    ExpandValue(op, spec, name, *value, expansion);
+                }
+            }
+        }
+
+        static void AppendNamed(const Operator& op,
+                                std::string_view name,
+                                std::string_view value,
+                                std::string& expansion)
+        {
+            expansion.append(name);
+            if (!value.empty() || op.empty_keeps_equals)
+            {
+                expansion.push_back('=');
+            }
+        }
+
+        static void ExpandValue(const Operator& op,
+                                const VariableSpec& spec,
+                                std::string_view name,
+                                const Value& value,
+                                std::string& expansion)
+        {
+            if (value.type == Value::Type::STRING)
+            {
+                auto string = value.string;
+                if (spec.max_length != 0)
+                {
+                    string = Prefix(string, spec.max_length);
+                }
+                if (op.named)
+                {
+                    AppendNamed(op, name, string, expansion);
+                }
+                AppendValue(expansion, string, op.allow_reserved);
+            }
+            else if (!spec.explode)
+            {
+                if (op.named)
+                {
+                    expansion.append(name);
+                    expansion.push_back('=');
+                }
+                bool first = true;
+                auto append_item = [&](std::string_view item)
+                {
+                    if (!first)
+                    {
+                        expansion.push_back(',');
+                    }
+                    first = false;
+                    AppendValue(expansion, item, op.allow_reserved);
+                };
+                if (value.type == Value::Type::LIST)
+                {
+                    for (const auto item: value.list)
+                    {
+                        append_item(item);
+                    }
+                }
+                else
+                {
+                    for (const auto& pair: value.map)
+                    {
+                        append_item(pair.first);
+                        append_item(pair.second);
+                    }
+                }
+            }
+            else if (value.type == Value::Type::LIST)
+            {
+                bool first = true;
+                for (const auto item: value.list)
+                {
+                    if (!first)
+                    {
+                        expansion.push_back(op.separator);
+                    }
+                    first = false;
+                    if (op.named)
+                    {
+                        AppendNamed(op, name, item, expansion);
+                    }
+                    AppendValue(expansion, item, op.allow_reserved);
+                }
+            }
+            else
+            {
+                bool first = true;
+                for (const auto& pair: value.map)
+                {
+                    if (!first)
+                    {
+                        expansion.push_back(op.separator);
+                    }
+                    first = false;
+                    AppendValue(expansion, pair.first, op.allow_reserved);
+                    if (op.named && pair.second.empty() && !op.empty_keeps_equals)
+                    {
+                        continue;
+                    }
+                    expansion.push_back('=');
+                    AppendValue(expansion, pair.second, op.allow_reserved);
+                }
+            }
+        }
+    };
+
+    const size_t UriTemplate::NO_VARIABLE;
+
+    UriTemplate::Value::Value(std::string_view new_string)
+        : type(Type::STRING)
+        , string(new_string)
+    {
+    }
+
+    UriTemplate::Value::Value(const char* new_string)
+        : type(Type::STRING)
+        , string(new_string)
+    {
+    }
+
+    UriTemplate::Value::Value(std::vector< std::string_view > new_list)
+        : type(Type::LIST)
+        , list(std::move(new_list))
+    {
+    }
+
+    UriTemplate::Value::Value(std::vector< std::pair< std::string_view, std::string_view > > new_map)
+        : type(Type::MAP)
+        , map(std::move(new_map))
+    {
+    }
+
+    UriTemplate::~UriTemplate() noexcept = default;
+    UriTemplate::UriTemplate(const UriTemplate& other)
+        : impl_(new Impl(*other.impl_))
+    {
+    }
+    UriTemplate::UriTemplate(UriTemplate&&) noexcept = default;
+    UriTemplate& UriTemplate::operator=(const UriTemplate& other)
+    {
+        if (this != &other)
+        {
+            *impl_ = *other.impl_;
+        }
+        return *this;
+    }
+    UriTemplate& UriTemplate::operator=(UriTemplate&&) noexcept = default;
+
+    UriTemplate::UriTemplate()
+        : impl_(new Impl)
+    {
+    }
+
+    bool UriTemplate::Parse(std::string_view template_string)
+    {
+        Impl parsed;
+        if (!parsed.Parse(template_string))
+        {
+            return false;
+        }
+        parsed.literals.shrink_to_fit();
+        *impl_ = std::move(parsed);
+        return true;
+    }
+
+    const std::vector< std::string >& UriTemplate::GetVariableNames() const
+    {
+        return impl_->names;
+    }
+
+    size_t UriTemplate::GetVariableIndex(std::string_view name) const
+    {
+        for (size_t i = 0; i < impl_->names.size(); ++i)
+        {
+            if (impl_->names[i] == name)
+            {
+                return i;
+            }
+        }
+        return NO_VARIABLE;
+    }
+
+    void UriTemplate::Expand(const std::vector< Value >& values, std::string& expansion) const
+    {
+        impl_->Expand(
+            [&](size_t variable) -> const Value*
+            {
+                return ((variable < values.size()) ? &values[variable] : nullptr);
+            },
+            expansion
+        );
+    }
+
+    void UriTemplate::Expand(const Variables& variables, std::string& expansion) const
+    {
+        impl_->Expand(
+            [&](size_t variable) -> const Value*
+            {
+                const auto value = variables.find(impl_->names[variable]);
+                return ((value == variables.end()) ? nullptr : &value->second);
+            },
+            expansion
+        );
+    }
+
+    bool UriTemplate::Expand(const std::vector< Value >& values, Uri& uri) const
+    {
+        std::string expansion;
+        Expand(values, expansion);
+        return uri.ParseFromString(expansion);
+    }
+}
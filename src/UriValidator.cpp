@@ -0,0 +1,280 @@
+#include "UriGrammar.hpp"
+#include <Uri/UriValidator.hpp>
+#include <algorithm>
+#include <stdint.h>
+
+namespace
+{
+    typedef Uri::UriValidator::Component Component;
+    typedef Uri::UriValidator::Error Error;
+
+    bool Fail(Error& error, size_t offset, Component component)
+    {
+        error.offset = offset;
+        error.component = component;
+        return false;
+    }
+
+    bool ValidateElement(std::string_view element,
+                         size_t start,
+                         const Uri::CharacterSet& allowed_characters,
+                         Component component,
+                         Error& error)
+    {
+        size_t error_offset;
+        if (!Uri::IsValidElement(element, allowed_characters, error_offset))
+        {
+            return Fail(error, start + error_offset, component);
+        }
+        return true;
+    }
+
+    // IsLegalScheme, reporting where it fails.
+    bool ValidateScheme(std::string_view scheme, Error& error)
+    {
+        if (scheme.empty() || !Uri::ALPHA.Contains(scheme[0]))
+        {
+            return Fail(error, 0, Component::SCHEME);
+        }
+        const auto legal_length = 1 + Uri::SCHEME_NOT_FIRST.CountLeading(scheme.substr(1));
+        if (legal_length < scheme.length())
+        {
+            return Fail(error, legal_length, Component::SCHEME);
+        }
+        return true;
+    }
+
+    // What ToInteger accepts, in the range of a port.
+    bool ValidatePort(std::string_view port, size_t start, Error& error)
+    {
+        if (port.empty())
+        {
+            return true;
+        }
+        size_t i = 0;
+        const bool negative = (port[0] == '-');
+        if (negative)
+        {
+            ++i;
+        }
+        if (i == port.length())
+        {
+            return Fail(error, start + i, Component::PORT);
+        }
+        uint32_t value = 0;
+        if (port[i] == '0')
+        {
+            if (i + 1 < port.length())
+            {
+                return Fail(error, start + i + 1, Component::PORT);
+            }
+        }
+        else
+        {
+            for (; i < port.length(); ++i)
+            {
+                if (!Uri::DIGIT.Contains(port[i]))
+                {
+                    return Fail(error, start + i, Component::PORT);
+                }
+                value = value * 10 + (uint32_t)(port[i] - '0');
+                if (value > 65535)
+                {
+                    return Fail(error, start, Component::PORT);
+                }
+            }
+        }
+        if (negative && (value != 0))
+        {
+            return Fail(error, start, Component::PORT);
+        }
+        return true;
+    }
+
+    // Uri::Impl::ParseAuthority's host states, a run at a time.
+    bool ValidateHostAndPort(std::string_view host_port, size_t start, Error& error)
+    {
+        size_t host_end = 0;
+        if (!host_port.empty() && (host_port[0] == '['))
+        {
+            if ((host_port.length() > 1) && (host_port[1] == 'v'))
+            {
+                auto i = 2 + Uri::HEXDIG.CountLeading(host_port.substr(2));
+                if ((i == host_port.length()) || (host_port[i] != '.'))
+                {
+                    return Fail(error, start + i, Component::HOST);
+                }
+                ++i;
+                i += Uri::IPV_FUTURE_LAST_PART.CountLeading(host_port.substr(i));
+                if ((i == host_port.length()) || (host_port[i] != ']'))
+                {
+                    return Fail(error, start + i, Component::HOST);
+                }
+                host_end = i + 1;
+            }
+            else
+            {
+                const auto literal_end = host_port.find(']');
+                if (literal_end == std::string_view::npos)
+                {
+                    return Fail(error, start + host_port.length(), Component::HOST);
+                }
+                if (!Uri::ValidateIpv6Address(host_port.substr(1, literal_end - 1)))
+                {
+                    return Fail(error, start + 1, Component::HOST);
+                }
+                host_end = literal_end + 1;
+            }
+            if ((host_end < host_port.length()) && (host_port[host_end] != ':'))
+            {
+                return Fail(error, start + host_end, Component::HOST);
+            }
+        }
+        else
+        {
+            for (;;)
+            {
+                host_end += Uri::REG_NAME_NOT_PCT_ENCODED.CountLeading(host_port.substr(host_end));
+                if ((host_end == host_port.length()) || (host_port[host_end] == ':'))
+                {
+                    break;
+                }
+                if (host_port[host_end] != '%')
+                {
+                    return Fail(error, start + host_end, Component::HOST);
+                }
+                for (size_t digit = 1; digit <= 2; ++digit)
+                {
+                    if (host_end + digit == host_port.length())
+                    {
+                        return Fail(error, start + host_port.length(), Component::HOST);
+                    }
+                    if (!Uri::HEXDIG.Contains(host_port[host_end + digit]))
+                    {
+                        return Fail(error, start + host_end + digit, Component::HOST);
+                    }
+                }
+                host_end += 3;
+            }
+        }
+        if (host_end >= host_port.length())
+        {
+            return true;
+        }
+        return ValidatePort(host_port.substr(host_end + 1), start + host_end + 1, error);
+    }
+}
+
+namespace Uri
+{
+    bool UriValidator::IsValid(std::string_view uri_string)
+    {
+        Error error;
+        return IsValid(uri_string, error);
+    }
+
+    bool UriValidator::IsValid(std::string_view uri_string, Error& error)
+    {
+        error = Error();
+        auto authority_or_path_delimiter_start = uri_string.find('/');
+        if (authority_or_path_delimiter_start == std::string_view::npos)
+        {
+            authority_or_path_delimiter_start = uri_string.length();
+        }
+        const auto scheme_end = uri_string.substr(0, authority_or_path_delimiter_start).find(':');
+        size_t rest_start = 0;
+        if (scheme_end != std::string_view::npos)
+        {
+            if (!ValidateScheme(uri_string.substr(0, scheme_end), error))
+            {
+                return false;
+            }
+            rest_start = scheme_end + 1;
+        }
+        // Two memchr-backed searches beat find_first_of's per-character one.
+        const auto fragment_delimiter = std::min(uri_string.find('#', rest_start), uri_string.length());
+        const auto path_end = std::min(uri_string.substr(0, fragment_delimiter).find('?', rest_start),
+                                       fragment_delimiter);
+        const auto authority_and_path = uri_string.substr(0, path_end);
+        auto path_start = rest_start;
+        if (uri_string.substr(rest_start, 2) == "//")
+        {
+            const auto authority_start = rest_start + 2;
+            auto authority_end = authority_and_path.find('/', authority_start);
+            if (authority_end == std::string_view::npos)
+            {
+                authority_end = path_end;
+            }
+            const auto authority = uri_string.substr(authority_start, authority_end - authority_start);
+            auto host_port_start = authority_start;
+            const auto user_info_delimiter = authority.find('@');
+            if (user_info_delimiter != std::string_view::npos)
+            {
+                if (!ValidateElement(
+                        authority.substr(0, user_info_delimiter),
+                        authority_start,
+                        USER_INFO_NOT_PCT_ENCODED,
+                        Component::USER_INFO,
+                        error
+                    ))
+                {
+                    return false;
+                }
+                host_port_start += user_info_delimiter + 1;
+            }
+            if (!ValidateHostAndPort(
+                    uri_string.substr(host_port_start, authority_end - host_port_start),
+                    host_port_start,
+                    error
+                ))
+            {
+                return false;
+            }
+            path_start = authority_end;
+        }
+        for (auto segment_start = path_start;;)
+        {
+            auto segment_end = authority_and_path.find('/', segment_start);
+            if (segment_end == std::string_view::npos)
+            {
+                segment_end = path_end;
+            }
+            if (!ValidateElement(
+                    uri_string.substr(segment_start, segment_end - segment_start),
+                    segment_start,
+                    PCHAR_NOT_PCT_ENCODED,
+                    Component::PATH,
+                    error
+                ))
+            {
+                return false;
+            }
+            if (segment_end == path_end)
+            {
+                break;
+            }
+            segment_start = segment_end + 1;
+        }
+        if ((fragment_delimiter > path_end)
+            && !ValidateElement(
+                uri_string.substr(path_end + 1, fragment_delimiter - path_end - 1),
+                path_end + 1,
+                QUERY_OR_FRAGMENT_NOT_PCT_ENCODED,
+                Component::QUERY,
+                error
+            ))
+        {
+            return false;
+        }
+        return (
+            (fragment_delimiter == uri_string.length())
+            || ValidateElement(
+                uri_string.substr(fragment_delimiter + 1),
+                fragment_delimiter + 1,
+                QUERY_OR_FRAGMENT_NOT_PCT_ENCODED,
+                Component::FRAGMENT,
+                error
+            )
+        );
+    }
+}
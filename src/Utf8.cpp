@@ -0,0 +1,191 @@
+#include "Utf8.hpp"
+#include <stdint.h>
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const uint64_t HIGH_BITS = 0x8080808080808080;
+
+    bool IsContinuation(uint8_t c, uint8_t lowest = 0x80, uint8_t highest = 0xBF)
+    {
+        return (c >= lowest) && (c <= highest);
+    }
+}
+
+namespace Uri
+{
+    size_t CountLeadingAscii(std::string_view input)
+    {
+        size_t count = 0;
+#if defined(__SSE2__)
+        // The high bit of each byte, thirty-two at a time while none is
+        // set, then sixteen to find where.
+        while (count + 32 <= input.length())
+        {
+            const auto first = _mm_loadu_si128((const __m128i*)(input.data() + count));
+            const auto second = _mm_loadu_si128((const __m128i*)(input.data() + count + 16));
+            if (_mm_movemask_epi8(_mm_or_si128(first, second)) != 0)
+            {
+                break;
+            }
+            count += 32;
+        }
+        while (count + 16 <= input.length())
+        {
+            const auto block = _mm_loadu_si128((const __m128i*)(input.data() + count));
+            const auto non_ascii = (uint32_t)_mm_movemask_epi8(block);
+            if (non_ascii != 0)
+            {
+                return count + (size_t)__builtin_ctz(non_ascii);
+            }
+            count += 16;
+        }
+#endif
+        while (count + sizeof(uint64_t) <= input.length())
+        {
+            uint64_t word;
+            (void)memcpy(&word, input.data() + count, sizeof(word));
+            if ((word & HIGH_BITS) != 0)
+            {
+                break;
+            }
+            count += sizeof(word);
+        }
+        while ((count < input.length()) && ((uint8_t)input[count] < 0x80))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    size_t Utf8SequenceLength(std::string_view input)
+    {
+        if (input.empty())
+        {
+            return 0;
+        }
+        const uint8_t lead = (uint8_t)input[0];
+        if (lead < 0x80)
+        {
+            return 1;
+        }
+        size_t length;
+        uint8_t second_lowest = 0x80;
+        uint8_t second_highest = 0xBF;
+        if ((lead >= 0xC2) && (lead <= 0xDF))
+        {
+            length = 2;
+        }
+        else if ((lead >= 0xE0) && (lead <= 0xEF))
+        {
+            length = 3;
+            if (lead == 0xE0)
+            {
+                second_lowest = 0xA0;
+            }
+            else if (lead == 0xED)
+            {
+                second_highest = 0x9F;
+            }
+        }
+        else if ((lead >= 0xF0) && (lead <= 0xF4))
+        {
+            length = 4;
+            if (lead == 0xF0)
+            {
+                second_lowest = 0x90;
+            }
+            else if (lead == 0xF4)
+            {
+                second_highest = 0x8F;
+            }
+        }
+        else
+        {
+            return 0;
+        }
+        if ((input.length() < length)
+            || !IsContinuation((uint8_t)input[1], second_lowest, second_highest))
+        {
+            return 0;
+        }
+        for (size_t i = 2; i < length; ++i)
+        {
+            if (!IsContinuation((uint8_t)input[i]))
+            {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    bool IsValidUtf8(std::string_view input)
+    {
+        size_t i = 0;
+        for (;;)
+        {
+            i += CountLeadingAscii(input.substr(i));
+            if (i == input.length())
+            {
+                return true;
+            }
+            const auto length = Utf8SequenceLength(input.substr(i));
+            if (length == 0)
+            {
+                return false;
+            }
+            i += length;
+        }
+    }
+
+    bool DecodeUtf8(std::string_view input, std::u32string& code_points)
+    {
+        static const uint8_t LEAD_MASKS[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+        code_points.clear();
+        for (size_t i = 0; i < input.length();)
+        {
+            const auto length = Utf8SequenceLength(input.substr(i));
+            if (length == 0)
+            {
+                return false;
+            }
+            char32_t code_point = (uint8_t)input[i] & LEAD_MASKS[length];
+            for (size_t j = 1; j < length; ++j)
+            {
+                code_point = (code_point << 6) | ((uint8_t)input[i + j] & 0x3F);
+            }
+            code_points.push_back(code_point);
+            i += length;
+        }
+        return true;
+    }
+
+    void AppendUtf8(std::string& buffer, char32_t code_point)
+    {
+        if (code_point < 0x80)
+        {
+            buffer.push_back((char)code_point);
+        }
+        else if (code_point < 0x800)
+        {
+            buffer.push_back((char)(0xC0 | (code_point >> 6)));
+            buffer.push_back((char)(0x80 | (code_point & 0x3F)));
+        }
+        else if (code_point < 0x10000)
+        {
+            buffer.push_back((char)(0xE0 | (code_point >> 12)));
+            buffer.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+            buffer.push_back((char)(0x80 | (code_point & 0x3F)));
+        }
+        else
+        {
+            buffer.push_back((char)(0xF0 | (code_point >> 18)));
+            buffer.push_back((char)(0x80 | ((code_point >> 12) & 0x3F)));
+            buffer.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+            buffer.push_back((char)(0x80 | (code_point & 0x3F)));
+        }
+    }
+}
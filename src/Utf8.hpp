@@ -0,0 +1,28 @@
+#ifndef URI_UTF8_HPP
+#define URI_UTF8_HPP
+
+#include <stddef.h>
+#include <string>
+#include <string_view>
+
+namespace Uri
+{
+    // The number of leading bytes of input below 0x80, found sixteen at a
+    // time with SSE2, or else a word at a time.
+    size_t CountLeadingAscii(std::string_view input);
+
+    // The length of the well-formed UTF-8 sequence (RFC 3629) input starts
+    // with, or 0 if it doesn't start with one.  Overlong forms, surrogates
+    // and code points past U+10FFFF are not well-formed.
+    size_t Utf8SequenceLength(std::string_view input);
+
+    bool IsValidUtf8(std::string_view input);
+
+    // Fails, leaving code_points unspecified, if input is not well-formed.
+    bool DecodeUtf8(std::string_view input, std::u32string& code_points);
+
+    // code_point must be a Unicode scalar value.
+    void AppendUtf8(std::string& buffer, char32_t code_point);
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef URI_VARINT_HPP
+#define URI_VARINT_HPP
+
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace Uri
+{
+    // LEB128: seven bits per byte, least significant group first.
+    inline void AppendVarint(std::vector< uint8_t >& buffer, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((uint8_t)value);
+    }
+
+    inline size_t VarintLength(uint64_t value)
+    {
+        size_t length = 1;
+        while (value >= 0x80)
+        {
+            value >>= 7;
+            ++length;
+        }
+        return length;
+    }
+
+    template< typename Integer >
+    bool ReadVarint(const uint8_t*& position, const uint8_t* end, Integer& value)
+    {
+        uint64_t wide_value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7)
+        {
+            if (position == end)
+            {
+                return false;
+            }
+            const auto byte = *position++;
+            wide_value |= (uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                if (wide_value > (uint64_t)std::numeric_limits< Integer >::max())
+                {
+                    return false;
+                }
+                value = (Integer)wide_value;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+#endif
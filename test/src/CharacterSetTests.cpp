@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <src/CharacterSet.hpp>
+#include <stdint.h>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -104,4 +106,42 @@ TEST(CharacterSetTests, InitializerListConstructor)
             ASSERT_FALSE(cs5.Contains(c));
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(CharacterSetTests, CountLeading)
+{
+    // Sets of one to many ranges, so that blocks of characters are
+    // checked both all at once and one at a time.
+    const std::vector< Uri::CharacterSet > sets{
+        Uri::CharacterSet(),
+        Uri::CharacterSet('a', 'z'),
+        Uri::CharacterSet{
+            Uri::CharacterSet('a', 'z'),
+            Uri::CharacterSet('A', 'Z'),
+            Uri::CharacterSet('0', '9'),
+            '-', '.', '_', '~', '!', '$', '&', '\'', '(', ')', '*', '+', ',', ';', '=', ':', '@',
+        },
+        Uri::CharacterSet((char)0x80, (char)0xFF),
+    };
+    uint32_t state = 12345;
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        std::string characters;
+        const auto length = i % 70;
+        for (size_t j = 0; j < length; ++j)
+        {
+            state = state * 1103515245 + 12345;
+            const auto value = (state >> 16) & 0xFF;
+            characters.push_back((char)(((i % 3) == 0) ? value : ('a' + value % 64)));
+        }
+        for (const auto& set: sets)
+        {
+            size_t expected = 0;
+            while ((expected < characters.length()) && set.Contains(characters[expected]))
+            {
+                ++expected;
+            }
+            ASSERT_EQ(expected, set.CountLeading(characters)) << i;
+        }
+    }
+}
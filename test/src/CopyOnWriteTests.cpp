@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <src/CopyOnWrite.hpp>
+#include <string>
+#include <vector>
+
+TEST(CopyOnWriteTests, CopiesShareUntilWritten)
+{
+    Uri::CopyOnWrite< std::string > original;
+    original = "hello";
+    auto copy = original;
+    ASSERT_TRUE(copy.SharesWith(original));
+    ASSERT_EQ("hello", *copy);
+    copy.Write() += ", world";
+    ASSERT_FALSE(copy.SharesWith(original));
+    ASSERT_EQ("hello", *original);
+    ASSERT_EQ("hello, world", *copy);
+    ASSERT_NE(original, copy);
+}
+
+TEST(CopyOnWriteTests, UniqueValuesAreWrittenInPlace)
+{
+    Uri::CopyOnWrite< std::string > value;
+    value = "first";
+    const auto* storage = &*value;
+    value.Write() += "!";
+    value = "second";
+    value.Overwrite() = "third";
+    ASSERT_EQ(storage, &*value);
+    ASSERT_EQ("third", *value);
+}
+
+TEST(CopyOnWriteTests, EmptyValuesShareOneInstance)
+{
+    Uri::CopyOnWrite< std::vector< std::string > > first, second;
+    ASSERT_TRUE(first.SharesWith(second));
+    first = std::vector< std::string >{"a"};
+    ASSERT_FALSE(first.SharesWith(second));
+    first.Clear();
+    ASSERT_TRUE(first.SharesWith(second));
+    first = std::vector< std::string >();
+    ASSERT_TRUE(first.SharesWith(second));
+    ASSERT_EQ(first, second);
+}
+
+TEST(CopyOnWriteTests, TakeMovesOrCopies)
+{
+    Uri::CopyOnWrite< std::vector< std::string > > value;
+    value = std::vector< std::string >{"a", "b"};
+    auto copy = value;
+    ASSERT_EQ((std::vector< std::string >{"a", "b"}), copy.Take());
+    ASSERT_TRUE(copy->empty());
+    ASSERT_EQ((std::vector< std::string >{"a", "b"}), *value);
+    ASSERT_EQ((std::vector< std::string >{"a", "b"}), value.Take());
+    ASSERT_TRUE(value->empty());
+}
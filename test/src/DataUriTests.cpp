@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string>
+#include <Uri/DataUri.hpp>
+#include <vector>
+
+namespace
+{
+    // Decodes the payload of a data URI, capacity bytes at a time.
+    bool DecodeAll(const std::string& uri_string, size_t capacity, std::string& decoded)
+    {
+        Uri::DataUri data_uri;
+        EXPECT_TRUE(data_uri.ParseFromString(uri_string)) << uri_string;
+        Uri::DataUriDecoder decoder(data_uri);
+        std::vector< char > buffer(capacity);
+        decoded.clear();
+        while (!decoder.Done())
+        {
+            size_t written = 0;
+            const auto ok = decoder.Read(buffer.data(), buffer.size(), written);
+            decoded.append(buffer.data(), written);
+            if (!ok)
+            {
+                return false;
+            }
+        }
+        EXPECT_LE(decoded.length(), data_uri.GetMaxDecodedLength());
+        return true;
+    }
+
+    std::string Base64Encode(const std::string& data)
+    {
+        static const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoded;
+        for (size_t i = 0; i < data.length(); i += 3)
+        {
+            uint32_t bits = (uint8_t)data[i] << 16;
+            if (i + 1 < data.length())
+            {
+                bits |= (uint8_t)data[i + 1] << 8;
+            }
+            if (i + 2 < data.length())
+            {
+                bits |= (uint8_t)data[i + 2];
+            }
+            encoded += ALPHABET[(bits >> 18) & 63];
+            encoded += ALPHABET[(bits >> 12) & 63];
+            encoded += ((i + 1 < data.length()) ? ALPHABET[(bits >> 6) & 63] : '=');
+            encoded += ((i + 2 < data.length()) ? ALPHABET[bits & 63] : '=');
+        }
+        return encoded;
+    }
+}
+
+TEST(DataUriTests, ParseFromString)
+{
+    Uri::DataUri data_uri;
+    ASSERT_TRUE(data_uri.ParseFromString("data:,A%20brief%20note"));
+    ASSERT_EQ("text/plain", data_uri.GetMediaType());
+    ASSERT_EQ(0, data_uri.GetNumParameters());
+    ASSERT_FALSE(data_uri.IsBase64());
+    ASSERT_EQ("A%20brief%20note", data_uri.GetPayload());
+
+    const std::string uri_string = "DATA:image/png;name=a%20b.png;Charset=utf-8;BASE64,iVBORw0K#frag";
+    ASSERT_TRUE(data_uri.ParseFromString(uri_string));
+    ASSERT_EQ("image/png", data_uri.GetMediaType());
+    ASSERT_EQ(uri_string.data() + 5, data_uri.GetMediaType().data());
+    ASSERT_EQ(2, data_uri.GetNumParameters());
+    ASSERT_EQ("name", data_uri.GetParameter(0).name);
+    ASSERT_EQ("a%20b.png", data_uri.GetParameter(0).value);
+    ASSERT_EQ("utf-8", data_uri.GetParameter("charset"));
+    ASSERT_EQ("", data_uri.GetParameter("missing"));
+    ASSERT_TRUE(data_uri.IsBase64());
+    ASSERT_EQ("iVBORw0K", data_uri.GetPayload());
+    ASSERT_EQ(6, data_uri.GetMaxDecodedLength());
+
+    ASSERT_TRUE(data_uri.ParseFromString("data:;base64,"));
+    ASSERT_EQ("text/plain", data_uri.GetMediaType());
+    ASSERT_TRUE(data_uri.IsBase64());
+
+    for (const auto* bad: {
+        "",
+        "http://example.com/",
+        "data:text/plain",
+        "data:text;a=b,x",
+        "data:/plain,x",
+        "data:text/,x",
+        "data:text/plain;base64;a=b,x",
+        "data:text/plain;charset,x",
+        "data:text/plain;=b,x",
+    })
+    {
+        ASSERT_FALSE(data_uri.ParseFromString(bad)) << bad;
+    }
+    ASSERT_EQ("text/plain", data_uri.GetMediaType());
+    ASSERT_TRUE(data_uri.IsBase64());
+
+    std::string many = "data:text/plain";
+    for (size_t i = 0; i <= Uri::DataUri::MAX_PARAMETERS; ++i)
+    {
+        many += ";p=v";
+    }
+    ASSERT_FALSE(data_uri.ParseFromString(many + ",x"));
+}
+
+TEST(DataUriTests, DecodeBase64InChunks)
+{
+    std::string data;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        data += (char)(i * 7 + i / 13);
+    }
+    for (size_t length: {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 47, 1000})
+    {
+        const auto prefix = data.substr(0, length);
+        auto encoded = Base64Encode(prefix);
+        for (size_t capacity: {1, 2, 3, 5, 6, 7, 64, 4096})
+        {
+            std::string decoded;
+            ASSERT_TRUE(DecodeAll("data:application/octet-stream;base64," + encoded, capacity, decoded))
+                << length << " " << capacity;
+            ASSERT_EQ(prefix, decoded) << length << " " << capacity;
+        }
+        while (!encoded.empty() && (encoded.back() == '='))
+        {
+            encoded.pop_back();
+        }
+        std::string decoded;
+        ASSERT_TRUE(DecodeAll("data:;base64," + encoded, 5, decoded)) << length;
+        ASSERT_EQ(prefix, decoded) << length;
+    }
+
+    std::string decoded;
+    for (const auto* bad: {
+        "data:;base64,A",
+        "data:;base64,AAAAA",
+        "data:;base64,AA==AAAA",
+        "data:;base64,A=AA",
+        "data:;base64,AAAA AAA",
+        "data:;base64,AAAAAAA%3D",
+    })
+    {
+        ASSERT_FALSE(DecodeAll(bad, 16, decoded)) << bad;
+    }
+    ASSERT_FALSE(DecodeAll("data:;base64,QUJDREVG*", 16, decoded));
+    ASSERT_EQ("ABCDEF", decoded);
+}
+
+TEST(DataUriTests, DecodeBase64AroundBlockBoundaries)
+{
+    // 80 characters whose values step by 5, so that every character of the
+    // alphabet appears, some of them in two different 16-character blocks.
+    std::string data;
+    for (uint32_t quantum = 0; quantum < 20; ++quantum)
+    {
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            bits = (bits << 6) | ((quantum * 4 + i) * 5 % 64);
+        }
+        data += (char)(bits >> 16);
+        data += (char)(bits >> 8);
+        data += (char)bits;
+    }
+    const auto encoded = Base64Encode(data);
+    for (size_t length = 0; length <= encoded.length(); length += 4)
+    {
+        for (size_t capacity: {11, 12, 13, 14, 15, 24, 4096})
+        {
+            std::string decoded;
+            ASSERT_TRUE(DecodeAll("data:;base64," + encoded.substr(0, length), capacity, decoded))
+                << length << " " << capacity;
+            ASSERT_EQ(data.substr(0, length / 4 * 3), decoded) << length << " " << capacity;
+        }
+    }
+
+    // Neighbours of the alphabet's ranges, and bytes outside ASCII, at
+    // every position of the first 48 characters: everything in the
+    // quanta before the bad character is decoded, and nothing after.
+    for (const auto bad: {'*', ',', '-', '.', ':', '@', '[', '`', '{', '=', '\x80', '\xFF'})
+    {
+        for (size_t position = 0; position < 48; ++position)
+        {
+            auto corrupted = encoded;
+            corrupted[position] = bad;
+            std::string decoded;
+            ASSERT_FALSE(DecodeAll("data:;base64," + corrupted, 4096, decoded)) << bad << " " << position;
+            ASSERT_EQ(data.substr(0, position / 4 * 3), decoded) << bad << " " << position;
+        }
+    }
+}
+
+TEST(DataUriTests, DecodePercentEncoded)
+{
+    std::string decoded;
+    for (size_t capacity: {1, 2, 3, 100})
+    {
+        ASSERT_TRUE(DecodeAll("data:text/plain;charset=utf-8,A%20brief%0anote%e2%82%AC!", capacity, decoded));
+        ASSERT_EQ("A brief\nnote\xE2\x82\xAC!", decoded);
+    }
+    ASSERT_TRUE(DecodeAll("data:,", 4, decoded));
+    ASSERT_EQ("", decoded);
+    ASSERT_FALSE(DecodeAll("data:,ab%2", 4, decoded));
+    ASSERT_EQ("ab", decoded);
+    ASSERT_FALSE(DecodeAll("data:,%zz", 4, decoded));
+}
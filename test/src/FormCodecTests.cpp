@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <Uri/FormCodec.hpp>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    typedef std::vector< std::pair< std::string, std::string > > Pairs;
+
+    Pairs Copy(const std::vector< Uri::FormPair >& pairs)
+    {
+        Pairs copy;
+        for (const auto& pair: pairs)
+        {
+            copy.emplace_back(pair.name, pair.value);
+        }
+        return copy;
+    }
+
+    Pairs DecodeAll(std::string_view form)
+    {
+        std::vector< Uri::FormPair > pairs;
+        std::string storage;
+        Uri::FormDecoder::DecodeAll(form, pairs, storage);
+        return Copy(pairs);
+    }
+
+    // Decodes form fed to the decoder chunk_size bytes at a time.
+    Pairs DecodeInChunks(std::string_view form, size_t chunk_size)
+    {
+        Uri::FormDecoder decoder;
+        std::vector< Uri::FormPair > pairs;
+        std::string storage;
+        Pairs all;
+        while (!form.empty())
+        {
+            const auto chunk = form.substr(0, chunk_size);
+            form.remove_prefix(chunk.length());
+            decoder.Decode(chunk, pairs, storage);
+            const auto decoded = Copy(pairs);
+            all.insert(all.end(), decoded.begin(), decoded.end());
+        }
+        decoder.Finish(pairs, storage);
+        const auto decoded = Copy(pairs);
+        all.insert(all.end(), decoded.begin(), decoded.end());
+        return all;
+    }
+}
+
+TEST(FormCodecTests, Decode)
+{
+    ASSERT_EQ(Pairs(), DecodeAll(""));
+    ASSERT_EQ(Pairs(), DecodeAll("&&"));
+    ASSERT_EQ((Pairs{{"a", "1"}, {"b", ""}, {"", "2"}, {"c", ""}}), DecodeAll("a=1&b=&=2&&c&"));
+    ASSERT_EQ(
+        (Pairs{{"first name", "J\xC3\xB6rg & Co"}, {"eq", "x=y"}, {"plus", "+"}}),
+        DecodeAll("first+name=J%C3%b6rg+%26+Co&eq=x=y&plus=%2B")
+    );
+    ASSERT_EQ((Pairs{{"bad", "%zz%4"}, {"end", "%"}}), DecodeAll("bad=%zz%4&end=%"));
+    const std::string long_value(100, 'v');
+    ASSERT_EQ(
+        (Pairs{{"long", long_value + " " + long_value}, {"x", "y"}}),
+        DecodeAll("long=" + long_value + "+" + long_value + "&x=y")
+    );
+}
+
+TEST(FormCodecTests, DecodeInChunks)
+{
+    std::string form;
+    for (size_t i = 0; i < 50; ++i)
+    {
+        form += "name" + std::to_string(i) + "=a+b%20c%3D" + std::string(i, 'x') + "&&";
+    }
+    form += "last=%41";
+    const auto expected = DecodeAll(form);
+    ASSERT_EQ(50 + 1, expected.size());
+    ASSERT_EQ("A", expected.back().second);
+    for (size_t chunk_size: {1, 2, 3, 7, 16, 100, 10000})
+    {
+        ASSERT_EQ(expected, DecodeInChunks(form, chunk_size)) << chunk_size;
+    }
+
+    // Storage is reserved up front, so the views of every pair stay valid.
+    Uri::FormDecoder decoder;
+    std::vector< Uri::FormPair > pairs;
+    std::string storage;
+    decoder.Decode(form, pairs, storage);
+    ASSERT_EQ(50, pairs.size());
+    ASSERT_EQ("name0", pairs[0].name);
+    ASSERT_EQ("a b c=", pairs[0].value);
+    ASSERT_GE(storage.data() + storage.length(), pairs.back().value.data() + pairs.back().value.length());
+    decoder.Finish(pairs, storage);
+    ASSERT_EQ((Pairs{{"last", "A"}}), Copy(pairs));
+    decoder.Finish(pairs, storage);
+    ASSERT_TRUE(pairs.empty());
+}
+
+TEST(FormCodecTests, Build)
+{
+    Uri::FormBuilder builder;
+    ASSERT_EQ("", builder.Build());
+    builder.Add("first name", "J\xC3\xB6rg & Co");
+    builder.Add("", "a*b-c.d_e~f+g");
+    builder.Add("empty", "");
+    const std::string expected = "first+name=J%C3%B6rg+%26+Co&=a*b-c.d_e%7Ef%2Bg&empty=";
+    ASSERT_EQ(3, builder.Size());
+    ASSERT_EQ(expected.length(), builder.EncodedLength());
+    const auto form = builder.Build();
+    ASSERT_EQ(expected, form);
+    ASSERT_EQ(form.length(), form.capacity());
+
+    std::string appended = "q?";
+    builder.AppendTo(appended);
+    ASSERT_EQ("q?" + expected, appended);
+
+    std::vector< Uri::FormPair > pairs;
+    std::string storage;
+    Uri::FormDecoder::DecodeAll(form, pairs, storage);
+    ASSERT_EQ(expected.length(), Uri::FormBuilder::EncodedLength(pairs));
+    std::string encoded;
+    Uri::FormBuilder::Encode(pairs, encoded);
+    ASSERT_EQ(expected, encoded);
+
+    builder.Clear();
+    ASSERT_EQ(0, builder.Size());
+    ASSERT_EQ(0, builder.EncodedLength());
+}
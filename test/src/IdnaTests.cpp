@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <Uri/Idna.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct PunycodeVector
+    {
+        std::string label;
+        std::string encoded;
+    };
+
+    // RFC 3492 section 7.1 samples (L) and (M), and common IDN labels.
+    const std::vector< PunycodeVector > PUNYCODE_VECTORS{
+        {"b\xC3\xBC" "cher", "bcher-kva"},
+        {"m\xC3\xBCnchen", "mnchen-3ya"},
+        {"\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", "wgv71a119e"},
+        {"\xD0\xBF\xD1\x80\xD0\xB8\xD0\xBC\xD0\xB5\xD1\x80", "e1afmkfd"},
+        {"\xD1\x80\xD1\x84", "p1ai"},
+        {
+            "3\xE5\xB9\xB4" "B\xE7\xB5\x84\xE9\x87\x91\xE5\x85\xAB\xE5\x85\x88\xE7\x94\x9F",
+            "3B-ww4c5e180e575a65lsy2b"
+        },
+        {
+            "\xE5\xAE\x89\xE5\xAE\xA4\xE5\xA5\x88\xE7\xBE\x8E\xE6\x81\xB5-with-SUPER-MONKEYS",
+            "-with-SUPER-MONKEYS-pc58ag80a8qai00g7n9n"
+        },
+        {"abc", "abc-"},
+        {"", ""},
+    };
+}
+
+TEST(IdnaTests, EncodePunycode)
+{
+    for (const auto& test_vector: PUNYCODE_VECTORS)
+    {
+        std::string encoded;
+        ASSERT_TRUE(Uri::Idna::EncodePunycode(test_vector.label, encoded)) << test_vector.encoded;
+        ASSERT_EQ(test_vector.encoded, encoded);
+    }
+    std::string encoded;
+    ASSERT_FALSE(Uri::Idna::EncodePunycode("b\xC3", encoded));
+}
+
+TEST(IdnaTests, DecodePunycode)
+{
+    for (const auto& test_vector: PUNYCODE_VECTORS)
+    {
+        std::string label;
+        ASSERT_TRUE(Uri::Idna::DecodePunycode(test_vector.encoded, label)) << test_vector.encoded;
+        ASSERT_EQ(test_vector.label, label);
+    }
+    std::string label;
+    ASSERT_TRUE(Uri::Idna::DecodePunycode("BCHER-KVA", label));
+    ASSERT_EQ("B\xC3\xBC" "CHER", label);
+    for (const auto* bad: {"bcher-kv!", "bcher-k", "b\xC3\xBC-kva", "99999999999", "-a"})
+    {
+        ASSERT_FALSE(Uri::Idna::DecodePunycode(bad, label)) << bad;
+    }
+}
+
+TEST(IdnaTests, ToAsciiAndToUnicode)
+{
+    struct TestVector
+    {
+        std::string unicode_host;
+        std::string ascii_host;
+    };
+    const std::vector< TestVector > test_vectors{
+        {"www.example.com", "www.example.com"},
+        {"b\xC3\xBC" "cher.example", "xn--bcher-kva.example"},
+        {"\xD0\xBF\xD1\x80\xD0\xB8\xD0\xBC\xD0\xB5\xD1\x80.\xD1\x80\xD1\x84", "xn--e1afmkfd.xn--p1ai"},
+        {"\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E.jp", "xn--wgv71a119e.jp"},
+    };
+    Uri::Idna idna;
+    for (const auto& test_vector: test_vectors)
+    {
+        std::string converted;
+        ASSERT_TRUE(idna.ToAscii(test_vector.unicode_host, converted)) << test_vector.unicode_host;
+        ASSERT_EQ(test_vector.ascii_host, converted);
+        ASSERT_TRUE(idna.ToUnicode(test_vector.ascii_host, converted)) << test_vector.ascii_host;
+        ASSERT_EQ(test_vector.unicode_host, converted);
+    }
+
+    std::string converted;
+    ASSERT_TRUE(idna.ToAscii("WWW.B\xC3\xBC" "cher.Example", converted));
+    ASSERT_EQ("www.xn--bcher-kva.example", converted);
+    ASSERT_TRUE(idna.ToAscii("\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E\xE3\x80\x82jp", converted));
+    ASSERT_EQ("xn--wgv71a119e.jp", converted);
+    ASSERT_TRUE(idna.ToAscii("XN--BCHER-KVA.example", converted));
+    ASSERT_EQ("xn--bcher-kva.example", converted);
+    ASSERT_FALSE(idna.ToAscii("xn--bcher-k.example", converted));
+    ASSERT_FALSE(idna.ToAscii("b\xC3.example", converted));
+    ASSERT_FALSE(idna.ToAscii(std::string(40, 'a') + "\xC3\xBC" + std::string(40, 'a'), converted));
+
+    ASSERT_TRUE(idna.ToUnicode("xn--bcher-k.XN--BCHER-KVA.Example", converted));
+    ASSERT_EQ("xn--bcher-k.b\xC3\xBC" "cher.example", converted);
+    ASSERT_FALSE(idna.ToUnicode("b\xC3.example", converted));
+}
+
+TEST(IdnaTests, CachesConversionsButNotPlainAsciiHosts)
+{
+    Uri::Idna idna(2);
+    std::string converted;
+    ASSERT_TRUE(idna.ToAscii("www.example.com", converted));
+    ASSERT_TRUE(idna.ToUnicode("www.example.com", converted));
+    auto statistics = idna.GetStatistics();
+    ASSERT_EQ(0, statistics.hits + statistics.misses);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(idna.ToAscii("b\xC3\xBC" "cher.example", converted));
+        ASSERT_EQ("xn--bcher-kva.example", converted);
+    }
+    statistics = idna.GetStatistics();
+    ASSERT_EQ(2, statistics.hits);
+    ASSERT_EQ(1, statistics.misses);
+    ASSERT_EQ(1, statistics.entries);
+
+    ASSERT_TRUE(idna.ToUnicode("xn--bcher-kva.example", converted));
+    ASSERT_TRUE(idna.ToAscii("m\xC3\xBCnchen.example", converted));
+    statistics = idna.GetStatistics();
+    ASSERT_EQ(2, statistics.entries);
+    ASSERT_EQ(1, statistics.evictions);
+
+    idna.ClearCache();
+    ASSERT_EQ(0, idna.GetStatistics().entries);
+    ASSERT_TRUE(idna.ToAscii("m\xC3\xBCnchen.example", converted));
+    ASSERT_EQ("xn--mnchen-3ya.example", converted);
+}
+
+TEST(IdnaTests, HostFromIri)
+{
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromIriString("http://b\xC3\xBC" "cher.example/"));
+    Uri::Idna idna;
+    std::string ascii_host;
+    ASSERT_TRUE(idna.ToAscii(uri.GetHostView(), ascii_host));
+    uri.SetHost(std::move(ascii_host));
+    ASSERT_EQ("http://xn--bcher-kva.example/", uri.GenerateString());
+}
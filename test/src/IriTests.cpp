@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <Uri/Iri.hpp>
+#include <Uri/Uri.hpp>
+#include <src/Utf8.hpp>
+#include <string>
+#include <vector>
+
+TEST(IriTests, IsValidUtf8)
+{
+    struct TestVector
+    {
+        std::string input;
+        bool is_valid;
+    };
+    const std::vector< TestVector > test_vectors{
+        {"", true},
+        {"plain ascii, longer than one word", true},
+        {"caf\xC3\xA9", true},
+        {"\xE2\x82\xAC and \xF0\x9F\x98\x80", true},
+        {"\xF4\x8F\xBF\xBF", true},
+        {"\xC3", false},
+        {"\xC3(", false},
+        {"\xC0\xAF", false},
+        {"\xE0\x80\xAF", false},
+        {"\xED\xA0\x80", false},
+        {"\xF4\x90\x80\x80", false},
+        {"\xF5\x80\x80\x80", false},
+        {"\x80", false},
+        {"aaaaaaaaaaaaaaaa\xFF", false},
+        {"aaaaaaaaaaaaaaa\xC3\xA9" "aaaaaaaaaaaaaaaaaaaa", true},
+        {"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\xE2\x82\xAC" "aaaaaaaaaaaaaaaaaaaa", true},
+        {"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\xC3", false},
+        {"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\xE2\x82\xAC" "aaaaaaaaaaaaaaaaaaaa\xFF", false},
+    };
+    for (const auto& test_vector: test_vectors)
+    {
+        ASSERT_EQ(test_vector.is_valid, Uri::Iri::IsValidUtf8(test_vector.input)) << test_vector.input;
+    }
+}
+
+TEST(IriTests, CountLeadingAscii)
+{
+    // A non-ASCII byte at every position in and around 16 and 32 byte
+    // blocks.
+    for (size_t length = 0; length < 70; ++length)
+    {
+        std::string input(length, 'a');
+        ASSERT_EQ(length, Uri::CountLeadingAscii(input));
+        for (size_t position = 0; position < length; ++position)
+        {
+            input[position] = '\xC3';
+            ASSERT_EQ(position, Uri::CountLeadingAscii(input)) << length;
+            input[position] = 'a';
+        }
+    }
+}
+
+TEST(IriTests, ToUri)
+{
+    struct TestVector
+    {
+        std::string iri;
+        std::string uri;
+    };
+    const std::vector< TestVector > test_vectors{
+        {"http://example.com/", "http://example.com/"},
+        {"http://example.com/caf\xC3\xA9?q=\xE2\x82\xAC#\xF0\x9F\x98\x80", "http://example.com/caf%C3%A9?q=%E2%82%AC#%F0%9F%98%80"},
+        {"http://\xC3\xA9x.com/%20", "http://%C3%A9x.com/%20"},
+    };
+    for (const auto& test_vector: test_vectors)
+    {
+        std::string uri = "leftover";
+        ASSERT_TRUE(Uri::Iri::ToUri(test_vector.iri, uri)) << test_vector.iri;
+        ASSERT_EQ(test_vector.uri, uri);
+    }
+    std::string uri;
+    ASSERT_FALSE(Uri::Iri::ToUri("http://example.com/\xC3(", uri));
+}
+
+TEST(IriTests, ToIri)
+{
+    struct TestVector
+    {
+        std::string uri;
+        std::string iri;
+    };
+    const std::vector< TestVector > test_vectors{
+        {"http://example.com/", "http://example.com/"},
+        {"http://example.com/caf%C3%A9?q=%e2%82%ac", "http://example.com/caf\xC3\xA9?q=\xE2\x82\xAC"},
+        {"/%20%41%2F", "/%20%41%2F"},
+        {"/%C3", "/%C3"},
+        {"/%C3%28", "/%C3%28"},
+        {"/%C0%AF", "/%C0%AF"},
+        {"/%ED%A0%80", "/%ED%A0%80"},
+        {"/%C3%C3%A9", "/%C3\xC3\xA9"},
+        {"/%F0%9F%98%80%F0%9F%98", "/\xF0\x9F\x98\x80%F0%9F%98"},
+        {"/%", "/%"},
+        {"/%C", "/%C"},
+    };
+    for (const auto& test_vector: test_vectors)
+    {
+        ASSERT_EQ(test_vector.iri, Uri::Iri::ToIri(test_vector.uri)) << test_vector.uri;
+    }
+}
+
+TEST(IriTests, ParseFromIriString)
+{
+    Uri::Uri iri;
+    ASSERT_TRUE(iri.ParseFromIriString("http://\xC3\xA9x.com/caf\xC3\xA9/?q=\xE2\x82\xAC#\xF0\x9F\x98\x80"));
+    ASSERT_EQ("\xC3\xA9x.com", iri.GetHost());
+    ASSERT_EQ((std::vector< std::string >{"", "caf\xC3\xA9", ""}), iri.GetPath());
+    ASSERT_EQ("q=\xE2\x82\xAC", iri.GetQuery());
+    ASSERT_EQ("\xF0\x9F\x98\x80", iri.GetFragment());
+    ASSERT_EQ("http://%C3%A9x.com/caf%C3%A9/?q=%E2%82%AC#%F0%9F%98%80", iri.GenerateString());
+    ASSERT_EQ("http://\xC3\xA9x.com/caf\xC3\xA9/?q=\xE2\x82\xAC#\xF0\x9F\x98\x80", iri.GenerateIriString());
+
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://%C3%A9x.com/caf%C3%A9/?q=%E2%82%AC#%F0%9F%98%80"));
+    ASSERT_EQ(uri, iri);
+
+    ASSERT_FALSE(uri.ParseFromString("http://example.com/caf\xC3\xA9"));
+    ASSERT_FALSE(uri.ParseFromIriString("http://example.com/caf\xC3"));
+    ASSERT_FALSE(uri.ParseFromIriString("http://example.com/a b"));
+    ASSERT_TRUE(uri.ParseFromIriString("http://example.com/ascii"));
+    ASSERT_EQ("http://example.com/ascii", uri.GenerateIriString());
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <Uri/ParseCache.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ParseCacheTests, HitsReturnTheSameParsedUri)
+{
+    Uri::ParseCache cache;
+    const auto first = cache.Parse("http://www.example.com/foo?bar#baz");
+    ASSERT_TRUE(first != nullptr);
+    ASSERT_EQ("www.example.com", first->GetHost());
+    const auto second = cache.Parse("http://www.example.com/foo?bar#baz");
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(first, cache.Find("http://www.example.com/foo?bar#baz"));
+    ASSERT_TRUE(cache.Find("http://www.example.com/") == nullptr);
+    auto statistics = cache.GetStatistics();
+    ASSERT_EQ(2, statistics.hits);
+    ASSERT_EQ(2, statistics.misses);
+    ASSERT_EQ(1, statistics.entries);
+    ASSERT_GT(statistics.memory_usage, 0);
+
+    cache.Clear();
+    ASSERT_TRUE(cache.Find("http://www.example.com/foo?bar#baz") == nullptr);
+    ASSERT_EQ("www.example.com", first->GetHost());
+    ASSERT_EQ(0, cache.GetStatistics().entries);
+}
+
+TEST(ParseCacheTests, InvalidUrisAreNotCached)
+{
+    Uri::ParseCache cache;
+    ASSERT_TRUE(cache.Parse("http://www.example.com/[") == nullptr);
+    ASSERT_TRUE(cache.Parse("http://www.example.com/[") == nullptr);
+    const auto statistics = cache.GetStatistics();
+    ASSERT_EQ(0, statistics.hits);
+    ASSERT_EQ(2, statistics.misses);
+    ASSERT_EQ(0, statistics.entries);
+}
+
+TEST(ParseCacheTests, EvictsToStayUnderMemoryCap)
+{
+    Uri::ParseCache cache(16 * 1024, 4);
+    ASSERT_EQ(16 * 1024, cache.GetMemoryCap());
+    std::vector< Uri::ParseCache::Handle > handles;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        handles.push_back(cache.Parse("http://example.com/" + std::to_string(i)));
+        ASSERT_TRUE(handles.back() != nullptr);
+        ASSERT_LE(cache.GetStatistics().memory_usage, cache.GetMemoryCap());
+    }
+    const auto statistics = cache.GetStatistics();
+    ASSERT_GT(statistics.evictions, 0);
+    ASSERT_EQ(1000 - statistics.evictions, statistics.entries);
+    for (size_t i = 0; i < handles.size(); ++i)
+    {
+        ASSERT_EQ(
+            (std::vector< std::string >{"", std::to_string(i)}),
+            handles[i]->GetPath()
+        );
+    }
+}
+
+TEST(ParseCacheTests, ReferencedEntriesSurviveEviction)
+{
+    Uri::ParseCache cache(16 * 1024, 1);
+    const auto hot = cache.Parse("http://example.com/hot");
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(hot, cache.Parse("http://example.com/hot"));
+        (void)cache.Parse("http://example.com/cold/" + std::to_string(i));
+    }
+    ASSERT_EQ(hot, cache.Find("http://example.com/hot"));
+}
+
+TEST(ParseCacheTests, ConcurrentParse)
+{
+    Uri::ParseCache cache(64 * 1024, 8);
+    std::vector< std::thread > workers;
+    std::vector< size_t > failures(8, 0);
+    for (size_t worker = 0; worker < failures.size(); ++worker)
+    {
+        workers.emplace_back(
+            [&cache, &failures, worker]
+            {
+                for (size_t i = 0; i < 5000; ++i)
+                {
+                    const auto id = std::to_string((i * 7 + worker) % 300);
+                    const auto uri = cache.Parse("http://example.com/" + id + "?q=" + id);
+                    if ((uri == nullptr) || (uri->GetQuery() != "q=" + id))
+                    {
+                        ++failures[worker];
+                    }
+                }
+            }
+        );
+    }
+    for (auto& worker: workers)
+    {
+        worker.join();
+    }
+    for (auto failure_count: failures)
+    {
+        ASSERT_EQ(0, failure_count);
+    }
+    const auto statistics = cache.GetStatistics();
+    ASSERT_EQ(8 * 5000, statistics.hits + statistics.misses);
+    ASSERT_LE(statistics.memory_usage, cache.GetMemoryCap());
+}
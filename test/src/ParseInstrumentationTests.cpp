@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <Uri/ParseInstrumentation.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <thread>
+
+namespace
+{
+    typedef Uri::ParseInstrumentation Instrumentation;
+    typedef Uri::ParseInstrumentation::Stage Stage;
+}
+
+TEST(ParseInstrumentationTests, CountsEveryStageOfAParse)
+{
+    Instrumentation::SetSampleInterval(1);
+    Instrumentation::ResetThread();
+    const std::string uri_string = "http://[::1]:8080/a/b?q#f";
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString(uri_string));
+    const auto snapshot = Instrumentation::GetThreadSnapshot();
+    if (!Instrumentation::IsCompiledIn())
+    {
+        ASSERT_EQ(0, snapshot[Stage::PARSE].calls);
+        return;
+    }
+    ASSERT_EQ(1, snapshot[Stage::PARSE].calls);
+    ASSERT_EQ(0, snapshot[Stage::PARSE].failures);
+    ASSERT_EQ(uri_string.length(), snapshot[Stage::PARSE].bytes);
+    ASSERT_EQ(1, snapshot[Stage::PARSE].timed_calls);
+    for (const auto stage: {
+        Stage::PARSE_SCHEME,
+        Stage::PARSE_AUTHORITY,
+        Stage::VALIDATE_IPV6_ADDRESS,
+        Stage::PARSE_PATH,
+        Stage::PARSE_QUERY,
+        Stage::PARSE_FRAGMENT,
+    })
+    {
+        ASSERT_EQ(1, snapshot[stage].calls) << Instrumentation::GetStageName(stage);
+        ASSERT_EQ(1, snapshot[stage].timed_calls) << Instrumentation::GetStageName(stage);
+        ASSERT_LE(snapshot[stage].ticks, snapshot[Stage::PARSE].ticks);
+    }
+    ASSERT_EQ(3, snapshot[Stage::VALIDATE_IPV6_ADDRESS].bytes);
+    ASSERT_EQ(4, snapshot[Stage::PARSE_PATH].bytes);
+    ASSERT_EQ(0, snapshot[Stage::GENERATE_STRING].calls);
+}
+
+TEST(ParseInstrumentationTests, RecordsTheStageThatFailed)
+{
+    if (!Instrumentation::IsCompiledIn())
+    {
+        return;
+    }
+    Instrumentation::ResetThread();
+    Uri::Uri uri;
+    ASSERT_FALSE(uri.ParseFromString("http://[::x]/"));
+    ASSERT_FALSE(uri.ParseFromString("http://example.com/%zz"));
+    const auto snapshot = Instrumentation::GetThreadSnapshot();
+    ASSERT_EQ(2, snapshot[Stage::PARSE].calls);
+    ASSERT_EQ(2, snapshot[Stage::PARSE].failures);
+    ASSERT_EQ(1, snapshot[Stage::VALIDATE_IPV6_ADDRESS].failures);
+    ASSERT_EQ(1, snapshot[Stage::PARSE_AUTHORITY].failures);
+    ASSERT_EQ(1, snapshot[Stage::PARSE_PATH].calls);
+    ASSERT_EQ(1, snapshot[Stage::PARSE_PATH].failures);
+    ASSERT_EQ(0, snapshot[Stage::PARSE_QUERY].calls);
+}
+
+TEST(ParseInstrumentationTests, SamplesOneTopLevelCallPerInterval)
+{
+    if (!Instrumentation::IsCompiledIn())
+    {
+        return;
+    }
+    Instrumentation::SetSampleInterval(4);
+    Instrumentation::ResetThread();
+    Uri::Uri uri;
+    for (size_t i = 0; i < 16; ++i)
+    {
+        ASSERT_TRUE(uri.ParseFromString("http://example.com/" + std::to_string(i)));
+        (void)uri.GenerateString();
+    }
+    Instrumentation::SetSampleInterval(1);
+    const auto snapshot = Instrumentation::GetThreadSnapshot();
+    ASSERT_EQ(16, snapshot[Stage::PARSE].calls);
+    ASSERT_EQ(16, snapshot[Stage::GENERATE_STRING].calls);
+    ASSERT_EQ(8, snapshot[Stage::PARSE].timed_calls + snapshot[Stage::GENERATE_STRING].timed_calls);
+    ASSERT_EQ(snapshot[Stage::PARSE].timed_calls, snapshot[Stage::PARSE_PATH].timed_calls);
+}
+
+TEST(ParseInstrumentationTests, SnapshotIncludesOtherThreads)
+{
+    Instrumentation::SetSampleInterval(1);
+    const auto before = Instrumentation::GetSnapshot();
+    std::thread worker([]{
+        Uri::Uri base, reference;
+        ASSERT_TRUE(base.ParseFromString("http://example.com/a/b"));
+        ASSERT_TRUE(reference.ParseFromString("../c"));
+        (void)base.Resolve(reference);
+    });
+    worker.join();
+    const auto after = Instrumentation::GetSnapshot();
+    const uint64_t expected = Instrumentation::IsCompiledIn() ? 1 : 0;
+    ASSERT_EQ(2 * expected, after[Stage::PARSE].calls - before[Stage::PARSE].calls);
+    ASSERT_EQ(expected, after[Stage::RESOLVE].calls - before[Stage::RESOLVE].calls);
+}
+
+TEST(ParseInstrumentationTests, Export)
+{
+    Instrumentation::Snapshot snapshot;
+    snapshot.stages[(size_t)Stage::PARSE_PATH].calls = 3;
+    snapshot.stages[(size_t)Stage::PARSE_PATH].failures = 1;
+    const auto exported = Instrumentation::Export(snapshot);
+    ASSERT_NE(
+        std::string::npos,
+        exported.find("\nparse_path calls=3 failures=1 bytes=0 timed_calls=0 ticks=0\n")
+    );
+    ASSERT_EQ(0, exported.find("parse calls=0 "));
+    ASSERT_STREQ("validate_ipv6_address", Instrumentation::GetStageName(Stage::VALIDATE_IPV6_ADDRESS));
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <Uri/PathRouter.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // The index of the route matching a URI's path, or NO_ROUTE.  The
+    // match has views of uri's path, so uri must outlive its use.
+    size_t FindRoute(const Uri::PathRouter& router,
+                     const std::string& uri_string,
+                     Uri::Uri& uri,
+                     Uri::PathRouter::Match& match)
+    {
+        EXPECT_TRUE(uri.ParseFromString(uri_string)) << uri_string;
+        if (!router.Find(uri, match))
+        {
+            return Uri::PathRouter::NO_ROUTE;
+        }
+        return match.route;
+    }
+}
+
+TEST(PathRouterTests, LiteralsAndParameters)
+{
+    Uri::PathRouter router;
+    ASSERT_EQ(0, router.AddRoute("/v1/users/{id}/orders/{orderId}"));
+    ASSERT_EQ(1, router.AddRoute("/v1/users/{id}"));
+    ASSERT_EQ(2, router.AddRoute("/v1/users/me"));
+    ASSERT_EQ(3, router.AddRoute("/"));
+    ASSERT_EQ(4, router.AddRoute("/v1/users/"));
+    ASSERT_EQ(5, router.Size());
+
+    Uri::Uri uri;
+    Uri::PathRouter::Match match;
+    ASSERT_EQ(0, FindRoute(router, "http://example.com/v1/users/42/orders/7?x=1", uri, match));
+    ASSERT_EQ(2, match.num_parameters);
+    ASSERT_EQ("id", match.parameters[0].name);
+    ASSERT_EQ("42", match.parameters[0].value);
+    ASSERT_EQ("7", match.Get("orderId"));
+    ASSERT_EQ("", match.Get("missing"));
+
+    ASSERT_EQ(1, FindRoute(router, "/v1/users/a%20b", uri, match));
+    ASSERT_EQ("a b", match.Get("id"));
+    ASSERT_EQ(2, FindRoute(router, "/v1/users/me", uri, match));
+    ASSERT_EQ(0, match.num_parameters);
+    ASSERT_EQ(3, FindRoute(router, "http://example.com/", uri, match));
+    ASSERT_EQ(4, FindRoute(router, "/v1/users/", uri, match));
+    ASSERT_EQ(Uri::PathRouter::NO_ROUTE, FindRoute(router, "/v1/users/42/orders", uri, match));
+    ASSERT_EQ(Uri::PathRouter::NO_ROUTE, FindRoute(router, "/v1/users//orders/7", uri, match));
+    ASSERT_EQ(Uri::PathRouter::NO_ROUTE, FindRoute(router, "/v2", uri, match));
+}
+
+TEST(PathRouterTests, PrioritiesAndBacktracking)
+{
+    Uri::PathRouter router;
+    ASSERT_EQ(0, router.AddRoute("/files/{*}"));
+    ASSERT_EQ(1, router.AddRoute("/files/{name}"));
+    ASSERT_EQ(2, router.AddRoute("/files/readme"));
+    ASSERT_EQ(3, router.AddRoute("/a/b/c"));
+    ASSERT_EQ(4, router.AddRoute("/a/{x}/d"));
+    ASSERT_EQ(5, router.AddRoute("/{*}"));
+
+    Uri::Uri uri;
+    Uri::PathRouter::Match match;
+    ASSERT_EQ(2, FindRoute(router, "/files/readme", uri, match));
+    ASSERT_EQ(1, FindRoute(router, "/files/license", uri, match));
+    ASSERT_EQ(0, FindRoute(router, "/files/docs/license", uri, match));
+    ASSERT_EQ(1, match.rest_start);
+    ASSERT_EQ(0, FindRoute(router, "/files/", uri, match));
+    ASSERT_EQ(0, FindRoute(router, "/files", uri, match));
+    ASSERT_EQ(1, match.rest_start);
+    ASSERT_EQ(3, FindRoute(router, "/a/b/c", uri, match));
+    ASSERT_EQ(4, FindRoute(router, "/a/b/d", uri, match));
+    ASSERT_EQ("b", match.Get("x"));
+    ASSERT_EQ(5, FindRoute(router, "/a/b/e", uri, match));
+    ASSERT_EQ(0, match.num_parameters);
+    ASSERT_EQ(0, match.rest_start);
+
+    std::vector< std::string > path{"", "a", "q", "d"};
+    ASSERT_TRUE(router.Find(path, match));
+    ASSERT_EQ(4, match.route);
+    ASSERT_EQ("q", match.Get("x"));
+}
+
+TEST(PathRouterTests, RejectsBadAndDuplicateTemplates)
+{
+    Uri::PathRouter router;
+    ASSERT_EQ(0, router.AddRoute("/users/{id}"));
+    for (const auto* bad: {
+        "",
+        "users",
+        "/users/{name}",
+        "/users/{}",
+        "/users/{id",
+        "/users/x{id}",
+        "/{*}/x",
+        "/{a}/{a}",
+        "/a b",
+        "/%zz",
+    })
+    {
+        ASSERT_EQ(Uri::PathRouter::NO_ROUTE, router.AddRoute(bad)) << bad;
+    }
+    ASSERT_EQ(1, router.AddRoute("/{*}"));
+    ASSERT_EQ(Uri::PathRouter::NO_ROUTE, router.AddRoute("/{*}"));
+    std::string too_many;
+    for (size_t i = 0; i <= Uri::PathRouter::MAX_PARAMETERS; ++i)
+    {
+        too_many += "/{p" + std::to_string(i) + "}";
+    }
+    ASSERT_EQ(Uri::PathRouter::NO_ROUTE, router.AddRoute(too_many));
+    ASSERT_EQ(2, router.Size());
+
+    Uri::PathRouter copy(router);
+    ASSERT_EQ(2, copy.AddRoute("/x"));
+    ASSERT_EQ(2, router.Size());
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <Uri/PublicSuffixList.hpp>
+#include <Uri/Uri.hpp>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // A few rules of each kind, as in the published list.
+    const char* const LIST =
+        "// ===BEGIN ICANN DOMAINS===\n"
+        "\n"
+        "com\n"
+        "uk\n"
+        "co.uk\n"
+        "  jp  \n"
+        "// Comment in the middle\n"
+        "*.kawasaki.jp\n"
+        "!city.kawasaki.jp\n"
+        "*.ck\n"
+        "!www.ck\n"
+        "\xE9\xA6\x99\xE6\xB8\xAF\r\n"
+        "\xE5\x80\x8B\xE4\xBA\xBA.\xE9\xA6\x99\xE6\xB8\xAF\n"
+        "// ===BEGIN PRIVATE DOMAINS===\n"
+        "blogspot.com    trailing text is ignored\n"
+        "*.compute.amazonaws.com\n";
+
+    Uri::PublicSuffixList MakeList()
+    {
+        Uri::PublicSuffixList list;
+        EXPECT_TRUE(list.Build(LIST));
+        return list;
+    }
+}
+
+TEST(PublicSuffixListTests, FindsPublicSuffixAndRegistrableDomain)
+{
+    struct TestVector
+    {
+        std::string host;
+        std::string public_suffix;
+        std::string registrable_domain;
+    };
+    const std::vector< TestVector > test_vectors{
+        {"com", "com", ""},
+        {"example.com", "com", "example.com"},
+        {"www.Example.COM", "COM", "Example.COM"},
+        {"a.b.example.co.uk", "co.uk", "example.co.uk"},
+        {"co.uk", "co.uk", ""},
+        {"example.uk", "uk", "example.uk"},
+        {"example.test", "test", "example.test"},
+        {"test", "test", ""},
+        {"a.b.kawasaki.jp", "b.kawasaki.jp", "a.b.kawasaki.jp"},
+        {"b.kawasaki.jp", "b.kawasaki.jp", ""},
+        {"kawasaki.jp", "jp", "kawasaki.jp"},
+        {"city.kawasaki.jp", "kawasaki.jp", "city.kawasaki.jp"},
+        {"www.city.kawasaki.jp", "kawasaki.jp", "city.kawasaki.jp"},
+        {"www.ck", "ck", "www.ck"},
+        {"a.www.ck", "ck", "www.ck"},
+        {"other.ck", "other.ck", ""},
+        {"a.other.ck", "other.ck", "a.other.ck"},
+        {"me.blogspot.com", "blogspot.com", "me.blogspot.com"},
+        {"a.b.eu-west-1.compute.amazonaws.com", "eu-west-1.compute.amazonaws.com", "b.eu-west-1.compute.amazonaws.com"},
+        {"amazonaws.com", "com", "amazonaws.com"},
+        {"example.com.", "com.", "example.com."},
+        {"www.\xE5\x80\x8B\xE4\xBA\xBA.\xE9\xA6\x99\xE6\xB8\xAF", "\xE5\x80\x8B\xE4\xBA\xBA.\xE9\xA6\x99\xE6\xB8\xAF", "www.\xE5\x80\x8B\xE4\xBA\xBA.\xE9\xA6\x99\xE6\xB8\xAF"},
+        {"www.xn--gmqw5a.xn--j6w193g", "xn--gmqw5a.xn--j6w193g", "www.xn--gmqw5a.xn--j6w193g"},
+        {"a..com", "com", ""},
+        {"192.168.0.1", "", ""},
+        {"[::1]", "", ""},
+        {"", "", ""},
+    };
+    const auto list = MakeList();
+    for (const auto& test_vector: test_vectors)
+    {
+        ASSERT_EQ(test_vector.public_suffix, list.GetPublicSuffix(test_vector.host)) << test_vector.host;
+        ASSERT_EQ(test_vector.registrable_domain, list.GetRegistrableDomain(test_vector.host)) << test_vector.host;
+    }
+}
+
+TEST(PublicSuffixListTests, UriReturnsViewsIntoHost)
+{
+    const auto list = MakeList();
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("https://user@shop.Example.co.uk:8443/cart"));
+    const auto host = uri.GetHostView();
+    const auto domain = uri.GetRegistrableDomain(list);
+    ASSERT_EQ("example.co.uk", domain);
+    ASSERT_EQ(host.data() + host.length(), domain.data() + domain.length());
+    ASSERT_EQ("co.uk", uri.GetPublicSuffix(list));
+}
+
+TEST(PublicSuffixListTests, BuildRejectsMalformedLists)
+{
+    auto list = MakeList();
+    const auto size = list.Size();
+    ASSERT_EQ(12, size);
+    for (const auto* bad: {"", "// only comments\n", "a..b\n", "*x.com\n", "!com\n", "!*.com\n", "com\n!\n"})
+    {
+        ASSERT_FALSE(list.Build(bad)) << bad;
+        ASSERT_EQ(size, list.Size());
+    }
+    ASSERT_EQ("co.uk", list.GetPublicSuffix("example.co.uk"));
+    const auto copy = list;
+    ASSERT_EQ("co.uk", copy.GetPublicSuffix("example.co.uk"));
+    ASSERT_GT(copy.MemoryUsage(), 0);
+}
+
+TEST(PublicSuffixListTests, LoadFromFile)
+{
+    const std::string file_path = testing::TempDir() + "PublicSuffixListTests.LoadFromFile.dat";
+    FILE* file = fopen(file_path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    fputs(LIST, file);
+    fclose(file);
+    Uri::PublicSuffixList list;
+    ASSERT_TRUE(list.LoadFromFile(file_path));
+    ASSERT_EQ("example.co.uk", list.GetRegistrableDomain("www.example.co.uk"));
+    ASSERT_FALSE(list.LoadFromFile(file_path + ".missing"));
+    ASSERT_EQ(12, list.Size());
+    (void)remove(file_path.c_str());
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <Uri/ResolvedBase.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const std::vector< std::string > RELATIVE_REFERENCES
+    {
+        "g:h", "g", "./g", "g/", "/g", "//g", "?y", "g?y", "#s", "g#s",
+        "g?y#s", ";x", "g;x", "g;x?y#s", "", ".", "./", "..", "../",
+        "../g", "../..", "../../", "../../g", "../../../g", "/./g",
+        "/../g", "g.", "..g", "./../g", "g/./h", "g/../h",
+        "%", "%4", "%/g", "xv1.xx//+%C3%A9",
+    };
+}
+
+TEST(ResolvedBaseTests, MatchesUriResolve)
+{
+    const std::vector< std::string > bases
+    {
+        "http://a/b/c/d;p?q",
+        "http://bob@example.com:8080/x/./y/../z?q#f",
+        "http://example.com",
+        "foo/bar",
+        "%",
+    };
+    for (const auto& base_string : bases)
+    {
+        Uri::Uri base;
+        ASSERT_TRUE(base.ParseFromString(base_string)) << base_string;
+        const Uri::ResolvedBase resolved_base(base);
+        size_t index = 0;
+        for (const auto& relative_reference_string : RELATIVE_REFERENCES)
+        {
+            Uri::Uri relative_reference;
+            ASSERT_TRUE(relative_reference.ParseFromString(relative_reference_string)) << index;
+            ASSERT_EQ(base.Resolve(relative_reference), resolved_base.Resolve(relative_reference))
+                << base_string << " " << index;
+            ++index;
+        }
+    }
+}
+
+TEST(ResolvedBaseTests, KeepsDotSegmentsOfBase)
+{
+    // An empty path takes the base's as it is (RFC 3986 5.2.2); only a
+    // merged path has its dot segments removed.
+    Uri::Uri base;
+    ASSERT_TRUE(base.ParseFromString("urn:../0%2F$$?q"));
+    const Uri::ResolvedBase resolved_base(base);
+    ASSERT_EQ(base, resolved_base.GetBase());
+    for (const auto& relative_reference_string: {"", "?y", "#s", "g"})
+    {
+        Uri::Uri relative_reference;
+        ASSERT_TRUE(relative_reference.ParseFromString(relative_reference_string));
+        const auto expected = base.Resolve(relative_reference).GenerateString();
+        ASSERT_EQ(expected, base.ResolveToString(relative_reference)) << relative_reference_string;
+        ASSERT_EQ(expected, resolved_base.Resolve(relative_reference).GenerateString()) << relative_reference_string;
+        std::string target;
+        resolved_base.ResolveInto(relative_reference, target);
+        ASSERT_EQ(expected, target) << relative_reference_string;
+        ASSERT_TRUE(resolved_base.ResolveInto(std::string(relative_reference_string), target));
+        ASSERT_EQ(expected, target) << relative_reference_string;
+    }
+    ASSERT_EQ("urn:../0%2F$$?q", resolved_base.Resolve(Uri::Uri()).GenerateString());
+    std::string target;
+    ASSERT_TRUE(resolved_base.ResolveInto(std::string("?y"), target));
+    ASSERT_EQ("urn:../0%2F$$?y", target);
+    ASSERT_TRUE(resolved_base.ResolveInto(std::string("g"), target));
+    ASSERT_EQ("urn:g", target);
+}
+
+TEST(ResolvedBaseTests, ResolveIntoReusesTarget)
+{
+    Uri::Uri base;
+    ASSERT_TRUE(base.ParseFromString("http://a/b/c/d;p?q"));
+    const Uri::ResolvedBase resolved_base(base);
+    Uri::Uri target;
+    ASSERT_TRUE(resolved_base.ResolveInto("g?y#s", target));
+    ASSERT_EQ("http://a/b/c/g?y#s", target.GenerateString());
+    ASSERT_TRUE(resolved_base.ResolveInto("../g", target));
+    ASSERT_EQ("http://a/b/g", target.GenerateString());
+    ASSERT_FALSE(target.HasQuery());
+    ASSERT_FALSE(target.HasFragment());
+    ASSERT_FALSE(resolved_base.ResolveInto("/[", target));
+}
+
+TEST(ResolvedBaseTests, ResolveAllBatches)
+{
+    Uri::Uri base;
+    ASSERT_TRUE(base.ParseFromString("http://a/b/c/d;p?q"));
+    const Uri::ResolvedBase resolved_base(base);
+
+    std::vector< Uri::Uri > references(RELATIVE_REFERENCES.size());
+    std::vector< std::string > expected_strings;
+    for (size_t i = 0; i < RELATIVE_REFERENCES.size(); ++i)
+    {
+        ASSERT_TRUE(references[i].ParseFromString(RELATIVE_REFERENCES[i])) << i;
+        expected_strings.push_back(base.Resolve(references[i]).GenerateString());
+    }
+
+    std::vector< Uri::Uri > targets;
+    resolved_base.ResolveAll(references, targets);
+    ASSERT_EQ(references.size(), targets.size());
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        ASSERT_EQ(expected_strings[i], targets[i].GenerateString()) << i;
+    }
+
+    std::vector< std::string > target_strings;
+    resolved_base.ResolveAll(references, target_strings);
+    ASSERT_EQ(expected_strings, target_strings);
+
+    target_strings.clear();
+    ASSERT_EQ(RELATIVE_REFERENCES.size(), resolved_base.ResolveAll(RELATIVE_REFERENCES, target_strings));
+    ASSERT_EQ(expected_strings, target_strings);
+
+    targets.clear();
+    ASSERT_EQ(RELATIVE_REFERENCES.size(), resolved_base.ResolveAll(RELATIVE_REFERENCES, targets));
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        ASSERT_EQ(expected_strings[i], targets[i].GenerateString()) << i;
+    }
+}
+
+TEST(ResolvedBaseTests, ResolveAllStringsReportsFailures)
+{
+    Uri::Uri base;
+    ASSERT_TRUE(base.ParseFromString("http://example.com/a/b"));
+    const Uri::ResolvedBase resolved_base(base);
+    const std::vector< std::string > references{"c", "/[", "d?e"};
+    std::vector< std::string > targets;
+    ASSERT_EQ(2, resolved_base.ResolveAll(references, targets));
+    ASSERT_EQ((std::vector< std::string >{"http://example.com/a/c", "", "http://example.com/a/d?e"}), targets);
+}
+
+TEST(ResolvedBaseTests, ResolveIntoStringMatchesResolve)
+{
+    const std::vector< std::string > bases
+    {
+        "http://a/b/c/d;p?q",
+        "HTTP://Bob@WWW.Example.COM:8080/x/./y/../z?q%2B#f",
+        "http://example.com",
+        "//:8080",
+        "foo/bar",
+        "%",
+    };
+    for (const auto& base_string : bases)
+    {
+        Uri::Uri base;
+        ASSERT_TRUE(base.ParseFromString(base_string)) << base_string;
+        const Uri::ResolvedBase resolved_base(base);
+        for (const auto& relative_reference_string : RELATIVE_REFERENCES)
+        {
+            Uri::Uri relative_reference;
+            ASSERT_TRUE(relative_reference.ParseFromString(relative_reference_string));
+            const auto expected = resolved_base.Resolve(relative_reference).GenerateString();
+            std::string target;
+            resolved_base.ResolveInto(relative_reference, target);
+            ASSERT_EQ(expected, target) << base_string << " + " << relative_reference_string;
+            ASSERT_TRUE(resolved_base.ResolveInto(relative_reference_string, target));
+            ASSERT_EQ(expected, target) << base_string << " + " << relative_reference_string;
+        }
+    }
+}
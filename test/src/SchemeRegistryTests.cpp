@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <Uri/SchemeRegistry.hpp>
+#include <Uri/Uri.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct GopherScheme
+    {
+        static constexpr Uri::SchemePolicy POLICY{"gopher", true, 70, true, false};
+    };
+}
+
+TEST(SchemeRegistryTests, BuiltInSchemesAreFoundCaseInsensitively)
+{
+    const auto http = Uri::SchemeRegistry::Find("HtTp");
+    ASSERT_TRUE(http != nullptr);
+    ASSERT_EQ("http", http->name);
+    ASSERT_TRUE(http->has_default_port);
+    ASSERT_EQ(80, http->default_port);
+    ASSERT_TRUE(http->requires_host);
+    ASSERT_EQ(443, Uri::SchemeRegistry::Find("wss")->default_port);
+    ASSERT_FALSE(Uri::SchemeRegistry::Find("file")->has_default_port);
+    ASSERT_TRUE(Uri::SchemeRegistry::Find("htt") == nullptr);
+    ASSERT_TRUE(Uri::SchemeRegistry::Find("") == nullptr);
+}
+
+TEST(SchemeRegistryTests, RegisterCustomScheme)
+{
+    ASSERT_TRUE(Uri::SchemeRegistry::Find("gopher") == nullptr);
+    ASSERT_TRUE(Uri::SchemeRegistry::Register< GopherScheme >());
+    ASSERT_FALSE(Uri::SchemeRegistry::Register< GopherScheme >());
+    const auto gopher = Uri::SchemeRegistry::Find("GOPHER");
+    ASSERT_TRUE(gopher != nullptr);
+    ASSERT_EQ("gopher", gopher->name);
+    ASSERT_EQ(70, gopher->default_port);
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("Gopher://example.com:70"));
+    uri.Normalize();
+    ASSERT_EQ("gopher://example.com/", uri.GenerateString());
+}
+
+TEST(SchemeRegistryTests, RegisterRejectsIllegalAndBuiltInNames)
+{
+    ASSERT_FALSE(Uri::SchemeRegistry::Register(Uri::SchemePolicy{"HTTP", true, 8080}));
+    ASSERT_FALSE(Uri::SchemeRegistry::Register(Uri::SchemePolicy{"1abc"}));
+    ASSERT_FALSE(Uri::SchemeRegistry::Register(Uri::SchemePolicy{"a b"}));
+    ASSERT_FALSE(Uri::SchemeRegistry::Register(Uri::SchemePolicy{""}));
+    ASSERT_EQ(80, Uri::SchemeRegistry::Find("http")->default_port);
+}
+
+TEST(SchemeRegistryTests, NormalizeDropsDefaultPortsOnly)
+{
+    struct TestVector
+    {
+        std::string uri_string;
+        std::string normalized;
+    };
+    const std::vector< TestVector > test_vectors{
+        {"http://example.com:80/a/../b", "http://example.com/b"},
+        {"HTTPS://example.com:443", "https://example.com/"},
+        {"https://example.com:80/", "https://example.com:80/"},
+        {"ws://example.com:80/socket", "ws://example.com/socket"},
+        {"wss://example.com:443/socket", "wss://example.com/socket"},
+        {"ftp://example.com:21/", "ftp://example.com/"},
+        {"gopher://example.com:21/", "gopher://example.com:21/"},
+        {"file:/etc/./hosts", "file:/etc/hosts"},
+        {"/a/./b", "/a/b"},
+    };
+    for (const auto& test_vector: test_vectors)
+    {
+        Uri::Uri uri;
+        ASSERT_TRUE(uri.ParseFromString(test_vector.uri_string)) << test_vector.uri_string;
+        uri.Normalize();
+        ASSERT_EQ(test_vector.normalized, uri.GenerateString()) << test_vector.uri_string;
+    }
+    Uri::Uri uri;
+    uri.SetScheme("http");
+    uri.SetHost("example.com");
+    uri.Normalize();
+    ASSERT_EQ((std::vector< std::string >{""}), uri.GetPath());
+}
+
+TEST(SchemeRegistryTests, IsValidForScheme)
+{
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://example.com/"));
+    ASSERT_TRUE(uri.IsValidForScheme());
+    ASSERT_TRUE(uri.ParseFromString("http:/no/host"));
+    ASSERT_FALSE(uri.IsValidForScheme());
+    ASSERT_TRUE(uri.ParseFromString("file:/etc/hosts"));
+    ASSERT_TRUE(uri.IsValidForScheme());
+    ASSERT_TRUE(uri.ParseFromString("urn:isbn:0451450523"));
+    ASSERT_TRUE(uri.IsValidForScheme());
+}
+
+TEST(SchemeRegistryTests, ParsedSchemesAreLowerCaseAndIndependent)
+{
+    Uri::Uri first, second;
+    ASSERT_TRUE(first.ParseFromString("HTTP://example.com/"));
+    ASSERT_TRUE(second.ParseFromString("http://example.com/"));
+    ASSERT_EQ("http", first.GetScheme());
+    ASSERT_EQ(first, second);
+    first.SetScheme("https");
+    ASSERT_EQ("http", second.GetScheme());
+    ASSERT_EQ("http", Uri::SchemeRegistry::Find("http")->name);
+}
+
+TEST(SchemeRegistryTests, ConcurrentLookupsAndRegistrations)
+{
+    std::vector< std::thread > threads;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([i]{
+            const auto name = "custom" + std::to_string(i);
+            ASSERT_TRUE(Uri::SchemeRegistry::Register(Uri::SchemePolicy{name, true, (uint16_t)(1000 + i)}));
+            for (size_t j = 0; j < 1000; ++j)
+            {
+                Uri::Uri uri;
+                ASSERT_TRUE(uri.ParseFromString("HTTPS://example.com/" + std::to_string(j)));
+                ASSERT_EQ("https", uri.GetSchemeView());
+            }
+            ASSERT_EQ(1000 + i, Uri::SchemeRegistry::Find(name)->default_port);
+        });
+    }
+    for (auto& thread: threads)
+    {
+        thread.join();
+    }
+}
+
+TEST(SchemeRegistryTests, SchemeIds)
+{
+    typedef Uri::SchemeRegistry Registry;
+    const std::vector< std::pair< std::string, Uri::SchemeId > > builtins{
+        {"HTTP", Uri::HttpScheme::ID},
+        {"https", Uri::HttpsScheme::ID},
+        {"Ws", Uri::WsScheme::ID},
+        {"wsS", Uri::WssScheme::ID},
+        {"ftp", Uri::FtpScheme::ID},
+        {"FILE", Uri::FileScheme::ID},
+        {"mailto", Uri::MailtoScheme::ID},
+        {"urn", Uri::UrnScheme::ID},
+        {"data", Uri::DataScheme::ID},
+    };
+    for (const auto& builtin: builtins)
+    {
+        ASSERT_EQ(builtin.second, Registry::FindId(builtin.first)) << builtin.first;
+        ASSERT_EQ(Registry::Find(builtin.first), Registry::Find(builtin.second)) << builtin.first;
+    }
+    ASSERT_EQ(Registry::NO_SCHEME, Registry::FindId(""));
+    for (const auto* unknown: {"htt", "httpx", "h\x08tp", "wsx", "urm", "mailtoo", "dat\x01"})
+    {
+        ASSERT_EQ(Registry::UNREGISTERED_SCHEME, Registry::FindId(unknown)) << unknown;
+    }
+    ASSERT_TRUE(Registry::Find(Registry::NO_SCHEME) == nullptr);
+    ASSERT_TRUE(Registry::Find(Registry::UNREGISTERED_SCHEME) == nullptr);
+    ASSERT_TRUE(Registry::Find((Uri::SchemeId)60000) == nullptr);
+
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("MailTo:someone@example.com"));
+    ASSERT_EQ(Uri::MailtoScheme::ID, uri.GetSchemeId());
+    ASSERT_TRUE(uri.ParseFromString("foo:bar"));
+    ASSERT_EQ(Registry::UNREGISTERED_SCHEME, uri.GetSchemeId());
+    ASSERT_TRUE(uri.ParseFromString("/just/a/path"));
+    ASSERT_EQ(Registry::NO_SCHEME, uri.GetSchemeId());
+    uri.SetScheme("https");
+    ASSERT_EQ(Uri::HttpsScheme::ID, uri.GetSchemeId());
+    uri.SetScheme("HTTPS");
+    ASSERT_EQ(Registry::UNREGISTERED_SCHEME, uri.GetSchemeId());
+}
+
+TEST(SchemeRegistryTests, CustomSchemeIdsAndLateRegistration)
+{
+    typedef Uri::SchemeRegistry Registry;
+    Uri::Uri before;
+    ASSERT_TRUE(before.ParseFromString("Svn+SSH://example.com:22/repo"));
+    ASSERT_EQ(Registry::UNREGISTERED_SCHEME, before.GetSchemeId());
+    ASSERT_TRUE(Registry::Register(Uri::SchemePolicy{"svn+ssh", true, 22, true, true}));
+    const auto id = Registry::FindId("SVN+SSH");
+    ASSERT_GE(id, Registry::FIRST_CUSTOM_SCHEME);
+    ASSERT_EQ(22, Registry::Find(id)->default_port);
+
+    Uri::Uri after;
+    ASSERT_TRUE(after.ParseFromString("svn+ssh://example.com:22/repo"));
+    ASSERT_EQ(id, after.GetSchemeId());
+    ASSERT_EQ(before, after);
+    before.Normalize();
+    ASSERT_EQ("svn+ssh://example.com/repo", before.GenerateString());
+    after.SetScheme("http");
+    ASSERT_NE(before, after);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <Uri/SeenSet.hpp>
+#include <Uri/Uri.hpp>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+TEST(SeenSetTests, InsertDetectsDuplicatesAfterNormalization)
+{
+    Uri::SeenSet seen_set;
+    ASSERT_EQ(Uri::SeenSet::InsertResult::INSERTED, seen_set.Insert(std::string("http://www.example.com/a/b")));
+    ASSERT_EQ(Uri::SeenSet::InsertResult::ALREADY_PRESENT, seen_set.Insert(std::string("HTTP://WWW.Example.com/a/./c/../b")));
+    ASSERT_EQ(Uri::SeenSet::InsertResult::ALREADY_PRESENT, seen_set.Insert(std::string("http://www.example.com/%61/b")));
+    ASSERT_EQ(Uri::SeenSet::InsertResult::INSERTED, seen_set.Insert(std::string("http://www.example.com/a/b?q")));
+    ASSERT_EQ(Uri::SeenSet::InsertResult::INVALID_URI, seen_set.Insert(std::string("http://www.example.com/[")));
+    ASSERT_EQ(2, seen_set.Size());
+
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://www.example.com/a/b/../b"));
+    ASSERT_TRUE(seen_set.Contains(uri));
+    ASSERT_EQ(Uri::SeenSet::InsertResult::ALREADY_PRESENT, seen_set.Insert(uri));
+    ASSERT_TRUE(uri.ParseFromString("http://www.example.com/c"));
+    ASSERT_FALSE(seen_set.Contains(uri));
+    ASSERT_EQ(Uri::SeenSet::InsertResult::INSERTED, seen_set.Insert(uri));
+    ASSERT_TRUE(seen_set.Contains(std::string("http://www.example.com/c")));
+}
+
+TEST(SeenSetTests, GrowsAndKeepsEverything)
+{
+    for (auto bits: {Uri::SeenSet::FingerprintBits::BITS_64, Uri::SeenSet::FingerprintBits::BITS_128})
+    {
+        Uri::SeenSet seen_set(0, bits);
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            ASSERT_EQ(Uri::SeenSet::InsertResult::INSERTED,
+                      seen_set.Insert("http://example.com/" + std::to_string(i))) << i;
+        }
+        ASSERT_EQ(10000, seen_set.Size());
+        ASSERT_GE(seen_set.Capacity(), seen_set.Size());
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            ASSERT_TRUE(seen_set.Contains("http://example.com/" + std::to_string(i))) << i;
+        }
+        ASSERT_FALSE(seen_set.Contains(std::string("http://example.com/10000")));
+        ASSERT_EQ(bits, seen_set.GetFingerprintBits());
+    }
+}
+
+TEST(SeenSetTests, InsertAllReportsPerUriResults)
+{
+    Uri::SeenSet seen_set;
+    ASSERT_EQ(Uri::SeenSet::InsertResult::INSERTED, seen_set.Insert(std::string("http://example.com/old")));
+    const std::vector< std::string > uris
+    {
+        "http://example.com/new",
+        "http://example.com/old",
+        "http://EXAMPLE.com/new",
+        "/[",
+        "http://example.com/other",
+    };
+    std::vector< Uri::SeenSet::InsertResult > results;
+    ASSERT_EQ(2, seen_set.InsertAll(uris, results));
+    ASSERT_EQ((std::vector< Uri::SeenSet::InsertResult >{
+        Uri::SeenSet::InsertResult::INSERTED,
+        Uri::SeenSet::InsertResult::ALREADY_PRESENT,
+        Uri::SeenSet::InsertResult::ALREADY_PRESENT,
+        Uri::SeenSet::InsertResult::INVALID_URI,
+        Uri::SeenSet::InsertResult::INSERTED,
+    }), results);
+
+    std::vector< Uri::Uri > parsed(2);
+    ASSERT_TRUE(parsed[0].ParseFromString("http://example.com/other"));
+    ASSERT_TRUE(parsed[1].ParseFromString("http://example.com/fresh"));
+    ASSERT_EQ(1, seen_set.InsertAll(parsed, results));
+    ASSERT_EQ(Uri::SeenSet::InsertResult::ALREADY_PRESENT, results[0]);
+    ASSERT_EQ(Uri::SeenSet::InsertResult::INSERTED, results[1]);
+    ASSERT_EQ(4, seen_set.Size());
+}
+
+TEST(SeenSetTests, SaveAndLoad)
+{
+    const std::string file_path = testing::TempDir() + "SeenSetTests.SaveAndLoad.bin";
+    for (auto bits: {Uri::SeenSet::FingerprintBits::BITS_64, Uri::SeenSet::FingerprintBits::BITS_128})
+    {
+        Uri::SeenSet seen_set(0, bits);
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            (void)seen_set.Insert("http://example.com/" + std::to_string(i));
+        }
+        ASSERT_TRUE(seen_set.SaveToFile(file_path));
+
+        Uri::SeenSet loaded;
+        ASSERT_TRUE(loaded.LoadFromFile(file_path));
+        ASSERT_EQ(seen_set.Size(), loaded.Size());
+        ASSERT_EQ(bits, loaded.GetFingerprintBits());
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            ASSERT_TRUE(loaded.Contains("http://example.com/" + std::to_string(i))) << i;
+        }
+        ASSERT_EQ(Uri::SeenSet::InsertResult::INSERTED, loaded.Insert(std::string("http://example.com/new")));
+    }
+    (void)remove(file_path.c_str());
+}
+
+TEST(SeenSetTests, LoadRejectsBadFiles)
+{
+    const std::string file_path = testing::TempDir() + "SeenSetTests.LoadRejectsBadFiles.bin";
+    FILE* file = fopen(file_path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    fputs("not a seen set", file);
+    fclose(file);
+    Uri::SeenSet seen_set;
+    (void)seen_set.Insert(std::string("http://example.com/"));
+    ASSERT_FALSE(seen_set.LoadFromFile(file_path));
+    ASSERT_FALSE(seen_set.LoadFromFile(file_path + ".missing"));
+    ASSERT_EQ(1, seen_set.Size());
+
+    // A header whose capacity the file is too short for.
+    ASSERT_TRUE(seen_set.SaveToFile(file_path));
+    std::string contents;
+    file = fopen(file_path.c_str(), "rb");
+    ASSERT_NE(nullptr, file);
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        contents.append(buffer, length);
+    }
+    fclose(file);
+    const size_t capacity_offset = 16;
+    const uint64_t huge_capacity = (uint64_t)1 << 62;
+    auto corrupt = contents;
+    memcpy(&corrupt[capacity_offset], &huge_capacity, sizeof(huge_capacity));
+    for (const auto& bad_contents: {corrupt, contents.substr(0, contents.length() - 1)})
+    {
+        file = fopen(file_path.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        (void)fwrite(bad_contents.data(), 1, bad_contents.length(), file);
+        fclose(file);
+        ASSERT_FALSE(seen_set.LoadFromFile(file_path));
+        ASSERT_EQ(1, seen_set.Size());
+    }
+    (void)remove(file_path.c_str());
+}
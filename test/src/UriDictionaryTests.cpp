@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include <Uri/Uri.hpp>
+#include <Uri/UriDictionary.hpp>
+#include <algorithm>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector< std::string > MakeUris()
+    {
+        std::vector< std::string > uris;
+        for (size_t i = 0; i < 300; ++i)
+        {
+            uris.push_back(
+                "https://www.example.com/products/" + std::to_string(i % 7)
+                + "/item-" + std::to_string(i) + ((i % 5 == 0) ? "?color=red" : "")
+            );
+        }
+        uris.push_back("https://www.example.org/");
+        uris.push_back("mailto:someone@example.com");
+        uris.push_back("http://user@[::1]:8080/a%20b?q#frag");
+        uris.push_back("urn:book:fantasy:Hobbit");
+        return uris;
+    }
+}
+
+TEST(UriDictionaryTests, FindAndGetStringRoundTrip)
+{
+    auto uris = MakeUris();
+    for (size_t block_size: {1, 3, 16, 1000})
+    {
+        Uri::UriDictionary dictionary;
+        ASSERT_TRUE(dictionary.Build(uris, block_size));
+        ASSERT_EQ(uris.size(), dictionary.Size());
+        std::vector< std::string > serialized;
+        for (const auto& uri_string: uris)
+        {
+            Uri::Uri uri;
+            ASSERT_TRUE(uri.ParseFromString(uri_string));
+            serialized.push_back(uri.GenerateString());
+            size_t id;
+            ASSERT_TRUE(dictionary.Find(uri_string, id)) << uri_string;
+            ASSERT_TRUE(dictionary.Find(uri, id)) << uri_string;
+            std::string stored;
+            ASSERT_TRUE(dictionary.GetString(id, stored));
+            ASSERT_EQ(serialized.back(), stored);
+        }
+        std::sort(serialized.begin(), serialized.end());
+        for (size_t id = 0; id < serialized.size(); ++id)
+        {
+            std::string stored;
+            ASSERT_TRUE(dictionary.GetString(id, stored));
+            ASSERT_EQ(serialized[id], stored) << id;
+        }
+        size_t id;
+        ASSERT_FALSE(dictionary.Find(std::string("https://www.example.com/products/"), id));
+        ASSERT_FALSE(dictionary.Find(std::string("zzz:last"), id));
+        ASSERT_FALSE(dictionary.Find(std::string("aaa:first"), id));
+        ASSERT_FALSE(dictionary.Find(std::string("/["), id));
+        std::string stored;
+        ASSERT_FALSE(dictionary.GetString(dictionary.Size(), stored));
+    }
+}
+
+TEST(UriDictionaryTests, FindNormalizesLikeTheSerializer)
+{
+    Uri::UriDictionary dictionary;
+    ASSERT_TRUE(dictionary.Build(std::vector< std::string >{
+        "HTTP://WWW.Example.COM/%61",
+        "http://www.example.com/a",
+        "http://www.example.com/b",
+    }));
+    ASSERT_EQ(2, dictionary.Size());
+    size_t id;
+    ASSERT_TRUE(dictionary.Find(std::string("http://www.EXAMPLE.com/a"), id));
+    ASSERT_EQ(0, id);
+    ASSERT_TRUE(dictionary.Find(std::string("http://www.example.com/%62"), id));
+    ASSERT_EQ(1, id);
+    ASSERT_FALSE(dictionary.Build(std::vector< std::string >{"http://example.com/", "/["}));
+    ASSERT_EQ(2, dictionary.Size());
+}
+
+TEST(UriDictionaryTests, GetUriMatchesParseFromString)
+{
+    const auto uris = MakeUris();
+    Uri::UriDictionary dictionary;
+    ASSERT_TRUE(dictionary.Build(uris));
+    for (size_t id = 0; id < dictionary.Size(); ++id)
+    {
+        std::string stored;
+        ASSERT_TRUE(dictionary.GetString(id, stored));
+        Uri::Uri expected, decoded;
+        ASSERT_TRUE(expected.ParseFromString(stored));
+        ASSERT_TRUE(dictionary.GetUri(id, decoded)) << stored;
+        ASSERT_EQ(expected, decoded) << stored;
+    }
+    Uri::Uri uri;
+    ASSERT_FALSE(dictionary.GetUri(dictionary.Size(), uri));
+}
+
+TEST(UriDictionaryTests, BuildFromUris)
+{
+    std::vector< Uri::Uri > uris(3);
+    ASSERT_TRUE(uris[0].ParseFromString("http://example.com/b"));
+    ASSERT_TRUE(uris[1].ParseFromString("http://example.com/a?x#y"));
+    ASSERT_TRUE(uris[2].ParseFromString("http://example.com/b"));
+    Uri::UriDictionary dictionary;
+    ASSERT_TRUE(dictionary.Build(uris, 2));
+    ASSERT_EQ(2, dictionary.Size());
+    size_t id;
+    ASSERT_TRUE(dictionary.Find(uris[1], id));
+    ASSERT_EQ(0, id);
+    Uri::Uri decoded;
+    ASSERT_TRUE(dictionary.GetUri(id, decoded));
+    ASSERT_EQ(uris[1], decoded);
+}
+
+TEST(UriDictionaryTests, FindPrefix)
+{
+    const auto uris = MakeUris();
+    Uri::UriDictionary dictionary;
+    ASSERT_TRUE(dictionary.Build(uris, 8));
+    for (const std::string prefix: {
+        "https://www.example.com/products/3/",
+        "https://www.example.com/",
+        "https://www.example.",
+        "http",
+        "urn:",
+        "",
+    })
+    {
+        size_t expected_count = 0;
+        for (size_t id = 0; id < dictionary.Size(); ++id)
+        {
+            std::string stored;
+            ASSERT_TRUE(dictionary.GetString(id, stored));
+            if (stored.compare(0, prefix.length(), prefix) == 0)
+            {
+                ++expected_count;
+            }
+        }
+        size_t first, last;
+        ASSERT_TRUE(dictionary.FindPrefix(prefix, first, last)) << prefix;
+        ASSERT_EQ(expected_count, last - first) << prefix;
+        for (size_t id = first; id < last; ++id)
+        {
+            std::string stored;
+            ASSERT_TRUE(dictionary.GetString(id, stored));
+            ASSERT_EQ(0, stored.compare(0, prefix.length(), prefix)) << prefix;
+        }
+    }
+    size_t first, last;
+    ASSERT_FALSE(dictionary.FindPrefix("ftp://", first, last));
+    ASSERT_EQ(first, last);
+    ASSERT_FALSE(Uri::UriDictionary().FindPrefix("", first, last));
+}
+
+TEST(UriDictionaryTests, SaveAndLoad)
+{
+    const std::string file_path = testing::TempDir() + "UriDictionaryTests.SaveAndLoad.bin";
+    const auto uris = MakeUris();
+    Uri::UriDictionary dictionary;
+    ASSERT_TRUE(dictionary.Build(uris, 5));
+    ASSERT_TRUE(dictionary.SaveToFile(file_path));
+
+    Uri::UriDictionary loaded;
+    ASSERT_TRUE(loaded.LoadFromFile(file_path));
+    ASSERT_EQ(dictionary.Size(), loaded.Size());
+    ASSERT_EQ(5, loaded.GetBlockSize());
+    for (size_t id = 0; id < dictionary.Size(); ++id)
+    {
+        std::string expected, stored;
+        ASSERT_TRUE(dictionary.GetString(id, expected));
+        ASSERT_TRUE(loaded.GetString(id, stored));
+        ASSERT_EQ(expected, stored);
+        size_t found_id;
+        ASSERT_TRUE(loaded.Find(stored, found_id));
+        ASSERT_EQ(id, found_id);
+    }
+    const auto copy = loaded;
+    ASSERT_EQ(loaded.Size(), copy.Size());
+
+    ASSERT_TRUE(Uri::UriDictionary().SaveToFile(file_path));
+    ASSERT_TRUE(loaded.LoadFromFile(file_path));
+    ASSERT_EQ(0, loaded.Size());
+    (void)remove(file_path.c_str());
+}
+
+TEST(UriDictionaryTests, LoadRejectsBadFiles)
+{
+    const std::string file_path = testing::TempDir() + "UriDictionaryTests.LoadRejectsBadFiles.bin";
+    FILE* file = fopen(file_path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    fputs("not a dictionary, not even close to one", file);
+    fclose(file);
+    Uri::UriDictionary dictionary;
+    ASSERT_TRUE(dictionary.Build(std::vector< std::string >{"http://example.com/"}));
+    ASSERT_FALSE(dictionary.LoadFromFile(file_path));
+    ASSERT_FALSE(dictionary.LoadFromFile(file_path + ".missing"));
+    ASSERT_EQ(1, dictionary.Size());
+
+    // Headers whose size doesn't fit their blocks, one of them because
+    // rounding it up to whole blocks wraps around.
+    ASSERT_TRUE(Uri::UriDictionary().SaveToFile(file_path));
+    std::string contents;
+    file = fopen(file_path.c_str(), "rb");
+    ASSERT_NE(nullptr, file);
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        contents.append(buffer, length);
+    }
+    fclose(file);
+    const size_t block_size_offset = 12;
+    const size_t size_offset = 16;
+    const uint32_t block_size = 2;
+    for (const uint64_t size: {(uint64_t)1, (uint64_t)UINT64_MAX, (uint64_t)UINT64_MAX - 1})
+    {
+        auto corrupt = contents;
+        memcpy(&corrupt[block_size_offset], &block_size, sizeof(block_size));
+        memcpy(&corrupt[size_offset], &size, sizeof(size));
+        file = fopen(file_path.c_str(), "wb");
+        ASSERT_NE(nullptr, file);
+        (void)fwrite(corrupt.data(), 1, corrupt.length(), file);
+        fclose(file);
+        ASSERT_FALSE(dictionary.LoadFromFile(file_path)) << size;
+        ASSERT_EQ(1, dictionary.Size());
+    }
+    (void)remove(file_path.c_str());
+}
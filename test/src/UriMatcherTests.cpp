@@ -0,0 +1,200 @@
+#include <atomic>
+#include <gtest/gtest.h>
+#include <Uri/Uri.hpp>
+#include <Uri/UriMatcher.hpp>
+#include <Uri/UriView.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    typedef Uri::UriMatcher::Action Action;
+
+    struct Pattern
+    {
+        std::string pattern;
+        Action action;
+    };
+
+    std::vector< Uri::UriMatcher::Rule > MakeRules(const std::vector< Pattern >& patterns)
+    {
+        std::vector< Uri::UriMatcher::Rule > rules;
+        for (const auto& pattern: patterns)
+        {
+            rules.emplace_back();
+            EXPECT_TRUE(Uri::UriMatcher::ParseRule(pattern.pattern, pattern.action, rules.back()))
+                << pattern.pattern;
+        }
+        return rules;
+    }
+
+    size_t FindRule(const Uri::UriMatcher& matcher, const std::string& uri_string)
+    {
+        Uri::Uri uri;
+        EXPECT_TRUE(uri.ParseFromString(uri_string)) << uri_string;
+        Uri::UriView view;
+        EXPECT_TRUE(view.ParseFromString(uri_string)) << uri_string;
+        const auto rule_index = matcher.FindRule(uri);
+        EXPECT_EQ(rule_index, matcher.FindRule(view)) << uri_string;
+        return rule_index;
+    }
+}
+
+TEST(UriMatcherTests, ParseRule)
+{
+    Uri::UriMatcher::Rule rule;
+    ASSERT_TRUE(Uri::UriMatcher::ParseRule("HTTPS://*.Example.com/api/v1/", Action::ALLOW, rule));
+    ASSERT_EQ("https", rule.scheme);
+    ASSERT_EQ("*.example.com", rule.host);
+    ASSERT_EQ((std::vector< std::string >{"api", "v1"}), rule.path_prefix);
+    ASSERT_EQ(Action::ALLOW, rule.action);
+
+    ASSERT_TRUE(Uri::UriMatcher::ParseRule("//example.com", Action::DENY, rule));
+    ASSERT_EQ("", rule.scheme);
+    ASSERT_EQ("example.com", rule.host);
+    ASSERT_TRUE(rule.path_prefix.empty());
+
+    ASSERT_FALSE(Uri::UriMatcher::ParseRule("/no/host", Action::DENY, rule));
+    ASSERT_FALSE(Uri::UriMatcher::ParseRule("http://exa mple.com/", Action::DENY, rule));
+}
+
+TEST(UriMatcherTests, EmptyMatcherAllowsEverything)
+{
+    Uri::UriMatcher matcher;
+    ASSERT_EQ(0, matcher.Size());
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://www.example.com/"));
+    ASSERT_EQ(Uri::UriMatcher::NO_RULE, matcher.FindRule(uri));
+    ASSERT_EQ(Action::ALLOW, matcher.Match(uri));
+
+    ASSERT_TRUE(matcher.Build({}));
+    ASSERT_EQ(Action::DENY, matcher.Match(uri));
+}
+
+TEST(UriMatcherTests, HostPatterns)
+{
+    Uri::UriMatcher matcher;
+    ASSERT_TRUE(matcher.Build(MakeRules({
+        {"//example.com", Action::ALLOW},
+        {"//*.example.com", Action::ALLOW},
+        {"//*.ads.example.com", Action::DENY},
+        {"//*", Action::DENY},
+        {"//login.ads.example.com", Action::ALLOW},
+    }), Action::ALLOW));
+    ASSERT_EQ(5, matcher.Size());
+    ASSERT_EQ(0, FindRule(matcher, "http://example.com/"));
+    ASSERT_EQ(0, FindRule(matcher, "http://EXAMPLE.com/"));
+    ASSERT_EQ(1, FindRule(matcher, "http://www.example.com/"));
+    ASSERT_EQ(1, FindRule(matcher, "http://ads.example.com/"));
+    ASSERT_EQ(2, FindRule(matcher, "http://x.ads.example.com/"));
+    ASSERT_EQ(2, FindRule(matcher, "http://y.x.ads.example.com/"));
+    ASSERT_EQ(4, FindRule(matcher, "http://login.ads.example.com/"));
+    ASSERT_EQ(3, FindRule(matcher, "http://example.org/"));
+    ASSERT_EQ(3, FindRule(matcher, "http://badexample.com/"));
+    ASSERT_EQ(3, FindRule(matcher, "mailto:someone"));
+    ASSERT_EQ(3, FindRule(matcher, "http://[::1]/"));
+
+    ASSERT_FALSE(matcher.Build(MakeRules({
+        {"//example.*", Action::ALLOW},
+    })));
+    ASSERT_EQ(5, matcher.Size());
+    Uri::UriMatcher::Rule rule;
+    rule.host = "a..b";
+    ASSERT_FALSE(matcher.Build({rule}));
+    rule.host = "*.";
+    ASSERT_FALSE(matcher.Build({rule}));
+    rule.host = "";
+    ASSERT_FALSE(matcher.Build({rule}));
+    rule.host = "example.com";
+    rule.scheme = "1http";
+    ASSERT_FALSE(matcher.Build({rule}));
+    ASSERT_EQ(5, matcher.Size());
+}
+
+TEST(UriMatcherTests, PathPrefixesAndSchemes)
+{
+    Uri::UriMatcher matcher;
+    ASSERT_TRUE(matcher.Build(MakeRules({
+        {"//example.com", Action::ALLOW},
+        {"//example.com/admin", Action::DENY},
+        {"//example.com/admin/public/", Action::ALLOW},
+        {"http://example.com/admin/public", Action::DENY},
+        {"https://example.com/admin", Action::ALLOW},
+        {"//example.com/admin", Action::ALLOW},
+        {"//*/private", Action::DENY},
+    })));
+    ASSERT_EQ(0, FindRule(matcher, "https://example.com/"));
+    ASSERT_EQ(0, FindRule(matcher, "https://example.com/administrator"));
+    ASSERT_EQ(4, FindRule(matcher, "https://example.com/admin"));
+    ASSERT_EQ(4, FindRule(matcher, "HTTPS://example.com/admin/x"));
+    ASSERT_EQ(1, FindRule(matcher, "ftp://example.com/admin/x"));
+    ASSERT_EQ(2, FindRule(matcher, "https://example.com/admin/public/page"));
+    ASSERT_EQ(3, FindRule(matcher, "http://example.com/admin/public/page"));
+    ASSERT_EQ(0, FindRule(matcher, "http://example.com/private"));
+    ASSERT_EQ(6, FindRule(matcher, "http://example.org/private/key"));
+    ASSERT_EQ(Uri::UriMatcher::NO_RULE, FindRule(matcher, "http://example.org/public"));
+}
+
+TEST(UriMatcherTests, PercentEncodedPaths)
+{
+    Uri::UriMatcher matcher;
+    Uri::UriMatcher::Rule rule;
+    rule.host = "example.com";
+    rule.path_prefix = {"a b", "c/d"};
+    ASSERT_TRUE(matcher.Build({rule}, Action::ALLOW));
+    ASSERT_EQ(0, FindRule(matcher, "http://example.com/a%20b/c%2Fd/e"));
+    ASSERT_EQ(0, FindRule(matcher, "http://example.com/a%20b/c%2fd"));
+    ASSERT_EQ(Uri::UriMatcher::NO_RULE, FindRule(matcher, "http://example.com/a%20b/c/d"));
+}
+
+TEST(UriMatcherTests, BatchMatch)
+{
+    Uri::UriMatcher matcher;
+    ASSERT_TRUE(matcher.Build(MakeRules({
+        {"//*.example.com", Action::ALLOW},
+    })));
+    std::vector< Uri::Uri > uris(3);
+    ASSERT_TRUE(uris[0].ParseFromString("http://www.example.com/"));
+    ASSERT_TRUE(uris[1].ParseFromString("http://www.example.org/"));
+    ASSERT_TRUE(uris[2].ParseFromString("urn:example:x"));
+    std::vector< Action > actions;
+    matcher.Match(uris, actions);
+    ASSERT_EQ((std::vector< Action >{Action::ALLOW, Action::DENY, Action::DENY}), actions);
+}
+
+TEST(UriMatcherTests, RebuildWhileMatching)
+{
+    Uri::UriMatcher matcher;
+    const auto allow_rules = MakeRules({{"//example.com", Action::ALLOW}});
+    const auto deny_rules = MakeRules({{"//example.com", Action::DENY}});
+    ASSERT_TRUE(matcher.Build(allow_rules));
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("http://example.com/"));
+    std::atomic< bool > done(false);
+    std::atomic< size_t > mismatches(0);
+    std::vector< std::thread > workers;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        workers.emplace_back([&]{
+            while (!done)
+            {
+                if (matcher.FindRule(uri) != 0)
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (size_t i = 0; i < 200; ++i)
+    {
+        EXPECT_TRUE(matcher.Build(((i % 2) == 0) ? deny_rules : allow_rules));
+    }
+    done = true;
+    for (auto& worker: workers)
+    {
+        worker.join();
+    }
+    ASSERT_EQ(0, mismatches);
+    ASSERT_EQ(Action::ALLOW, matcher.Match(uri));
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <Uri/Uri.hpp>
+#include <Uri/UriTemplate.hpp>
+#include <vector>
+
+namespace
+{
+    typedef Uri::UriTemplate::Value Value;
+
+    // The example variables of RFC 6570 section 3.2.
+    const Uri::UriTemplate::Variables& GetRfcVariables()
+    {
+        static const Uri::UriTemplate::Variables variables{
+            {"count", Value(std::vector< std::string_view >{"one", "two", "three"})},
+            {"dom", Value(std::vector< std::string_view >{"example", "com"})},
+            {"dub", "me/too"},
+            {"hello", "Hello World!"},
+            {"half", "50%"},
+            {"var", "value"},
+            {"who", "fred"},
+            {"base", "http://example.com/home/"},
+            {"path", "/foo/bar"},
+            {"list", Value(std::vector< std::string_view >{"red", "green", "blue"})},
+            {"keys", Value(std::vector< std::pair< std::string_view, std::string_view > >{
+                {"semi", ";"}, {"dot", "."}, {"comma", ","}
+            })},
+            {"v", "6"},
+            {"x", "1024"},
+            {"y", "768"},
+            {"empty", ""},
+            {"empty_keys", Value(std::vector< std::pair< std::string_view, std::string_view > >{})},
+            {"undef", Value()},
+        };
+        return variables;
+    }
+
+    struct TestVector
+    {
+        std::string template_string;
+        std::string expansion;
+    };
+
+    // RFC 6570 sections 3.2.2 through 3.2.9.
+    const std::vector< TestVector > RFC_TEST_VECTORS{
+        {"{var}", "value"},
+        {"{hello}", "Hello%20World%21"},
+        {"{half}", "50%25"},
+        {"O{empty}X", "OX"},
+        {"O{undef}X", "OX"},
+        {"{x,y}", "1024,768"},
+        {"{x,hello,y}", "1024,Hello%20World%21,768"},
+        {"?{x,empty}", "?1024,"},
+        {"?{x,undef}", "?1024"},
+        {"?{undef,y}", "?768"},
+        {"{var:3}", "val"},
+        {"{var:30}", "value"},
+        {"{list}", "red,green,blue"},
+        {"{list*}", "red,green,blue"},
+        {"{keys}", "semi,%3B,dot,.,comma,%2C"},
+        {"{keys*}", "semi=%3B,dot=.,comma=%2C"},
+        {"{+var}", "value"},
+        {"{+hello}", "Hello%20World!"},
+        {"{+half}", "50%25"},
+        {"{base}index", "http%3A%2F%2Fexample.com%2Fhome%2Findex"},
+        {"{+base}index", "http://example.com/home/index"},
+        {"O{+empty}X", "OX"},
+        {"{+path}/here", "/foo/bar/here"},
+        {"here?ref={+path}", "here?ref=/foo/bar"},
+        {"up{+path}{var}/here", "up/foo/barvalue/here"},
+        {"{+x,hello,y}", "1024,Hello%20World!,768"},
+        {"{+path,x}/here", "/foo/bar,1024/here"},
+        {"{+path:6}/here", "/foo/b/here"},
+        {"{+list}", "red,green,blue"},
+        {"{+list*}", "red,green,blue"},
+        {"{+keys}", "semi,;,dot,.,comma,,"},
+        {"{+keys*}", "semi=;,dot=.,comma=,"},
+        {"{#var}", "#value"},
+        {"{#hello}", "#Hello%20World!"},
+        {"{#half}", "#50%25"},
+        {"foo{#empty}", "foo#"},
+        {"foo{#undef}", "foo"},
+        {"{#x,hello,y}", "#1024,Hello%20World!,768"},
+        {"{#path,x}/here", "#/foo/bar,1024/here"},
+        {"{#path:6}/here", "#/foo/b/here"},
+        {"{#list}", "#red,green,blue"},
+        {"{#list*}", "#red,green,blue"},
+        {"{#keys}", "#semi,;,dot,.,comma,,"},
+        {"{#keys*}", "#semi=;,dot=.,comma=,"},
+        {"{.who}", ".fred"},
+        {"{.who,who}", ".fred.fred"},
+        {"{.half,who}", ".50%25.fred"},
+        {"www{.dom*}", "www.example.com"},
+        {"X{.var}", "X.value"},
+        {"X{.empty}", "X."},
+        {"X{.undef}", "X"},
+        {"X{.var:3}", "X.val"},
+        {"X{.list}", "X.red,green,blue"},
+        {"X{.list*}", "X.red.green.blue"},
+        {"X{.keys}", "X.semi,%3B,dot,.,comma,%2C"},
+        {"X{.keys*}", "X.semi=%3B.dot=..comma=%2C"},
+        {"X{.empty_keys}", "X"},
+        {"X{.empty_keys*}", "X"},
+        {"{/who}", "/fred"},
+        {"{/who,who}", "/fred/fred"},
+        {"{/half,who}", "/50%25/fred"},
+        {"{/who,dub}", "/fred/me%2Ftoo"},
+        {"{/var}", "/value"},
+        {"{/var,empty}", "/value/"},
+        {"{/var,undef}", "/value"},
+        {"{/var,x}/here", "/value/1024/here"},
+        {"{/var:1,var}", "/v/value"},
+        {"{/list}", "/red,green,blue"},
+        {"{/list*}", "/red/green/blue"},
+        {"{/list*,path:4}", "/red/green/blue/%2Ffoo"},
+        {"{/keys}", "/semi,%3B,dot,.,comma,%2C"},
+        {"{/keys*}", "/semi=%3B/dot=./comma=%2C"},
+        {"{;who}", ";who=fred"},
+        {"{;half}", ";half=50%25"},
+        {"{;empty}", ";empty"},
+        {"{;v,empty,who}", ";v=6;empty;who=fred"},
+        {"{;v,bar,who}", ";v=6;who=fred"},
+        {"{;x,y}", ";x=1024;y=768"},
+        {"{;x,y,empty}", ";x=1024;y=768;empty"},
+        {"{;x,y,undef}", ";x=1024;y=768"},
+        {"{;hello:5}", ";hello=Hello"},
+        {"{;list}", ";list=red,green,blue"},
+        {"{;list*}", ";list=red;list=green;list=blue"},
+        {"{;keys}", ";keys=semi,%3B,dot,.,comma,%2C"},
+        {"{;keys*}", ";semi=%3B;dot=.;comma=%2C"},
+        {"{?who}", "?who=fred"},
+        {"{?half}", "?half=50%25"},
+        {"{?x,y}", "?x=1024&y=768"},
+        {"{?x,y,empty}", "?x=1024&y=768&empty="},
+        {"{?x,y,undef}", "?x=1024&y=768"},
+        {"{?var:3}", "?var=val"},
+        {"{?list}", "?list=red,green,blue"},
+        {"{?list*}", "?list=red&list=green&list=blue"},
+        {"{?keys}", "?keys=semi,%3B,dot,.,comma,%2C"},
+        {"{?keys*}", "?semi=%3B&dot=.&comma=%2C"},
+        {"{&who}", "&who=fred"},
+        {"{&half}", "&half=50%25"},
+        {"?fixed=yes{&x}", "?fixed=yes&x=1024"},
+        {"{&x,y,empty}", "&x=1024&y=768&empty="},
+        {"{&var:3}", "&var=val"},
+        {"{&list}", "&list=red,green,blue"},
+        {"{&list*}", "&list=red&list=green&list=blue"},
+        {"{&keys}", "&keys=semi,%3B,dot,.,comma,%2C"},
+        {"{&keys*}", "&semi=%3B&dot=.&comma=%2C"},
+    };
+}
+
+TEST(UriTemplateTests, RfcExamples)
+{
+    for (const auto& test_vector: RFC_TEST_VECTORS)
+    {
+        Uri::UriTemplate uri_template;
+        ASSERT_TRUE(uri_template.Parse(test_vector.template_string)) << test_vector.template_string;
+        std::string expansion;
+        uri_template.Expand(GetRfcVariables(), expansion);
+        ASSERT_EQ(test_vector.expansion, expansion) << test_vector.template_string;
+    }
+}
+
+TEST(UriTemplateTests, IndexedVariables)
+{
+    Uri::UriTemplate uri_template;
+    ASSERT_TRUE(uri_template.Parse("https://{host}/search{?q,lang,page}{#q}"));
+    ASSERT_EQ((std::vector< std::string >{"host", "q", "lang", "page"}), uri_template.GetVariableNames());
+    ASSERT_EQ(2, uri_template.GetVariableIndex("lang"));
+    ASSERT_EQ(Uri::UriTemplate::NO_VARIABLE, uri_template.GetVariableIndex("missing"));
+
+    std::string expansion = "previous contents";
+    uri_template.Expand(std::vector< Value >{"www.example.com", "a&b c"}, expansion);
+    ASSERT_EQ("https://www.example.com/search?q=a%26b%20c#a&b%20c", expansion);
+
+    Uri::Uri uri;
+    ASSERT_TRUE(uri_template.Expand(std::vector< Value >{"www.example.com", "x", Value(), "2"}, uri));
+    ASSERT_EQ("www.example.com", uri.GetHost());
+    ASSERT_EQ("q=x&page=2", uri.GetQuery());
+}
+
+TEST(UriTemplateTests, NonAsciiLiteralsAndPrefixes)
+{
+    Uri::UriTemplate uri_template;
+    ASSERT_TRUE(uri_template.Parse("/caf\xC3\xA9/{name:2}"));
+    std::string expansion;
+    uri_template.Expand(std::vector< Value >{"\xC3\xBC" "ber"}, expansion);
+    ASSERT_EQ("/caf%C3%A9/%C3%BCb", expansion);
+}
+
+TEST(UriTemplateTests, RejectsMalformedTemplates)
+{
+    Uri::UriTemplate uri_template;
+    ASSERT_TRUE(uri_template.Parse("/{x}"));
+    for (const auto* bad: {
+        "{", "}", "{}", "{x", "{=x}", "{|x}", "{x:0}", "{x:10000}", "{x*:3}", "{x:}",
+        "{x.}", "{x..y}", "{.x,}", "{,}", "{x y}", "a b", "a<b", "%zz", "{%2}",
+    })
+    {
+        ASSERT_FALSE(uri_template.Parse(bad)) << bad;
+    }
+    ASSERT_TRUE(uri_template.Parse("{x%20y,a.b,_1:9999}"));
+    ASSERT_EQ((std::vector< std::string >{"x%20y", "a.b", "_1"}), uri_template.GetVariableNames());
+}
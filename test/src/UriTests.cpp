@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <Uri/ResolvedBase.hpp>
 #include <Uri/Uri.hpp>
 
 TEST(UriTests, ParseFromStringNoScheme)
@@ -474,3 +475,374 @@ TEST(UriTests, ParseFromStringPathsWithPercentEncodedCharacters)
     }
 }
 
+
+TEST(UriTests, ParseFromStringQueryAndFragment)
+{
+    struct TestVector
+    {
+        std::string uri_string;
+        bool has_query;
+        std::string query;
+        bool has_fragment;
+        std::string fragment;
+    };
+    const std::vector< TestVector > test_vectors
+    {
+        {"http://www.example.com/", false, "", false, ""},
+        {"http://www.example.com/?", true, "", false, ""},
+        {"http://www.example.com/?foo=bar", true, "foo=bar", false, ""},
+        {"http://www.example.com/#frag", false, "", true, "frag"},
+        {"http://www.example.com/?foo#frag", true, "foo", true, "frag"},
+        {"?%41#%42", true, "A", true, "B"},
+    };
+    size_t index = 0;
+    for (const auto& test_vector : test_vectors)
+    {
+        Uri::Uri uri;
+        ASSERT_TRUE(uri.ParseFromString(test_vector.uri_string)) << index;
+        ASSERT_EQ(test_vector.has_query, uri.HasQuery()) << index;
+        ASSERT_EQ(test_vector.query, uri.GetQuery()) << index;
+        ASSERT_EQ(test_vector.has_fragment, uri.HasFragment()) << index;
+        ASSERT_EQ(test_vector.fragment, uri.GetFragment()) << index;
+        ++index;
+    }
+}
+
+TEST(UriTests, ResolveReferences)
+{
+    struct TestVector
+    {
+        std::string base_string;
+        std::string relative_reference_string;
+        std::string target_string;
+    };
+    const std::vector< TestVector > test_vectors
+    {
+        {"http://a/b/c/d;p?q", "g:h", "g:h"},
+        {"http://a/b/c/d;p?q", "g", "http://a/b/c/g"},
+        {"http://a/b/c/d;p?q", "./g", "http://a/b/c/g"},
+        {"http://a/b/c/d;p?q", "g/", "http://a/b/c/g/"},
+        {"http://a/b/c/d;p?q", "/g", "http://a/g"},
+        {"http://a/b/c/d;p?q", "//g", "http://g/"},
+        {"http://a/b/c/d;p?q", "?y", "http://a/b/c/d;p?y"},
+        {"http://a/b/c/d;p?q", "g?y", "http://a/b/c/g?y"},
+        {"http://a/b/c/d;p?q", "#s", "http://a/b/c/d;p?q#s"},
+        {"http://a/b/c/d;p?q", "g#s", "http://a/b/c/g#s"},
+        {"http://a/b/c/d;p?q", "g?y#s", "http://a/b/c/g?y#s"},
+        {"http://a/b/c/d;p?q", ";x", "http://a/b/c/;x"},
+        {"http://a/b/c/d;p?q", "g;x", "http://a/b/c/g;x"},
+        {"http://a/b/c/d;p?q", "g;x?y#s", "http://a/b/c/g;x?y#s"},
+        {"http://a/b/c/d;p?q", "", "http://a/b/c/d;p?q"},
+        {"http://a/b/c/d;p?q", ".", "http://a/b/c/"},
+        {"http://a/b/c/d;p?q", "./", "http://a/b/c/"},
+        {"http://a/b/c/d;p?q", "..", "http://a/b/"},
+        {"http://a/b/c/d;p?q", "../", "http://a/b/"},
+        {"http://a/b/c/d;p?q", "../g", "http://a/b/g"},
+        {"http://a/b/c/d;p?q", "../..", "http://a/"},
+        {"http://a/b/c/d;p?q", "../../", "http://a/"},
+        {"http://a/b/c/d;p?q", "../../g", "http://a/g"},
+        {"http://a/b/c/d;p?q", "../../../g", "http://a/g"},
+        {"http://a/b/c/d;p?q", "/./g", "http://a/g"},
+        {"http://a/b/c/d;p?q", "/../g", "http://a/g"},
+        {"http://a/b/c/d;p?q", "g.", "http://a/b/c/g."},
+        {"http://a/b/c/d;p?q", "..g", "http://a/b/c/..g"},
+        {"http://a/b/c/d;p?q", "./../g", "http://a/b/g"},
+        {"http://a/b/c/d;p?q", "g/./h", "http://a/b/c/g/h"},
+        {"http://a/b/c/d;p?q", "g/../h", "http://a/b/c/h"},
+        {"http://example.com", "foo", "http://example.com/foo"},
+        {"http://example.com/", "foo", "http://example.com/foo"},
+        {"foo", "bar", "bar"},
+    };
+    size_t index = 0;
+    for (const auto& test_vector : test_vectors)
+    {
+        Uri::Uri base_uri, relative_reference_uri, expected_target_uri;
+        ASSERT_TRUE(base_uri.ParseFromString(test_vector.base_string)) << index;
+        ASSERT_TRUE(relative_reference_uri.ParseFromString(test_vector.relative_reference_string)) << index;
+        ASSERT_TRUE(expected_target_uri.ParseFromString(test_vector.target_string)) << index;
+        const auto actual_target_uri = base_uri.Resolve(relative_reference_uri);
+        ASSERT_EQ(test_vector.target_string, actual_target_uri.GenerateString()) << index;
+        ASSERT_EQ(expected_target_uri, actual_target_uri) << index;
+        ++index;
+    }
+}
+
+TEST(UriTests, ResolveToStringMatchesResolve)
+{
+    const std::vector< std::string > bases
+    {
+        "http://a/b/c/d;p?q",
+        "HTTP://Bob:Pw@WWW.Example.COM:8080/%7Efoo/./bar/../baz?q%41=1+2#frag",
+        "http://[2001:DB8::1]:80/a/b",
+        "http://example.com",
+        "http://example.com/",
+        "//joe@example.com",
+        "//:8080",
+        "foo/bar",
+        "/",
+        "",
+        "urn:hello,%20w%6Frld",
+        "%",
+        "%4/x",
+    };
+    const std::vector< std::string > references
+    {
+        "g:h", "g", "./g", "g/", "/g", "//g", "?y", "g?y", "#s", "g#s",
+        "g?y#s", ";x", "g;x", "g;x?y#s", "", ".", "./", "..", "../",
+        "../g", "../..", "../../", "../../g", "../../../g", "/./g",
+        "/../g", "g.", "..g", "./../g", "g/./h", "g/../h", "g/.//h",
+        "%2E%2E/g", "a%2fb/c", "%7e%41", "?a+b%2B", "#%5B%5d",
+        "HTTPS://User@HOST.example:443", "//[::FFFF:1.2.3.4]/x",
+        "//h:0/", "//@h", "mailto:Joe@Example.com", "//", "///x",
+        "%", "%4", "%/g", "%4/g", "xv1.xx//+%C3%A9",
+    };
+    for (const auto& base_string : bases)
+    {
+        Uri::Uri base;
+        ASSERT_TRUE(base.ParseFromString(base_string)) << base_string;
+        for (const auto& reference_string : references)
+        {
+            Uri::Uri reference;
+            ASSERT_TRUE(reference.ParseFromString(reference_string)) << reference_string;
+            const auto expected = base.Resolve(reference).GenerateString();
+            ASSERT_EQ(expected, base.ResolveToString(reference))
+                << base_string << " + " << reference_string;
+            std::string target;
+            ASSERT_TRUE(base.ResolveInto(reference_string, target));
+            ASSERT_EQ(expected, target) << base_string << " + " << reference_string;
+            ASSERT_TRUE(Uri::Uri::ResolveInto(base_string, reference_string, target));
+            ASSERT_EQ(expected, target) << base_string << " + " << reference_string;
+        }
+    }
+}
+
+TEST(UriTests, MakeRelative)
+{
+    struct TestVector
+    {
+        std::string target_string;
+        std::string relative_reference_string;
+    };
+    const std::vector< TestVector > test_vectors
+    {
+        {"http://a/b/c/g", "g"},
+        {"http://a/b/c/g/", "g/"},
+        {"http://a/b/c/g?y#s", "g?y#s"},
+        {"http://a/g", "/g"},
+        {"http://a/b/g", "../g"},
+        {"http://a/b/", "../"},
+        {"http://a/b/c/", "."},
+        {"http://a/", "/"},
+        {"http://g/", "//g/"},
+        {"http://a:81/b/c/d;p?q", "//a:81/b/c/d;p?q"},
+        {"http://a/b/c/d;p?y", "?y"},
+        {"http://a/b/c/d;p?q#s", "#s"},
+        {"http://a/b/c/d;p?q", ""},
+        {"http://a/b/c/d;p", "d;p"},
+        {"http://a/b/c/x:y", "./x:y"},
+        {"http://a/b/x/y/z", "../x/y/z"},
+        {"https://a/b/c/d;p?q", "https://a/b/c/d;p?q"},
+        {"mailto:joe@example.com", "mailto:joe@example.com"},
+    };
+    Uri::Uri base;
+    ASSERT_TRUE(base.ParseFromString("http://a/b/c/d;p?q"));
+    for (const auto& test_vector : test_vectors)
+    {
+        Uri::Uri target;
+        ASSERT_TRUE(target.ParseFromString(test_vector.target_string));
+        const auto relative_reference = base.MakeRelative(target);
+        ASSERT_EQ(test_vector.relative_reference_string, relative_reference.GenerateString())
+            << test_vector.target_string;
+        ASSERT_EQ(target, base.Resolve(relative_reference)) << test_vector.target_string;
+    }
+}
+
+TEST(UriTests, MakeRelativeRoundTripsThroughResolve)
+{
+    const std::vector< std::string > bases
+    {
+        "http://a/b/c/d;p?q",
+        "http://a/b/c/",
+        "http://Bob:Pw@WWW.Example.COM:8080/%7Efoo/bar/baz?q%41=1+2#frag",
+        "http://example.com",
+        "http://example.com/",
+        "http://example.com/a:b/c",
+        "file:///etc/hosts",
+        "urn:hello,%20w%6Frld",
+        "http://a/b/./c/../d/e;p?q",
+        "http://a/b/c/./",
+        "http://a/../../b/c",
+        "http://a/b//../c//./d",
+        "file:///'080/./",
+        "urn:../0%2F$$",
+    };
+    const std::vector< std::string > references
+    {
+        "g:h", "g", "./g", "g/", "/g", "//g", "?y", "g?y", "#s", "g#s",
+        "g?y#s", ";x", "g;x", "g;x?y#s", "", ".", "./", "..", "../",
+        "../g", "../..", "../../", "../../g", "/./g", "./x:y", "a%2fb/c",
+        "%7e%41", "?a+b%2B", "#%5B%5d", "a//b", "/a//b", "../a/b/c/d/e/f",
+        "HTTPS://User@HOST.example:443", "//[::FFFF:1.2.3.4]/x",
+        "mailto:Joe@Example.com", "http://a", "http://a?x",
+    };
+    for (const auto& base_string : bases)
+    {
+        Uri::Uri base;
+        ASSERT_TRUE(base.ParseFromString(base_string)) << base_string;
+        Uri::ResolvedBase resolved_base(base);
+        for (const auto& reference_string : references)
+        {
+            Uri::Uri reference;
+            ASSERT_TRUE(reference.ParseFromString(reference_string)) << reference_string;
+            const auto target = base.Resolve(reference);
+            const auto relative_reference = base.MakeRelative(target);
+            ASSERT_EQ(target, base.Resolve(relative_reference))
+                << base_string << " + " << reference_string
+                << " -> " << relative_reference.GenerateString();
+            const auto relative_reference_string = relative_reference.GenerateString();
+            ASSERT_LE(relative_reference_string.length(), target.GenerateString().length())
+                << base_string << " + " << reference_string;
+            Uri::Uri parsed_target, parsed_relative_reference;
+            ASSERT_TRUE(parsed_target.ParseFromString(target.GenerateString()));
+            ASSERT_TRUE(parsed_relative_reference.ParseFromString(relative_reference_string))
+                << relative_reference_string;
+            ASSERT_EQ(parsed_target, base.Resolve(parsed_relative_reference))
+                << base_string << " + " << reference_string
+                << " -> " << relative_reference_string;
+            ASSERT_EQ(relative_reference, resolved_base.MakeRelative(target))
+                << base_string << " + " << reference_string;
+        }
+    }
+
+    // A base whose path has dot segments is a directory other than the
+    // one its segments spell.
+    Uri::Uri base, target;
+    ASSERT_TRUE(base.ParseFromString("file:///'080/./"));
+    ASSERT_TRUE(target.ParseFromString("file:/'080/8080*"));
+    const auto relative_reference = base.MakeRelative(target);
+    ASSERT_EQ("8080*", relative_reference.GenerateString());
+    ASSERT_EQ(target, base.Resolve(relative_reference));
+}
+
+TEST(UriTests, ResolveIntoRejectsWhatParseFromStringRejects)
+{
+    const std::vector< std::string > test_vectors
+    {
+        "0://www.example.com/",
+        "//%X@www.example.com/",
+        "//{@www.example.com/",
+        "//@www:example.com/",
+        "//[vX.:]/",
+        "//[::1",
+        "//[::1]x",
+        "//www.example.com:badport/",
+        "//www.example.com:65536/",
+        "//www.example.com%4/",
+        "/foo[bar",
+        "?foo]",
+        "#[",
+    };
+    Uri::Uri base;
+    ASSERT_TRUE(base.ParseFromString("http://a/b/c/d;p?q"));
+    size_t index = 0;
+    for (const auto& test_vector : test_vectors)
+    {
+        Uri::Uri uri;
+        ASSERT_FALSE(uri.ParseFromString(test_vector)) << index;
+        std::string target;
+        ASSERT_FALSE(base.ResolveInto(test_vector, target)) << index;
+        ASSERT_TRUE(target.empty()) << index;
+        ASSERT_FALSE(Uri::Uri::ResolveInto(test_vector, "g", target)) << index;
+        ++index;
+    }
+}
+
+TEST(UriTests, CopiesAreIndependent)
+{
+    Uri::Uri original;
+    ASSERT_TRUE(original.ParseFromString("http://bob@www.example.com:8080/foo/bar?query#fragment"));
+    Uri::Uri copy(original);
+    ASSERT_EQ(original, copy);
+    copy.SetHost("other.example.com");
+    copy.SetPath({"", "baz"});
+    copy.SetQuery("changed");
+    copy.SetFragment("changed");
+    copy.SetUserInfo("alice");
+    copy.SetScheme("https");
+    ASSERT_EQ("http://bob@www.example.com:8080/foo/bar?query#fragment", original.GenerateString());
+    ASSERT_EQ("https://alice@other.example.com:8080/baz?changed#changed", copy.GenerateString());
+
+    Uri::Uri assigned;
+    assigned = original;
+    assigned.NormalizePath();
+    ASSERT_TRUE(assigned.ParseFromString("/a/./b/../c"));
+    ASSERT_EQ("http://bob@www.example.com:8080/foo/bar?query#fragment", original.GenerateString());
+
+    Uri::Uri reference;
+    ASSERT_TRUE(reference.ParseFromString("../g/./h"));
+    auto resolved = original.Resolve(reference);
+    ASSERT_EQ("http://bob@www.example.com:8080/g/h", resolved.GenerateString());
+    resolved.SetHost("changed");
+    ASSERT_EQ("www.example.com", original.GetHost());
+    ASSERT_EQ((std::vector< std::string >{"..", "g", ".", "h"}), reference.GetPath());
+}
+
+TEST(UriTests, ParseFromStringViewsAndBuffers)
+{
+    const char buffer[] = "GET http://www.example.com/foo/bar?q=1#f HTTP/1.1";
+    const std::string_view request_line(buffer);
+    const auto target = request_line.substr(4, request_line.find(' ', 4) - 4);
+    Uri::Uri from_view;
+    ASSERT_TRUE(from_view.ParseFromString(target));
+    Uri::Uri from_buffer;
+    ASSERT_TRUE(from_buffer.ParseFromString(target.data(), target.length()));
+    Uri::Uri from_string;
+    ASSERT_TRUE(from_string.ParseFromString(std::string(target)));
+    ASSERT_EQ(from_string, from_view);
+    ASSERT_EQ(from_string, from_buffer);
+    ASSERT_EQ("http://www.example.com/foo/bar?q=1#f", from_view.GenerateString());
+    Uri::Uri truncated;
+    ASSERT_TRUE(truncated.ParseFromString(buffer + 4, 22));
+    ASSERT_EQ("www.example.com", truncated.GetHost());
+    ASSERT_EQ((std::vector< std::string >{""}), truncated.GetPath());
+    ASSERT_FALSE(truncated.ParseFromString(std::string_view("http://[::1")));
+}
+
+TEST(UriTests, ViewGetters)
+{
+    Uri::Uri uri;
+    ASSERT_TRUE(uri.ParseFromString("HTTP://bob@www.Example.com:8080/a/%20b/?q=%41#frag"));
+    ASSERT_EQ("http", uri.GetSchemeView());
+    ASSERT_EQ("bob", uri.GetUserInfoView());
+    ASSERT_EQ("www.example.com", uri.GetHostView());
+    ASSERT_EQ("q=A", uri.GetQueryView());
+    ASSERT_EQ("frag", uri.GetFragmentView());
+    const auto path = uri.GetPath();
+    ASSERT_EQ(path.size(), uri.GetPathSegmentCount());
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        ASSERT_EQ(path[i], uri.GetPathSegment(i));
+    }
+    ASSERT_EQ(" b", uri.GetPathSegment(2));
+}
+
+TEST(UriTests, RvalueSettersTakeOwnership)
+{
+    Uri::Uri uri;
+    std::string host(64, 'h');
+    const auto* host_characters = host.data();
+    uri.SetHost(std::move(host));
+    ASSERT_EQ(host_characters, uri.GetHostView().data());
+
+    std::vector< std::string > path{"", std::string(64, 'p')};
+    const auto* segment_characters = path[1].data();
+    uri.SetPath(std::move(path));
+    ASSERT_EQ(segment_characters, uri.GetPathSegment(1).data());
+    ASSERT_EQ("//" + std::string(64, 'h') + "/" + std::string(64, 'p'), uri.GenerateString());
+
+    uri.SetScheme(std::string("https"));
+    uri.SetUserInfo(std::string("bob"));
+    uri.SetQuery(std::string("q"));
+    uri.SetFragment(std::string("f"));
+    ASSERT_EQ("https://bob@" + std::string(64, 'h') + "/" + std::string(64, 'p') + "?q#f", uri.GenerateString());
+}